@@ -0,0 +1,81 @@
+#!/usr/bin/env bash
+# ============================================================================
+# simple-redis — AOF fsync policy comparison
+#
+# Starts the server once per --appendfsync policy and runs SET with 1, 50
+# and 500 concurrent connections, and with 50 connections pipelining 16
+# commands each. Group commit makes one write() (and under `always`, one
+# fsync) cover every SET of an event loop iteration, so throughput under
+# `always` should grow with the number of concurrent writers.
+#
+# Usage:  ./bench/run_aof_benchmark.sh
+#         (the AOF is written to the current directory; run it on the disk
+#          you want to measure)
+# ============================================================================
+set -euo pipefail
+
+PORT=16410
+SERVER=./build/simple-redis
+REQUESTS=100000
+DATASIZE=64
+CONNECTIONS=(1 50 500)
+PIPELINE=16
+POLICIES=(no everysec always)
+
+# ── Helpers ─────────────────────────────────────────────────────────────────
+cleanup() {
+    if [[ -n "${SERVER_PID:-}" ]]; then
+        kill "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+    fi
+    rm -f appendonly.aof
+}
+trap cleanup EXIT
+
+start_server() {
+    rm -f appendonly.aof
+    "$SERVER" "$PORT" --appendfsync "$1" &
+    SERVER_PID=$!
+    sleep 0.5
+}
+
+stop_server() {
+    cleanup
+    SERVER_PID=
+}
+
+bench_set() {
+    local clients="$1" pipeline="$2"
+    local out ops
+    out=$(redis-benchmark -p "$PORT" -n "$REQUESTS" -c "$clients" \
+          -P "$pipeline" -d "$DATASIZE" -r 100000 -t set -q 2>&1 || true)
+    ops=$(echo "$out" | grep -oP '[\d.]+(?= requests per second)' | head -1 || true)
+    echo "${ops:-N/A}"
+}
+
+# ============================================================================
+if [[ ! -x "$SERVER" ]]; then
+    make -j"$(nproc)"
+fi
+
+echo "============================================"
+echo " simple-redis AOF fsync policy comparison"
+echo " requests=$REQUESTS  data=${DATASIZE}B"
+echo "============================================"
+header=$(printf "%-11s" "appendfsync")
+for clients in "${CONNECTIONS[@]}"; do
+    header+=$(printf " %12s" "c=$clients")
+done
+header+=$(printf " %15s" "c=50 P=$PIPELINE")
+echo "$header"
+
+for policy in "${POLICIES[@]}"; do
+    start_server "$policy"
+    row=$(printf "%-11s" "$policy")
+    for clients in "${CONNECTIONS[@]}"; do
+        row+=$(printf " %12s" "$(bench_set "$clients" 1)")
+    done
+    row+=$(printf " %15s" "$(bench_set 50 "$PIPELINE")")
+    echo "$row"
+    stop_server
+done
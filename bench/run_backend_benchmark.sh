@@ -0,0 +1,72 @@
+#!/usr/bin/env bash
+# ============================================================================
+# simple-redis — I/O Backend Comparison (epoll vs io_uring)
+#
+# Starts the server once per --io-backend and runs SET/GET with 1,000 and
+# 10,000 concurrent connections against each.
+#
+# Usage:  ./bench/run_backend_benchmark.sh
+#         (raises the fd limit; 10k clients need `ulimit -n` >= ~10100)
+# ============================================================================
+set -euo pipefail
+
+PORT=16409
+SERVER=./build/simple-redis
+REQUESTS=200000
+DATASIZE=64
+CONNECTIONS=(1000 10000)
+BACKENDS=(epoll io_uring)
+
+# ── Helpers ─────────────────────────────────────────────────────────────────
+cleanup() {
+    if [[ -n "${SERVER_PID:-}" ]]; then
+        kill "$SERVER_PID" 2>/dev/null || true
+        wait "$SERVER_PID" 2>/dev/null || true
+    fi
+    rm -f appendonly.aof
+}
+trap cleanup EXIT
+
+start_server() {
+    rm -f appendonly.aof
+    "$SERVER" "$PORT" --io-backend "$1" &
+    SERVER_PID=$!
+    sleep 0.5
+}
+
+stop_server() {
+    cleanup
+    SERVER_PID=
+}
+
+bench_one() {
+    local clients="$1" test="$2"
+    local out ops
+    out=$(redis-benchmark -p "$PORT" -n "$REQUESTS" -c "$clients" \
+          -d "$DATASIZE" -r 100000 -t "$test" -q 2>&1 || true)
+    ops=$(echo "$out" | grep -oP '[\d.]+(?= requests per second)' | head -1 || true)
+    echo "${ops:-N/A}"
+}
+
+# ============================================================================
+ulimit -n 65536 2>/dev/null || echo "warning: could not raise fd limit ($(ulimit -n))"
+
+if [[ ! -x "$SERVER" ]]; then
+    make -j"$(nproc)"
+fi
+
+echo "============================================"
+echo " simple-redis I/O backend comparison"
+echo " requests=$REQUESTS  data=${DATASIZE}B"
+echo "============================================"
+printf "%-10s %8s %14s %14s\n" "backend" "clients" "SET ops/sec" "GET ops/sec"
+
+for backend in "${BACKENDS[@]}"; do
+    start_server "$backend"
+    for clients in "${CONNECTIONS[@]}"; do
+        set_ops=$(bench_one "$clients" set)
+        get_ops=$(bench_one "$clients" get)
+        printf "%-10s %8s %14s %14s\n" "$backend" "$clients" "$set_ops" "$get_ops"
+    done
+    stop_server
+done
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+/// A command's arguments, args[0] being the command name.
+///
+/// The views point into the client's input buffer (RespParser's zero-copy
+/// parse) and are only valid for the duration of the handler call. Copy an
+/// argument into a std::string before storing it.
+using CommandArgs = std::vector<std::string_view>;
@@ -6,79 +6,244 @@
 #include "cmd/SetCommands.h"
 #include "cmd/ZSetCommands.h"
 #include "cmd/TransactionCommands.h"
-#include "cmd/PubSubCommands.h"
+#include "cmd/ServerCommands.h"
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
 
-#include <algorithm>
-#include <cctype>
-
-CommandTable::CommandTable() {
-    // Register all commands for Phases 2-6.
-    StringCommands::registerAll(*this);
-    KeyCommands::registerAll(*this);
-    ListCommands::registerAll(*this);
-    HashCommands::registerAll(*this);
-    SetCommands::registerAll(*this);
-    ZSetCommands::registerAll(*this);
-    TransactionCommands::registerAll(*this);
-    PubSubCommands::registerAll(*this);
+#include <string>
+
+// ── The command table ──────────────────────────────────────────────────────
+// One row per CommandId, in enum order. A null handler means the command
+// needs server state and is attached at startup with bind(): INFO
+// (ServerCommands), and EXEC, SUBSCRIBE, UNSUBSCRIBE, PUBLISH and
+// BGREWRITEAOF (Shard).
+
+using C = CommandId;
+static constexpr uint32_t W  = kCmdWrite;
+static constexpr uint32_t R  = kCmdReadonly;
+static constexpr uint32_t PS = kCmdPubSub;
+static constexpr uint32_t NM = kCmdNoMulti;
+static constexpr uint32_t WD = kCmdWrite | kCmdDenyOom;
+
+static constexpr CommandSpec kCommands[] = {
+    // id              name            handler                          arity flags  keys       fanout
+    {C::PING,         "PING",         StringCommands::cmdPing,         -1, PS,       0, 0, 0, Fanout::LOCAL},
+    {C::SET,          "SET",          StringCommands::cmdSet,           3, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::GET,          "GET",          StringCommands::cmdGet,           2, R,        1, 1, 1, Fanout::LOCAL},
+
+    {C::DEL,          "DEL",          KeyCommands::cmdDel,             -2, W,        1, -1, 1, Fanout::LOCAL},
+    {C::EXISTS,       "EXISTS",       KeyCommands::cmdExists,          -2, R,        1, -1, 1, Fanout::LOCAL},
+    {C::KEYS,         "KEYS",         KeyCommands::cmdKeys,             2, R,        0, 0, 0, Fanout::CONCAT_ARRAYS},
+    {C::EXPIRE,       "EXPIRE",       KeyCommands::cmdExpire,           3, W,        1, 1, 1, Fanout::LOCAL},
+    {C::TTL,          "TTL",          KeyCommands::cmdTtl,              2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::PEXPIRE,      "PEXPIRE",      KeyCommands::cmdPexpire,          3, W,        1, 1, 1, Fanout::LOCAL},
+    {C::PTTL,         "PTTL",         KeyCommands::cmdPttl,             2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::SCAN,         "SCAN",         KeyCommands::cmdScan,            -2, R,        0, 0, 0, Fanout::SCAN_CURSOR},
+    // OBJECT ENCODING key — the key is the third argument
+    {C::OBJECT,       "OBJECT",       KeyCommands::cmdObject,          -3, R,        2, 2, 1, Fanout::LOCAL},
+
+    {C::LPUSH,        "LPUSH",        ListCommands::cmdLPush,          -3, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::RPUSH,        "RPUSH",        ListCommands::cmdRPush,          -3, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::LPOP,         "LPOP",         ListCommands::cmdLPop,            2, W,        1, 1, 1, Fanout::LOCAL},
+    {C::RPOP,         "RPOP",         ListCommands::cmdRPop,            2, W,        1, 1, 1, Fanout::LOCAL},
+    {C::LLEN,         "LLEN",         ListCommands::cmdLLen,            2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::LRANGE,       "LRANGE",       ListCommands::cmdLRange,          4, R,        1, 1, 1, Fanout::LOCAL},
+
+    // HSET key field value [field value ...] — minimum 4 args
+    {C::HSET,         "HSET",         HashCommands::cmdHSet,           -4, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::HGET,         "HGET",         HashCommands::cmdHGet,            3, R,        1, 1, 1, Fanout::LOCAL},
+    {C::HDEL,         "HDEL",         HashCommands::cmdHDel,           -3, W,        1, 1, 1, Fanout::LOCAL},
+    {C::HGETALL,      "HGETALL",      HashCommands::cmdHGetAll,         2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::HLEN,         "HLEN",         HashCommands::cmdHLen,            2, R,        1, 1, 1, Fanout::LOCAL},
+
+    {C::SADD,         "SADD",         SetCommands::cmdSAdd,            -3, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::SREM,         "SREM",         SetCommands::cmdSRem,            -3, W,        1, 1, 1, Fanout::LOCAL},
+    {C::SISMEMBER,    "SISMEMBER",    SetCommands::cmdSIsMember,        3, R,        1, 1, 1, Fanout::LOCAL},
+    {C::SMEMBERS,     "SMEMBERS",     SetCommands::cmdSMembers,         2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::SCARD,        "SCARD",        SetCommands::cmdSCard,            2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::SINTER,       "SINTER",       SetCommands::cmdSInter,          -2, R,        1, -1, 1, Fanout::LOCAL},
+
+    // ZADD key score member [score member ...] — minimum 4 args
+    {C::ZADD,         "ZADD",         ZSetCommands::cmdZAdd,           -4, WD,       1, 1, 1, Fanout::LOCAL},
+    {C::ZSCORE,       "ZSCORE",       ZSetCommands::cmdZScore,          3, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZRANK,        "ZRANK",        ZSetCommands::cmdZRank,           3, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZREVRANK,     "ZREVRANK",     ZSetCommands::cmdZRevRank,        3, R,        1, 1, 1, Fanout::LOCAL},
+    // ZRANGE / ZREVRANGE key start stop [WITHSCORES] — 4 or 5 args
+    {C::ZRANGE,       "ZRANGE",       ZSetCommands::cmdZRange,         -4, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZREVRANGE,    "ZREVRANGE",    ZSetCommands::cmdZRevRange,      -4, R,        1, 1, 1, Fanout::LOCAL},
+    // ZRANGEBYSCORE / ZRANGEBYLEX key min max [options]
+    {C::ZRANGEBYSCORE, "ZRANGEBYSCORE", ZSetCommands::cmdZRangeByScore, -4, R,      1, 1, 1, Fanout::LOCAL},
+    {C::ZRANGEBYLEX,  "ZRANGEBYLEX",  ZSetCommands::cmdZRangeByLex,    -4, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZCOUNT,       "ZCOUNT",       ZSetCommands::cmdZCount,          4, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZREMRANGEBYSCORE, "ZREMRANGEBYSCORE", ZSetCommands::cmdZRemRangeByScore, 4, W, 1, 1, 1, Fanout::LOCAL},
+    {C::ZCARD,        "ZCARD",        ZSetCommands::cmdZCard,           2, R,        1, 1, 1, Fanout::LOCAL},
+    {C::ZREM,         "ZREM",         ZSetCommands::cmdZRem,           -3, W,        1, 1, 1, Fanout::LOCAL},
+
+    {C::MULTI,        "MULTI",        TransactionCommands::cmdMulti,    1, NM,       0, 0, 0, Fanout::LOCAL},
+    {C::DISCARD,      "DISCARD",      TransactionCommands::cmdDiscard,  1, NM,       0, 0, 0, Fanout::LOCAL},
+    {C::EXEC,         "EXEC",         nullptr,                          1, NM,       0, 0, 0, Fanout::LOCAL},
+
+    {C::SUBSCRIBE,    "SUBSCRIBE",    nullptr,                         -2, PS,       0, 0, 0, Fanout::LOCAL},
+    {C::UNSUBSCRIBE,  "UNSUBSCRIBE",  nullptr,                         -1, PS,       0, 0, 0, Fanout::LOCAL},
+    // Subscribers live on whichever shard accepted them: PUBLISH runs
+    // on every shard and the delivery counts are summed.
+    {C::PUBLISH,      "PUBLISH",      nullptr,                          3, 0,        0, 0, 0, Fanout::SUM_INTEGERS},
+
+    {C::DBSIZE,       "DBSIZE",       ServerCommands::cmdDbsize,        1, R,        0, 0, 0, Fanout::SUM_INTEGERS},
+    {C::FLUSHDB,      "FLUSHDB",      ServerCommands::cmdFlushdb,      -1, W,        0, 0, 0, Fanout::ALL_OK},
+    // Counters and keys are per shard: INFO runs on every shard and
+    // ServerCommands::mergeInfo() adds them up.
+    {C::INFO,         "INFO",         nullptr,                         -1, 0,        0, 0, 0, Fanout::MERGE_INFO},
+    {C::BGREWRITEAOF, "BGREWRITEAOF", nullptr,                          1, 0,        0, 0, 0, Fanout::LOCAL},
+    // MEMORY USAGE key [SAMPLES n] — the key is the third argument
+    {C::MEMORY,       "MEMORY",       ServerCommands::cmdMemory,       -3, R,        2, 2, 1, Fanout::LOCAL},
+    // CONFIG GET answers locally; Shard::route() sends CONFIG SET to
+    // every shard, since each applies the setting to its own event loop.
+    {C::CONFIG,       "CONFIG",       nullptr,                         -2, 0,        0, 0, 0, Fanout::LOCAL},
+
+    // Sentinel for spec(CommandId::UNKNOWN).
+    {C::UNKNOWN,      "",             nullptr,                          0, 0,        0, 0, 0, Fanout::LOCAL},
+};
+
+static_assert(sizeof(kCommands) / sizeof(kCommands[0]) == kCommandCount + 1,
+              "kCommands needs exactly one row per CommandId");
+
+static constexpr bool rowsInIdOrder() {
+    for (size_t i = 0; i <= kCommandCount; ++i) {
+        if (static_cast<size_t>(kCommands[i].id) != i) return false;
+    }
+    return true;
 }
+static_assert(rowsInIdOrder(), "kCommands rows must follow CommandId order");
 
-void CommandTable::registerCommand(CommandEntry entry) {
-    // Store command name in uppercase for case-insensitive lookup.
-    std::string upper = entry.name;
-    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
-    entry.name = upper;
-    table_[upper] = std::move(entry);
+static constexpr bool namesAreUppercaseLetters() {
+    for (size_t i = 0; i < kCommandCount; ++i) {
+        if (kCommands[i].name.empty()) return false;
+        for (char c : kCommands[i].name) {
+            if (c < 'A' || c > 'Z') return false;
+        }
+    }
+    return true;
+}
+// resolve() folds case with `& 0xDF`, which is only exact for letters.
+static_assert(namesAreUppercaseLetters(), "command names must be A-Z only");
+
+// ── Perfect hash ───────────────────────────────────────────────────────────
+// FNV-1a over the case-folded name, seeded; the top 8 bits pick one of 256
+// slots. The first seed under which no two command names share a slot is
+// found by the compiler, so a lookup never probes.
+
+static constexpr size_t kHashBits  = 8;
+static constexpr size_t kHashSlots = size_t{1} << kHashBits;
+static_assert(kCommandCount < kHashSlots / 2, "grow kHashBits");
+
+static constexpr size_t hashSlot(std::string_view name, uint32_t seed) {
+    uint32_t h = seed ^ static_cast<uint32_t>(name.size());
+    for (char c : name) {
+        h ^= static_cast<uint8_t>(c) & 0xDF;  // ASCII uppercase
+        h *= 16777619u;
+    }
+    return h >> (32 - kHashBits);
 }
 
+static constexpr bool collisionFree(uint32_t seed) {
+    bool used[kHashSlots] = {};
+    for (size_t i = 0; i < kCommandCount; ++i) {
+        size_t slot = hashSlot(kCommands[i].name, seed);
+        if (used[slot]) return false;
+        used[slot] = true;
+    }
+    return true;
+}
+
+static constexpr uint32_t findSeed() {
+    uint32_t seed = 2166136261u;  // FNV offset basis
+    while (!collisionFree(seed)) ++seed;
+    return seed;
+}
+
+static constexpr uint32_t kHashSeed = findSeed();
+
+struct SlotTable {
+    uint8_t ids[kHashSlots];
+};
+
+static constexpr SlotTable buildSlots() {
+    SlotTable t{};
+    for (size_t s = 0; s < kHashSlots; ++s) {
+        t.ids[s] = static_cast<uint8_t>(CommandId::UNKNOWN);
+    }
+    for (size_t i = 0; i < kCommandCount; ++i) {
+        t.ids[hashSlot(kCommands[i].name, kHashSeed)] = static_cast<uint8_t>(i);
+    }
+    return t;
+}
+
+static constexpr SlotTable kSlots = buildSlots();
+
+// ── Lookup ─────────────────────────────────────────────────────────────────
+
+CommandId CommandTable::resolve(std::string_view name) {
+    size_t id = kSlots.ids[hashSlot(name, kHashSeed)];
+    if (id == kCommandCount) return CommandId::UNKNOWN;
+
+    // The slot holds the only command that can match; confirm it is this one.
+    std::string_view expected = kCommands[id].name;
+    if (name.size() != expected.size()) return CommandId::UNKNOWN;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if ((name[i] & 0xDF) != expected[i]) return CommandId::UNKNOWN;
+    }
+    return static_cast<CommandId>(id);
+}
+
+const CommandSpec& CommandTable::spec(CommandId id) {
+    return kCommands[static_cast<size_t>(id)];
+}
+
+void CommandTable::bind(CommandId id, BoundCommandHandler handler, void* ctx) {
+    bound_[static_cast<size_t>(id)] = {handler, ctx};
+}
+
+// ── Dispatch ───────────────────────────────────────────────────────────────
+
 void CommandTable::dispatch(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) const {
     if (args.empty()) return;
+    dispatch(resolve(args[0]), db, conn, args);
+}
 
-    // Convert command name to uppercase for case-insensitive matching.
-    std::string cmdName = args[0];
-    std::transform(cmdName.begin(), cmdName.end(), cmdName.begin(), ::toupper);
-
-    auto it = table_.find(cmdName);
-    if (it == table_.end()) {
-        // Unknown command.
-        std::string msg = "ERR unknown command '" + args[0] + "'";
+void CommandTable::dispatch(CommandId id, Database& db, Connection& conn,
+                            const CommandArgs& args) const {
+    if (id == CommandId::UNKNOWN) {
+        std::string msg = "ERR unknown command '" + std::string(args[0]) + "'";
         RespSerializer::writeError(conn.outgoing(), msg);
         return;
     }
 
-    const CommandEntry& entry = it->second;
+    const CommandSpec& entry = kCommands[static_cast<size_t>(id)];
 
-    // Validate arity.
+    // Validate arity: positive = exact, negative = minimum.
     int argCount = static_cast<int>(args.size());
-    if (entry.arity > 0) {
-        // Exact arity: args.size() must equal entry.arity.
-        if (argCount != entry.arity) {
-            std::string msg = "ERR wrong number of arguments for '" +
-                              cmdName + "' command";
-            RespSerializer::writeError(conn.outgoing(), msg);
-            return;
-        }
-    } else {
-        // Minimum arity: args.size() must be >= -entry.arity.
-        if (argCount < -entry.arity) {
-            std::string msg = "ERR wrong number of arguments for '" +
-                              cmdName + "' command";
-            RespSerializer::writeError(conn.outgoing(), msg);
-            return;
-        }
+    bool arityOk = entry.arity > 0 ? argCount == entry.arity
+                                   : argCount >= -entry.arity;
+    if (!arityOk) {
+        std::string msg = "ERR wrong number of arguments for '" +
+                          std::string(entry.name) + "' command";
+        RespSerializer::writeError(conn.outgoing(), msg);
+        return;
     }
 
     // Dispatch to the handler.
-    entry.handler(db, conn, args);
-}
-
-bool CommandTable::isWriteCommand(const std::string& name) const {
-    std::string upper = name;
-    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
-    auto it = table_.find(upper);
-    if (it == table_.end()) return false;
-    return it->second.isWrite;
+    if (entry.handler) {
+        entry.handler(db, conn, args);
+        return;
+    }
+    const Binding& b = bound_[static_cast<size_t>(id)];
+    if (!b.handler) {
+        std::string msg = "ERR command '" + std::string(entry.name) +
+                          "' is not available";
+        RespSerializer::writeError(conn.outgoing(), msg);
+        return;
+    }
+    b.handler(b.ctx, db, conn, args);
 }
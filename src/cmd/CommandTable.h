@@ -1,44 +1,114 @@
 #pragma once
 
+#include "cmd/CommandArgs.h"
 #include "store/Database.h"
 
-#include <functional>
-#include <string>
-#include <unordered_map>
-#include <vector>
+#include <cstdint>
+#include <string_view>
 
 class Connection;
 
-/// Describes one registered command.
-struct CommandEntry {
-    std::string name;
+/// Dense command IDs — the index of the command in the compile-time table
+/// (kCommands in CommandTable.cpp). A request's name is resolved to its ID
+/// once; everything after that keys off the ID and the command's flags.
+enum class CommandId : uint8_t {
+    PING, SET, GET,
+    DEL, EXISTS, KEYS, EXPIRE, TTL, PEXPIRE, PTTL, SCAN, OBJECT,
+    LPUSH, RPUSH, LPOP, RPOP, LLEN, LRANGE,
+    HSET, HGET, HDEL, HGETALL, HLEN,
+    SADD, SREM, SISMEMBER, SMEMBERS, SCARD, SINTER,
+    ZADD, ZSCORE, ZRANK, ZREVRANK, ZRANGE, ZREVRANGE,
+    ZRANGEBYSCORE, ZRANGEBYLEX, ZCOUNT, ZREMRANGEBYSCORE, ZCARD, ZREM,
+    MULTI, DISCARD, EXEC,
+    SUBSCRIBE, UNSUBSCRIBE, PUBLISH,
+    DBSIZE, FLUSHDB, INFO, BGREWRITEAOF, MEMORY, CONFIG,
+    UNKNOWN,               // not a command; also the number of commands
+};
+
+/// Number of real commands (UNKNOWN excluded).
+static constexpr size_t kCommandCount = static_cast<size_t>(CommandId::UNKNOWN);
+
+// ── Command flags ───────────────────────────────────────────────────────────
+static constexpr uint32_t kCmdWrite    = 1u << 0;  // modifies the keyspace — logged to the AOF
+static constexpr uint32_t kCmdReadonly = 1u << 1;  // only reads the keyspace
+static constexpr uint32_t kCmdPubSub   = 1u << 2;  // allowed in subscriber mode
+static constexpr uint32_t kCmdNoMulti  = 1u << 3;  // runs immediately inside MULTI, never queued
+static constexpr uint32_t kCmdDenyOom  = 1u << 4;  // may grow memory — refused while over maxmemory
+
+/// How a keyless command executes when the keyspace is sharded across
+/// threads (--threads N). Ignored in single-shard mode.
+enum class Fanout : uint8_t {
+    LOCAL,          // run on the shard that received it (PING, MULTI)
+    SUM_INTEGERS,   // run on every shard, reply with the sum (DBSIZE, PUBLISH)
+    CONCAT_ARRAYS,  // run on every shard, reply with one merged array (KEYS)
+    ALL_OK,         // run on every shard, +OK unless one failed (FLUSHDB)
+    MERGE_INFO,     // run on every shard, merge the INFO texts (INFO)
+    SCAN_CURSOR     // routed by the shard index encoded in the cursor (SCAN)
+};
+
+/// A command handler that needs nothing beyond the database and client.
+using CommandHandler = void (*)(Database& db, Connection& conn,
+                                const CommandArgs& args);
+
+/// A handler that also needs server state (metrics, pub/sub registry,
+/// AOF writer). `ctx` is the pointer passed to CommandTable::bind().
+using BoundCommandHandler = void (*)(void* ctx, Database& db, Connection& conn,
+                                     const CommandArgs& args);
+
+/// Describes one command. All specs live in a constexpr table.
+struct CommandSpec {
+    CommandId        id;
+    std::string_view name;     // uppercase
+    CommandHandler   handler;  // nullptr: bound per table with bind()
     int arity;       // positive = exact arg count, negative = minimum (e.g., -2 means >= 2)
-    bool isWrite;    // true for SET, DEL, etc. — used by AOF in Phase 4.
-    std::function<void(Database& db, Connection& conn,
-                       const std::vector<std::string>& args)> handler;
+    uint32_t flags;  // kCmd* bits
+
+    // Key positions (Redis key-spec style) — used to route a command to the
+    // shard that owns its keys. firstKey == 0 means the command is keyless.
+    int firstKey;    // index of the first key argument
+    int lastKey;     // index of the last key argument, -1 = last arg
+    int keyStep;     // distance between consecutive keys
+    Fanout fanout;   // keyless commands only
 };
 
-/// Maps command names to handler functions, validates arity, dispatches.
-/// Uses a simple hash map — O(1) lookup per command.
+/// Resolves command names to IDs and dispatches to handlers.
+///
+/// The command set is fixed at compile time. Names are resolved with a
+/// case-insensitive perfect hash whose seed is also found at compile
+/// time: one hash, one table load and one compare per lookup, no
+/// uppercased copy. Dispatch is an index into a flat array of plain
+/// function pointers.
+///
+/// A table instance only holds the bound handlers (commands that need
+/// per-server state); everything else is static.
 ///
 /// Must NOT know about: Sockets, epoll, RESP parsing internals.
 class CommandTable {
 public:
-    /// Constructor registers all Phase 2 commands.
-    CommandTable();
+    /// Case-insensitive name → ID. CommandId::UNKNOWN if not a command.
+    static CommandId resolve(std::string_view name);
 
-    /// Look up command, validate arity, call handler.
-    /// Writes error responses for unknown commands or wrong arity.
-    void dispatch(Database& db, Connection& conn,
-                  const std::vector<std::string>& args);
+    /// The spec for `id`. spec(CommandId::UNKNOWN) is an all-zero entry
+    /// (no flags, keyless, LOCAL).
+    static const CommandSpec& spec(CommandId id);
 
-    /// Register a command entry. Used by command modules during init.
-    void registerCommand(CommandEntry entry);
+    /// Attach the handler of a command whose spec has none.
+    void bind(CommandId id, BoundCommandHandler handler, void* ctx);
 
-    /// Return true if the named command is flagged as a write command.
-    /// Used by the AOF system to decide which commands to log.
-    bool isWriteCommand(const std::string& name) const;
+    /// Resolve args[0], then dispatch. Used by AOF replay.
+    void dispatch(Database& db, Connection& conn,
+                  const CommandArgs& args) const;
+
+    /// Validate arity and call the handler. Writes error responses for
+    /// unknown commands, wrong arity, or an unbound handler.
+    void dispatch(CommandId id, Database& db, Connection& conn,
+                  const CommandArgs& args) const;
 
 private:
-    std::unordered_map<std::string, CommandEntry> table_;
+    struct Binding {
+        BoundCommandHandler handler = nullptr;
+        void*               ctx = nullptr;
+    };
+
+    Binding bound_[kCommandCount];
 };
@@ -1,14 +1,13 @@
 #include "cmd/KeyCommands.h"
-#include "cmd/CommandTable.h"
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
 
 #include <algorithm>
-#include <cerrno>
+#include <charconv>
 #include <chrono>
-#include <climits>
-#include <cstdlib>
+#include <optional>
 #include <string>
+#include <utility>
 
 /// Return current time in milliseconds since epoch.
 static int64_t nowMs() {
@@ -19,31 +18,34 @@ static int64_t nowMs() {
 }
 
 /// Parse a string as int64_t. Returns false if not a valid integer.
-static bool parseInteger(const std::string& s, int64_t& out) {
+static bool parseInteger(std::string_view s, int64_t& out) {
     if (s.empty()) return false;
-    const char* start = s.c_str();
-    char* end = nullptr;
-    errno = 0;
-    long long val = std::strtoll(start, &end, 10);
-    if (end != start + s.size() || errno != 0) return false;
-    out = static_cast<int64_t>(val);
-    return true;
+    const char* end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, out);
+    return ec == std::errc() && ptr == end;
 }
 
-void KeyCommands::registerAll(CommandTable& table) {
-    table.registerCommand({"DEL",     -2, true,  cmdDel});
-    table.registerCommand({"EXISTS",  -2, false, cmdExists});
-    table.registerCommand({"KEYS",     2, false, cmdKeys});
-    table.registerCommand({"EXPIRE",   3, true,  cmdExpire});
-    table.registerCommand({"TTL",      2, false, cmdTtl});
-    table.registerCommand({"PEXPIRE",  3, true,  cmdPexpire});
-    table.registerCommand({"PTTL",     2, false, cmdPttl});
-    table.registerCommand({"DBSIZE",   1, false, cmdDbsize});
-    table.registerCommand({"SCAN",    -2, false, cmdScan});
+/// Map a SCAN TYPE name ("string", "list", ...; case-insensitive) to its
+/// DataType. Returns false for unknown names.
+static bool parseTypeName(std::string_view name, DataType& out) {
+    static constexpr std::pair<const char*, DataType> kTypes[] = {
+        {"STRING", DataType::STRING}, {"LIST", DataType::LIST},
+        {"HASH", DataType::HASH},     {"SET", DataType::SET},
+        {"ZSET", DataType::ZSET},
+    };
+    std::string upper(name);
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    for (const auto& [typeName, type] : kTypes) {
+        if (upper == typeName) {
+            out = type;
+            return true;
+        }
+    }
+    return false;
 }
 
 void KeyCommands::cmdDel(Database& db, Connection& conn,
-                         const std::vector<std::string>& args) {
+                         const CommandArgs& args) {
     // DEL key [key ...] — delete one or more keys, return count deleted.
     int64_t count = 0;
     for (size_t i = 1; i < args.size(); ++i) {
@@ -55,7 +57,7 @@ void KeyCommands::cmdDel(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdExists(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     // EXISTS key [key ...] — return count of keys that exist.
     int64_t count = 0;
     for (size_t i = 1; i < args.size(); ++i) {
@@ -67,7 +69,7 @@ void KeyCommands::cmdExists(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdKeys(Database& db, Connection& conn,
-                          const std::vector<std::string>& args) {
+                          const CommandArgs& args) {
     // KEYS pattern — only "*" is supported (return all keys).
     (void)args;  // pattern is always "*" for Phase 2.
     auto allKeys = db.keys();
@@ -79,7 +81,7 @@ void KeyCommands::cmdKeys(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdExpire(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     // EXPIRE key seconds — set TTL. Returns 1 if key exists, 0 if not.
     int64_t seconds = 0;
     if (!parseInteger(args[2], seconds)) {
@@ -94,7 +96,7 @@ void KeyCommands::cmdExpire(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdTtl(Database& db, Connection& conn,
-                         const std::vector<std::string>& args) {
+                         const CommandArgs& args) {
     // TTL key — remaining seconds, -1 (no TTL), -2 (key missing).
     int64_t remainingMs = db.ttl(args[1]);
     if (remainingMs == -1 || remainingMs == -2) {
@@ -106,7 +108,7 @@ void KeyCommands::cmdTtl(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdPexpire(Database& db, Connection& conn,
-                             const std::vector<std::string>& args) {
+                             const CommandArgs& args) {
     // PEXPIRE key milliseconds — set TTL in ms. Returns 1 or 0.
     int64_t ms = 0;
     if (!parseInteger(args[2], ms)) {
@@ -121,14 +123,14 @@ void KeyCommands::cmdPexpire(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdPttl(Database& db, Connection& conn,
-                          const std::vector<std::string>& args) {
+                          const CommandArgs& args) {
     // PTTL key — remaining milliseconds, -1 (no TTL), -2 (key missing).
     int64_t remainingMs = db.ttl(args[1]);
     RespSerializer::writeInteger(conn.outgoing(), remainingMs);
 }
 
 void KeyCommands::cmdDbsize(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     // DBSIZE — return the number of keys in the database.
     (void)args;
     RespSerializer::writeInteger(conn.outgoing(),
@@ -136,8 +138,8 @@ void KeyCommands::cmdDbsize(Database& db, Connection& conn,
 }
 
 void KeyCommands::cmdScan(Database& db, Connection& conn,
-                          const std::vector<std::string>& args) {
-    // SCAN cursor [COUNT count] [MATCH pattern]
+                          const CommandArgs& args) {
+    // SCAN cursor [COUNT count] [MATCH pattern] [TYPE type]
     // args[0] = "SCAN", args[1] = cursor, then optional pairs.
 
     int64_t cursorVal = 0;
@@ -150,10 +152,11 @@ void KeyCommands::cmdScan(Database& db, Connection& conn,
     size_t cursor = static_cast<size_t>(cursorVal);
     size_t count = 10;  // default COUNT
     std::string pattern = "*";
+    std::optional<DataType> type;
 
     // Parse optional arguments (case-insensitive).
     for (size_t i = 2; i + 1 < args.size(); i += 2) {
-        std::string option = args[i];
+        std::string option(args[i]);
         std::transform(option.begin(), option.end(), option.begin(), ::toupper);
         if (option == "COUNT") {
             int64_t c = 0;
@@ -165,6 +168,14 @@ void KeyCommands::cmdScan(Database& db, Connection& conn,
             count = static_cast<size_t>(c);
         } else if (option == "MATCH") {
             pattern = args[i + 1];
+        } else if (option == "TYPE") {
+            DataType t;
+            if (!parseTypeName(args[i + 1], t)) {
+                RespSerializer::writeError(conn.outgoing(),
+                                           "ERR unknown type name");
+                return;
+            }
+            type = t;
         } else {
             RespSerializer::writeError(conn.outgoing(),
                                        "ERR syntax error");
@@ -172,7 +183,7 @@ void KeyCommands::cmdScan(Database& db, Connection& conn,
         }
     }
 
-    auto [nextCursor, keys] = db.scan(cursor, count, pattern);
+    auto [nextCursor, keys] = db.scan(cursor, count, pattern, type);
 
     // SCAN returns a two-element array:
     //   [0] = next cursor as bulk string
@@ -185,3 +196,22 @@ void KeyCommands::cmdScan(Database& db, Connection& conn,
         RespSerializer::writeBulkString(conn.outgoing(), key);
     }
 }
+
+void KeyCommands::cmdObject(Database& db, Connection& conn,
+                            const CommandArgs& args) {
+    std::string sub(args[1]);
+    std::transform(sub.begin(), sub.end(), sub.begin(), ::toupper);
+    if (sub != "ENCODING" || args.size() != 3) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR unknown subcommand or wrong number of arguments for '" +
+            std::string(args[1]) + "'. Try OBJECT ENCODING.");
+        return;
+    }
+    HTEntry* entry = db.findEntry(args[2]);
+    if (!entry) {
+        RespSerializer::writeNull(conn.outgoing());
+        return;
+    }
+    RespSerializer::writeBulkString(conn.outgoing(),
+                                    encodingName(entry->value.encoding));
+}
@@ -1,25 +1,14 @@
 #include "cmd/ListCommands.h"
-#include "cmd/CommandTable.h"
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
 
-#include <deque>
+#include <string>
 
 static const char* WRONGTYPE =
     "WRONGTYPE Operation against a key holding the wrong kind of value";
 
-void ListCommands::registerAll(CommandTable& table) {
-    // arity: negative means minimum arg count
-    table.registerCommand({"LPUSH",  -3, true,  cmdLPush});
-    table.registerCommand({"RPUSH",  -3, true,  cmdRPush});
-    table.registerCommand({"LPOP",    2, true,  cmdLPop});
-    table.registerCommand({"RPOP",    2, true,  cmdRPop});
-    table.registerCommand({"LLEN",    2, false, cmdLLen});
-    table.registerCommand({"LRANGE",  4, false, cmdLRange});
-}
-
 void ListCommands::cmdLPush(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (entry && entry->value.type != DataType::LIST) {
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
@@ -29,16 +18,19 @@ void ListCommands::cmdLPush(Database& db, Connection& conn,
         db.setObject(args[1], RedisObject::createList());
         entry = db.findEntry(args[1]);
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
+    size_t before = entry->value.memoryUsage();
+    int fill = db.encodingConfig().listFill;
     for (size_t i = 2; i < args.size(); ++i) {
-        list.push_front(args[i]);
+        list.pushFront(args[i], fill);
     }
+    db.valueChanged(entry, before);
     RespSerializer::writeInteger(conn.outgoing(),
                                  static_cast<int64_t>(list.size()));
 }
 
 void ListCommands::cmdRPush(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (entry && entry->value.type != DataType::LIST) {
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
@@ -48,16 +40,19 @@ void ListCommands::cmdRPush(Database& db, Connection& conn,
         db.setObject(args[1], RedisObject::createList());
         entry = db.findEntry(args[1]);
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
+    size_t before = entry->value.memoryUsage();
+    int fill = db.encodingConfig().listFill;
     for (size_t i = 2; i < args.size(); ++i) {
-        list.push_back(args[i]);
+        list.pushBack(args[i], fill);
     }
+    db.valueChanged(entry, before);
     RespSerializer::writeInteger(conn.outgoing(),
                                  static_cast<int64_t>(list.size()));
 }
 
 void ListCommands::cmdLPop(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeNull(conn.outgoing());
@@ -67,13 +62,14 @@ void ListCommands::cmdLPop(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
     if (list.empty()) {
         RespSerializer::writeNull(conn.outgoing());
         return;
     }
-    std::string val = std::move(list.front());
-    list.pop_front();
+    size_t before = entry->value.memoryUsage();
+    std::string val = list.popFront();
+    db.valueChanged(entry, before);
     // Auto-delete empty containers.
     if (list.empty()) {
         db.del(args[1]);
@@ -82,7 +78,7 @@ void ListCommands::cmdLPop(Database& db, Connection& conn,
 }
 
 void ListCommands::cmdRPop(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeNull(conn.outgoing());
@@ -92,13 +88,14 @@ void ListCommands::cmdRPop(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
     if (list.empty()) {
         RespSerializer::writeNull(conn.outgoing());
         return;
     }
-    std::string val = std::move(list.back());
-    list.pop_back();
+    size_t before = entry->value.memoryUsage();
+    std::string val = list.popBack();
+    db.valueChanged(entry, before);
     if (list.empty()) {
         db.del(args[1]);
     }
@@ -106,7 +103,7 @@ void ListCommands::cmdRPop(Database& db, Connection& conn,
 }
 
 void ListCommands::cmdLLen(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -116,13 +113,13 @@ void ListCommands::cmdLLen(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
     RespSerializer::writeInteger(conn.outgoing(),
                                  static_cast<int64_t>(list.size()));
 }
 
 void ListCommands::cmdLRange(Database& db, Connection& conn,
-                             const std::vector<std::string>& args) {
+                             const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeArrayHeader(conn.outgoing(), 0);
@@ -132,11 +129,11 @@ void ListCommands::cmdLRange(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& list = std::get<std::deque<std::string>>(entry->value.data);
+    auto& list = entry->value.asList();
     int n = static_cast<int>(list.size());
 
-    int start = std::stoi(args[2]);
-    int stop  = std::stoi(args[3]);
+    int start = std::stoi(std::string(args[2]));
+    int stop  = std::stoi(std::string(args[3]));
 
     // Convert negative indices.
     if (start < 0) start += n;
@@ -152,7 +149,8 @@ void ListCommands::cmdLRange(Database& db, Connection& conn,
 
     int count = stop - start + 1;
     RespSerializer::writeArrayHeader(conn.outgoing(), count);
-    for (int i = start; i <= stop; ++i) {
-        RespSerializer::writeBulkString(conn.outgoing(), list[i]);
-    }
+    list.forRange(static_cast<size_t>(start), static_cast<size_t>(count),
+                  [&](std::string_view elem) {
+        RespSerializer::writeBulkString(conn.outgoing(), elem);
+    });
 }
@@ -21,14 +21,14 @@ size_t PubSubRegistry::unsubscribe(const std::string& channel, Connection& conn)
 }
 
 size_t PubSubRegistry::publish(const std::string& channel,
-                                const std::string& message) {
+                                std::string_view message) {
     auto it = channels_.find(channel);
     if (it == channels_.end()) return 0;
 
     size_t delivered = 0;
     for (Connection* sub : it->second) {
         // Write RESP push message: *3\r\n$7\r\nmessage\r\n$<chanlen>\r\n<chan>\r\n$<msglen>\r\n<msg>\r\n
-        Buffer& out = sub->outgoing();
+        ReplyChain& out = sub->outgoing();
         RespSerializer::writeArrayHeader(out, 3);
         RespSerializer::writeBulkString(out, "message");
         RespSerializer::writeBulkString(out, channel);
@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -26,7 +27,7 @@ public:
     /// Publish a message to a channel. Returns the number of subscribers
     /// that received the message. Writes the RESP push message directly
     /// into each subscriber's outgoing buffer.
-    size_t publish(const std::string& channel, const std::string& message);
+    size_t publish(const std::string& channel, std::string_view message);
 
     /// Remove a connection from ALL channels it is subscribed to.
     /// Must be called before a Connection is destroyed (e.g., on disconnect).
@@ -3,25 +3,30 @@
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
 
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <iomanip>
 #include <sstream>
+#include <string>
+#include <string_view>
 #include <unistd.h>    // getpid()
+#include <vector>
 
 // ── Registration ───────────────────────────────────────────────────────────
 
-void ServerCommands::registerAll(CommandTable& table, ServerMetrics& metrics) {
-    table.registerCommand({"DBSIZE", 1, false, cmdDbsize});
-    table.registerCommand({"FLUSHDB", -1, true, cmdFlushdb});
-    table.registerCommand({"INFO", -1, false,
-        [&metrics](Database& db, Connection& conn,
-                   const std::vector<std::string>& args) {
-            cmdInfo(db, conn, args, metrics);
-        }});
+void ServerCommands::bindAll(CommandTable& table, ServerMetrics& metrics) {
+    table.bind(CommandId::INFO,
+        [](void* ctx, Database& db, Connection& conn, const CommandArgs& args) {
+            cmdInfo(db, conn, args, *static_cast<ServerMetrics*>(ctx));
+        },
+        &metrics);
 }
 
 // ── DBSIZE ─────────────────────────────────────────────────────────────────
 
 void ServerCommands::cmdDbsize(Database& db, Connection& conn,
-                               const std::vector<std::string>& /*args*/) {
+                               const CommandArgs& /*args*/) {
     RespSerializer::writeInteger(conn.outgoing(),
                                  static_cast<int64_t>(db.dbsize()));
 }
@@ -29,9 +34,65 @@ void ServerCommands::cmdDbsize(Database& db, Connection& conn,
 // ── FLUSHDB ────────────────────────────────────────────────────────────────
 
 void ServerCommands::cmdFlushdb(Database& db, Connection& conn,
-                                const std::vector<std::string>& /*args*/) {
+                                const CommandArgs& args) {
+    // FLUSHDB [ASYNC|SYNC] — both modes flush synchronously.
+    if (args.size() > 2) {
+        RespSerializer::writeError(conn.outgoing(), "ERR syntax error");
+        return;
+    }
+    if (args.size() == 2) {
+        std::string mode(args[1]);
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::toupper);
+        if (mode != "ASYNC" && mode != "SYNC") {
+            RespSerializer::writeError(conn.outgoing(), "ERR syntax error");
+            return;
+        }
+    }
     db.flushdb();
-    RespSerializer::writeSimpleString(conn.outgoing(), "OK");
+    RespSerializer::writeOk(conn.outgoing());
+}
+
+// ── MEMORY ─────────────────────────────────────────────────────────────────
+
+// Elements MEMORY USAGE measures when SAMPLES is not given (Redis default).
+static constexpr size_t kMemoryUsageSamples = 5;
+
+void ServerCommands::cmdMemory(Database& db, Connection& conn,
+                               const CommandArgs& args) {
+    std::string sub(args[1]);
+    std::transform(sub.begin(), sub.end(), sub.begin(), ::toupper);
+    if (sub != "USAGE") {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR unknown subcommand '" + std::string(args[1]) +
+            "'. Try MEMORY USAGE.");
+        return;
+    }
+
+    size_t samples = kMemoryUsageSamples;
+    if (args.size() == 5) {
+        std::string option(args[3]);
+        std::transform(option.begin(), option.end(), option.begin(), ::toupper);
+        int64_t n = 0;
+        if (option != "SAMPLES" || !RedisObject::parseInteger(args[4], n) ||
+            n < 0) {
+            RespSerializer::writeError(conn.outgoing(), "ERR syntax error");
+            return;
+        }
+        samples = static_cast<size_t>(n);
+    } else if (args.size() != 3) {
+        RespSerializer::writeError(conn.outgoing(), "ERR syntax error");
+        return;
+    }
+
+    // Like Redis, a plain lookup: no lazy expiry, no LRU/LFU access.
+    const HTEntry* entry = db.table().find(args[2]);
+    if (!entry) {
+        RespSerializer::writeNull(conn.outgoing());
+        return;
+    }
+    size_t bytes = entry->memoryUsage() - entry->value.memoryUsage() +
+                   entry->value.computeMemoryUsage(samples);
+    RespSerializer::writeInteger(conn.outgoing(), static_cast<int64_t>(bytes));
 }
 
 // ── INFO helpers ───────────────────────────────────────────────────────────
@@ -46,6 +107,8 @@ static void appendServerSection(std::ostringstream& ss,
     ss << "redis_version:simple-redis-0.7.0\r\n";
     ss << "process_id:" << ::getpid() << "\r\n";
     ss << "tcp_port:" << m.tcpPort << "\r\n";
+    ss << "io_backend:" << m.ioBackend << "\r\n";
+    ss << "hz:" << m.hz << "\r\n";
     ss << "uptime_in_seconds:" << uptimeSec << "\r\n";
     ss << "uptime_in_days:" << (uptimeSec / 86400) << "\r\n";
     ss << "\r\n";
@@ -61,13 +124,35 @@ static void appendClientsSection(std::ostringstream& ss,
 static void appendMemorySection(std::ostringstream& ss, const Database& db) {
     ss << "# Memory\r\n";
     ss << "used_memory:" << db.usedMemory() << "\r\n";
+    ss << "maxmemory:" << db.maxMemory() << "\r\n";
+    ss << "maxmemory_policy:" << evictionPolicyName(db.evictionPolicy())
+       << "\r\n";
+    ss << "\r\n";
+}
+
+static void appendPersistenceSection(std::ostringstream& ss,
+                                     const ServerMetrics& m) {
+    ss << "# Persistence\r\n";
+    ss << "aof_enabled:" << (m.aofEnabled ? 1 : 0) << "\r\n";
+    ss << "aof_rewrite_in_progress:" << (m.aofRewriteInProgress ? 1 : 0)
+       << "\r\n";
+    ss << "aof_pending_bio_fsync:" << m.aofPendingBioFsync << "\r\n";
+    ss << "aof_delayed_fsync:" << m.aofDelayedFsync << "\r\n";
+    ss << "aof_last_fsync_duration_us:" << m.aofLastFsyncDurationUs << "\r\n";
     ss << "\r\n";
 }
 
 static void appendStatsSection(std::ostringstream& ss,
-                                const ServerMetrics& m) {
+                                const ServerMetrics& m, const Database& db) {
     ss << "# Stats\r\n";
     ss << "total_commands_processed:" << m.totalCommandsProcessed << "\r\n";
+    ss << "evicted_keys:" << db.evictionStats().evictedKeys << "\r\n";
+    ss << "eviction_time_us:" << db.evictionStats().evictionTimeUs << "\r\n";
+    ss << "expired_keys:" << db.expireStats().expiredKeys << "\r\n";
+    ss << "expired_stale_perc:" << std::fixed << std::setprecision(2)
+       << db.expireStats().stalePerc << "\r\n";
+    ss << "expire_cycle_cpu_milliseconds:"
+       << db.expireStats().cycleTimeUs / 1000 << "\r\n";
 
     // Latency histogram.
     ss << "latency_histogram_us_lt100:" << m.latencyHistogram[0] << "\r\n";
@@ -82,6 +167,12 @@ static void appendStatsSection(std::ostringstream& ss,
                             ? static_cast<size_t>(m.slowLogCount)
                             : kSlowLogMaxEntries;
     ss << "slowlog_len:" << slowlogLen << "\r\n";
+
+    // Threaded I/O offload.
+    ss << "io_threads_active:" << (m.ioThreads > 1 ? 1 : 0) << "\r\n";
+    ss << "io_threads:" << m.ioThreads << "\r\n";
+    ss << "io_threaded_reads_processed:" << m.ioThreadedReadsProcessed << "\r\n";
+    ss << "io_threaded_writes_processed:" << m.ioThreadedWritesProcessed << "\r\n";
     ss << "\r\n";
 }
 
@@ -99,7 +190,7 @@ static void appendKeyspaceSection(std::ostringstream& ss,
 // ── INFO command ───────────────────────────────────────────────────────────
 
 void ServerCommands::cmdInfo(Database& db, Connection& conn,
-                             const std::vector<std::string>& args,
+                             const CommandArgs& args,
                              ServerMetrics& metrics) {
     std::string section;
     if (args.size() >= 2) {
@@ -115,8 +206,136 @@ void ServerCommands::cmdInfo(Database& db, Connection& conn,
     if (all || section == "server")   appendServerSection(ss, metrics);
     if (all || section == "clients")  appendClientsSection(ss, metrics);
     if (all || section == "memory")   appendMemorySection(ss, db);
-    if (all || section == "stats")    appendStatsSection(ss, metrics);
+    if (all || section == "persistence") appendPersistenceSection(ss, metrics);
+    if (all || section == "stats")    appendStatsSection(ss, metrics, db);
     if (all || section == "keyspace") appendKeyspaceSection(ss, db);
 
     RespSerializer::writeBulkString(conn.outgoing(), ss.str());
 }
+
+// ── INFO merge (sharded mode) ──────────────────────────────────────────────
+
+struct InfoField {
+    std::string              name;
+    std::vector<std::string> values;  // one per shard that reported it
+};
+
+struct InfoSection {
+    std::string            header;    // "# Stats"
+    std::vector<InfoField> fields;
+};
+
+/// Fields that are the same setting on every shard, not a per-shard count.
+static bool isSharedSetting(const std::string& section,
+                            const std::string& name) {
+    return section == "# Server" || section == "# Persistence" ||
+           name == "maxmemory_policy" || name == "io_threads_active" ||
+           name == "io_threads";
+}
+
+static bool parseCount(std::string_view s, int64_t& out) {
+    auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && ptr == s.data() + s.size();
+}
+
+/// Sum "keys=3,expires=1,avg_ttl=0" style values key by key.
+static std::string sumKeyspaceValues(const std::vector<std::string>& values) {
+    std::vector<std::pair<std::string, int64_t>> totals;
+    for (const auto& value : values) {
+        std::string_view rest = value;
+        while (!rest.empty()) {
+            size_t comma = rest.find(',');
+            std::string_view item = rest.substr(0, comma);
+            rest = comma == std::string_view::npos ? std::string_view{}
+                                                   : rest.substr(comma + 1);
+            size_t eq = item.find('=');
+            if (eq == std::string_view::npos) continue;
+            std::string key(item.substr(0, eq));
+            int64_t n = 0;
+            parseCount(item.substr(eq + 1), n);
+            auto it = std::find_if(totals.begin(), totals.end(),
+                                   [&](const auto& t) { return t.first == key; });
+            if (it == totals.end()) totals.emplace_back(std::move(key), n);
+            else it->second += n;
+        }
+    }
+    std::string out;
+    for (const auto& [key, n] : totals) {
+        if (!out.empty()) out += ',';
+        out += key + "=" + std::to_string(n);
+    }
+    return out;
+}
+
+static std::string mergeValues(const std::string& section,
+                               const InfoField& field) {
+    const auto& values = field.values;
+    if (isSharedSetting(section, field.name)) return values.front();
+
+    if (field.name == "expired_stale_perc") {
+        double total = 0;
+        for (const auto& v : values) total += std::strtod(v.c_str(), nullptr);
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2)
+           << total / static_cast<double>(values.size());
+        return ss.str();
+    }
+    if (values.front().find('=') != std::string::npos) {
+        return sumKeyspaceValues(values);
+    }
+    int64_t sum = 0;
+    for (const auto& v : values) {
+        int64_t n = 0;
+        if (!parseCount(v, n)) return values.front();  // not a counter
+        sum += n;
+    }
+    return std::to_string(sum);
+}
+
+std::string ServerCommands::mergeInfo(
+        const std::vector<std::string>& shardInfos) {
+    std::vector<InfoSection> sections;
+    for (const auto& info : shardInfos) {
+        InfoSection* current = nullptr;
+        std::string_view rest = info;
+        while (!rest.empty()) {
+            size_t eol = rest.find("\r\n");
+            std::string_view line = rest.substr(0, eol);
+            rest = eol == std::string_view::npos ? std::string_view{}
+                                                 : rest.substr(eol + 2);
+            if (line.empty()) continue;
+            if (line[0] == '#') {
+                auto it = std::find_if(sections.begin(), sections.end(),
+                    [&](const InfoSection& s) { return s.header == line; });
+                if (it == sections.end()) {
+                    sections.push_back({std::string(line), {}});
+                    current = &sections.back();
+                } else {
+                    current = &*it;
+                }
+                continue;
+            }
+            size_t colon = line.find(':');
+            if (current == nullptr || colon == std::string_view::npos) continue;
+            std::string_view name = line.substr(0, colon);
+            auto& fields = current->fields;
+            auto it = std::find_if(fields.begin(), fields.end(),
+                [&](const InfoField& f) { return f.name == name; });
+            if (it == fields.end()) {
+                fields.push_back({std::string(name), {}});
+                it = fields.end() - 1;
+            }
+            it->values.emplace_back(line.substr(colon + 1));
+        }
+    }
+
+    std::string out;
+    for (const auto& section : sections) {
+        out += section.header + "\r\n";
+        for (const auto& field : section.fields) {
+            out += field.name + ":" + mergeValues(section.header, field) + "\r\n";
+        }
+        out += "\r\n";
+    }
+    return out;
+}
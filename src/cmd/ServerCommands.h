@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cmd/CommandArgs.h"
 #include "store/Database.h"
 
 #include <chrono>
@@ -43,9 +44,8 @@ static constexpr size_t kSlowLogMaxEntries = 128;
 
 // ── Server-wide metrics ────────────────────────────────────────────────────
 //
-// Single instance created in main.cpp, referenced by ServerCommands for
-// INFO output. All fields are updated on the main (single) thread — no
-// need for atomics.
+// One instance per shard, referenced by ServerCommands for INFO output.
+// All fields are updated on the shard's own thread — no need for atomics.
 
 struct ServerMetrics {
     std::chrono::steady_clock::time_point startTime{
@@ -62,9 +62,24 @@ struct ServerMetrics {
     uint64_t     slowLogCount{0};       // monotonic counter → used as ID
     int64_t      slowLogThresholdUs{10000};  // default 10 ms (Redis default)
 
-    // External state injected by main.cpp.
+    // External state injected by the shard.
     size_t   connectedClients{0};
     uint16_t tcpPort{6379};
+    const char* ioBackend{"epoll"};
+    int      hz{10};                 // current cron frequency (CONFIG SET hz)
+
+    // Threaded I/O (--io-threads): client reads / writes that ran on the
+    // I/O thread pool rather than inline on the shard thread.
+    int      ioThreads{1};
+    uint64_t ioThreadedReadsProcessed{0};
+    uint64_t ioThreadedWritesProcessed{0};
+
+    // AOF, copied from the shared AOFWriter once per loop iteration.
+    bool     aofEnabled{false};
+    bool     aofRewriteInProgress{false};
+    size_t   aofPendingBioFsync{0};      // background fsyncs queued or running
+    uint64_t aofDelayedFsync{0};         // writes forced past a slow fsync
+    uint64_t aofLastFsyncDurationUs{0};
 
     // ── helpers ──
 
@@ -73,7 +88,7 @@ struct ServerMetrics {
     }
 
     void maybeRecordSlowLog(int64_t durationUs,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
         if (durationUs < slowLogThresholdUs) return;
         auto& e       = slowLog[slowLogNextIdx % kSlowLogMaxEntries];
         e.id           = slowLogCount++;
@@ -93,22 +108,34 @@ struct ServerMetrics {
 
 namespace ServerCommands {
 
-/// Register INFO, DBSIZE, FLUSHDB with the CommandTable.
-/// INFO is captured as a lambda referencing the ServerMetrics instance.
-void registerAll(CommandTable& table, ServerMetrics& metrics);
+/// Bind INFO, which reads `metrics`, in `table`. DBSIZE and FLUSHDB
+/// are plain handlers in the static command table.
+void bindAll(CommandTable& table, ServerMetrics& metrics);
 
 /// DBSIZE — returns the number of keys in the database.
 void cmdDbsize(Database& db, Connection& conn,
-               const std::vector<std::string>& args);
+               const CommandArgs& args);
 
-/// FLUSHDB — delete all keys.
+/// FLUSHDB [ASYNC|SYNC] — delete all keys and give their memory back.
 void cmdFlushdb(Database& db, Connection& conn,
-                const std::vector<std::string>& args);
+                const CommandArgs& args);
+
+/// MEMORY USAGE key [SAMPLES n] — bytes used by a key and its value.
+/// Walks up to n elements of a collection (default 5, 0 = all) and
+/// scales to its size, instead of reporting the running total.
+void cmdMemory(Database& db, Connection& conn,
+               const CommandArgs& args);
 
 /// INFO [section] — return server information.
-/// Needs metrics reference → called via lambda capture.
+/// Needs the metrics → bound with the ServerMetrics as context.
 void cmdInfo(Database& db, Connection& conn,
-             const std::vector<std::string>& args,
+             const CommandArgs& args,
              ServerMetrics& metrics);
 
+/// Merge the INFO texts of every shard into one (`--threads N`):
+/// counters, memory and the keyspace are summed, expired_stale_perc is
+/// averaged, and settings (the Server and Persistence sections, policy,
+/// I/O threads) are taken from the first shard. Fields keep their order.
+std::string mergeInfo(const std::vector<std::string>& shardInfos);
+
 }  // namespace ServerCommands
@@ -1,45 +1,35 @@
 #include "cmd/SetCommands.h"
-#include "cmd/CommandTable.h"
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
-
-#include <unordered_set>
+#include "store/SetType.h"
 
 static const char* WRONGTYPE =
     "WRONGTYPE Operation against a key holding the wrong kind of value";
 
-void SetCommands::registerAll(CommandTable& table) {
-    table.registerCommand({"SADD",      -3, true,  cmdSAdd});
-    table.registerCommand({"SREM",      -3, true,  cmdSRem});
-    table.registerCommand({"SISMEMBER",  3, false, cmdSIsMember});
-    table.registerCommand({"SMEMBERS",   2, false, cmdSMembers});
-    table.registerCommand({"SCARD",      2, false, cmdSCard});
-}
-
 void SetCommands::cmdSAdd(Database& db, Connection& conn,
-                          const std::vector<std::string>& args) {
+                          const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (entry && entry->value.type != DataType::SET) {
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
     if (!entry) {
-        db.setObject(args[1], RedisObject::createSet());
+        db.setObject(args[1],
+                     SetType::create(args[2], db.encodingConfig().set));
         entry = db.findEntry(args[1]);
     }
-    auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
-
+    size_t before = entry->value.memoryUsage();
+    const SetLimits& limits = db.encodingConfig().set;
     int64_t added = 0;
     for (size_t i = 2; i < args.size(); ++i) {
-        if (set.insert(args[i]).second) {
-            ++added;
-        }
+        if (SetType::add(entry->value, args[i], limits)) ++added;
     }
+    db.valueChanged(entry, before);
     RespSerializer::writeInteger(conn.outgoing(), added);
 }
 
 void SetCommands::cmdSRem(Database& db, Connection& conn,
-                          const std::vector<std::string>& args) {
+                          const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -49,21 +39,21 @@ void SetCommands::cmdSRem(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
-
+    size_t before = entry->value.memoryUsage();
     int64_t removed = 0;
     for (size_t i = 2; i < args.size(); ++i) {
-        removed += set.erase(args[i]);
+        if (SetType::remove(entry->value, args[i])) ++removed;
     }
+    db.valueChanged(entry, before);
     // Auto-delete empty container.
-    if (set.empty()) {
+    if (SetType::size(entry->value) == 0) {
         db.del(args[1]);
     }
     RespSerializer::writeInteger(conn.outgoing(), removed);
 }
 
 void SetCommands::cmdSIsMember(Database& db, Connection& conn,
-                               const std::vector<std::string>& args) {
+                               const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -73,13 +63,12 @@ void SetCommands::cmdSIsMember(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
     RespSerializer::writeInteger(conn.outgoing(),
-                                 set.count(args[2]) ? 1 : 0);
+                                 SetType::contains(entry->value, args[2]) ? 1 : 0);
 }
 
 void SetCommands::cmdSMembers(Database& db, Connection& conn,
-                              const std::vector<std::string>& args) {
+                              const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeArrayHeader(conn.outgoing(), 0);
@@ -89,17 +78,15 @@ void SetCommands::cmdSMembers(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
-
     RespSerializer::writeArrayHeader(conn.outgoing(),
-                                     static_cast<int64_t>(set.size()));
-    for (const auto& member : set) {
+        static_cast<int64_t>(SetType::size(entry->value)));
+    SetType::forEach(entry->value, [&](std::string_view member) {
         RespSerializer::writeBulkString(conn.outgoing(), member);
-    }
+    });
 }
 
 void SetCommands::cmdSCard(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -109,7 +96,36 @@ void SetCommands::cmdSCard(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
     RespSerializer::writeInteger(conn.outgoing(),
-                                 static_cast<int64_t>(set.size()));
+        static_cast<int64_t>(SetType::size(entry->value)));
+}
+
+void SetCommands::cmdSInter(Database& db, Connection& conn,
+                            const CommandArgs& args) {
+    std::vector<const RedisObject*> sets;
+    sets.reserve(args.size() - 1);
+    bool missing = false;
+    for (size_t i = 1; i < args.size(); ++i) {
+        HTEntry* entry = db.findEntry(args[i]);
+        if (!entry) {
+            missing = true;  // still check the rest for WRONGTYPE
+            continue;
+        }
+        if (entry->value.type != DataType::SET) {
+            RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
+            return;
+        }
+        sets.push_back(&entry->value);
+    }
+    if (missing) {
+        // A missing key is an empty set.
+        RespSerializer::writeArrayHeader(conn.outgoing(), 0);
+        return;
+    }
+    std::vector<std::string> members = SetType::intersect(std::move(sets));
+    RespSerializer::writeArrayHeader(conn.outgoing(),
+                                     static_cast<int64_t>(members.size()));
+    for (const std::string& member : members) {
+        RespSerializer::writeBulkString(conn.outgoing(), member);
+    }
 }
@@ -1,12 +1,15 @@
 #include "cmd/ZSetCommands.h"
-#include "cmd/CommandTable.h"
 #include "net/Connection.h"
 #include "proto/RespSerializer.h"
+#include "store/ZSetType.h"
 
 #include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <limits>
 
 static const char* WRONGTYPE =
     "WRONGTYPE Operation against a key holding the wrong kind of value";
@@ -18,19 +21,115 @@ static std::string formatScore(double score) {
     return buf;
 }
 
-void ZSetCommands::registerAll(CommandTable& table) {
-    // ZADD key score member [score member ...] — minimum 4 args
-    table.registerCommand({"ZADD",   -4, true,  cmdZAdd});
-    table.registerCommand({"ZSCORE",  3, false, cmdZScore});
-    table.registerCommand({"ZRANK",   3, false, cmdZRank});
-    // ZRANGE key start stop [WITHSCORES] — 4 or 5 args
-    table.registerCommand({"ZRANGE", -4, false, cmdZRange});
-    table.registerCommand({"ZCARD",   2, false, cmdZCard});
-    table.registerCommand({"ZREM",   -3, true,  cmdZRem});
+/// Parse a string as int64_t. Returns false if not a valid integer.
+static bool parseInteger(std::string_view s, int64_t& out) {
+    if (s.empty()) return false;
+    const char* end = s.data() + s.size();
+    auto [ptr, ec] = std::from_chars(s.data(), end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+/// Parse one end of a score range: a float, "-inf"/"+inf", optionally
+/// prefixed with "(" for an exclusive bound.
+static bool parseScoreBound(std::string_view s, double& value,
+                            bool& exclusive) {
+    exclusive = !s.empty() && s[0] == '(';
+    if (exclusive) s.remove_prefix(1);
+    if (s.empty()) return false;
+    std::string text(s);
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    return end == text.c_str() + text.size() && !std::isnan(value);
+}
+
+static bool parseScoreRange(std::string_view min, std::string_view max,
+                            ScoreRange& range) {
+    return parseScoreBound(min, range.min, range.minExclusive) &&
+           parseScoreBound(max, range.max, range.maxExclusive);
+}
+
+/// The options after `key min max`: [WITHSCORES] (if `allowScores`) and
+/// [LIMIT offset count], in any order. Writes the error reply and returns
+/// false if they do not parse. A negative offset matches nothing, and a
+/// negative count means no limit.
+static bool parseRangeOptions(Connection& conn, const CommandArgs& args,
+                              bool allowScores, bool& withScores,
+                              int64_t& offset, size_t& count) {
+    withScores = false;
+    offset = 0;
+    count = std::numeric_limits<size_t>::max();
+    for (size_t i = 4; i < args.size(); ++i) {
+        std::string option(args[i]);
+        std::transform(option.begin(), option.end(), option.begin(), ::toupper);
+        if (allowScores && option == "WITHSCORES") {
+            withScores = true;
+        } else if (option == "LIMIT" && i + 2 < args.size()) {
+            int64_t n = 0;
+            if (!parseInteger(args[i + 1], offset) ||
+                !parseInteger(args[i + 2], n)) {
+                RespSerializer::writeError(conn.outgoing(),
+                    "ERR value is not an integer or out of range");
+                return false;
+            }
+            if (n >= 0) count = static_cast<size_t>(n);
+            i += 2;
+        } else {
+            RespSerializer::writeError(conn.outgoing(), "ERR syntax error");
+            return false;
+        }
+    }
+    return true;
+}
+
+/// Reply with `result` as members, or member/score pairs.
+static void writeRange(
+    Connection& conn,
+    const std::vector<std::pair<std::string, double>>& result,
+    bool withScores) {
+    if (withScores) {
+        RespSerializer::writeArrayHeader(conn.outgoing(),
+            static_cast<int64_t>(result.size() * 2));
+        for (const auto& [member, score] : result) {
+            RespSerializer::writeBulkString(conn.outgoing(), member);
+            RespSerializer::writeBulkString(conn.outgoing(),
+                                            formatScore(score));
+        }
+    } else {
+        RespSerializer::writeArrayHeader(conn.outgoing(),
+            static_cast<int64_t>(result.size()));
+        for (const auto& [member, score] : result) {
+            RespSerializer::writeBulkString(conn.outgoing(), member);
+        }
+    }
+}
+
+/// Look up a sorted set for a read. Returns nullptr, having written
+/// `emptyReply` or WRONGTYPE, if there is none to read.
+static const RedisObject* findZSet(Database& db, Connection& conn,
+                                   std::string_view key,
+                                   void (*emptyReply)(Connection&)) {
+    HTEntry* entry = db.findEntry(key);
+    if (!entry) {
+        emptyReply(conn);
+        return nullptr;
+    }
+    if (entry->value.type != DataType::ZSET) {
+        RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
+        return nullptr;
+    }
+    return &entry->value;
+}
+
+static void writeEmptyArray(Connection& conn) {
+    RespSerializer::writeArrayHeader(conn.outgoing(), 0);
+}
+
+static void writeZero(Connection& conn) {
+    RespSerializer::writeInteger(conn.outgoing(), 0);
 }
 
 void ZSetCommands::cmdZAdd(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     // args: ZADD key score1 member1 [score2 member2 ...]
     if ((args.size() - 2) % 2 != 0) {
         RespSerializer::writeError(conn.outgoing(),
@@ -47,35 +146,19 @@ void ZSetCommands::cmdZAdd(Database& db, Connection& conn,
         db.setObject(args[1], RedisObject::createZSet());
         entry = db.findEntry(args[1]);
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
-
+    size_t before = entry->value.memoryUsage();
+    const ListpackLimits& limits = db.encodingConfig().zset;
     int64_t added = 0;
     for (size_t i = 2; i < args.size(); i += 2) {
-        double score = std::strtod(args[i].c_str(), nullptr);
-        const std::string& member = args[i + 1];
-
-        auto it = zset.dict.find(member);
-        if (it != zset.dict.end()) {
-            // Member exists — update score if different.
-            double oldScore = it->second;
-            if (oldScore != score) {
-                zset.skiplist.remove(member, oldScore);
-                zset.skiplist.insert(member, score);
-                it->second = score;
-            }
-            // Not counted as "added" — it's an update.
-        } else {
-            // New member.
-            zset.skiplist.insert(member, score);
-            zset.dict[member] = score;
-            ++added;
-        }
+        double score = std::strtod(std::string(args[i]).c_str(), nullptr);
+        if (ZSetType::add(entry->value, args[i + 1], score, limits)) ++added;
     }
+    db.valueChanged(entry, before);
     RespSerializer::writeInteger(conn.outgoing(), added);
 }
 
 void ZSetCommands::cmdZScore(Database& db, Connection& conn,
-                             const std::vector<std::string>& args) {
+                             const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeNull(conn.outgoing());
@@ -85,19 +168,17 @@ void ZSetCommands::cmdZScore(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
-
-    auto it = zset.dict.find(args[2]);
-    if (it == zset.dict.end()) {
+    auto score = ZSetType::score(entry->value, args[2]);
+    if (!score) {
         RespSerializer::writeNull(conn.outgoing());
     } else {
-        RespSerializer::writeBulkString(conn.outgoing(),
-                                        formatScore(it->second));
+        RespSerializer::writeBulkString(conn.outgoing(), formatScore(*score));
     }
 }
 
-void ZSetCommands::cmdZRank(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+/// ZRANK / ZREVRANK: `reverse` counts ranks from the highest score down.
+static void rankCommand(Database& db, Connection& conn,
+                        const CommandArgs& args, bool reverse) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeNull(conn.outgoing());
@@ -107,35 +188,33 @@ void ZSetCommands::cmdZRank(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
-
-    auto it = zset.dict.find(args[2]);
-    if (it == zset.dict.end()) {
+    auto rank = ZSetType::rank(entry->value, args[2]);
+    if (!rank) {
         RespSerializer::writeNull(conn.outgoing());
         return;
     }
+    size_t r = reverse ? ZSetType::size(entry->value) - 1 - *rank : *rank;
+    RespSerializer::writeInteger(conn.outgoing(), static_cast<int64_t>(r));
+}
 
-    // Compute rank by walking level 0 to find position.
-    double score = it->second;
-    auto range = zset.skiplist.rangeByRank(0, static_cast<int>(zset.skiplist.size()) - 1);
-    int64_t rank = 0;
-    for (const auto& [m, s] : range) {
-        if (m == args[2] && s == score) {
-            RespSerializer::writeInteger(conn.outgoing(), rank);
-            return;
-        }
-        ++rank;
+/// ZRANGE / ZREVRANGE key start stop [WITHSCORES].
+static void rangeCommand(Database& db, Connection& conn,
+                         const CommandArgs& args, bool reverse) {
+    int64_t start64 = 0;
+    int64_t stop64 = 0;
+    if (!parseInteger(args[2], start64) || !parseInteger(args[3], stop64)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR value is not an integer or out of range");
+        return;
     }
-    // Should not happen if dict and skiplist are in sync.
-    RespSerializer::writeNull(conn.outgoing());
-}
+    // Ranks past an int are past any set's end: clamp, then narrow.
+    constexpr int64_t kMaxRank = std::numeric_limits<int>::max();
+    int start = static_cast<int>(std::clamp(start64, -kMaxRank, kMaxRank));
+    int stop  = static_cast<int>(std::clamp(stop64, -kMaxRank, kMaxRank));
 
-void ZSetCommands::cmdZRange(Database& db, Connection& conn,
-                             const std::vector<std::string>& args) {
-    // args: ZRANGE key start stop [WITHSCORES]
     bool withScores = false;
     if (args.size() == 5) {
-        std::string flag = args[4];
+        std::string flag(args[4]);
         // Case-insensitive comparison.
         std::transform(flag.begin(), flag.end(), flag.begin(), ::toupper);
         if (flag == "WITHSCORES") {
@@ -156,32 +235,130 @@ void ZSetCommands::cmdZRange(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
+    auto result = reverse
+        ? ZSetType::revRangeByRank(entry->value, start, stop)
+        : ZSetType::rangeByRank(entry->value, start, stop);
+    writeRange(conn, result, withScores);
+}
 
-    int start = std::stoi(args[2]);
-    int stop  = std::stoi(args[3]);
+void ZSetCommands::cmdZRank(Database& db, Connection& conn,
+                            const CommandArgs& args) {
+    rankCommand(db, conn, args, false);
+}
 
-    auto result = zset.skiplist.rangeByRank(start, stop);
+void ZSetCommands::cmdZRevRank(Database& db, Connection& conn,
+                               const CommandArgs& args) {
+    rankCommand(db, conn, args, true);
+}
 
-    if (withScores) {
-        RespSerializer::writeArrayHeader(conn.outgoing(),
-            static_cast<int64_t>(result.size() * 2));
-        for (const auto& [member, score] : result) {
-            RespSerializer::writeBulkString(conn.outgoing(), member);
-            RespSerializer::writeBulkString(conn.outgoing(),
-                                            formatScore(score));
-        }
-    } else {
-        RespSerializer::writeArrayHeader(conn.outgoing(),
-            static_cast<int64_t>(result.size()));
-        for (const auto& [member, score] : result) {
-            RespSerializer::writeBulkString(conn.outgoing(), member);
-        }
+void ZSetCommands::cmdZRange(Database& db, Connection& conn,
+                             const CommandArgs& args) {
+    rangeCommand(db, conn, args, false);
+}
+
+void ZSetCommands::cmdZRevRange(Database& db, Connection& conn,
+                                const CommandArgs& args) {
+    rangeCommand(db, conn, args, true);
+}
+
+void ZSetCommands::cmdZRangeByScore(Database& db, Connection& conn,
+                                    const CommandArgs& args) {
+    // args: ZRANGEBYSCORE key min max [WITHSCORES] [LIMIT offset count]
+    ScoreRange range;
+    if (!parseScoreRange(args[2], args[3], range)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR min or max is not a float");
+        return;
+    }
+    bool withScores;
+    int64_t offset;
+    size_t count;
+    if (!parseRangeOptions(conn, args, true, withScores, offset, count)) {
+        return;
+    }
+    const RedisObject* zset = findZSet(db, conn, args[1], writeEmptyArray);
+    if (!zset) return;
+    if (offset < 0) {
+        writeEmptyArray(conn);
+        return;
+    }
+    writeRange(conn,
+               ZSetType::rangeByScore(*zset, range,
+                                      static_cast<size_t>(offset), count),
+               withScores);
+}
+
+void ZSetCommands::cmdZRangeByLex(Database& db, Connection& conn,
+                                  const CommandArgs& args) {
+    // args: ZRANGEBYLEX key min max [LIMIT offset count]
+    LexRange range;
+    if (!LexRange::parse(args[2], args[3], range)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR min or max not valid string range item");
+        return;
     }
+    bool withScores;
+    int64_t offset;
+    size_t count;
+    if (!parseRangeOptions(conn, args, false, withScores, offset, count)) {
+        return;
+    }
+    const RedisObject* zset = findZSet(db, conn, args[1], writeEmptyArray);
+    if (!zset) return;
+    if (offset < 0) {
+        writeEmptyArray(conn);
+        return;
+    }
+    writeRange(conn,
+               ZSetType::rangeByLex(*zset, range,
+                                    static_cast<size_t>(offset), count),
+               false);
+}
+
+void ZSetCommands::cmdZCount(Database& db, Connection& conn,
+                             const CommandArgs& args) {
+    ScoreRange range;
+    if (!parseScoreRange(args[2], args[3], range)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR min or max is not a float");
+        return;
+    }
+    const RedisObject* zset = findZSet(db, conn, args[1], writeZero);
+    if (!zset) return;
+    RespSerializer::writeInteger(conn.outgoing(),
+        static_cast<int64_t>(ZSetType::count(*zset, range)));
+}
+
+void ZSetCommands::cmdZRemRangeByScore(Database& db, Connection& conn,
+                                       const CommandArgs& args) {
+    ScoreRange range;
+    if (!parseScoreRange(args[2], args[3], range)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR min or max is not a float");
+        return;
+    }
+    HTEntry* entry = db.findEntry(args[1]);
+    if (!entry) {
+        writeZero(conn);
+        return;
+    }
+    if (entry->value.type != DataType::ZSET) {
+        RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
+        return;
+    }
+    size_t before = entry->value.memoryUsage();
+    size_t removed = ZSetType::removeRangeByScore(entry->value, range);
+    db.valueChanged(entry, before);
+    // Auto-delete empty container.
+    if (ZSetType::size(entry->value) == 0) {
+        db.del(args[1]);
+    }
+    RespSerializer::writeInteger(conn.outgoing(),
+                                 static_cast<int64_t>(removed));
 }
 
 void ZSetCommands::cmdZCard(Database& db, Connection& conn,
-                            const std::vector<std::string>& args) {
+                            const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -191,13 +368,12 @@ void ZSetCommands::cmdZCard(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
     RespSerializer::writeInteger(conn.outgoing(),
-                                 static_cast<int64_t>(zset.skiplist.size()));
+        static_cast<int64_t>(ZSetType::size(entry->value)));
 }
 
 void ZSetCommands::cmdZRem(Database& db, Connection& conn,
-                           const std::vector<std::string>& args) {
+                           const CommandArgs& args) {
     HTEntry* entry = db.findEntry(args[1]);
     if (!entry) {
         RespSerializer::writeInteger(conn.outgoing(), 0);
@@ -207,19 +383,14 @@ void ZSetCommands::cmdZRem(Database& db, Connection& conn,
         RespSerializer::writeError(conn.outgoing(), WRONGTYPE);
         return;
     }
-    auto& zset = std::get<ZSetData>(entry->value.data);
-
+    size_t before = entry->value.memoryUsage();
     int64_t removed = 0;
     for (size_t i = 2; i < args.size(); ++i) {
-        auto it = zset.dict.find(args[i]);
-        if (it != zset.dict.end()) {
-            zset.skiplist.remove(it->first, it->second);
-            zset.dict.erase(it);
-            ++removed;
-        }
+        if (ZSetType::remove(entry->value, args[i])) ++removed;
     }
+    db.valueChanged(entry, before);
     // Auto-delete empty container.
-    if (zset.dict.empty()) {
+    if (ZSetType::size(entry->value) == 0) {
         db.del(args[1]);
     }
     RespSerializer::writeInteger(conn.outgoing(), removed);
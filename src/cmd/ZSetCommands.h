@@ -1,42 +1,67 @@
 #pragma once
 
+#include "cmd/CommandArgs.h"
 #include "store/Database.h"
 
 #include <string>
 #include <vector>
 
 class Connection;
-class CommandTable;
 
 /// Free functions implementing sorted set commands:
-/// ZADD, ZSCORE, ZRANK, ZRANGE, ZCARD, ZREM.
+/// ZADD, ZSCORE, ZRANK, ZREVRANK, ZRANGE, ZREVRANGE, ZRANGEBYSCORE,
+/// ZRANGEBYLEX, ZCOUNT, ZREMRANGEBYSCORE, ZCARD, ZREM.
 namespace ZSetCommands {
 
-/// Register all sorted set commands with the CommandTable.
-void registerAll(CommandTable& table);
-
 /// ZADD key score member [score member ...] — add members with scores.
 void cmdZAdd(Database& db, Connection& conn,
-             const std::vector<std::string>& args);
+             const CommandArgs& args);
 
 /// ZSCORE key member — return the score of a member.
 void cmdZScore(Database& db, Connection& conn,
-               const std::vector<std::string>& args);
+               const CommandArgs& args);
 
 /// ZRANK key member — return the rank (0-based) of a member.
 void cmdZRank(Database& db, Connection& conn,
-              const std::vector<std::string>& args);
+              const CommandArgs& args);
+
+/// ZREVRANK key member — return the rank of a member, highest score first.
+void cmdZRevRank(Database& db, Connection& conn,
+                 const CommandArgs& args);
 
 /// ZRANGE key start stop [WITHSCORES] — return elements by rank range.
 void cmdZRange(Database& db, Connection& conn,
-               const std::vector<std::string>& args);
+               const CommandArgs& args);
+
+/// ZREVRANGE key start stop [WITHSCORES] — as ZRANGE, highest score first.
+void cmdZRevRange(Database& db, Connection& conn,
+                  const CommandArgs& args);
+
+/// ZRANGEBYSCORE key min max [WITHSCORES] [LIMIT offset count] — return
+/// members whose score is in [min, max]; "(" makes a bound exclusive.
+void cmdZRangeByScore(Database& db, Connection& conn,
+                      const CommandArgs& args);
+
+/// ZRANGEBYLEX key min max [LIMIT offset count] — return members between
+/// "[a" / "(a" bounds ("-" and "+" for open ends), for equal-score sets.
+void cmdZRangeByLex(Database& db, Connection& conn,
+                    const CommandArgs& args);
+
+/// ZCOUNT key min max — count members whose score is in [min, max].
+void cmdZCount(Database& db, Connection& conn,
+               const CommandArgs& args);
+
+/// ZREMRANGEBYSCORE key min max — remove members whose score is in
+/// [min, max].
+void cmdZRemRangeByScore(Database& db, Connection& conn,
+                         const CommandArgs& args);
 
 /// ZCARD key — return the number of members in a sorted set.
 void cmdZCard(Database& db, Connection& conn,
-              const std::vector<std::string>& args);
+              const CommandArgs& args);
 
 /// ZREM key member [member ...] — remove members from a sorted set.
 void cmdZRem(Database& db, Connection& conn,
-             const std::vector<std::string>& args);
+             const CommandArgs& args);
 
 }  // namespace ZSetCommands
@@ -1,41 +1,209 @@
-#include "cmd/CommandTable.h"
-#include "cmd/PubSubRegistry.h"
-#include "cmd/ServerCommands.h"
-#include "net/Connection.h"
-#include "net/EventLoop.h"
-#include "net/Listener.h"
 #include "persistence/AOFLoader.h"
 #include "persistence/AOFWriter.h"
-#include "proto/RespParser.h"
-#include "proto/RespSerializer.h"
-#include "store/Database.h"
+#include "server/ServerConfig.h"
+#include "server/Shard.h"
 
-#include <algorithm>
-#include <chrono>
+#include <atomic>
+#include <climits>
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <memory>
-#include <unordered_map>
+#include <thread>
 #include <vector>
+#include <pthread.h>       // pthread_sigmask
+#include <strings.h>       // strcasecmp
 #include <sys/resource.h>  // setrlimit
 
 // ── AOF configuration constants ────────────────────────────────────────────
 static constexpr const char* kAOFFilename = "appendonly.aof";
-static constexpr auto kAOFPolicy = AOFWriter::FsyncPolicy::EVERYSEC;
 
 // ── Global state (acceptable per understanding doc §10 — signal handler) ──
-static volatile sig_atomic_t g_running = 1;
+// Atomic: read by every shard thread, written by the signal handler.
+static std::atomic<bool> g_running{true};
 
 static void signalHandler(int /*sig*/) {
-    g_running = 0;
+    g_running.store(false, std::memory_order_relaxed);
+}
+
+/// Parse a Redis memory size: a byte count with an optional k/m/g suffix
+/// (powers of 1000) or kb/mb/gb suffix (powers of 1024), any case.
+static bool parseMemorySize(const char* text, size_t& out) {
+    char* end = nullptr;
+    unsigned long long value = std::strtoull(text, &end, 10);
+    if (end == text || text[0] == '-') return false;
+    static constexpr struct {
+        const char* suffix;
+        unsigned long long multiplier;
+    } kUnits[] = {
+        {"", 1},
+        {"k", 1000ULL},        {"kb", 1024ULL},
+        {"m", 1000ULL * 1000}, {"mb", 1024ULL * 1024},
+        {"g", 1000ULL * 1000 * 1000}, {"gb", 1024ULL * 1024 * 1024},
+    };
+    for (const auto& unit : kUnits) {
+        if (strcasecmp(end, unit.suffix) == 0) {
+            out = static_cast<size_t>(value * unit.multiplier);
+            return true;
+        }
+    }
+    return false;
+}
+
+/// The encoding limit a `--<type>-max-listpack-<entries|value>` or
+/// `--set-max-intset-entries` flag sets, or nullptr if `arg` is not one
+/// of them.
+static size_t* encodingLimitFlag(const char* arg, EncodingConfig& encoding) {
+    const struct {
+        const char* flag;
+        size_t* target;
+    } kFlags[] = {
+        {"--hash-max-listpack-entries", &encoding.hash.maxEntries},
+        {"--hash-max-listpack-value",   &encoding.hash.maxValue},
+        {"--set-max-listpack-entries",  &encoding.set.maxEntries},
+        {"--set-max-listpack-value",    &encoding.set.maxValue},
+        {"--set-max-intset-entries",    &encoding.set.maxIntsetEntries},
+        {"--zset-max-listpack-entries", &encoding.zset.maxEntries},
+        {"--zset-max-listpack-value",   &encoding.zset.maxValue},
+    };
+    for (const auto& f : kFlags) {
+        if (std::strcmp(arg, f.flag) == 0) return f.target;
+    }
+    return nullptr;
+}
+
+/// Parse `simple-redis [port] [--port N] [--threads N] [--io-threads N]
+/// [--io-backend epoll|io_uring] [--maxmemory BYTES]
+/// [--maxmemory-policy POLICY] [--{hash,set,zset}-max-listpack-{entries,value} N]
+/// [--set-max-intset-entries N] [--list-max-listpack-size N]`.
+/// Returns false (after printing usage) on a malformed command line.
+static bool parseArgs(int argc, char* argv[], ServerConfig& config) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        int* target = nullptr;
+        if (std::strcmp(arg, "--port") == 0) {
+            target = &config.port;
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            target = &config.threads;
+        } else if (std::strcmp(arg, "--io-threads") == 0) {
+            target = &config.ioThreads;
+        } else if (std::strcmp(arg, "--hz") == 0) {
+            target = &config.hz;
+        }
+        size_t* limit = encodingLimitFlag(arg, config.encoding);
+
+        if (limit && i + 1 < argc) {
+            // 0 is valid: that type never uses the compact encoding.
+            char* end = nullptr;
+            const char* text = argv[++i];
+            unsigned long long value = std::strtoull(text, &end, 10);
+            if (end == text || *end != '\0' || text[0] == '-') {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", arg, text);
+                return false;
+            }
+            *limit = static_cast<size_t>(value);
+        } else if (std::strcmp(arg, "--list-max-listpack-size") == 0 &&
+                   i + 1 < argc) {
+            // N > 0 entries per quicklist chunk, or -1 … -5 for 4 … 64 KB.
+            char* end = nullptr;
+            const char* text = argv[++i];
+            long value = std::strtol(text, &end, 10);
+            if (end == text || *end != '\0' || value == 0 || value < -5 ||
+                value > 65535) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", arg, text);
+                return false;
+            }
+            config.encoding.listFill = static_cast<int>(value);
+        } else if (std::strcmp(arg, "--maxmemory") == 0 && i + 1 < argc) {
+            if (!parseMemorySize(argv[++i], config.maxMemory)) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", arg, argv[i]);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--maxmemory-policy") == 0 && i + 1 < argc) {
+            if (!parseEvictionPolicy(argv[++i], config.maxMemoryPolicy)) {
+                std::fprintf(stderr, "Unknown maxmemory policy: %s\n", argv[i]);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--io-backend") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (std::strcmp(name, "epoll") == 0) {
+                config.ioBackend = EventLoop::Backend::EPOLL;
+            } else if (std::strcmp(name, "io_uring") == 0) {
+                config.ioBackend = EventLoop::Backend::IO_URING;
+            } else {
+                std::fprintf(stderr, "Unknown I/O backend: %s\n", name);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--appendfsync") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (strcasecmp(name, "always") == 0) {
+                config.appendFsync = AOFWriter::FsyncPolicy::ALWAYS;
+            } else if (strcasecmp(name, "everysec") == 0) {
+                config.appendFsync = AOFWriter::FsyncPolicy::EVERYSEC;
+            } else if (strcasecmp(name, "no") == 0) {
+                config.appendFsync = AOFWriter::FsyncPolicy::NO;
+            } else {
+                std::fprintf(stderr, "Unknown appendfsync policy: %s\n", name);
+                return false;
+            }
+        } else if (std::strcmp(arg, "--timeout") == 0 && i + 1 < argc) {
+            // 0 is valid: idle clients are never closed.
+            char* end = nullptr;
+            const char* text = argv[++i];
+            long value = std::strtol(text, &end, 10);
+            if (end == text || *end != '\0' || value < 0 || value > INT_MAX) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", arg, text);
+                return false;
+            }
+            config.timeout = static_cast<int>(value);
+        } else if (target && i + 1 < argc) {
+            int value = std::atoi(argv[++i]);
+            if (value <= 0) {
+                std::fprintf(stderr, "Invalid value for %s: %s\n", arg, argv[i]);
+                return false;
+            }
+            *target = value;
+        } else if (arg[0] != '-') {
+            config.port = std::atoi(arg);  // legacy positional port
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [port] [--port N] [--threads N] "
+                         "[--io-threads N] [--io-backend epoll|io_uring] "
+                         "[--hz N] [--timeout SECONDS] "
+                         "[--appendfsync always|everysec|no] "
+                         "[--maxmemory BYTES] [--maxmemory-policy POLICY] "
+                         "[--{hash,set,zset}-max-listpack-{entries,value} N] "
+                         "[--set-max-intset-entries N] "
+                         "[--list-max-listpack-size N]\n",
+                         argv[0]);
+            return false;
+        }
+    }
+
+    if (config.hz > ServerConfig::kMaxHz) {
+        std::fprintf(stderr, "--hz must be between 1 and %d\n",
+                     ServerConfig::kMaxHz);
+        return false;
+    }
+    // Both scale past one core; combining them would oversubscribe.
+    if (config.threads > 1 && config.ioThreads > 1) {
+        std::fprintf(stderr, "--io-threads requires --threads 1\n");
+        return false;
+    }
+    // io_uring already batches all socket I/O into one syscall per tick.
+    if (config.ioThreads > 1 && config.ioBackend == EventLoop::Backend::IO_URING) {
+        std::fprintf(stderr, "--io-threads requires --io-backend epoll\n");
+        return false;
+    }
+    return true;
 }
 
 int main(int argc, char* argv[]) {
     // ── Parse arguments ────────────────────────────────────────────────
-    int port = 6379;
-    if (argc > 1) {
-        port = std::atoi(argv[1]);
+    ServerConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        return 1;
     }
 
     // ── Signal setup ───────────────────────────────────────────────────
@@ -56,327 +224,67 @@ int main(int argc, char* argv[]) {
         }
     }
 
-    // ── Create listener + event loop ───────────────────────────────────
-    Listener  listener("0.0.0.0", port);
-    EventLoop eventLoop;
-    eventLoop.addFd(listener.fd(), EPOLLIN);
-
-    std::printf("Listening on port %d\n", port);
-
-    // ── Database + Command Engine ──────────────────────────────────────
-    Database     db;
-    CommandTable commandTable;
-    RespParser   parser;
-
-    // ── Server metrics (Phase 7) ───────────────────────────────────────
-    ServerMetrics metrics;
-    metrics.tcpPort = static_cast<uint16_t>(port);
+    if (!EventLoop::backendSupported(config.ioBackend)) {
+        std::fprintf(stderr, "%s unavailable on this kernel; using epoll\n",
+                     EventLoop::backendName(config.ioBackend));
+        config.ioBackend = EventLoop::Backend::EPOLL;
+    }
 
-    // Register INFO / DBSIZE / FLUSHDB.
-    ServerCommands::registerAll(commandTable, metrics);
+    // ── AOF persistence (Phase 4) — one file shared by all shards ──────
+    AOFWriter aofWriter(kAOFFilename, config.appendFsync);
 
-    // ── AOF persistence (Phase 4) ──────────────────────────────────────
-    AOFWriter aofWriter(kAOFFilename, kAOFPolicy);
+    // ── Shards: listener + event loop + database each ──────────────────
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<Shard*> peers;
+    for (int i = 0; i < config.threads; ++i) {
+        shards.push_back(
+            std::make_unique<Shard>(static_cast<uint32_t>(i), config, aofWriter));
+        peers.push_back(shards.back().get());
+    }
+    for (auto& shard : shards) {
+        shard->setPeers(peers);
+    }
 
-    // Register BGREWRITEAOF command (needs AOFWriter reference via capture).
-    commandTable.registerCommand({"BGREWRITEAOF", 1, false,
-        [&aofWriter](Database& cmdDb, Connection& conn,
-                     const std::vector<std::string>& /*args*/) {
-            aofWriter.triggerRewrite(cmdDb);
-            RespSerializer::writeSimpleString(conn.outgoing(),
-                "Background append only file rewriting started");
-        }
-    });
+    std::printf("Listening on port %d (%d thread%s, %d I/O thread%s, %s)\n",
+                config.port, config.threads, config.threads == 1 ? "" : "s",
+                config.ioThreads, config.ioThreads == 1 ? "" : "s",
+                EventLoop::backendName(config.ioBackend));
 
-    // Load AOF on startup (replay commands to reconstruct database).
+    // Load AOF on startup (replay commands into the owning shards).
     {
         AOFLoader loader;
-        int loaded = loader.load(kAOFFilename, commandTable, db);
+        int loaded = loader.load(kAOFFilename,
+            [&peers](Connection& dummy, const CommandArgs& args) {
+                Shard::replay(peers, dummy, args);
+            });
         if (loaded > 0) {
             std::printf("DB loaded from AOF: %d commands replayed\n", loaded);
         }
     }
 
-    // ── Pub/Sub Registry (Phase 6) ─────────────────────────────────────
-    PubSubRegistry pubsubRegistry;
-
-    // Register EXEC — needs CommandTable& and AOFWriter& to re-dispatch.
-    commandTable.registerCommand({"EXEC", 1, false,
-        [&commandTable, &aofWriter](Database& cmdDb, Connection& conn,
-                                     const std::vector<std::string>& /*args*/) {
-            if (!conn.txn.has_value()) {
-                RespSerializer::writeError(conn.outgoing(),
-                                           "ERR EXEC without MULTI");
-                return;
-            }
-
-            auto& queued = conn.txn->queuedCommands;
-
-            // Write the array header for the results.
-            RespSerializer::writeArrayHeader(conn.outgoing(),
-                                             static_cast<int64_t>(queued.size()));
-
-            // Execute each queued command.
-            for (auto& qcmd : queued) {
-                commandTable.dispatch(cmdDb, conn, qcmd);
-
-                // Log write commands to AOF.
-                if (aofWriter.isEnabled() &&
-                    commandTable.isWriteCommand(qcmd[0])) {
-                    aofWriter.log(qcmd);
-                }
-            }
-
-            // Clear transaction state.
-            conn.txn.reset();
-        }
-    });
-
-    // Register SUBSCRIBE — needs PubSubRegistry&.
-    commandTable.registerCommand({"SUBSCRIBE", -2, false,
-        [&pubsubRegistry](Database& /*cmdDb*/, Connection& conn,
-                          const std::vector<std::string>& args) {
-            // SUBSCRIBE channel [channel ...]
-            for (size_t i = 1; i < args.size(); ++i) {
-                size_t numSubs = pubsubRegistry.subscribe(args[i], conn);
-
-                // Reply: ["subscribe", channelName, numSubscriptions]
-                RespSerializer::writeArrayHeader(conn.outgoing(), 3);
-                RespSerializer::writeBulkString(conn.outgoing(), "subscribe");
-                RespSerializer::writeBulkString(conn.outgoing(), args[i]);
-                RespSerializer::writeInteger(conn.outgoing(),
-                                             static_cast<int64_t>(numSubs));
-            }
-        }
-    });
-
-    // Register UNSUBSCRIBE — needs PubSubRegistry&.
-    commandTable.registerCommand({"UNSUBSCRIBE", -1, false,
-        [&pubsubRegistry](Database& /*cmdDb*/, Connection& conn,
-                          const std::vector<std::string>& args) {
-            if (args.size() <= 1) {
-                // Unsubscribe from all channels.
-                if (conn.subscribedChannels.empty()) {
-                    // No subscriptions — reply with 0 count.
-                    RespSerializer::writeArrayHeader(conn.outgoing(), 3);
-                    RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
-                    RespSerializer::writeNull(conn.outgoing());
-                    RespSerializer::writeInteger(conn.outgoing(), 0);
-                } else {
-                    auto channels = conn.subscribedChannels;  // copy — set will be modified
-                    for (const auto& ch : channels) {
-                        size_t remaining = pubsubRegistry.unsubscribe(ch, conn);
-                        RespSerializer::writeArrayHeader(conn.outgoing(), 3);
-                        RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
-                        RespSerializer::writeBulkString(conn.outgoing(), ch);
-                        RespSerializer::writeInteger(conn.outgoing(),
-                                                     static_cast<int64_t>(remaining));
-                    }
-                }
-            } else {
-                for (size_t i = 1; i < args.size(); ++i) {
-                    size_t remaining = pubsubRegistry.unsubscribe(args[i], conn);
-                    RespSerializer::writeArrayHeader(conn.outgoing(), 3);
-                    RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
-                    RespSerializer::writeBulkString(conn.outgoing(), args[i]);
-                    RespSerializer::writeInteger(conn.outgoing(),
-                                                 static_cast<int64_t>(remaining));
-                }
-            }
-        }
-    });
-
-    // Register PUBLISH — needs PubSubRegistry&.
-    commandTable.registerCommand({"PUBLISH", 3, false,
-        [&pubsubRegistry](Database& /*cmdDb*/, Connection& conn,
-                          const std::vector<std::string>& args) {
-            // PUBLISH channel message
-            size_t delivered = pubsubRegistry.publish(args[1], args[2]);
-            RespSerializer::writeInteger(conn.outgoing(),
-                                         static_cast<int64_t>(delivered));
-        }
-    });
-
-    // ── Wire active expiry timer (Phase 3) + AOF tick (Phase 4) ────────
-    // Every 100ms: expire keys, fsync if EVERYSEC, check rewrite child.
-    eventLoop.setTimerCallback([&db, &aofWriter]() {
-        db.activeExpireCycle(200);
-        aofWriter.tick();
-        aofWriter.checkRewriteComplete();
-    }, 100);
-
-    // ── Connection map: fd → Connection ────────────────────────────────
-    std::unordered_map<int, std::unique_ptr<Connection>> connections;
-
-    // ── Main loop ──────────────────────────────────────────────────────
-    while (g_running) {
-        // Update connected clients count for INFO command.
-        metrics.connectedClients = connections.size();
-
-        int n = eventLoop.poll(100);  // 100 ms timeout
-        if (n < 0) break;            // epoll error
-
-        for (int i = 0; i < n; ++i) {
-            const auto& ev = eventLoop.event(i);
-            int         fd = ev.data.fd;
-            uint32_t events = ev.events;
-
-            // ── Listener event: accept new connections ─────────────────
-            if (fd == listener.fd()) {
-                // Drain all pending connections (level-triggered).
-                while (true) {
-                    int clientFd = listener.acceptClient();
-                    if (clientFd < 0) break;  // EAGAIN — no more pending
-
-                    auto conn = std::make_unique<Connection>(clientFd);
-                    eventLoop.addFd(clientFd, EPOLLIN);
-                    connections[clientFd] = std::move(conn);
-                }
-                continue;
-            }
-
-            // ── Client event ───────────────────────────────────────────
-            auto it = connections.find(fd);
-            if (it == connections.end()) continue;  // stale event
-            Connection& conn = *it->second;
-
-            // Fatal error — close immediately.
-            if (events & EPOLLERR) {
-                conn.setWantClose(true);
-                continue;
-            }
-
-            // Readable (EPOLLIN or EPOLLHUP — HUP may still have data).
-            if (events & (EPOLLIN | EPOLLHUP)) {
-                if (!conn.handleRead()) {
-                    // EOF or error on read side.  Stop reading but keep
-                    // the connection alive to flush any outgoing data.
-                    conn.setWantRead(false);
-                }
-                // ── Parse/dispatch loop: handle pipelining ─────────────
-                while (true) {
-                    auto cmd = parser.parse(conn.incoming());
-                    if (!cmd.has_value()) break;  // incomplete frame
-                    if (cmd->empty()) continue;   // empty command (null array)
-
-                    // Uppercase command name for comparisons.
-                    std::string cmdName = (*cmd)[0];
-                    std::transform(cmdName.begin(), cmdName.end(),
-                                   cmdName.begin(), ::toupper);
-
-                    // ── Subscriber mode gate (Phase 6) ─────────────────
-                    // In subscriber mode, only allow SUBSCRIBE, UNSUBSCRIBE,
-                    // PING, and QUIT.
-                    if (conn.inSubscribeMode() &&
-                        cmdName != "SUBSCRIBE" && cmdName != "UNSUBSCRIBE" &&
-                        cmdName != "PING" && cmdName != "QUIT") {
-                        RespSerializer::writeError(conn.outgoing(),
-                            "ERR Can't execute '" + (*cmd)[0] +
-                            "': only (P)SUBSCRIBE / (P)UNSUBSCRIBE / "
-                            "PING / QUIT are allowed in this context");
-                        continue;
-                    }
-
-                    // ── Transaction queuing (Phase 6) ──────────────────
-                    // If in MULTI mode, queue commands instead of executing
-                    // (except EXEC, DISCARD, MULTI themselves).
-                    if (conn.txn.has_value() &&
-                        cmdName != "EXEC" && cmdName != "DISCARD" &&
-                        cmdName != "MULTI") {
-                        conn.txn->queuedCommands.push_back(*cmd);
-                        RespSerializer::writeSimpleString(conn.outgoing(),
-                                                          "QUEUED");
-                        continue;
-                    }
-
-                    // \u2500\u2500 Timed dispatch (Phase 7) \u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500\u2500
-                    auto dispatchStart = std::chrono::steady_clock::now();
-                    commandTable.dispatch(db, conn, *cmd);
-                    auto dispatchEnd = std::chrono::steady_clock::now();
-
-                    int64_t durationUs =
-                        std::chrono::duration_cast<std::chrono::microseconds>(
-                            dispatchEnd - dispatchStart).count();
-                    metrics.totalCommandsProcessed++;
-                    metrics.recordLatency(durationUs);
-                    metrics.maybeRecordSlowLog(durationUs, *cmd);
-
-                    // INV-1: Log to AOF only AFTER successful dispatch,
-                    // and only for write commands (not inside transactions
-                    // — EXEC handler logs its own queued write commands).
-                    if (cmdName != "EXEC" &&
-                        aofWriter.isEnabled() &&
-                        commandTable.isWriteCommand((*cmd)[0])) {
-                        aofWriter.log(*cmd);
-                    }
-                }
-                if (conn.outgoing().readableBytes() > 0) {
-                    conn.setWantWrite(true);
-                }
-            }
-
-            // Writable
-            if ((events & EPOLLOUT) && !conn.wantClose()) {
-                if (!conn.handleWrite()) {
-                    conn.setWantClose(true);
-                } else if (conn.outgoing().readableBytes() == 0) {
-                    conn.setWantWrite(false);
-                }
-            }
-
-            // Close if read side is done and nothing left to write.
-            if (!conn.wantRead() && conn.outgoing().readableBytes() == 0) {
-                conn.setWantClose(true);
-            }
-
-            // ── Update epoll registration for this fd ──────────────────
-            if (!conn.wantClose()) {
-                uint32_t desired = 0;
-                if (conn.wantRead())  desired |= EPOLLIN;
-                if (conn.wantWrite()) desired |= EPOLLOUT;
-                eventLoop.modFd(fd, desired);
-            }
-        }
-
-        // ── Advance incremental rehashing ───────────────────────────────
-        db.rehashStep();
-
-        // ── Sweep: enable EPOLLOUT for connections with pending output ──
-        // Necessary because PUBLISH (and future cross-connection writes)
-        // can fill a subscriber's outgoing buffer from another fd's handler.
-        for (auto& [sfd, sptr] : connections) {
-            if (!sptr->wantClose() && sptr->outgoing().readableBytes() > 0) {
-                sptr->setWantWrite(true);
-                uint32_t desired = 0;
-                if (sptr->wantRead())  desired |= EPOLLIN;
-                if (sptr->wantWrite()) desired |= EPOLLOUT;
-                eventLoop.modFd(sfd, desired);
-            }
-        }
-
-        // ── Cleanup closed connections ─────────────────────────────────
-        std::vector<int> toClose;
-        for (auto& [cfd, cptr] : connections) {
-            if (cptr->wantClose()) {
-                toClose.push_back(cfd);
-            }
-        }
-        for (int cfd : toClose) {
-            // Phase 6: Remove from pub/sub before destroying Connection.
-            auto it2 = connections.find(cfd);
-            if (it2 != connections.end()) {
-                pubsubRegistry.removeConnection(*it2->second);
-            }
-            eventLoop.removeFd(cfd);
-            connections.erase(cfd);  // unique_ptr dtor closes the fd.
+    // ── Start shard threads ────────────────────────────────────────────
+    // Shard 0 runs on the main thread. Workers are spawned with signals
+    // blocked so SIGINT/SIGTERM are always handled here.
+    std::vector<std::thread> workers;
+    {
+        sigset_t all, previous;
+        sigfillset(&all);
+        pthread_sigmask(SIG_BLOCK, &all, &previous);
+        for (size_t i = 1; i < shards.size(); ++i) {
+            Shard* shard = shards[i].get();
+            workers.emplace_back([shard]() { shard->run(g_running); });
         }
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
     }
 
+    shards[0]->run(g_running);
+
     // ── Clean shutdown ─────────────────────────────────────────────────
-    for (auto& [cfd, cptr] : connections) {
-        eventLoop.removeFd(cfd);
+    g_running.store(false, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        worker.join();
     }
-    connections.clear();
+    shards.clear();
 
     std::printf("Server shut down.\n");
     return 0;
@@ -1,7 +1,8 @@
 #include "net/Connection.h"
 
 #include <cerrno>
-#include <unistd.h>   // read, write, close
+#include <sys/uio.h>  // writev
+#include <unistd.h>   // read, close
 
 Connection::Connection(int fd)
     : fd_(fd),
@@ -13,10 +14,18 @@ Connection::~Connection() {
     }
 }
 
+void Connection::reserveIncoming(size_t len) {
+    size_t readable = in_.readableBytes();
+    if (parseState.expectedBytes > readable + len) {
+        len = parseState.expectedBytes - readable;
+    }
+    in_.ensureWritableBytes(len);
+}
+
 bool Connection::handleRead() {
     // Lazily allocate — an idle connection that never receives data
     // never allocates buffer memory.
-    in_.ensureWritableBytes(kReadBufSize);
+    reserveIncoming(kReadBufSize);
 
     ssize_t n = ::read(fd_, in_.writablePtr(), in_.writableBytes());
     if (n > 0) {
@@ -40,7 +49,9 @@ bool Connection::handleWrite() {
         return true;  // Nothing to send.
     }
 
-    ssize_t n = ::write(fd_, out_.readablePtr(), out_.readableBytes());
+    struct iovec iov[kMaxIov];
+    int count = out_.gather(iov, kMaxIov);
+    ssize_t n = ::writev(fd_, iov, count);
     if (n > 0) {
         out_.consume(static_cast<size_t>(n));
         updateActivity();
@@ -1,16 +1,20 @@
 #pragma once
 
 #include "net/Buffer.h"
+#include "net/ParseState.h"
+#include "net/ReplyChain.h"
 
 #include <chrono>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
 /// Transaction state: queued commands waiting for EXEC.
 struct TransactionState {
     /// Each queued command is a full argument vector (e.g., {"SET","a","1"}).
+    /// Owned copies: the input buffer is reused long before EXEC arrives.
     std::vector<std::vector<std::string>> queuedCommands;
 };
 
@@ -26,16 +30,21 @@ public:
 
     int fd() const { return fd_; }
 
+    /// Make room for `len` more incoming bytes — or, if the frame being
+    /// received is known to be larger, for all of it. Call only when no
+    /// parsed argument views are outstanding: growing may move the bytes.
+    void reserveIncoming(size_t len);
+
     /// Attempt to read data from the fd into the incoming buffer.
     /// Returns true if the connection is still alive, false on EOF or error.
     bool handleRead();
 
-    /// Attempt to write data from the outgoing buffer to the fd.
+    /// Attempt to write the outgoing chain to the fd with one writev().
     /// Returns true if the connection is still alive, false on error.
     bool handleWrite();
 
     Buffer& incoming() { return in_; }
-    Buffer& outgoing() { return out_; }
+    ReplyChain& outgoing() { return out_; }
 
     bool wantRead()  const { return wantRead_; }
     bool wantWrite() const { return wantWrite_; }
@@ -53,6 +62,18 @@ public:
         return lastActivity_;
     }
 
+    /// Commands already parsed off the shard thread by an I/O thread
+    /// (--io-threads), waiting to be executed in order. The views point
+    /// into incoming(), which is not touched again until they have run.
+    std::vector<std::vector<std::string_view>> parsedCommands;
+
+    /// RESP parse progress through a frame that has only partly arrived.
+    ParseState parseState;
+
+    /// Server-assigned id, unique per shard. Lets late replies detect that
+    /// the fd they target was closed and reused by a newer client.
+    uint64_t id = 0;
+
     // ── Transaction state (Phase 6) ──────────────────────────────────
     /// When has_value(), the connection is in MULTI mode.
     std::optional<TransactionState> txn;
@@ -66,10 +87,11 @@ public:
 
 private:
     static constexpr size_t kReadBufSize = 4096;
+    static constexpr int    kMaxIov = 64;  // segments per writev()
 
     int fd_;
     Buffer in_;
-    Buffer out_;
+    ReplyChain out_;
     bool wantRead_  = true;
     bool wantWrite_ = false;
     bool wantClose_ = false;
@@ -0,0 +1,52 @@
+#include "net/EpollBackend.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <unistd.h>  // close
+
+EpollBackend::EpollBackend() {
+    epollFd_ = ::epoll_create1(0);
+    if (epollFd_ < 0) {
+        throw std::runtime_error("epoll_create1() failed");
+    }
+}
+
+EpollBackend::~EpollBackend() {
+    if (epollFd_ >= 0) {
+        ::close(epollFd_);
+    }
+}
+
+void EpollBackend::addFd(int fd, uint32_t events) {
+    struct epoll_event ev{};
+    ev.events  = events;
+    ev.data.fd = fd;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+}
+
+void EpollBackend::modFd(int fd, uint32_t events) {
+    struct epoll_event ev{};
+    ev.events  = events;
+    ev.data.fd = fd;
+    ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void EpollBackend::removeFd(int fd) {
+    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+int EpollBackend::wait(int timeoutMs, std::vector<IOEvent>& out) {
+    out.clear();
+    int n = ::epoll_wait(epollFd_, events_, kMaxEvents, timeoutMs);
+    if (n < 0) {
+        return errno == EINTR ? 0 : -1;  // EINTR: interrupted by a signal
+    }
+    for (int i = 0; i < n; ++i) {
+        IOEvent ev;
+        ev.kind   = IOEvent::Kind::READY;
+        ev.fd     = events_[i].data.fd;
+        ev.events = events_[i].events;
+        out.push_back(ev);
+    }
+    return n;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "net/IOBackend.h"
+
+#include <sys/epoll.h>
+
+/// Level-triggered epoll readiness backend — the default, and the fallback
+/// when io_uring is unavailable.
+class EpollBackend : public IOBackend {
+public:
+    EpollBackend();
+    ~EpollBackend() override;
+
+    EpollBackend(const EpollBackend&) = delete;
+    EpollBackend& operator=(const EpollBackend&) = delete;
+
+    void addFd(int fd, uint32_t events) override;
+    void modFd(int fd, uint32_t events) override;
+    void removeFd(int fd) override;
+    int  wait(int timeoutMs, std::vector<IOEvent>& out) override;
+
+private:
+    int epollFd_;
+    static constexpr int kMaxEvents = 128;
+    struct epoll_event events_[kMaxEvents];
+};
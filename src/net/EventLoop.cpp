@@ -1,86 +1,65 @@
 #include "net/EventLoop.h"
+#include "net/EpollBackend.h"
+#include "net/UringBackend.h"
 
-#include <cerrno>
-#include <stdexcept>
-#include <unistd.h>  // close
+#include <algorithm>
+#include <climits>
 
-EventLoop::EventLoop() {
-    epollFd_ = ::epoll_create1(0);
-    if (epollFd_ < 0) {
-        throw std::runtime_error("epoll_create1() failed");
+EventLoop::EventLoop(Backend backend) : backendKind_(backend) {
+    if (backend == Backend::IO_URING) {
+        backend_ = std::make_unique<UringBackend>();
+    } else {
+        backend_ = std::make_unique<EpollBackend>();
     }
-    lastTimerFire_ = std::chrono::steady_clock::now();
+    epoch_ = std::chrono::steady_clock::now();
 }
 
-EventLoop::~EventLoop() {
-    if (epollFd_ >= 0) {
-        ::close(epollFd_);
-    }
+EventLoop::~EventLoop() = default;
+
+bool EventLoop::backendSupported(Backend backend) {
+    return backend == Backend::EPOLL || UringBackend::supported();
+}
+
+const char* EventLoop::backendName(Backend backend) {
+    return backend == Backend::IO_URING ? "io_uring" : "epoll";
 }
 
-void EventLoop::addFd(int fd, uint32_t events) {
-    struct epoll_event ev{};
-    ev.events  = events;
-    ev.data.fd = fd;
-    ::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+// ── Timers ─────────────────────────────────────────────────────────────────
+
+int64_t EventLoop::nowMs() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - epoch_)
+        .count();
 }
 
-void EventLoop::modFd(int fd, uint32_t events) {
-    struct epoll_event ev{};
-    ev.events  = events;
-    ev.data.fd = fd;
-    ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, fd, &ev);
+EventLoop::TimerId EventLoop::addTimer(int delayMs, TimerCallback cb) {
+    return timers_.add(nowMs() + std::max(delayMs, 0), 0, std::move(cb));
 }
 
-void EventLoop::removeFd(int fd) {
-    ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+EventLoop::TimerId EventLoop::addPeriodicTimer(int periodMs,
+                                               TimerCallback cb) {
+    periodMs = std::max(periodMs, 1);
+    return timers_.add(nowMs() + periodMs, periodMs, std::move(cb));
 }
 
-void EventLoop::setTimerCallback(TimerCallback cb, int intervalMs) {
-    timerCb_         = std::move(cb);
-    timerIntervalMs_ = intervalMs;
-    lastTimerFire_   = std::chrono::steady_clock::now();
+int EventLoop::msUntilNextTimer() {
+    int64_t next = timers_.nextDeadline();
+    if (next < 0) return -1;
+    return static_cast<int>(std::clamp<int64_t>(next - nowMs(), 0, INT_MAX));
 }
 
 int EventLoop::poll(int timeoutMs) {
-    // Clamp timeout to the next timer deadline so we don't oversleep.
-    int actualTimeout = timeoutMs;
-    if (timerCb_ && timerIntervalMs_ > 0) {
-        auto now     = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           now - lastTimerFire_)
-                           .count();
-        int remaining = timerIntervalMs_ - static_cast<int>(elapsed);
-        if (remaining <= 0) {
-            actualTimeout = 0;  // Timer is overdue — don't block.
-        } else if (remaining < actualTimeout) {
-            actualTimeout = remaining;
-        }
+    // Sleep until the nearest timer, or the caller's limit if sooner.
+    int actualTimeout = msUntilNextTimer();
+    if (timeoutMs >= 0 && (actualTimeout < 0 || timeoutMs < actualTimeout)) {
+        actualTimeout = timeoutMs;
     }
 
-    int n = ::epoll_wait(epollFd_, events_, kMaxEvents, actualTimeout);
-
+    int n = backend_->wait(actualTimeout, events_);
     if (n < 0) {
-        if (errno == EINTR) {
-            numReady_ = 0;
-            return 0;  // Interrupted by signal — not an error.
-        }
-        numReady_ = 0;
         return -1;  // Real error — caller decides how to handle.
     }
-    numReady_ = n;
-
-    // Fire the timer callback if the interval has elapsed.
-    if (timerCb_ && timerIntervalMs_ > 0) {
-        auto now     = std::chrono::steady_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                           now - lastTimerFire_)
-                           .count();
-        if (elapsed >= timerIntervalMs_) {
-            timerCb_();
-            lastTimerFire_ = now;
-        }
-    }
 
+    if (!timers_.empty()) timers_.runDue(nowMs());
     return n;
 }
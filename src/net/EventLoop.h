@@ -1,44 +1,87 @@
 #pragma once
 
+#include "net/IOBackend.h"
+#include "net/TimerWheel.h"
+
 #include <chrono>
 #include <functional>
-#include <sys/epoll.h>
+#include <memory>
+#include <vector>
 
-/// Owns the epoll instance and provides a single-threaded event loop.
+/// Owns the I/O backend and provides a single-threaded event loop.
 ///
-/// poll() runs one iteration of epoll_wait and fires the timer callback
-/// when the configured interval elapses.
+/// poll() runs one iteration of the backend (epoll_wait, or one
+/// io_uring_enter), sleeping no later than the nearest timer deadline, then
+/// fires every timer that came due. Timers — one-shot or periodic, as many
+/// as needed — live in a TimerWheel keyed by milliseconds since the loop
+/// was created, so an idle loop wakes only when some timer asks it to.
 ///
 /// Must NOT know about: RESP, commands, the database, specific connection logic.
 class EventLoop {
 public:
-    EventLoop();
+    enum class Backend : uint8_t { EPOLL, IO_URING };
+
+    /// Throws std::runtime_error if the backend cannot be created.
+    explicit EventLoop(Backend backend = Backend::EPOLL);
     ~EventLoop();
 
     EventLoop(const EventLoop&) = delete;
     EventLoop& operator=(const EventLoop&) = delete;
 
-    void addFd(int fd, uint32_t events);
-    void modFd(int fd, uint32_t events);
-    void removeFd(int fd);
+    /// True if `backend` can be created on this kernel.
+    static bool backendSupported(Backend backend);
+    static const char* backendName(Backend backend);
+
+    Backend backend() const { return backendKind_; }
+
+    void addFd(int fd, uint32_t events) { backend_->addFd(fd, events); }
+    void modFd(int fd, uint32_t events) { backend_->modFd(fd, events); }
+    void removeFd(int fd) { backend_->removeFd(fd); }
+
+    // ── Completion I/O (see IOBackend) ─────────────────────────────────
+    /// True if the backend reads/writes itself (io_uring): clients get
+    /// RECEIVED events and replies go out through send().
+    bool completionIO() const { return backend_->completionIO(); }
+    void watchAccept(int listenFd) { backend_->watchAccept(listenFd); }
+    void watchRecv(int fd) { backend_->watchRecv(fd); }
+    void send(int fd, const uint8_t* data, size_t len) {
+        backend_->send(fd, data, len);
+    }
+    bool sendPending(int fd) const { return backend_->sendPending(fd); }
+
+    // ── Timers ─────────────────────────────────────────────────────────
+    using TimerCallback = TimerWheel::Callback;
+    using TimerId = TimerWheel::TimerId;
 
-    using TimerCallback = std::function<void()>;
-    void setTimerCallback(TimerCallback cb, int intervalMs);
+    /// Run `cb` once, `delayMs` from now.
+    TimerId addTimer(int delayMs, TimerCallback cb);
 
-    /// Run one iteration: epoll_wait + timer check.
+    /// Run `cb` every `periodMs` (> 0), starting `periodMs` from now.
+    TimerId addPeriodicTimer(int periodMs, TimerCallback cb);
+
+    /// Disarm a timer; safe from its own callback. Returns false if it
+    /// already fired (one-shot) or was cancelled.
+    bool cancelTimer(TimerId id) { return timers_.cancel(id); }
+
+    /// Milliseconds until the nearest timer is due (0 if overdue), or -1
+    /// if no timer is armed.
+    int msUntilNextTimer();
+
+    /// Run one iteration: backend wait + due timers. Waits at most
+    /// `timeoutMs` (-1 = no limit), and never past the nearest timer.
     /// Returns the number of ready events (>= 0), or 0 on EINTR.
     int poll(int timeoutMs);
 
-    /// Access the i-th ready event from the most recent poll() call.
-    const struct epoll_event& event(int i) const { return events_[i]; }
+    /// Access the i-th event from the most recent poll() call.
+    const IOEvent& event(int i) const { return events_[static_cast<size_t>(i)]; }
 
 private:
-    int epollFd_;
-    static constexpr int kMaxEvents = 128;
-    struct epoll_event events_[kMaxEvents];
-    int numReady_ = 0;
-
-    TimerCallback timerCb_;
-    int timerIntervalMs_ = 0;
-    std::chrono::steady_clock::time_point lastTimerFire_;
+    Backend                    backendKind_;
+    std::unique_ptr<IOBackend> backend_;
+    std::vector<IOEvent>       events_;
+
+    TimerWheel timers_;
+    std::chrono::steady_clock::time_point epoch_;  // time 0 of the wheel
+
+    int64_t nowMs() const;
 };
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/epoll.h>
+#include <vector>
+
+/// One notification produced by EventLoop::poll().
+///
+/// Readiness backends (epoll) only produce READY events and leave the
+/// actual read()/write()/accept() to the caller. Completion backends
+/// (io_uring) perform the I/O themselves and report what happened.
+struct IOEvent {
+    enum class Kind : uint8_t {
+        READY,      // fd is ready; `events` holds EPOLLIN/EPOLLOUT/... flags
+        ACCEPTED,   // listener `fd` accepted a client; new fd in `result`
+        RECEIVED,   // `len` bytes from `fd` are at `data`; len == 0 means EOF
+        FAILED      // I/O on `fd` failed with -errno in `result`
+    };
+
+    Kind           kind = Kind::READY;
+    int            fd = -1;
+    uint32_t       events = 0;
+    int            result = 0;
+    const uint8_t* data = nullptr;  // valid until the next poll()
+    size_t         len = 0;
+};
+
+/// Pluggable I/O multiplexer behind EventLoop.
+///
+/// addFd/modFd/removeFd register readiness interest and work on every
+/// backend. The watch*/send calls are the completion-style API: readiness
+/// backends map watchAccept/watchRecv onto EPOLLIN interest and never see
+/// send(); callers check completionIO() before using it.
+///
+/// Must NOT know about: RESP, commands, the database, connections.
+class IOBackend {
+public:
+    virtual ~IOBackend() = default;
+
+    virtual void addFd(int fd, uint32_t events) = 0;
+    virtual void modFd(int fd, uint32_t events) = 0;
+
+    /// Forget `fd` (and cancel its in-flight I/O). Must be called before
+    /// the fd is closed.
+    virtual void removeFd(int fd) = 0;
+
+    /// Wait up to `timeoutMs` (-1 = until something happens) and replace
+    /// `out` with the new events.
+    /// Returns the number of events, or -1 on a real error (EINTR = 0).
+    virtual int wait(int timeoutMs, std::vector<IOEvent>& out) = 0;
+
+    /// True if this backend performs reads/writes itself.
+    virtual bool completionIO() const { return false; }
+
+    /// Report accepted clients on `listenFd` (ACCEPTED, or READY if
+    /// readiness-based).
+    virtual void watchAccept(int listenFd) { addFd(listenFd, EPOLLIN); }
+
+    /// Report data received on `fd` (RECEIVED, or READY if readiness-based).
+    virtual void watchRecv(int fd) { addFd(fd, EPOLLIN); }
+
+    /// Completion backends: queue bytes for `fd`. The data is copied; sends
+    /// are batched and submitted on the next wait(). Errors come back as
+    /// FAILED events.
+    virtual void send(int /*fd*/, const uint8_t* /*data*/, size_t /*len*/) {}
+
+    /// Completion backends: true while bytes for `fd` are queued or owned
+    /// by the kernel. Closing the fd earlier drops the unsent bytes.
+    virtual bool sendPending(int /*fd*/) const { return false; }
+};
@@ -9,7 +9,7 @@
 #include <sys/socket.h>    // socket, setsockopt, bind, listen, accept4
 #include <unistd.h>        // close
 
-Listener::Listener(const std::string& addr, int port) {
+Listener::Listener(const std::string& addr, int port, bool reusePort) {
     // Create a non-blocking TCP socket.
     fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
     if (fd_ < 0) {
@@ -21,6 +21,15 @@ Listener::Listener(const std::string& addr, int port) {
     int opt = 1;
     ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 
+    // Multi-shard mode: every shard binds its own socket to the same port.
+    if (reusePort &&
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        ::close(fd_);
+        throw std::runtime_error(
+            std::string("setsockopt(SO_REUSEPORT) failed: ") +
+            std::strerror(errno));
+    }
+
     struct sockaddr_in saddr{};
     saddr.sin_family = AF_INET;
     saddr.sin_port   = htons(static_cast<uint16_t>(port));
@@ -5,9 +5,13 @@
 /// Manages the server's listening socket.
 /// Binds to a given address:port and accepts new client connections.
 /// The socket is non-blocking so accept won't stall the event loop.
+///
+/// With `reusePort`, SO_REUSEPORT is set so several listeners (one per
+/// shard thread) can bind the same port; the kernel then load-balances
+/// incoming connections across them.
 class Listener {
 public:
-    Listener(const std::string& addr, int port);
+    Listener(const std::string& addr, int port, bool reusePort = false);
     ~Listener();
 
     Listener(const Listener&) = delete;
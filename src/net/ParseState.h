@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/// How far the parser got into the frame at the front of a connection's
+/// input buffer. Kept between reads so a frame that arrives in pieces is
+/// parsed once, not re-scanned from byte 0 on every read.
+///
+/// Positions are offsets from the buffer's read cursor. Buffer compaction
+/// moves the readable bytes as a block, so they survive it. Only
+/// RespParser writes the fields; the connection reads expectedBytes.
+struct ParseState {
+    int64_t arrayCount = -1;  // elements in the frame, -1 = header not parsed
+    int64_t bulkLength = -1;  // length of the element being read, -1 = its
+                              // $len header is not parsed yet
+    size_t  pos = 0;          // bytes of the frame parsed (or scanned) so far
+
+    /// Full size of the frame, set once a large bulk length is known and 0
+    /// otherwise. The connection grows its input buffer to this before the
+    /// next read so the payload lands in place instead of being moved by
+    /// every doubling.
+    size_t  expectedBytes = 0;
+
+    /// (offset, length) of every completed element; size() is the index
+    /// of the element currently being read.
+    std::vector<std::pair<size_t, size_t>> spans;
+
+    /// Forget the frame (after it was consumed). Keeps spans' capacity.
+    void reset() {
+        arrayCount = -1;
+        bulkLength = -1;
+        pos = 0;
+        expectedBytes = 0;
+        spans.clear();
+    }
+};
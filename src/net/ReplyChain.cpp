@@ -0,0 +1,148 @@
+#include "net/ReplyChain.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>  // std::memcpy
+
+void ReplyChain::append(const void* data, size_t len) {
+    const char* p = static_cast<const char*>(data);
+    size_ += len;
+
+    // Large writes get an exact-size segment of their own rather than
+    // being split across blocks.
+    if (len >= kBlockSize) {
+        Segment seg;
+        seg.data.assign(p, len);
+        segs_.push_back(std::move(seg));
+        return;
+    }
+
+    while (len > 0) {
+        if (segs_.empty() || !segs_.back().block ||
+            segs_.back().data.size() == kBlockSize) {
+            Segment seg;
+            seg.block = true;
+            seg.data.reserve(kBlockSize);  // appends below never reallocate
+            segs_.push_back(std::move(seg));
+        }
+        Segment& tail = segs_.back();
+        size_t n = std::min(len, kBlockSize - tail.data.size());
+        tail.data.append(p, n);
+        p   += n;
+        len -= n;
+    }
+}
+
+char* ReplyChain::appendSpace(size_t len) {
+    assert(len <= kBlockSize);
+    if (segs_.empty() || !segs_.back().block ||
+        kBlockSize - segs_.back().data.size() < len) {
+        // The rest of the current block (if any) stays unused; a reply is
+        // never split across blocks this way.
+        Segment seg;
+        seg.block = true;
+        seg.data.reserve(kBlockSize);
+        segs_.push_back(std::move(seg));
+    }
+    Segment& tail = segs_.back();
+    size_t used = tail.data.size();
+    tail.data.resize(used + len);
+    size_ += len;
+    return &tail.data[used];
+}
+
+void ReplyChain::appendOwned(std::string&& data) {
+    if (data.size() < kBlockSize) {
+        append(data.data(), data.size());
+        return;
+    }
+    size_ += data.size();
+    Segment seg;
+    seg.data = std::move(data);
+    segs_.push_back(std::move(seg));
+}
+
+void ReplyChain::consume(size_t n) {
+    assert(n <= size_);
+    size_ -= n;
+    while (n > 0) {
+        Segment& front = segs_.front();
+        size_t avail = front.size();
+        if (n < avail) {
+            front.readPos += n;
+            return;
+        }
+        n -= avail;
+        if (segs_.size() == 1 && front.block) {
+            // Keep one empty block so request/response traffic does not
+            // allocate per reply.
+            front.data.clear();
+            front.readPos = 0;
+            return;
+        }
+        segs_.pop_front();
+    }
+}
+
+void ReplyChain::unwrite(size_t n) {
+    assert(n <= size_);
+    size_ -= n;
+    while (n > 0) {
+        Segment& back = segs_.back();
+        size_t avail = back.size();
+        if (n < avail) {
+            back.data.resize(back.data.size() - n);
+            return;
+        }
+        n -= avail;
+        if (segs_.size() == 1 && back.block) {
+            back.data.clear();
+            back.readPos = 0;
+            return;
+        }
+        segs_.pop_back();
+    }
+}
+
+std::string ReplyChain::takeTail(size_t n) {
+    assert(n <= size_);
+    std::string out;
+    if (n == 0) return out;
+
+    // The tail is exactly one owned string: hand it over as is.
+    Segment& back = segs_.back();
+    if (!back.block && back.readPos == 0 && back.data.size() == n) {
+        out = std::move(back.data);
+        segs_.pop_back();
+        size_ -= n;
+        return out;
+    }
+
+    out.resize(n);
+    size_t pos = n;
+    for (size_t i = segs_.size(); pos > 0; ) {
+        const Segment& seg = segs_[--i];
+        size_t take = std::min(pos, seg.size());
+        std::memcpy(&out[pos - take], seg.data.data() + seg.data.size() - take,
+                    take);
+        pos -= take;
+    }
+    unwrite(n);
+    return out;
+}
+
+std::string ReplyChain::takeAll() {
+    return takeTail(size_);
+}
+
+int ReplyChain::gather(struct iovec* iov, int maxIov) const {
+    int count = 0;
+    for (const Segment& seg : segs_) {
+        if (count == maxIov) break;
+        if (seg.size() == 0) continue;
+        iov[count].iov_base = const_cast<char*>(seg.data.data() + seg.readPos);
+        iov[count].iov_len  = seg.size();
+        ++count;
+    }
+    return count;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <sys/uio.h>  // iovec
+
+/// Outgoing byte stream, kept as a chain of segments instead of one
+/// contiguous buffer.
+///
+///   - Small writes are packed into fixed-size blocks (kBlockSize), so a
+///     large reply never triggers a grow-and-copy of everything before it.
+///   - appendOwned() adopts a large string as its own segment by move —
+///     the value is not copied at all.
+///   - Fully sent segments are freed immediately, so a connection does not
+///     keep a multi-MB buffer around after one big reply.
+///
+/// gather() exposes the unsent bytes as an iovec array for writev().
+///
+/// Must NOT know about: sockets, RESP, commands.
+class ReplyChain {
+public:
+    /// Block size for packed small writes. Also the size at which an
+    /// appendOwned() string becomes its own segment.
+    static constexpr size_t kBlockSize = 16 * 1024;
+
+    /// Copy `len` bytes to the end of the chain.
+    void append(const void* data, size_t len);
+
+    /// Reserve `len` contiguous bytes (at most kBlockSize) at the end of
+    /// the chain and return a pointer to them; the caller fills all of
+    /// them. Lets a small reply be written with one bounds check instead
+    /// of one append() per piece.
+    char* appendSpace(size_t len);
+
+    /// Move `data` to the end of the chain. Strings of kBlockSize or more
+    /// become a segment of their own; smaller ones are copied into a block.
+    void appendOwned(std::string&& data);
+
+    /// Total number of unsent bytes.
+    size_t readableBytes() const { return size_; }
+
+    /// Number of segments (blocks + owned strings) currently held.
+    size_t segmentCount() const { return segs_.size(); }
+
+    /// Drop `n` bytes from the front (after a successful write).
+    void consume(size_t n);
+
+    /// Drop the last `n` bytes (the most recently appended data).
+    void unwrite(size_t n);
+
+    /// Remove the last `n` bytes from the chain and return them. Used to
+    /// lift a just-written reply out so it can be delivered later in order
+    /// (sharded mode reply slots).
+    std::string takeTail(size_t n);
+
+    /// Remove and return everything. A single owned segment is moved out
+    /// without copying.
+    std::string takeAll();
+
+    /// Fill up to `maxIov` entries of `iov` with the unsent bytes, front to
+    /// back. Returns the number of entries used.
+    int gather(struct iovec* iov, int maxIov) const;
+
+private:
+    struct Segment {
+        std::string data;
+        size_t      readPos = 0;    // already-sent prefix
+        bool        block = false;  // packed block; may still be appended to
+
+        size_t size() const { return data.size() - readPos; }
+    };
+
+    std::deque<Segment> segs_;
+    size_t size_ = 0;
+};
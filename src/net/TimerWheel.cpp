@@ -0,0 +1,215 @@
+#include "net/TimerWheel.h"
+
+#include <algorithm>
+
+TimerWheel::TimerWheel() {
+    std::fill(buckets_, buckets_ + kOverflow + 1, kNil);
+}
+
+// ── Links ──────────────────────────────────────────────────────────────────
+
+void TimerWheel::place(uint32_t index) {
+    Timer& t = timers_[index];
+    // A timer already due goes in the current millisecond's slot.
+    int64_t at = std::max(t.deadline, current_);
+    // The level is that of the highest digit where `at` and current_ differ.
+    auto diff = static_cast<uint64_t>(at ^ current_);
+    int level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / kSlotBits;
+    uint32_t bucket = kOverflow;
+    if (level < kLevels) {
+        int slot = digit(at, level);
+        bucket = static_cast<uint32_t>(level * kSlots + slot);
+        occupied_[level] |= uint64_t{1} << slot;
+    }
+
+    uint32_t& head = buckets_[bucket];
+    t.bucket = bucket;
+    t.prev = kNil;
+    t.next = head;
+    if (head != kNil) timers_[head].prev = index;
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Timer& t = timers_[index];
+    uint32_t& head = buckets_[t.bucket];
+    if (t.prev != kNil) {
+        timers_[t.prev].next = t.next;
+    } else {
+        head = t.next;
+    }
+    if (t.next != kNil) timers_[t.next].prev = t.prev;
+    if (head == kNil && t.bucket < kOverflow) {
+        occupied_[t.bucket / kSlots] &= ~(uint64_t{1} << (t.bucket % kSlots));
+    }
+    t.bucket = kUnlinked;
+    t.prev = t.next = kNil;
+}
+
+// ── Slab ───────────────────────────────────────────────────────────────────
+
+uint32_t TimerWheel::lookup(TimerId id) const {
+    uint64_t slot = id & 0xffffffffu;
+    if (slot == 0 || slot > timers_.size()) return kNil;
+    auto index = static_cast<uint32_t>(slot - 1);
+    const Timer& t = timers_[index];
+    return t.armed && t.generation == (id >> 32) ? index : kNil;
+}
+
+void TimerWheel::release(uint32_t index) {
+    Timer& t = timers_[index];
+    if (t.bucket != kUnlinked) unlink(index);
+    t.cb = nullptr;
+    t.armed = false;
+    ++t.generation;
+    t.next = freeHead_;
+    freeHead_ = index;
+    --size_;
+}
+
+TimerWheel::TimerId TimerWheel::add(int64_t deadlineMs, int64_t periodMs,
+                                    Callback cb) {
+    uint32_t index;
+    if (freeHead_ != kNil) {
+        index = freeHead_;
+        freeHead_ = timers_[index].next;
+    } else {
+        index = static_cast<uint32_t>(timers_.size());
+        timers_.emplace_back();
+    }
+    Timer& t = timers_[index];
+    t.deadline = deadlineMs;
+    t.period = std::max<int64_t>(periodMs, 0);
+    t.cb = std::move(cb);
+    t.armed = true;
+    place(index);
+    ++size_;
+
+    // The cached minimum stays exact: the new one either beats it or not.
+    if (nextValid_ && (nextCache_ < 0 || deadlineMs < nextCache_)) {
+        nextCache_ = deadlineMs;
+    }
+    return makeId(index, t.generation);
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t index = lookup(id);
+    if (index == kNil) return false;
+    if (timers_[index].deadline == nextCache_) nextValid_ = false;
+    release(index);
+    return true;
+}
+
+// ── Deadlines ──────────────────────────────────────────────────────────────
+
+int64_t TimerWheel::nextDeadline() {
+    if (nextValid_) return nextCache_;
+
+    // The earliest timer is in the lowest level's first non-empty slot
+    // ahead of current_ (each level's slots all come after the lower
+    // levels'), or in the overflow list if the wheel itself is empty.
+    uint32_t bucket = kOverflow;
+    for (int l = 0; l < kLevels && bucket == kOverflow; ++l) {
+        int cur = digit(current_, l);
+        uint64_t ahead = l == 0 ? ~uint64_t{0} << cur
+                       : cur == kSlots - 1 ? 0
+                       : ~uint64_t{0} << (cur + 1);
+        uint64_t bits = occupied_[l] & ahead;
+        if (bits) {
+            bucket = static_cast<uint32_t>(l * kSlots + __builtin_ctzll(bits));
+        }
+    }
+
+    int64_t next = -1;
+    for (uint32_t i = buckets_[bucket]; i != kNil; i = timers_[i].next) {
+        if (next < 0 || timers_[i].deadline < next) next = timers_[i].deadline;
+    }
+    nextCache_ = next;
+    nextValid_ = true;
+    return next;
+}
+
+size_t TimerWheel::runDue(int64_t nowMs) {
+    // Collect first, fire second: callbacks may add and cancel timers.
+    due_.clear();
+    while (size_ > 0) {
+        int level = -1;
+        int slot = 0;
+        for (int l = 0; l < kLevels && level < 0; ++l) {
+            int cur = digit(current_, l);
+            uint64_t ahead = l == 0 ? ~uint64_t{0} << cur
+                           : cur == kSlots - 1 ? 0
+                           : ~uint64_t{0} << (cur + 1);
+            uint64_t bits = occupied_[l] & ahead;
+            if (bits) {
+                level = l;
+                slot = __builtin_ctzll(bits);
+            }
+        }
+
+        // When current_ reaches that slot (or, with only overflow timers
+        // left, the next 2^24 ms boundary).
+        int64_t due;
+        uint32_t bucket;
+        if (level >= 0) {
+            int shift = level * kSlotBits;
+            due = (current_ >> (shift + kSlotBits) << (shift + kSlotBits)) |
+                  (int64_t{slot} << shift);
+            bucket = static_cast<uint32_t>(level * kSlots + slot);
+        } else {
+            if (buckets_[kOverflow] == kNil) break;
+            int shift = kLevels * kSlotBits;
+            due = ((current_ >> shift) + 1) << shift;
+            bucket = kOverflow;
+        }
+        if (due > nowMs) break;
+        current_ = due;
+
+        // Level 0: a millisecond's worth of timers, all due. Otherwise
+        // cascade the slot's timers down to where they now belong.
+        // The list is detached first: overflow timers may land back in it.
+        uint32_t index = buckets_[bucket];
+        buckets_[bucket] = kNil;
+        if (level >= 0) occupied_[level] &= ~(uint64_t{1} << slot);
+        while (index != kNil) {
+            Timer& t = timers_[index];
+            uint32_t next = t.next;
+            t.bucket = kUnlinked;
+            t.prev = t.next = kNil;
+            if (level == 0) {
+                due_.push_back(makeId(index, t.generation));
+            } else {
+                place(index);
+            }
+            index = next;
+        }
+    }
+    // Nothing else is due by nowMs, and no slot starts at or before it.
+    current_ = std::max(current_, nowMs);
+    if (due_.empty()) return 0;
+    nextValid_ = false;
+
+    size_t fired = 0;
+    for (TimerId id : due_) {
+        uint32_t index = lookup(id);
+        if (index == kNil) continue;  // cancelled by an earlier callback
+        ++fired;
+        Callback cb = std::move(timers_[index].cb);
+        if (timers_[index].period == 0) {
+            release(index);
+            cb();
+            continue;
+        }
+        cb();
+        if (lookup(id) != index) continue;  // cancelled itself
+
+        // timers_ may have grown during the call: look the timer up again.
+        Timer& t = timers_[index];
+        t.cb = std::move(cb);
+        t.deadline += t.period;
+        if (t.deadline <= nowMs) t.deadline = nowMs + t.period;
+        place(index);
+    }
+    nextValid_ = false;
+    return fired;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/// One-shot and periodic timers for the event loop: a hierarchical timing
+/// wheel over absolute deadlines in milliseconds.
+///
+/// Level L has 64 slots of 64^L ms each — 1 ms, 64 ms, ~4 s, ~4.5 min —
+/// and holds the timers whose deadline first differs from the wheel's
+/// current time in its L-th 6-bit digit; later deadlines (past ~4.6 h)
+/// wait in an overflow list. Reaching a slot of level L >= 1 cascades its
+/// timers to lower levels; a level-0 slot holds timers due in the same
+/// millisecond. This is the ExpiryWheel layout, sized for the handful of
+/// timers a loop runs rather than every key with a TTL.
+///
+/// Timers live in a slab indexed by TimerId, so add and cancel are O(1)
+/// and a cancelled id can never hit a reused slot (the id carries the
+/// slot's generation). A 64-bit occupancy mask per level finds the next
+/// non-empty slot in one instruction; nextDeadline() is exact, cached
+/// until the wheel changes, and costs a scan of one slot's timers when
+/// the earliest sits above level 0.
+///
+/// Must NOT know about: the clock, file descriptors, the backend.
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    /// Identifies an armed timer. 0 is never a valid id.
+    using TimerId = uint64_t;
+
+    TimerWheel();
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    /// Arm a timer that fires at `deadlineMs` and then, if `periodMs` > 0,
+    /// every `periodMs` after that. A deadline already past fires on the
+    /// next runDue().
+    TimerId add(int64_t deadlineMs, int64_t periodMs, Callback cb);
+
+    /// Disarm a timer. Safe from inside any callback, including the
+    /// timer's own. Returns false if it already fired (one-shot) or was
+    /// cancelled.
+    bool cancel(TimerId id);
+
+    /// Earliest deadline of an armed timer, or -1 if there are none.
+    int64_t nextDeadline();
+
+    /// Fire every timer due at or before `nowMs`, earliest first, and
+    /// re-arm the periodic ones. A periodic timer that fell more than a
+    /// period behind skips the missed ticks. Timers added by a callback
+    /// fire no earlier than the next call. Returns how many fired.
+    size_t runDue(int64_t nowMs);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr int kLevels = 4;
+    static constexpr uint32_t kNil = UINT32_MAX;
+    static constexpr uint32_t kOverflow = kLevels * kSlots;  // bucket index
+    static constexpr uint32_t kUnlinked = kOverflow + 1;
+
+    struct Timer {
+        int64_t  deadline = 0;
+        int64_t  period = 0;
+        Callback cb;
+        uint32_t generation = 1;   // bumped on release; part of the TimerId
+        uint32_t bucket = kUnlinked;
+        uint32_t prev = kNil;      // list links: slab indexes
+        uint32_t next = kNil;      // (doubles as the free-list link)
+        bool     armed = false;
+    };
+
+    std::vector<Timer> timers_;
+    uint32_t freeHead_ = kNil;
+    uint32_t buckets_[kOverflow + 1];  // list heads: slots, then overflow
+    uint64_t occupied_[kLevels] = {};  // bit s set iff slot s is non-empty
+    int64_t  current_ = 0;             // every timer is due at or after this
+    size_t   size_ = 0;
+    int64_t  nextCache_ = -1;
+    bool     nextValid_ = true;
+    std::vector<TimerId> due_;         // runDue() batch, reused
+
+    static TimerId makeId(uint32_t index, uint32_t generation) {
+        return (uint64_t{generation} << 32) | (uint64_t{index} + 1);
+    }
+    /// Slab index of a live timer, or kNil if `id` is stale.
+    uint32_t lookup(TimerId id) const;
+
+    /// Link timer `index` into the bucket for its deadline.
+    void place(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+
+    static int digit(int64_t time, int level) {
+        return static_cast<int>((time >> (level * kSlotBits)) & (kSlots - 1));
+    }
+};
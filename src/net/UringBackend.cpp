@@ -0,0 +1,514 @@
+#include "net/UringBackend.h"
+
+#include <linux/io_uring.h>
+
+#include <cerrno>
+#include <csignal>    // _NSIG
+#include <cstring>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ── Raw syscalls (no liburing dependency) ──────────────────────────────────
+
+static int sysSetup(unsigned entries, io_uring_params* p) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int sysEnter(int fd, unsigned toSubmit, unsigned minComplete,
+                    unsigned flags, const void* arg, size_t argSize) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit,
+                                      minComplete, flags, arg, argSize));
+}
+
+static int sysRegister(int fd, unsigned opcode, const void* arg,
+                       unsigned nrArgs) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode,
+                                      arg, nrArgs));
+}
+
+// ── Construction ───────────────────────────────────────────────────────────
+
+UringBackend::UringBackend() {
+    io_uring_params p{};
+    p.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL |
+                   IORING_SETUP_COOP_TASKRUN;
+    p.cq_entries = kCqEntries;
+    ringFd_ = sysSetup(kSqEntries, &p);
+    if (ringFd_ < 0 && errno == EINVAL) {
+        // Older kernel: drop the optional flags.
+        p = io_uring_params{};
+        p.flags      = IORING_SETUP_CQSIZE;
+        p.cq_entries = kCqEntries;
+        ringFd_ = sysSetup(kSqEntries, &p);
+    }
+    if (ringFd_ < 0) {
+        throw std::runtime_error("io_uring_setup() failed");
+    }
+
+    constexpr unsigned kRequired = IORING_FEAT_SINGLE_MMAP |
+                                   IORING_FEAT_NODROP |
+                                   IORING_FEAT_EXT_ARG;
+    if ((p.features & kRequired) != kRequired) {
+        teardown();
+        throw std::runtime_error("io_uring: kernel too old");
+    }
+
+    // ── Map the SQ/CQ rings (one mapping) and the SQE array ────────────
+    size_t sqSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    size_t cqSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+    ringSize_ = sqSize > cqSize ? sqSize : cqSize;
+    ringPtr_ = ::mmap(nullptr, ringSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (ringPtr_ == MAP_FAILED) {
+        ringPtr_ = nullptr;
+        teardown();
+        throw std::runtime_error("io_uring: mmap(rings) failed");
+    }
+    auto* base = static_cast<uint8_t*>(ringPtr_);
+    sqHead_    = reinterpret_cast<unsigned*>(base + p.sq_off.head);
+    sqTail_    = reinterpret_cast<unsigned*>(base + p.sq_off.tail);
+    sqArray_   = reinterpret_cast<unsigned*>(base + p.sq_off.array);
+    sqMask_    = *reinterpret_cast<unsigned*>(base + p.sq_off.ring_mask);
+    sqEntries_ = *reinterpret_cast<unsigned*>(base + p.sq_off.ring_entries);
+    cqHead_    = reinterpret_cast<unsigned*>(base + p.cq_off.head);
+    cqTail_    = reinterpret_cast<unsigned*>(base + p.cq_off.tail);
+    cqMask_    = *reinterpret_cast<unsigned*>(base + p.cq_off.ring_mask);
+    cqes_      = reinterpret_cast<io_uring_cqe*>(base + p.cq_off.cqes);
+    sqLocalTail_ = *sqTail_;
+
+    sqesSize_ = p.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        teardown();
+        throw std::runtime_error("io_uring: mmap(sqes) failed");
+    }
+    sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    // ── Provided-buffer ring for multishot recv ────────────────────────
+    // The pool is anonymous memory: pages are only faulted in once the
+    // kernel actually receives into them.
+    bufRingSize_ = kBufCount * sizeof(io_uring_buf);
+    void* ring = ::mmap(nullptr, bufRingSize_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    void* pool = ::mmap(nullptr, kBufCount * kBufSize, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED || pool == MAP_FAILED) {
+        if (ring != MAP_FAILED) ::munmap(ring, bufRingSize_);
+        if (pool != MAP_FAILED) ::munmap(pool, kBufCount * kBufSize);
+        teardown();
+        throw std::runtime_error("io_uring: mmap(buffers) failed");
+    }
+    bufRing_ = static_cast<io_uring_buf_ring*>(ring);
+    bufPool_ = static_cast<uint8_t*>(pool);
+
+    io_uring_buf_reg reg{};
+    reg.ring_addr    = reinterpret_cast<uint64_t>(bufRing_);
+    reg.ring_entries = kBufCount;
+    reg.bgid         = kBufGroup;
+    if (sysRegister(ringFd_, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        teardown();
+        throw std::runtime_error("io_uring: provided buffer rings unsupported");
+    }
+    for (uint16_t bid = 0; bid < kBufCount; ++bid) {
+        provideBuffer(bid);
+    }
+    __atomic_store_n(&bufRing_->tail, bufTail_, __ATOMIC_RELEASE);
+}
+
+UringBackend::~UringBackend() {
+    teardown();
+}
+
+void UringBackend::teardown() {
+    // Closing the ring cancels everything still in flight.
+    if (ringFd_ >= 0) {
+        ::close(ringFd_);
+        ringFd_ = -1;
+    }
+    if (bufPool_) {
+        ::munmap(bufPool_, kBufCount * kBufSize);
+        bufPool_ = nullptr;
+    }
+    if (bufRing_) {
+        ::munmap(bufRing_, bufRingSize_);
+        bufRing_ = nullptr;
+    }
+    if (sqes_) {
+        ::munmap(sqes_, sqesSize_);
+        sqes_ = nullptr;
+    }
+    if (ringPtr_) {
+        ::munmap(ringPtr_, ringSize_);
+        ringPtr_ = nullptr;
+    }
+}
+
+bool UringBackend::supported() {
+    try {
+        UringBackend probe;
+        return true;
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+}
+
+// ── SQ / CQ plumbing ───────────────────────────────────────────────────────
+
+uint64_t UringBackend::userData(Op op, uint32_t gen, int fd) {
+    return (static_cast<uint64_t>(op) << 56) |
+           (static_cast<uint64_t>(gen & kGenMask) << 32) |
+           static_cast<uint32_t>(fd);
+}
+
+UringBackend::FdState& UringBackend::state(int fd) {
+    if (static_cast<size_t>(fd) >= fds_.size()) {
+        fds_.resize(static_cast<size_t>(fd) + 1);
+    }
+    return fds_[static_cast<size_t>(fd)];
+}
+
+io_uring_sqe* UringBackend::getSqe() {
+    unsigned head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    if (sqLocalTail_ - head >= sqEntries_) {
+        // SQ full — push what we have to the kernel first.
+        submitNow();
+        head = __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+        if (sqLocalTail_ - head >= sqEntries_) return nullptr;
+    }
+    unsigned idx = sqLocalTail_ & sqMask_;
+    io_uring_sqe* sqe = &sqes_[idx];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[idx] = idx;
+    ++sqLocalTail_;
+    ++toSubmit_;
+    return sqe;
+}
+
+int UringBackend::enter(unsigned minComplete, unsigned flags, int timeoutMs) {
+    // Publish prepared SQEs.
+    __atomic_store_n(sqTail_, sqLocalTail_, __ATOMIC_RELEASE);
+
+    io_uring_getevents_arg arg{};
+    struct __kernel_timespec ts{};
+    const void* argPtr = nullptr;
+    size_t argSize = 0;
+    // A negative timeout waits with no timespec, like epoll_wait(-1).
+    if ((flags & IORING_ENTER_GETEVENTS) && minComplete > 0 && timeoutMs >= 0) {
+        ts.tv_sec  = timeoutMs / 1000;
+        ts.tv_nsec = static_cast<long long>(timeoutMs % 1000) * 1000000;
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts         = reinterpret_cast<uint64_t>(&ts);
+        argPtr  = &arg;
+        argSize = sizeof(arg);
+        flags  |= IORING_ENTER_EXT_ARG;
+    }
+
+    int ret = sysEnter(ringFd_, toSubmit_, minComplete, flags, argPtr, argSize);
+    if (ret >= 0) {
+        unsigned submitted = static_cast<unsigned>(ret);
+        toSubmit_ -= submitted < toSubmit_ ? submitted : toSubmit_;
+    }
+    return ret;
+}
+
+void UringBackend::submitNow() {
+    if (toSubmit_ > 0) {
+        enter(0, 0, 0);
+    }
+}
+
+void UringBackend::provideBuffer(uint16_t bid) {
+    // Index the ring as a plain array: in C++ the header's flexible-array
+    // wrapper gains a 1-byte empty member, which shifts `bufs` by 8 bytes.
+    io_uring_buf* buf = reinterpret_cast<io_uring_buf*>(bufRing_) +
+                        (bufTail_ & (kBufCount - 1));
+    buf->addr = reinterpret_cast<uint64_t>(bufPool_ + bid * kBufSize);
+    buf->len  = static_cast<uint32_t>(kBufSize);
+    buf->bid  = bid;
+    ++bufTail_;
+}
+
+// ── Registration ───────────────────────────────────────────────────────────
+
+void UringBackend::armPoll(int fd) {
+    FdState& st = state(fd);
+    io_uring_sqe* sqe = getSqe();
+    if (!sqe) return;
+    sqe->opcode        = IORING_OP_POLL_ADD;
+    sqe->fd            = fd;
+    sqe->poll32_events = st.pollEvents;   // EPOLL* == POLL* bit values
+    sqe->len           = IORING_POLL_ADD_MULTI;
+    sqe->user_data     = userData(OP_POLL, st.gen, fd);
+}
+
+void UringBackend::armAccept(int fd) {
+    FdState& st = state(fd);
+    io_uring_sqe* sqe = getSqe();
+    if (!sqe) return;
+    sqe->opcode       = IORING_OP_ACCEPT;
+    sqe->fd           = fd;
+    sqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK;   // same as Listener::acceptClient()
+    sqe->user_data    = userData(OP_ACCEPT, st.gen, fd);
+}
+
+void UringBackend::armRecv(int fd) {
+    FdState& st = state(fd);
+    io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        rearm_.push_back(fd);  // retry next tick
+        return;
+    }
+    sqe->opcode    = IORING_OP_RECV;
+    sqe->fd        = fd;
+    sqe->ioprio    = IORING_RECV_MULTISHOT;
+    sqe->flags     = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufGroup;
+    sqe->user_data = userData(OP_RECV, st.gen, fd);
+}
+
+void UringBackend::startSend(int fd) {
+    FdState& st = state(fd);
+    if (st.sendInFlight) return;  // resumed from its completion
+    if (st.inFlightOff >= st.inFlight.size()) {
+        if (st.sendQueue.empty()) return;
+        st.inFlight.clear();
+        st.inFlight.swap(st.sendQueue);
+        st.inFlightOff = 0;
+    }
+    io_uring_sqe* sqe = getSqe();
+    if (!sqe) {
+        st.sendScheduled = true;
+        sendReady_.push_back(fd);  // retry next tick
+        return;
+    }
+    sqe->opcode    = IORING_OP_SEND;
+    sqe->fd        = fd;
+    sqe->addr      = reinterpret_cast<uint64_t>(st.inFlight.data() + st.inFlightOff);
+    sqe->len       = static_cast<uint32_t>(st.inFlight.size() - st.inFlightOff);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = userData(OP_SEND, st.gen, fd);
+    st.sendInFlight = true;
+}
+
+void UringBackend::addFd(int fd, uint32_t events) {
+    FdState& st = state(fd);
+    st.pollEvents = events;
+    if (events) armPoll(fd);
+}
+
+void UringBackend::modFd(int fd, uint32_t events) {
+    FdState& st = state(fd);
+    if (st.pollEvents == events) return;
+    if (st.pollEvents) {
+        io_uring_sqe* sqe = getSqe();
+        if (sqe) {
+            sqe->opcode    = IORING_OP_POLL_REMOVE;
+            sqe->addr      = userData(OP_POLL, st.gen, fd);
+            sqe->user_data = userData(OP_INTERNAL, 0, fd);
+        }
+    }
+    st.pollEvents = events;
+    if (events) armPoll(fd);
+}
+
+void UringBackend::removeFd(int fd) {
+    FdState& st = state(fd);
+    st.gen        = (st.gen + 1) & kGenMask;
+    st.pollEvents = 0;
+    st.accepting  = false;
+    st.receiving  = false;
+    st.sendQueue.clear();
+    // inFlight stays alive until the kernel hands it back (OP_SEND cqe).
+    if (!st.sendInFlight) {
+        st.inFlight.clear();
+        st.inFlightOff = 0;
+    }
+
+    io_uring_sqe* sqe = getSqe();
+    if (sqe) {
+        sqe->opcode       = IORING_OP_ASYNC_CANCEL;
+        sqe->fd           = fd;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data    = userData(OP_INTERNAL, 0, fd);
+    }
+    // The cancel resolves `fd` when it is issued, so it must reach the
+    // kernel before the caller closes the fd (and it gets reused).
+    submitNow();
+}
+
+void UringBackend::watchAccept(int listenFd) {
+    state(listenFd).accepting = true;
+    armAccept(listenFd);
+}
+
+void UringBackend::watchRecv(int fd) {
+    state(fd).receiving = true;
+    armRecv(fd);
+}
+
+void UringBackend::send(int fd, const uint8_t* data, size_t len) {
+    FdState& st = state(fd);
+    st.sendQueue.append(reinterpret_cast<const char*>(data), len);
+    if (!st.sendScheduled && !st.sendInFlight) {
+        st.sendScheduled = true;
+        sendReady_.push_back(fd);
+    }
+}
+
+bool UringBackend::sendPending(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= fds_.size()) return false;
+    const FdState& st = fds_[static_cast<size_t>(fd)];
+    return st.sendInFlight || !st.sendQueue.empty();
+}
+
+// ── Wait / completions ─────────────────────────────────────────────────────
+
+int UringBackend::wait(int timeoutMs, std::vector<IOEvent>& out) {
+    out.clear();
+
+    // RECEIVED data from the previous tick has been consumed by now.
+    if (!recycle_.empty()) {
+        for (uint16_t bid : recycle_) provideBuffer(bid);
+        __atomic_store_n(&bufRing_->tail, bufTail_, __ATOMIC_RELEASE);
+        recycle_.clear();
+    }
+
+    // Re-arm receives that stopped (e.g. ENOBUFS while the ring was empty).
+    std::vector<int> rearm;
+    rearm.swap(rearm_);
+    for (int fd : rearm) {
+        if (state(fd).receiving) armRecv(fd);
+    }
+
+    // One SEND per fd with queued output.
+    std::vector<int> ready;
+    ready.swap(sendReady_);
+    for (int fd : ready) {
+        state(fd).sendScheduled = false;
+        startSend(fd);
+    }
+
+    // Submit everything and wait, in a single syscall. Don't block if
+    // completions are already waiting to be reaped.
+    unsigned pendingCqes = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) - *cqHead_;
+    unsigned minComplete = (pendingCqes > 0 || timeoutMs == 0) ? 0 : 1;
+    int ret = enter(minComplete, IORING_ENTER_GETEVENTS, timeoutMs);
+    if (ret < 0 && errno != ETIME && errno != EINTR && errno != EBUSY &&
+        errno != EAGAIN) {
+        return -1;
+    }
+
+    reap(out);
+    return static_cast<int>(out.size());
+}
+
+void UringBackend::reap(std::vector<IOEvent>& out) {
+    unsigned head = *cqHead_;
+    unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        handleCompletion(cqes_[head & cqMask_], out);
+        ++head;
+    }
+    __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+}
+
+void UringBackend::handleCompletion(const io_uring_cqe& cqe,
+                                    std::vector<IOEvent>& out) {
+    Op       op   = static_cast<Op>(cqe.user_data >> 56);
+    uint32_t gen  = static_cast<uint32_t>(cqe.user_data >> 32) & kGenMask;
+    int      fd   = static_cast<int>(cqe.user_data & 0xFFFFFFFFu);
+    bool     more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+    if (op == OP_INTERNAL) return;  // cancel / poll-remove results
+
+    FdState& st = state(fd);
+    bool current = (st.gen == gen);
+
+    IOEvent ev;
+    ev.fd = fd;
+
+    switch (op) {
+    case OP_RECV: {
+        if (cqe.flags & IORING_CQE_F_BUFFER) {
+            auto bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+            recycle_.push_back(bid);  // handed back at the next wait()
+            if (current && cqe.res > 0) {
+                ev.kind = IOEvent::Kind::RECEIVED;
+                ev.data = bufPool_ + bid * kBufSize;
+                ev.len  = static_cast<size_t>(cqe.res);
+                out.push_back(ev);
+            }
+        }
+        if (!current || !st.receiving) break;
+        if (cqe.res == 0) {
+            // EOF
+            ev.kind = IOEvent::Kind::RECEIVED;
+            out.push_back(ev);
+            st.receiving = false;
+        } else if (cqe.res == -ENOBUFS) {
+            if (!more) rearm_.push_back(fd);  // after buffers are recycled
+        } else if (cqe.res < 0) {
+            ev.kind   = IOEvent::Kind::FAILED;
+            ev.result = cqe.res;
+            out.push_back(ev);
+            st.receiving = false;
+        } else if (!more) {
+            armRecv(fd);
+        }
+        break;
+    }
+
+    case OP_ACCEPT:
+        if (!current || !st.accepting) break;
+        if (cqe.res >= 0) {
+            ev.kind   = IOEvent::Kind::ACCEPTED;
+            ev.result = cqe.res;
+            out.push_back(ev);
+        }
+        if (!more) armAccept(fd);
+        break;
+
+    case OP_POLL:
+        if (!current || st.pollEvents == 0 || cqe.res == -ECANCELED) break;
+        ev.kind   = IOEvent::Kind::READY;
+        ev.events = cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR)
+                                : static_cast<uint32_t>(cqe.res);
+        out.push_back(ev);
+        if (!more) armPoll(fd);
+        break;
+
+    case OP_SEND:
+        st.sendInFlight = false;
+        if (!current) {
+            // The fd was removed; the kernel is done with the buffer.
+            st.inFlight.clear();
+            st.inFlightOff = 0;
+            if (!st.sendQueue.empty()) startSend(fd);  // fd reused meanwhile
+            break;
+        }
+        if (cqe.res < 0) {
+            ev.kind   = IOEvent::Kind::FAILED;
+            ev.result = cqe.res;
+            out.push_back(ev);
+            st.inFlight.clear();
+            st.inFlightOff = 0;
+            st.sendQueue.clear();
+            break;
+        }
+        st.inFlightOff += static_cast<size_t>(cqe.res);
+        if (st.inFlightOff >= st.inFlight.size()) {
+            st.inFlight.clear();
+            st.inFlightOff = 0;
+        }
+        startSend(fd);  // short-send remainder, or whatever queued since
+        break;
+
+    default:
+        break;
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "net/IOBackend.h"
+
+#include <string>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+
+/// io_uring completion backend (Linux 6.0+), driven with raw syscalls.
+///
+///   - Listeners use multishot accept: one SQE reports every new client.
+///   - Clients use multishot recv into a provided-buffer ring, so the
+///     kernel picks a buffer only when data actually arrives — idle
+///     connections pin no memory.
+///   - Outgoing bytes are queued per fd and submitted as one SEND per fd
+///     per tick (one in flight per fd keeps ordering; short sends are
+///     resubmitted).
+///   - Readiness registrations (addFd) become multishot POLL_ADDs.
+///
+/// wait() recycles last tick's receive buffers, queues every pending send
+/// and re-arm, then submits and waits with a single io_uring_enter — one
+/// syscall per tick regardless of the number of connections.
+class UringBackend : public IOBackend {
+public:
+    /// Throws std::runtime_error if the kernel lacks the needed features.
+    UringBackend();
+    ~UringBackend() override;
+
+    UringBackend(const UringBackend&) = delete;
+    UringBackend& operator=(const UringBackend&) = delete;
+
+    /// Probe whether a ring with a provided-buffer ring can be created.
+    static bool supported();
+
+    void addFd(int fd, uint32_t events) override;
+    void modFd(int fd, uint32_t events) override;
+    void removeFd(int fd) override;
+    int  wait(int timeoutMs, std::vector<IOEvent>& out) override;
+
+    bool completionIO() const override { return true; }
+    void watchAccept(int listenFd) override;
+    void watchRecv(int fd) override;
+    void send(int fd, const uint8_t* data, size_t len) override;
+    bool sendPending(int fd) const override;
+
+private:
+    // Operation tag stored in the top byte of a SQE's user_data.
+    enum Op : uint8_t { OP_POLL = 1, OP_ACCEPT, OP_RECV, OP_SEND, OP_INTERNAL };
+
+    /// Per-fd bookkeeping, indexed by fd. `gen` changes on removeFd(), so
+    /// completions for a closed (and possibly reused) fd are recognized.
+    struct FdState {
+        uint32_t    gen = 0;
+        uint32_t    pollEvents = 0;      // readiness interest, 0 = none
+        bool        accepting = false;
+        bool        receiving = false;
+        bool        sendScheduled = false;  // in sendReady_
+        bool        sendInFlight = false;
+        std::string sendQueue;           // bytes for the next SEND
+        std::string inFlight;            // bytes owned by the kernel
+        size_t      inFlightOff = 0;     // already-sent prefix of inFlight
+    };
+
+    static constexpr unsigned kSqEntries     = 4096;
+    static constexpr unsigned kCqEntries     = 16384;
+    static constexpr unsigned kBufCount      = 1024;   // power of 2
+    static constexpr size_t   kBufSize       = 4096;
+    static constexpr uint16_t kBufGroup      = 0;
+    static constexpr uint32_t kGenMask       = 0xFFFFFF;
+
+    int ringFd_ = -1;
+
+    // Submission queue (shared with the kernel).
+    void*         ringPtr_ = nullptr;
+    size_t        ringSize_ = 0;
+    unsigned*     sqHead_ = nullptr;
+    unsigned*     sqTail_ = nullptr;
+    unsigned*     sqArray_ = nullptr;
+    unsigned      sqMask_ = 0;
+    unsigned      sqEntries_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t        sqesSize_ = 0;
+    unsigned      sqLocalTail_ = 0;   // our tail, published on submit
+    unsigned      toSubmit_ = 0;      // prepared but not yet submitted
+
+    // Completion queue (shared with the kernel).
+    unsigned*     cqHead_ = nullptr;
+    unsigned*     cqTail_ = nullptr;
+    unsigned      cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    // Provided-buffer ring for multishot recv.
+    io_uring_buf_ring* bufRing_ = nullptr;
+    size_t             bufRingSize_ = 0;
+    uint8_t*           bufPool_ = nullptr;
+    uint16_t           bufTail_ = 0;
+    std::vector<uint16_t> recycle_;   // buffers handed out last tick
+
+    std::vector<FdState> fds_;
+    std::vector<int>     sendReady_;  // fds with queued bytes to submit
+    std::vector<int>     rearm_;      // fds whose multishot recv stopped
+
+    FdState& state(int fd);
+    static uint64_t userData(Op op, uint32_t gen, int fd);
+
+    io_uring_sqe* getSqe();
+    int  enter(unsigned minComplete, unsigned flags, int timeoutMs);
+    void submitNow();
+
+    void armPoll(int fd);
+    void armAccept(int fd);
+    void armRecv(int fd);
+    void startSend(int fd);
+    void provideBuffer(uint16_t bid);
+    void reap(std::vector<IOEvent>& out);
+    void handleCompletion(const io_uring_cqe& cqe, std::vector<IOEvent>& out);
+
+    void teardown();
+};
@@ -14,6 +14,13 @@
 
 int AOFLoader::load(const std::string& filename, CommandTable& cmdTable,
                     Database& db) {
+    return load(filename,
+        [&cmdTable, &db](Connection& dummy, const CommandArgs& args) {
+            cmdTable.dispatch(db, dummy, args);
+        });
+}
+
+int AOFLoader::load(const std::string& filename, const ReplayFn& replay) {
     // Step 1: Open the AOF file for reading.
     int fd = ::open(filename.c_str(), O_RDONLY);
     if (fd < 0) {
@@ -85,12 +92,14 @@ int AOFLoader::load(const std::string& filename, CommandTable& cmdTable,
     Connection dummyConn(pipeFds[1]);
 
     // Step 4: Parse and replay loop.
+    // The whole file stays in `buffer`, so the parsed views remain valid
+    // for as long as the replay callback needs them.
     RespParser parser;
+    CommandArgs cmd;
     int count = 0;
 
     while (buffer.readableBytes() > 0) {
-        auto cmd = parser.parse(buffer);
-        if (!cmd.has_value()) {
+        if (!parser.parse(buffer, cmd)) {
             // INV-8: Incomplete frame = truncated AOF. Load valid prefix.
             size_t remaining = buffer.readableBytes();
             if (remaining > 0) {
@@ -101,10 +110,10 @@ int AOFLoader::load(const std::string& filename, CommandTable& cmdTable,
             }
             break;
         }
-        if (cmd->empty()) continue;  // null array, skip
+        if (cmd.empty()) continue;  // null array, skip
 
-        // Replay the command through the command table.
-        cmdTable.dispatch(db, dummyConn, *cmd);
+        // Replay the command (through the command table).
+        replay(dummyConn, cmd);
 
         // Drain the dummy connection's outgoing buffer to prevent it from
         // growing unbounded during long replays.
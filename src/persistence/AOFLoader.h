@@ -1,9 +1,13 @@
 #pragma once
 
+#include <functional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 // Forward declarations — AOFLoader only needs these interfaces.
 class CommandTable;
+class Connection;
 class Database;
 
 /// Reads the AOF file on startup, parses RESP commands using RespParser,
@@ -19,4 +23,15 @@ public:
     /// On corruption/truncation, loads the valid prefix and logs a warning.
     int load(const std::string& filename, CommandTable& cmdTable,
              Database& db);
+
+    /// Replay callback: executes one parsed command. `dummy` is a sink
+    /// connection whose replies are discarded after every command. The
+    /// arguments are views into the loaded file and valid only for the call.
+    using ReplayFn = std::function<void(
+        Connection& dummy, const std::vector<std::string_view>& args)>;
+
+    /// Load the AOF file, handing every command to `replay` instead of a
+    /// single Database. Used in sharded mode to route each command to the
+    /// shard that owns its key. Same return values as above.
+    int load(const std::string& filename, const ReplayFn& replay);
 };
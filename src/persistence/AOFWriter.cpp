@@ -1,7 +1,11 @@
 #include "persistence/AOFWriter.h"
 #include "store/Database.h"
+#include "store/HashType.h"
+#include "store/SetType.h"
+#include "store/ZSetType.h"
 
 #include <cerrno>
+#include <charconv>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
@@ -16,8 +20,7 @@
 // ── Constructor / Destructor ────────────────────────────────────────────────
 
 AOFWriter::AOFWriter(const std::string& filename, FsyncPolicy policy)
-    : filename_(filename), policy_(policy),
-      lastFsync_(std::chrono::steady_clock::now()) {
+    : filename_(filename), policy_(policy) {
     // Open for append, create if missing. Mode 0644 = owner rw, group/other r.
     fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
     if (fd_ < 0) {
@@ -28,6 +31,9 @@ AOFWriter::AOFWriter(const std::string& filename, FsyncPolicy policy)
 }
 
 AOFWriter::~AOFWriter() {
+    flush(/*force=*/true);
+    // Queued fsyncs and closes first: one of them may be on fd_.
+    bio_.waitIdle();
     if (fd_ >= 0) {
         ::fsync(fd_);
         ::close(fd_);
@@ -37,21 +43,25 @@ AOFWriter::~AOFWriter() {
 
 // ── RESP formatting ─────────────────────────────────────────────────────────
 
-std::string AOFWriter::formatRespCommand(const std::vector<std::string>& args) {
+/// Append "<prefix><n>\r\n" without a temporary string.
+static void appendHeader(std::string& out, char prefix, size_t n) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), n);
+    (void)ec;
+    out += prefix;
+    out.append(digits, end);
+    out += "\r\n";
+}
+
+template <typename Args>
+void AOFWriter::appendRespCommand(std::string& out, const Args& args) {
     // Format: *N\r\n$len\r\narg\r\n$len\r\narg\r\n...
-    std::string result;
-    result.reserve(64);  // reasonable starting size for small commands
-    result += '*';
-    result += std::to_string(args.size());
-    result += "\r\n";
+    appendHeader(out, '*', args.size());
     for (const auto& arg : args) {
-        result += '$';
-        result += std::to_string(arg.size());
-        result += "\r\n";
-        result += arg;
-        result += "\r\n";
+        appendHeader(out, '$', arg.size());
+        out += arg;
+        out += "\r\n";
     }
-    return result;
 }
 
 void AOFWriter::writeAll(int fd, const void* buf, size_t len) {
@@ -70,30 +80,97 @@ void AOFWriter::writeAll(int fd, const void* buf, size_t len) {
 }
 
 void AOFWriter::writeRespCommand(int fd, const std::vector<std::string>& args) {
-    std::string resp = formatRespCommand(args);
+    std::string resp;
+    appendRespCommand(resp, args);
     writeAll(fd, resp.data(), resp.size());
 }
 
 // ── Core API ────────────────────────────────────────────────────────────────
 
-void AOFWriter::log(const std::vector<std::string>& args) {
+uint64_t AOFWriter::log(const std::vector<std::string_view>& args) {
     // INV-1: Only called after successful command execution.
-    if (fd_ < 0) return;  // AOF disabled
+    if (fd_ < 0) return 0;  // AOF disabled
 
-    std::string resp = formatRespCommand(args);
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t start = buffer_.size();
+    appendRespCommand(buffer_, args);
+    loggedBytes_ += buffer_.size() - start;
 
-    // Write to the AOF file.
-    writeAll(fd_, resp.data(), resp.size());
+    // INV-5: During rewrite, also buffer for later append to new file.
+    if (isRewriting_) {
+        rewriteBuffer_.emplace_back(buffer_, start);
+    }
+    return loggedBytes_;
+}
 
-    // INV-4: fsync per policy.
-    if (policy_ == FsyncPolicy::ALWAYS) {
-        ::fsync(fd_);
+static int64_t steadyMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(
+               steady_clock::now().time_since_epoch()).count();
+}
+
+void AOFWriter::flush(bool force) {
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    uint64_t through;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Empty: anything logged earlier went out with a previous flush,
+        // which finished before this one got flushMutex_.
+        if (buffer_.empty()) return;
+        through = loggedBytes_;
+
+        // A write() to a file being fsynced blocks until the fsync ends.
+        // Under EVERYSEC, hold the batch back for up to 2 s instead, and
+        // let its replies go: at most ~2 s of writes are at risk, as in
+        // Redis. Past that, write anyway and count a delayed fsync.
+        if (!force && policy_ == FsyncPolicy::EVERYSEC &&
+            bio_.pending(BackgroundIO::JobType::FSYNC) > 0) {
+            int64_t now = steadyMs();
+            int64_t since = postponedSince_.load(std::memory_order_relaxed);
+            if (since == 0) {
+                postponedSince_.store(now, std::memory_order_relaxed);
+                since = now;
+            }
+            if (now - since < kMaxPostponeMs) {
+                flushedBytes_.store(through, std::memory_order_release);
+                return;
+            }
+            ++delayedFsyncs_;
+            std::fprintf(stderr,
+                "AOFWriter: background fsync is taking too long (busy disk?); "
+                "writing the AOF without waiting for it. This may slow "
+                "down the server.\n");
+        }
+        postponedSince_.store(0, std::memory_order_relaxed);
+        flushing_.swap(buffer_);  // both keep their capacity
     }
+    writeBatch(through);
+}
 
-    // INV-5: During rewrite, also buffer for later append to new file.
-    if (isRewriting_) {
-        rewriteBuffer_.push_back(std::move(resp));
+void AOFWriter::writeBatch(uint64_t through) {
+    if (fd_ >= 0) {
+        writeAll(fd_, flushing_.data(), flushing_.size());
+        // INV-4: fsync per policy — once for the whole batch.
+        if (policy_ == FsyncPolicy::ALWAYS) {
+            timedFsync(fd_);
+        }
     }
+    flushing_.clear();
+    flushedBytes_.store(through, std::memory_order_release);
+}
+
+void AOFWriter::timedFsync(int fd) {
+    auto start = std::chrono::steady_clock::now();
+    ::fsync(fd);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    lastFsyncUs_.store(static_cast<uint64_t>(us), std::memory_order_relaxed);
+}
+
+uint64_t AOFWriter::lastFsyncDurationUs() const {
+    return policy_ == FsyncPolicy::ALWAYS
+               ? lastFsyncUs_.load(std::memory_order_relaxed)
+               : bio_.lastFsyncDurationUs();
 }
 
 void AOFWriter::tick() {
@@ -101,18 +178,22 @@ void AOFWriter::tick() {
     if (policy_ != FsyncPolicy::EVERYSEC) return;
     if (fd_ < 0) return;
 
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
-                       now - lastFsync_).count();
-    if (elapsed >= 1) {
-        ::fsync(fd_);
-        lastFsync_ = now;
+    // Retry a postponed write too: an idle loop would not flush it.
+    flush();
+
+    // The fsync runs on the background thread. If last second's is still
+    // running, this second's data goes with the next one.
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bio_.pending(BackgroundIO::JobType::FSYNC) == 0) {
+        bio_.submit(BackgroundIO::JobType::FSYNC, fd_);
     }
 }
 
 // ── Background Rewrite ──────────────────────────────────────────────────────
 
 void AOFWriter::triggerRewrite(Database& db) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
     // Ignore if already rewriting.
     if (isRewriting_) return;
 
@@ -151,48 +232,50 @@ void AOFWriter::triggerRewrite(Database& db) {
                 break;
             }
             case DataType::LIST: {
-                auto& list = std::get<std::deque<std::string>>(entry->value.data);
-                // Write: RPUSH key elem1 elem2 ... (preserves order)
-                if (!list.empty()) {
+                // Write: RPUSH key elem1 elem2 ... — one per quicklist
+                // chunk, so no command grows with the list.
+                for (const Quicklist::Node* node = entry->value.asList().head();
+                     node; node = node->next) {
+                    const Listpack& lp = node->entries;
                     std::vector<std::string> cmd = {"RPUSH", key};
-                    for (const auto& elem : list) {
-                        cmd.push_back(elem);
+                    cmd.reserve(2 + lp.size());
+                    for (size_t pos = lp.begin(); pos != lp.end();
+                         pos = lp.next(pos)) {
+                        cmd.emplace_back(lp.get(pos));
                     }
                     writeRespCommand(tmpFd, cmd);
                 }
                 break;
             }
             case DataType::HASH: {
-                auto& hash = std::get<std::unordered_map<std::string, std::string>>(entry->value.data);
                 // Write: HSET key field1 value1 field2 value2 ...
-                if (!hash.empty()) {
+                if (HashType::size(entry->value) > 0) {
                     std::vector<std::string> cmd = {"HSET", key};
-                    for (const auto& [field, value] : hash) {
-                        cmd.push_back(field);
-                        cmd.push_back(value);
-                    }
+                    HashType::forEach(entry->value,
+                        [&](std::string_view field, std::string_view value) {
+                            cmd.emplace_back(field);
+                            cmd.emplace_back(value);
+                        });
                     writeRespCommand(tmpFd, cmd);
                 }
                 break;
             }
             case DataType::SET: {
-                auto& set = std::get<std::unordered_set<std::string>>(entry->value.data);
                 // Write: SADD key member1 member2 ...
-                if (!set.empty()) {
+                if (SetType::size(entry->value) > 0) {
                     std::vector<std::string> cmd = {"SADD", key};
-                    for (const auto& member : set) {
-                        cmd.push_back(member);
-                    }
+                    SetType::forEach(entry->value, [&](std::string_view member) {
+                        cmd.emplace_back(member);
+                    });
                     writeRespCommand(tmpFd, cmd);
                 }
                 break;
             }
             case DataType::ZSET: {
-                auto& zset = std::get<ZSetData>(entry->value.data);
                 // Write: ZADD key score1 member1 score2 member2 ...
-                // Walk skiplist in order so replay recreates same ordering.
-                if (!zset.dict.empty()) {
-                    auto elems = zset.skiplist.rangeByRank(0, static_cast<int>(zset.skiplist.size()) - 1);
+                // Walk in rank order so replay recreates same ordering.
+                if (ZSetType::size(entry->value) > 0) {
+                    auto elems = ZSetType::rangeByRank(entry->value, 0, -1);
                     std::vector<std::string> cmd = {"ZADD", key};
                     for (const auto& [member, score] : elems) {
                         char buf[64];
@@ -225,6 +308,8 @@ void AOFWriter::triggerRewrite(Database& db) {
 }
 
 void AOFWriter::checkRewriteComplete() {
+    std::lock_guard<std::mutex> flushLock(flushMutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
     if (rewriteChildPid_ < 0) return;  // no rewrite in progress
 
     int status = 0;
@@ -232,32 +317,42 @@ void AOFWriter::checkRewriteComplete() {
 
     if (result == 0) return;  // child still running
 
+    // Finish the old file first: the unflushed commands are also in
+    // rewriteBuffer_, so after the swap they must not be written again.
+    if (!buffer_.empty()) {
+        postponedSince_.store(0, std::memory_order_relaxed);
+        flushing_.swap(buffer_);
+        writeBatch(loggedBytes_);
+    }
+
     if (result > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0) {
         // Child finished successfully.
         // Step 1: Append rewrite buffer to temp file.
+        // The child fsynced the snapshot; only this tail is unsynced.
         int tmpFd = ::open(rewriteTempFile_.c_str(),
                            O_WRONLY | O_APPEND, 0644);
         if (tmpFd >= 0) {
             for (const auto& entry : rewriteBuffer_) {
                 writeAll(tmpFd, entry.data(), entry.size());
             }
-            ::fsync(tmpFd);
-            ::close(tmpFd);
 
             // Step 2: Atomic swap — rename temp file over the AOF file.
             if (::rename(rewriteTempFile_.c_str(), filename_.c_str()) == 0) {
-                // Step 3: Reopen the AOF file for appending.
-                ::close(fd_);
-                fd_ = ::open(filename_.c_str(),
-                             O_WRONLY | O_CREAT | O_APPEND, 0644);
-                if (fd_ < 0) {
-                    std::fprintf(stderr,
-                        "AOFWriter: failed to reopen '%s' after rewrite: %s\n",
-                        filename_.c_str(), std::strerror(errno));
+                // Step 3: Append to the new file from now on. The old fd
+                // holds the last reference to the old file, so closing it
+                // frees the whole old log: leave that to the background
+                // thread, after any fsync of it already queued.
+                bio_.submit(BackgroundIO::JobType::CLOSE, fd_);
+                fd_ = tmpFd;
+                if (policy_ == FsyncPolicy::ALWAYS) {
+                    timedFsync(fd_);
+                } else if (policy_ == FsyncPolicy::EVERYSEC) {
+                    bio_.submit(BackgroundIO::JobType::FSYNC, fd_);
                 }
             } else {
                 std::fprintf(stderr, "AOFWriter: rename failed: %s\n",
                              std::strerror(errno));
+                ::close(tmpFd);
             }
         } else {
             std::fprintf(stderr,
@@ -1,8 +1,13 @@
 #pragma once
 
+#include "persistence/BackgroundIO.h"
+
+#include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // Forward declaration — AOFWriter only needs Database for rewrite snapshot.
@@ -11,14 +16,32 @@ class Database;
 /// Appends write commands to an Append-Only File in RESP format.
 /// Manages fsync policy (ALWAYS, EVERYSEC, NO) and background rewrite via fork().
 ///
+/// Group commit: log() only formats the command into an in-memory buffer.
+/// The event loop calls flush() once per iteration, before any reply of
+/// that iteration is written, so a whole batch of write commands costs
+/// one write() — and, under ALWAYS, one fsync(). log() returns the AOF
+/// offset just past the command; a reply that depends on it may go out
+/// once flushedThrough(offset) is true.
+///
+/// Under EVERYSEC the once-a-second fsync runs on a BackgroundIO thread,
+/// so a slow disk never stalls the event loop. While that fsync is still
+/// running, flush() postpones its write() (which would block behind it)
+/// for up to 2 s, as Redis does; the batch's replies go out regardless.
+/// Closing the old file after a rewrite swap is also left to that thread.
+///
+/// Thread-safe: in sharded mode (--threads N) every shard logs into the
+/// same buffer under an internal mutex. flush() swaps the buffer out and
+/// does its I/O outside that mutex, so other shards keep logging while
+/// one of them writes and fsyncs; a second mutex keeps flushes in order.
+///
 /// Sits in the persistence overlay layer. Must NOT include anything from net/.
 /// Must NOT own any data — it only logs commands to disk.
 class AOFWriter {
 public:
     /// Fsync policy controls durability vs throughput tradeoff.
     enum class FsyncPolicy {
-        ALWAYS,    // fsync after every log() — safest, slowest
-        EVERYSEC,  // fsync once per second via tick() — default
+        ALWAYS,    // fsync on every flush(), before replies — safest, slowest
+        EVERYSEC,  // fsync once per second in the background — default
         NO         // never fsync explicitly — OS decides
     };
 
@@ -27,20 +50,59 @@ public:
     AOFWriter(const std::string& filename,
               FsyncPolicy policy = FsyncPolicy::EVERYSEC);
 
-    /// Flushes and closes the AOF file descriptor.
+    /// Flushes the buffer, fsyncs and closes the AOF file descriptor.
     ~AOFWriter();
 
     AOFWriter(const AOFWriter&) = delete;
     AOFWriter& operator=(const AOFWriter&) = delete;
 
-    /// Append a command in RESP format: *N\r\n$len\r\narg\r\n...
+    /// Buffer a command in RESP format: *N\r\n$len\r\narg\r\n...
     /// Called after every successful write command (SET, DEL, EXPIRE, etc.).
-    void log(const std::vector<std::string>& args);
-
-    /// Called once per event loop tick. If EVERYSEC and 1+ second has
-    /// elapsed since last fsync, calls fsync(fd_).
+    /// The arguments are views into the client's input buffer; they are
+    /// formatted immediately and not retained. Returns the AOF offset (in
+    /// bytes logged since startup) just past this command.
+    uint64_t log(const std::vector<std::string_view>& args);
+
+    /// Write everything buffered with one write(), then fsync if ALWAYS.
+    /// Returns once commands logged before the call (by any thread) are
+    /// written, even if another thread's flush wrote them — unless the
+    /// write is postponed behind a background fsync (EVERYSEC, at most
+    /// 2 s, and never when `force` is set).
+    void flush(bool force = false);
+
+    /// True once the replies to commands up to `offset` (a log() result)
+    /// may go out: they are written — and under ALWAYS, fsynced — or
+    /// their write is postponed.
+    bool flushedThrough(uint64_t offset) const {
+        return flushedBytes_.load(std::memory_order_acquire) >= offset;
+    }
+
+    /// True while flush() is holding a batch back: keep calling it.
+    bool writePostponed() const {
+        return postponedSince_.load(std::memory_order_relaxed) != 0;
+    }
+
+    FsyncPolicy policy() const { return policy_; }
+
+    /// Called by the event loop's fsync timer, once a second. If
+    /// EVERYSEC, retries a postponed write and queues a background fsync
+    /// unless the previous one is still running.
     void tick();
 
+    /// Writes forced through after being postponed for 2 s (INFO
+    /// aof_delayed_fsync).
+    uint64_t delayedFsyncs() const {
+        return delayedFsyncs_.load(std::memory_order_relaxed);
+    }
+
+    /// Duration of the most recent AOF fsync, in microseconds.
+    uint64_t lastFsyncDurationUs() const;
+
+    /// Background fsyncs queued or running (INFO aof_pending_bio_fsync).
+    size_t pendingFsyncs() const {
+        return bio_.pending(BackgroundIO::JobType::FSYNC);
+    }
+
     /// Trigger background rewrite: fork(), child writes compact snapshot,
     /// parent continues logging to old file, swap on child exit.
     /// Does nothing if a rewrite is already in progress.
@@ -48,7 +110,7 @@ public:
 
     /// Non-blocking check: has the background rewrite child finished?
     /// If yes, appends rewrite buffer to new file, atomically swaps.
-    /// Called from the event loop timer callback.
+    /// Polled by an event loop timer while a rewrite is in progress.
     void checkRewriteComplete();
 
     /// Return the AOF file path.
@@ -62,9 +124,8 @@ public:
 
 private:
     std::string filename_;
-    int fd_ = -1;                    // file descriptor for AOF file
+    std::atomic<int> fd_{-1};        // file descriptor for AOF file (swapped on rewrite)
     FsyncPolicy policy_;
-    std::chrono::steady_clock::time_point lastFsync_;
 
     // Background rewrite state
     pid_t rewriteChildPid_ = -1;     // PID of rewrite child, -1 = none
@@ -72,12 +133,37 @@ private:
     bool isRewriting_ = false;       // true between fork() and swap
     std::vector<std::string> rewriteBuffer_;  // commands logged after fork
 
+    // Group commit
+    std::string buffer_;             // commands logged since the last flush
+    std::string flushing_;           // the batch being written (flushMutex_)
+    uint64_t loggedBytes_ = 0;       // offset past the last log()ed command
+    std::atomic<uint64_t> flushedBytes_{0};  // offset written (+ fsynced)
+
+    std::mutex mutex_;               // guards buffer_, fd_ and rewrite state
+    std::mutex flushMutex_;          // serializes flushes; taken before mutex_
+
+    // Background fsync / close
+    static constexpr int64_t kMaxPostponeMs = 2000;
+    std::atomic<int64_t> postponedSince_{0};   // steady ms; 0 = not postponed
+    std::atomic<uint64_t> delayedFsyncs_{0};
+    std::atomic<uint64_t> lastFsyncUs_{0};    // inline fsyncs (ALWAYS)
+    BackgroundIO bio_;               // drained before ~AOFWriter closes fd_
+
+    /// Write `flushing_` (swapped out under mutex_) and fsync per policy.
+    /// Caller holds flushMutex_.
+    void writeBatch(uint64_t through);
+
+    /// fsync(fd) on this thread, recording how long it took.
+    void timedFsync(int fd);
+
     /// Format a command as RESP and write to the given fd.
     /// Uses a write loop to handle partial writes.
     static void writeRespCommand(int fd, const std::vector<std::string>& args);
 
-    /// Format a command as RESP into a string (for buffering during rewrite).
-    static std::string formatRespCommand(const std::vector<std::string>& args);
+    /// Append a command as RESP to `out`. Accepts owned strings (rewrite
+    /// snapshot) or views (live commands).
+    template <typename Args>
+    static void appendRespCommand(std::string& out, const Args& args);
 
     /// Write all bytes in buf to fd, handling partial writes.
     static void writeAll(int fd, const void* buf, size_t len);
@@ -0,0 +1,70 @@
+#include "persistence/BackgroundIO.h"
+
+#include <chrono>
+#include <csignal>
+#include <pthread.h>  // pthread_sigmask
+#include <unistd.h>
+
+BackgroundIO::BackgroundIO() {
+    // The worker inherits a fully blocked mask: signals stay on the main thread.
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    worker_ = std::thread([this]() { workerMain(); });
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+BackgroundIO::~BackgroundIO() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workCv_.notify_one();
+    worker_.join();
+}
+
+void BackgroundIO::submit(JobType type, int fd) {
+    pending_[static_cast<int>(type)].fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back({type, fd});
+    }
+    workCv_.notify_one();
+}
+
+void BackgroundIO::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idleCv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+void BackgroundIO::workerMain() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            busy_ = false;
+            if (queue_.empty()) idleCv_.notify_all();
+            // Stop only once the queue is drained: the last fsync counts.
+            workCv_.wait(lock, [this]() {
+                return stopping_ || !queue_.empty();
+            });
+            if (queue_.empty()) return;
+            job = queue_.front();
+            queue_.pop_front();
+            busy_ = true;
+        }
+
+        if (job.type == JobType::FSYNC) {
+            auto start = std::chrono::steady_clock::now();
+            ::fsync(job.fd);
+            auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            lastFsyncUs_.store(static_cast<uint64_t>(us),
+                               std::memory_order_relaxed);
+        } else {
+            ::close(job.fd);
+        }
+        pending_[static_cast<int>(job.type)].fetch_sub(
+            1, std::memory_order_release);
+    }
+}
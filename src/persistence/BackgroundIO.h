@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/// One background thread that runs slow file-descriptor jobs off the
+/// event loop: fsync() of the AOF under everysec, and close() of the old
+/// AOF after a rewrite swap — the last reference to a renamed-over file,
+/// so closing it frees every block of the old log. Like Redis's bio.
+///
+/// Jobs run one at a time in submission order, so a CLOSE queued after an
+/// FSYNC of the same fd never runs first.
+///
+/// Must NOT know about: the AOF format, the event loop, the database.
+class BackgroundIO {
+public:
+    enum class JobType { FSYNC, CLOSE };
+
+    BackgroundIO();
+
+    /// Runs the jobs still queued, then stops the thread.
+    ~BackgroundIO();
+
+    BackgroundIO(const BackgroundIO&) = delete;
+    BackgroundIO& operator=(const BackgroundIO&) = delete;
+
+    /// Queue a job on `fd`. For CLOSE, the fd belongs to the job from now on.
+    void submit(JobType type, int fd);
+
+    /// Jobs of `type` queued or running.
+    size_t pending(JobType type) const {
+        return pending_[static_cast<int>(type)].load(std::memory_order_acquire);
+    }
+
+    /// Block until every job submitted so far has run.
+    void waitIdle();
+
+    /// How long the most recent FSYNC job took, in microseconds.
+    uint64_t lastFsyncDurationUs() const {
+        return lastFsyncUs_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Job {
+        JobType type;
+        int     fd;
+    };
+
+    void workerMain();
+
+    std::mutex              mutex_;
+    std::condition_variable workCv_;   // worker: a job was queued
+    std::condition_variable idleCv_;   // waitIdle(): the queue drained
+    std::deque<Job>         queue_;
+    bool                    busy_ = false;      // worker is running a job
+    bool                    stopping_ = false;
+
+    std::atomic<size_t>   pending_[2] = {};
+    std::atomic<uint64_t> lastFsyncUs_{0};
+
+    std::thread worker_;  // last: started once the rest is initialised
+};
@@ -0,0 +1,129 @@
+#include "proto/CrlfScanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMPLE_REDIS_X86 1
+#endif
+
+// ── Scalar kernel ──────────────────────────────────────────────────────────
+// Also finishes the last few bytes for the vector kernels.
+static int64_t findScalar(const uint8_t* data, size_t len, size_t i) {
+    for (; i + 1 < len; ++i) {
+        if (data[i] == '\r' && data[i + 1] == '\n') {
+            return static_cast<int64_t>(i);
+        }
+    }
+    return -1;
+}
+
+#ifdef SIMPLE_REDIS_X86
+
+// ── SSE2 kernel ────────────────────────────────────────────────────────────
+// Compare 16 bytes against '\r' and the same 16 bytes shifted by one
+// against '\n'; a set bit in both masks is a CRLF. Needs 17 readable bytes.
+__attribute__((target("sse2")))
+static int64_t findSse2(const uint8_t* data, size_t len, size_t i) {
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; i + 17 <= len; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(a, cr), _mm_cmpeq_epi8(b, lf))));
+        if (mask != 0) {
+            return static_cast<int64_t>(i + __builtin_ctz(mask));
+        }
+    }
+    return findScalar(data, len, i);
+}
+
+// ── AVX2 kernel ────────────────────────────────────────────────────────────
+// Same idea, 32 bytes per step.
+__attribute__((target("avx2")))
+static int64_t findAvx2(const uint8_t* data, size_t len, size_t i) {
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    for (; i + 33 <= len; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(a, cr),
+                             _mm256_cmpeq_epi8(b, lf))));
+        if (mask != 0) {
+            return static_cast<int64_t>(i + __builtin_ctz(mask));
+        }
+    }
+    return findSse2(data, len, i);
+}
+
+#endif  // SIMPLE_REDIS_X86
+
+// ── Dispatch ───────────────────────────────────────────────────────────────
+
+using FindFn = int64_t (*)(const uint8_t*, size_t, size_t);
+
+static FindFn kernelFn(CrlfScanner::Kernel k) {
+    switch (k) {
+#ifdef SIMPLE_REDIS_X86
+    case CrlfScanner::Kernel::AVX2: return findAvx2;
+    case CrlfScanner::Kernel::SSE2: return findSse2;
+#endif
+    default:                        return findScalar;
+    }
+}
+
+static CrlfScanner::Kernel bestKernel() {
+#ifdef SIMPLE_REDIS_X86
+    // Runs from a static initializer, possibly before libgcc's own.
+    __builtin_cpu_init();
+#endif
+    if (CrlfScanner::supported(CrlfScanner::Kernel::AVX2)) {
+        return CrlfScanner::Kernel::AVX2;
+    }
+    if (CrlfScanner::supported(CrlfScanner::Kernel::SSE2)) {
+        return CrlfScanner::Kernel::SSE2;
+    }
+    return CrlfScanner::Kernel::SCALAR;
+}
+
+static CrlfScanner::Kernel g_kernel = bestKernel();
+static FindFn g_find = kernelFn(g_kernel);
+
+int64_t CrlfScanner::find(const uint8_t* data, size_t len, size_t offset) {
+    return g_find(data, len, offset);
+}
+
+CrlfScanner::Kernel CrlfScanner::kernel() {
+    return g_kernel;
+}
+
+bool CrlfScanner::supported(Kernel k) {
+    switch (k) {
+    case Kernel::SCALAR:
+        return true;
+#ifdef SIMPLE_REDIS_X86
+    case Kernel::SSE2:
+        return __builtin_cpu_supports("sse2");
+    case Kernel::AVX2:
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+bool CrlfScanner::useKernel(Kernel k) {
+    if (!supported(k)) return false;
+    g_kernel = k;
+    g_find = kernelFn(k);
+    return true;
+}
+
+const char* CrlfScanner::kernelName(Kernel k) {
+    switch (k) {
+    case Kernel::SCALAR: return "scalar";
+    case Kernel::SSE2:   return "sse2";
+    case Kernel::AVX2:   return "avx2";
+    }
+    return "unknown";
+}
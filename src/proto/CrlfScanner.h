@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Finds the next "\r\n" in a byte range — the innermost loop of RESP
+/// parsing.
+///
+/// Three kernels: a portable byte loop, SSE2 (16 bytes per step, baseline
+/// on x86-64) and AVX2 (32 bytes per step, compiled with a target
+/// attribute so the binary still runs on CPUs without it). The fastest
+/// kernel the CPU supports is picked once, at startup.
+///
+/// Must NOT know about: Buffer, sockets, commands.
+class CrlfScanner {
+public:
+    enum class Kernel : uint8_t { SCALAR, SSE2, AVX2 };
+
+    /// Offset of the first '\r' in [data+offset, data+len) that is
+    /// immediately followed by '\n', or -1 if there is none.
+    static int64_t find(const uint8_t* data, size_t len, size_t offset);
+
+    /// The kernel find() currently uses.
+    static Kernel kernel();
+
+    /// True if this CPU can run `k`.
+    static bool supported(Kernel k);
+
+    /// Switch find() to `k` (benchmarks and tests; not thread-safe).
+    /// Returns false, changing nothing, if `k` is not supported.
+    static bool useKernel(Kernel k);
+
+    /// "scalar", "sse2" or "avx2".
+    static const char* kernelName(Kernel k);
+};
@@ -1,104 +1,151 @@
 #include "proto/RespParser.h"
+#include "proto/CrlfScanner.h"
 
-#include <cstdlib>
-#include <cstring>
+#include <algorithm>
+#include <cstdint>
 
 // ── Helper: find \r\n within [data+offset, data+len) ──────────────────────
 int RespParser::findCRLF(const uint8_t* data, size_t len, size_t offset) {
-    // Need at least 2 bytes for \r\n.
-    if (len < offset + 2) return -1;
-    for (size_t i = offset; i + 1 < len; ++i) {
-        if (data[i] == '\r' && data[i + 1] == '\n') {
-            return static_cast<int>(i);
-        }
-    }
-    return -1;
+    // SIMD kernel picked at startup (see CrlfScanner).
+    return static_cast<int>(CrlfScanner::find(data, len, offset));
 }
 
-// ── Parse RESP array ──────────────────────────────────────────────────────
-std::optional<std::vector<std::string>>
-RespParser::parseArray(const uint8_t* data, size_t len, size_t& bytesConsumed) {
-    // data[0] == '*'. Find the first \r\n to read the element count.
-    int crlfPos = findCRLF(data, len, 1);
-    if (crlfPos < 0) return std::nullopt;  // incomplete
-
-    // Parse the element count: *N\r\n
-    // N is between data[1] and data[crlfPos-1].
-    std::string countStr(reinterpret_cast<const char*>(data + 1),
-                         static_cast<size_t>(crlfPos - 1));
-    int count = std::atoi(countStr.c_str());
-    if (count < 0) {
-        // *-1\r\n is a null array — treat as empty command.
-        bytesConsumed = static_cast<size_t>(crlfPos) + 2;
-        return std::vector<std::string>{};
+// ── Helper: atoi() over a byte range ──────────────────────────────────────
+int64_t RespParser::parseLength(const uint8_t* data, size_t begin, size_t end) {
+    size_t i = begin;
+    bool negative = false;
+    if (i < end && (data[i] == '-' || data[i] == '+')) {
+        negative = data[i] == '-';
+        ++i;
     }
+    // Anything past 10 digits is an absurd length anyway; capping the
+    // count means the loop needs no overflow check, only one unsigned
+    // compare per digit.
+    end = std::min(end, i + 10);
+    int64_t value = 0;
+    for (; i < end; ++i) {
+        uint32_t digit = static_cast<uint32_t>(data[i]) - '0';
+        if (digit > 9) break;
+        value = value * 10 + digit;
+    }
+    return negative ? -value : value;
+}
 
-    // Now parse `count` bulk strings.
-    size_t pos = static_cast<size_t>(crlfPos) + 2;  // past *N\r\n
-    std::vector<std::string> args;
-    args.reserve(static_cast<size_t>(count));
+// ── Helper: a "<length>\r\n" header line ─────────────────────────────────
+size_t RespParser::parseLengthLine(const uint8_t* data, size_t len,
+                                   size_t pos, int64_t& value) {
+    // Fast path: optional '-', up to 10 digits, then \r\n — every header a
+    // real client sends. One pass, no CRLF search.
+    size_t i = pos;
+    bool negative = i < len && data[i] == '-';
+    if (negative) ++i;
+    size_t digitsBegin = i;
+    size_t digitsEnd = std::min(len, i + 10);
+    int64_t v = 0;
+    for (; i < digitsEnd; ++i) {
+        uint32_t digit = static_cast<uint32_t>(data[i]) - '0';
+        if (digit > 9) break;
+        v = v * 10 + digit;
+    }
+    if (i + 1 < len && i > digitsBegin && data[i] == '\r' && data[i + 1] == '\n') {
+        value = negative ? -v : v;
+        return i + 2;
+    }
+    if (i == len || (i + 1 == len && data[i] == '\r')) {
+        return 0;  // incomplete
+    }
 
-    for (int i = 0; i < count; ++i) {
-        if (pos >= len) return std::nullopt;  // incomplete
+    // Anything unusual ('+', spaces, 11+ digits): scan for the line end
+    // and parse it the lenient atoi() way, as before.
+    int crlfPos = findCRLF(data, len, pos);
+    if (crlfPos < 0) return 0;  // incomplete
+    value = parseLength(data, pos, static_cast<size_t>(crlfPos));
+    return static_cast<size_t>(crlfPos) + 2;
+}
 
-        if (data[pos] != '$') {
-            // Not a bulk string — protocol error. Try to recover.
-            return std::nullopt;
+// ── Parse RESP array ──────────────────────────────────────────────────────
+bool RespParser::parseArray(const uint8_t* data, size_t len,
+                            ParseState& state) {
+    if (state.arrayCount < 0) {
+        // data[0] == '*'. Parse the element count: *N\r\n
+        int64_t count = 0;
+        size_t next = parseLengthLine(data, len, 1, count);
+        if (next == 0) return false;  // incomplete
+        state.pos = next;  // past *N\r\n
+        if (count < 0) {
+            // *-1\r\n is a null array — treat as empty command.
+            return true;
         }
+        state.arrayCount = count;
+        state.spans.reserve(static_cast<size_t>(std::min<int64_t>(count, 1024)));
+    }
 
-        // Find \r\n after $len
-        int lenCRLF = findCRLF(data, len, pos + 1);
-        if (lenCRLF < 0) return std::nullopt;  // incomplete
-
-        // Parse the bulk string length.
-        std::string lenStr(reinterpret_cast<const char*>(data + pos + 1),
-                           static_cast<size_t>(lenCRLF) - (pos + 1));
-        int bulkLen = std::atoi(lenStr.c_str());
-
-        if (bulkLen < 0) {
-            // $-1\r\n = null bulk string.
-            args.emplace_back("");
-            pos = static_cast<size_t>(lenCRLF) + 2;
-            continue;
+    // Parse the remaining bulk strings, resuming at state.pos.
+    while (static_cast<int64_t>(state.spans.size()) < state.arrayCount) {
+        if (state.bulkLength < 0) {
+            size_t pos = state.pos;
+            if (pos >= len) return false;  // incomplete
+
+            if (data[pos] != '$') {
+                // Not a bulk string — protocol error. Try to recover.
+                return false;
+            }
+
+            // Parse the bulk string length: $len\r\n
+            int64_t bulkLen = 0;
+            size_t next = parseLengthLine(data, len, pos + 1, bulkLen);
+            if (next == 0) return false;  // incomplete
+            state.pos = next;
+
+            if (bulkLen < 0) {
+                // $-1\r\n = null bulk string.
+                state.spans.emplace_back(state.pos, 0);
+                continue;
+            }
+            state.bulkLength = bulkLen;
+            if (bulkLen >= kBigBulkLength && bulkLen <= kMaxPresizeLength) {
+                state.expectedBytes = state.pos + static_cast<size_t>(bulkLen) + 2;
+            }
         }
 
-        // The data starts after $len\r\n and is exactly bulkLen bytes,
+        // The data starts at state.pos and is exactly bulkLength bytes,
         // followed by \r\n.
-        size_t dataStart = static_cast<size_t>(lenCRLF) + 2;
-        size_t dataEnd   = dataStart + static_cast<size_t>(bulkLen);
+        size_t dataStart = state.pos;
+        size_t dataEnd   = dataStart + static_cast<size_t>(state.bulkLength);
 
         // Need dataEnd + 2 bytes (for trailing \r\n).
-        if (dataEnd + 2 > len) return std::nullopt;  // incomplete
+        if (dataEnd + 2 > len) return false;  // incomplete
 
         // Verify trailing \r\n (binary safety: we do NOT scan for \r\n
-        // within the bulk data — we read exactly bulkLen bytes).
+        // within the bulk data — we read exactly bulkLength bytes).
         if (data[dataEnd] != '\r' || data[dataEnd + 1] != '\n') {
             // Protocol error — malformed bulk string.
-            return std::nullopt;
+            return false;
         }
 
-        args.emplace_back(reinterpret_cast<const char*>(data + dataStart),
-                          static_cast<size_t>(bulkLen));
-        pos = dataEnd + 2;
+        state.spans.emplace_back(dataStart,
+                                 static_cast<size_t>(state.bulkLength));
+        state.pos = dataEnd + 2;
+        state.bulkLength = -1;
     }
-
-    bytesConsumed = pos;
-    return args;
+    return true;
 }
 
 // ── Parse inline command ──────────────────────────────────────────────────
-std::optional<std::vector<std::string>>
-RespParser::parseInline(const uint8_t* data, size_t len, size_t& bytesConsumed) {
-    // Read until \r\n, then split on spaces.
-    int crlfPos = findCRLF(data, len, 0);
-    if (crlfPos < 0) return std::nullopt;  // incomplete
+bool RespParser::parseInline(const uint8_t* data, size_t len,
+                             ParseState& state) {
+    // Read until \r\n, then split on spaces. Resume the search where the
+    // previous call stopped (one byte back: the \r may have been last).
+    int crlfPos = findCRLF(data, len, state.pos);
+    if (crlfPos < 0) {
+        state.pos = len > 0 ? len - 1 : 0;
+        return false;  // incomplete
+    }
 
-    std::string line(reinterpret_cast<const char*>(data),
-                     static_cast<size_t>(crlfPos));
-    bytesConsumed = static_cast<size_t>(crlfPos) + 2;
+    std::string_view line(reinterpret_cast<const char*>(data),
+                          static_cast<size_t>(crlfPos));
 
     // Split on spaces.
-    std::vector<std::string> args;
     size_t pos = 0;
     while (pos < line.size()) {
         // Skip leading spaces.
@@ -106,34 +153,46 @@ RespParser::parseInline(const uint8_t* data, size_t len, size_t& bytesConsumed)
         if (pos >= line.size()) break;
         // Find end of token.
         size_t end = line.find(' ', pos);
-        if (end == std::string::npos) end = line.size();
-        args.push_back(line.substr(pos, end - pos));
+        if (end == std::string_view::npos) end = line.size();
+        state.spans.emplace_back(pos, end - pos);
         pos = end;
     }
 
-    return args;
+    state.pos = static_cast<size_t>(crlfPos) + 2;
+    return true;
 }
 
-// ── Main parse entry point ────────────────────────────────────────────────
-std::optional<std::vector<std::string>> RespParser::parse(Buffer& buf) {
+// ── Main parse entry points ───────────────────────────────────────────────
+bool RespParser::parse(Buffer& buf, ParseState& state,
+                       std::vector<std::string_view>& args) {
+    args.clear();
     size_t readable = buf.readableBytes();
-    if (readable == 0) return std::nullopt;
+    if (readable == 0) return false;
 
     const uint8_t* data = buf.readablePtr();
-    size_t bytesConsumed = 0;
+    bool complete = data[0] == '*'
+        ? parseArray(data, readable, state)
+        : parseInline(data, readable, state);
 
-    std::optional<std::vector<std::string>> result;
+    if (!complete) return false;
 
-    if (data[0] == '*') {
-        result = parseArray(data, readable, bytesConsumed);
-    } else {
-        result = parseInline(data, readable, bytesConsumed);
+    args.reserve(state.spans.size());
+    for (const auto& [offset, length] : state.spans) {
+        args.emplace_back(reinterpret_cast<const char*>(data + offset), length);
     }
+    // Only consume bytes after a successful, complete parse. The bytes
+    // themselves stay where they are, so `args` remains valid.
+    size_t frameSize = state.pos;
+    state.reset();
+    buf.consume(frameSize);
+    return true;
+}
 
-    if (result.has_value()) {
-        // Only consume bytes after a successful, complete parse.
-        buf.consume(bytesConsumed);
-    }
+bool RespParser::parse(Buffer& buf, std::vector<std::string_view>& args) {
+    return parse(buf, state_, args);
+}
 
-    return result;
+std::optional<std::vector<std::string>> RespParser::parse(Buffer& buf) {
+    if (!parse(buf, state_, views_)) return std::nullopt;
+    return std::vector<std::string>(views_.begin(), views_.end());
 }
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "net/Buffer.h"
+#include "net/ParseState.h"
 
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 /// Parses RESP2 commands from a Buffer.
@@ -13,30 +15,73 @@
 ///   - Inline commands (text\r\n, split on spaces)
 ///
 /// If the buffer does not contain a complete frame, returns nullopt and
-/// leaves the buffer untouched. Only consumes bytes on successful parse.
+/// leaves the buffer's readable bytes untouched. Only consumes bytes on
+/// successful parse.
+///
+/// Parsing is resumable: progress through an incomplete frame is kept in
+/// a ParseState (one per connection), so each byte is examined once no
+/// matter how many reads the frame takes. Once the length of a large bulk
+/// string is known it records the frame's full size so the connection can
+/// grow its buffer once and read the rest of the payload in place.
 ///
 /// Must NOT know about: Sockets, epoll, commands, the database.
 class RespParser {
 public:
+    /// Bulk strings at least this long set ParseState::expectedBytes.
+    static constexpr int64_t kBigBulkLength = 32 * 1024;
+
+    /// Never presize for more than this (a client can claim any length).
+    static constexpr int64_t kMaxPresizeLength = 512LL * 1024 * 1024;
+
     /// Attempt to parse one complete command from the buffer.
     /// Returns nullopt if data is incomplete.
     /// On success, consumes the parsed bytes from the buffer.
     std::optional<std::vector<std::string>> parse(Buffer& buf);
 
+    /// Zero-copy variant: on success, replaces `args` with views into the
+    /// buffer's bytes, consumes the frame and returns true. Returns false
+    /// (leaving the readable bytes untouched) if data is incomplete. A null
+    /// array or blank inline line yields an empty `args`.
+    ///
+    /// The views stay valid until the buffer is next written to: consume()
+    /// never moves bytes, only ensureWritableBytes() compacts. Callers must
+    /// dispatch every parsed command before reading more into `buf`.
+    ///
+    /// `state` carries the progress through a partial frame from one call
+    /// to the next; it must always be used with the same buffer.
+    bool parse(Buffer& buf, ParseState& state,
+               std::vector<std::string_view>& args);
+
+    /// As above, with a parser-owned state — for a buffer that is only ever
+    /// parsed by this RespParser (AOF replay, tests).
+    bool parse(Buffer& buf, std::vector<std::string_view>& args);
+
 private:
     /// Try to find \r\n starting at `offset` within readable bytes.
     /// Returns the offset of \r, or -1 if not found.
     static int findCRLF(const uint8_t* data, size_t len, size_t offset);
 
-    /// Parse a RESP array (*N\r\n followed by N bulk strings).
-    /// Returns nullopt if incomplete. Does NOT consume from buffer.
-    /// Sets `bytesConsumed` to the total bytes of the complete frame.
-    std::optional<std::vector<std::string>>
-    parseArray(const uint8_t* data, size_t len, size_t& bytesConsumed);
-
-    /// Parse an inline command (read until \r\n, split on spaces).
-    /// Returns nullopt if incomplete. Does NOT consume from buffer.
-    /// Sets `bytesConsumed` to the total bytes of the complete frame.
-    std::optional<std::vector<std::string>>
-    parseInline(const uint8_t* data, size_t len, size_t& bytesConsumed);
+    /// Parse the decimal integer in [data+begin, data+end) the way atoi()
+    /// does, without a temporary string.
+    static int64_t parseLength(const uint8_t* data, size_t begin, size_t end);
+
+    /// Parse the "<length>\r\n" line starting at data[pos] into `value`.
+    /// Returns the offset just past its \r\n, or 0 if the line is
+    /// incomplete. Well-formed lines are read in one pass; anything else
+    /// falls back to findCRLF() + parseLength().
+    static size_t parseLengthLine(const uint8_t* data, size_t len, size_t pos,
+                                  int64_t& value);
+
+    /// Continue parsing a RESP array (*N\r\n followed by N bulk strings)
+    /// from `state`. Returns false if incomplete. Does NOT consume from
+    /// the buffer. On success `state.pos` is the size of the frame.
+    static bool parseArray(const uint8_t* data, size_t len, ParseState& state);
+
+    /// Continue parsing an inline command (read until \r\n, split on
+    /// spaces). Returns false if incomplete; `state.pos` records how far
+    /// the line has been scanned.
+    static bool parseInline(const uint8_t* data, size_t len, ParseState& state);
+
+    ParseState state_;                     // for the state-less overloads
+    std::vector<std::string_view> views_;  // scratch for the owning parse()
 };
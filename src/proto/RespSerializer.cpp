@@ -1,36 +1,154 @@
 #include "proto/RespSerializer.h"
 
+#include <charconv>
+#include <cstring>  // std::memcpy
 #include <string>
 
-void RespSerializer::writeSimpleString(Buffer& buf, std::string_view s) {
-    buf.append("+", 1);
-    buf.append(s.data(), s.size());
-    buf.append("\r\n", 2);
+// ── Pre-encoded fragments ──────────────────────────────────────────────────
+
+/// Longest line a number can produce: prefix, "-9223372036854775808", CRLF.
+static constexpr size_t kMaxNumberLine = 1 + 20 + 2;
+
+/// Bulk strings up to this size are written header+payload+CRLF in one
+/// ReplyChain reservation. Larger ones go piecewise, so a reservation
+/// never leaves more than this much of a block unused.
+static constexpr size_t kSingleCopyLimit = 1024;
+
+/// Encode `<prefix><v>\r\n` into `out` (kMaxNumberLine bytes). Returns
+/// the length.
+static size_t encodeNumberLine(char* out, char prefix, int64_t v) {
+    out[0] = prefix;
+    char* end = std::to_chars(out + 1, out + kMaxNumberLine - 2, v).ptr;
+    end[0] = '\r';
+    end[1] = '\n';
+    return static_cast<size_t>(end + 2 - out);
 }
 
-void RespSerializer::writeError(Buffer& buf, std::string_view msg) {
-    buf.append("-", 1);
-    buf.append(msg.data(), msg.size());
-    buf.append("\r\n", 2);
+/// One table entry. 8 bytes: the longest entry is ":9999\r\n".
+struct Fragment {
+    char    text[7];
+    uint8_t len;
+};
+
+struct FragmentTable {
+    Fragment integers[RespSerializer::kSharedIntegers];      // :N\r\n
+    Fragment bulkHeaders[RespSerializer::kSharedHeaders];    // $N\r\n
+    Fragment arrayHeaders[RespSerializer::kSharedHeaders];   // *N\r\n
+
+    FragmentTable() {
+        for (int64_t i = 0; i < RespSerializer::kSharedIntegers; ++i) {
+            fill(integers[i], ':', i);
+        }
+        for (int64_t i = 0; i < RespSerializer::kSharedHeaders; ++i) {
+            fill(bulkHeaders[i], '$', i);
+            fill(arrayHeaders[i], '*', i);
+        }
+    }
+
+    static void fill(Fragment& f, char prefix, int64_t v) {
+        char tmp[kMaxNumberLine];
+        f.len = static_cast<uint8_t>(encodeNumberLine(tmp, prefix, v));
+        std::memcpy(f.text, tmp, f.len);
+    }
+};
+
+static const FragmentTable g_shared;
+
+/// Write the `$len\r\n` header for a bulk string of `len` bytes into `out`
+/// (kMaxNumberLine bytes). Returns the header length.
+static size_t bulkHeader(char* out, size_t len) {
+    if (len < static_cast<size_t>(RespSerializer::kSharedHeaders)) {
+        const Fragment& f = g_shared.bulkHeaders[len];
+        std::memcpy(out, f.text, sizeof(f.text));
+        return f.len;
+    }
+    return encodeNumberLine(out, '$', static_cast<int64_t>(len));
+}
+
+/// `<prefix><s>\r\n` — simple strings and errors.
+static void writeLine(ReplyChain& buf, char prefix, std::string_view s) {
+    if (s.size() > kSingleCopyLimit) {
+        buf.append(&prefix, 1);
+        buf.append(s.data(), s.size());
+        buf.append("\r\n", 2);
+        return;
+    }
+    char* p = buf.appendSpace(1 + s.size() + 2);
+    p[0] = prefix;
+    std::memcpy(p + 1, s.data(), s.size());
+    p[1 + s.size()] = '\r';
+    p[2 + s.size()] = '\n';
+}
+
+// ── Replies ────────────────────────────────────────────────────────────────
+
+void RespSerializer::writeSimpleString(ReplyChain& buf, std::string_view s) {
+    writeLine(buf, '+', s);
+}
+
+void RespSerializer::writeOk(ReplyChain& buf) {
+    buf.append("+OK\r\n", 5);
+}
+
+void RespSerializer::writeQueued(ReplyChain& buf) {
+    buf.append("+QUEUED\r\n", 9);
+}
+
+void RespSerializer::writePong(ReplyChain& buf) {
+    buf.append("+PONG\r\n", 7);
+}
+
+void RespSerializer::writeError(ReplyChain& buf, std::string_view msg) {
+    writeLine(buf, '-', msg);
+}
+
+void RespSerializer::writeInteger(ReplyChain& buf, int64_t val) {
+    if (val >= 0 && val < kSharedIntegers) {
+        const Fragment& f = g_shared.integers[val];
+        buf.append(f.text, f.len);
+        return;
+    }
+    char line[kMaxNumberLine];
+    buf.append(line, encodeNumberLine(line, ':', val));
 }
 
-void RespSerializer::writeInteger(Buffer& buf, int64_t val) {
-    std::string s = ":" + std::to_string(val) + "\r\n";
-    buf.append(s.data(), s.size());
+void RespSerializer::writeBulkString(ReplyChain& buf, std::string_view s) {
+    char header[kMaxNumberLine];
+    size_t hlen = bulkHeader(header, s.size());
+    if (s.size() > kSingleCopyLimit) {
+        buf.append(header, hlen);
+        buf.append(s.data(), s.size());
+        buf.append("\r\n", 2);
+        return;
+    }
+    char* p = buf.appendSpace(hlen + s.size() + 2);
+    std::memcpy(p, header, hlen);
+    std::memcpy(p + hlen, s.data(), s.size());
+    p[hlen + s.size()] = '\r';
+    p[hlen + s.size() + 1] = '\n';
 }
 
-void RespSerializer::writeBulkString(Buffer& buf, std::string_view s) {
-    std::string header = "$" + std::to_string(s.size()) + "\r\n";
-    buf.append(header.data(), header.size());
-    buf.append(s.data(), s.size());
+void RespSerializer::writeBulkStringOwned(ReplyChain& buf, std::string&& s) {
+    if (s.size() <= kSingleCopyLimit) {
+        writeBulkString(buf, s);
+        return;
+    }
+    char header[kMaxNumberLine];
+    buf.append(header, bulkHeader(header, s.size()));
+    buf.appendOwned(std::move(s));
     buf.append("\r\n", 2);
 }
 
-void RespSerializer::writeNull(Buffer& buf) {
+void RespSerializer::writeNull(ReplyChain& buf) {
     buf.append("$-1\r\n", 5);
 }
 
-void RespSerializer::writeArrayHeader(Buffer& buf, int64_t count) {
-    std::string s = "*" + std::to_string(count) + "\r\n";
-    buf.append(s.data(), s.size());
+void RespSerializer::writeArrayHeader(ReplyChain& buf, int64_t count) {
+    if (count >= 0 && count < kSharedHeaders) {
+        const Fragment& f = g_shared.arrayHeaders[count];
+        buf.append(f.text, f.len);
+        return;
+    }
+    char line[kMaxNumberLine];
+    buf.append(line, encodeNumberLine(line, '*', count));
 }
@@ -1,32 +1,54 @@
 #pragma once
 
-#include "net/Buffer.h"
+#include "net/ReplyChain.h"
 
 #include <cstdint>
+#include <string>
 #include <string_view>
 
-/// Serializes RESP2 responses into a Buffer.
+/// Serializes RESP2 responses into a connection's ReplyChain.
 /// All methods are static — no state needed.
 ///
+/// The most frequent fragments — status replies, small integers, short
+/// bulk and array headers — are encoded once at startup and copied out of
+/// a table; other numbers are formatted with std::to_chars on the stack.
+///
 /// Must NOT know about: Commands, the database, networking.
 class RespSerializer {
 public:
+    /// Integers in [0, kSharedIntegers) come pre-encoded.
+    static constexpr int64_t kSharedIntegers = 10000;
+
+    /// Bulk-string and array headers for lengths in [0, kSharedHeaders)
+    /// come pre-encoded.
+    static constexpr int64_t kSharedHeaders = 1024;
+
     /// Write a simple string response: +msg\r\n
-    static void writeSimpleString(Buffer& buf, std::string_view s);
+    static void writeSimpleString(ReplyChain& buf, std::string_view s);
+
+    /// +OK\r\n, +QUEUED\r\n and +PONG\r\n.
+    static void writeOk(ReplyChain& buf);
+    static void writeQueued(ReplyChain& buf);
+    static void writePong(ReplyChain& buf);
 
     /// Write an error response: -msg\r\n
-    static void writeError(Buffer& buf, std::string_view msg);
+    static void writeError(ReplyChain& buf, std::string_view msg);
 
     /// Write an integer response: :val\r\n
-    static void writeInteger(Buffer& buf, int64_t val);
+    static void writeInteger(ReplyChain& buf, int64_t val);
 
     /// Write a bulk string response: $len\r\ndata\r\n
-    static void writeBulkString(Buffer& buf, std::string_view s);
+    /// Short values are written with a single reservation in the chain.
+    static void writeBulkString(ReplyChain& buf, std::string_view s);
+
+    /// Same as writeBulkString, but takes ownership of `s`: a large value
+    /// is linked into the chain instead of being copied.
+    static void writeBulkStringOwned(ReplyChain& buf, std::string&& s);
 
     /// Write a null bulk string: $-1\r\n
-    static void writeNull(Buffer& buf);
+    static void writeNull(ReplyChain& buf);
 
     /// Write an array header: *count\r\n
     /// Caller writes individual elements after this.
-    static void writeArrayHeader(Buffer& buf, int64_t count);
+    static void writeArrayHeader(ReplyChain& buf, int64_t count);
 };
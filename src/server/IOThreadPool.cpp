@@ -0,0 +1,79 @@
+#include "server/IOThreadPool.h"
+
+#include <csignal>
+#include <pthread.h>  // pthread_sigmask
+
+IOThreadPool::IOThreadPool(int numThreads)
+    : numThreads_(numThreads < 1 ? 1 : numThreads) {
+    // Workers inherit a fully blocked mask: signals stay on the main thread.
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &previous);
+    for (int i = 1; i < numThreads_; ++i) {
+        workers_.emplace_back([this, i]() { workerMain(i); });
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+}
+
+IOThreadPool::~IOThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    startCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void IOThreadPool::run(size_t count, const std::function<void(size_t)>& job) {
+    if (count == 0) return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_       = &job;
+        count_     = count;
+        remaining_ = numThreads_ - 1;
+        ++generation_;
+    }
+    startCv_.notify_all();
+
+    // The caller is thread 0 of the batch.
+    for (size_t i = 0; i < count; i += static_cast<size_t>(numThreads_)) {
+        job(i);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    doneCv_.wait(lock, [this]() { return remaining_ == 0; });
+    job_ = nullptr;
+}
+
+void IOThreadPool::workerMain(int index) {
+    uint64_t seen = 0;
+    while (true) {
+        const std::function<void(size_t)>* job;
+        size_t count;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            startCv_.wait(lock, [this, seen]() {
+                return stopping_ || generation_ != seen;
+            });
+            if (stopping_) return;
+            seen  = generation_;
+            job   = job_;
+            count = count_;
+        }
+
+        for (size_t i = static_cast<size_t>(index); i < count;
+             i += static_cast<size_t>(numThreads_)) {
+            (*job)(i);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--remaining_ == 0) {
+                doneCv_.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed pool of I/O threads that run one batch of jobs at a time.
+///
+/// The calling (shard) thread takes part in every batch: item i of a batch
+/// runs on thread i % size(), where thread 0 is the caller. run() returns
+/// only when every item is done, so between batches the caller owns all
+/// state again — no per-connection locking is needed, as long as a batch
+/// never touches the same connection from two items.
+///
+/// Used for --io-threads: socket reads + RESP parsing and socket writes
+/// run here, command execution stays on the shard thread.
+///
+/// Must NOT know about: connections, commands, the database.
+class IOThreadPool {
+public:
+    /// `numThreads` includes the calling thread; numThreads - 1 workers
+    /// are spawned.
+    explicit IOThreadPool(int numThreads);
+    ~IOThreadPool();
+
+    IOThreadPool(const IOThreadPool&) = delete;
+    IOThreadPool& operator=(const IOThreadPool&) = delete;
+
+    int size() const { return numThreads_; }
+
+    /// Run job(i) for every i in [0, count) across the pool and wait.
+    void run(size_t count, const std::function<void(size_t)>& job);
+
+private:
+    void workerMain(int index);
+
+    int numThreads_;
+    std::vector<std::thread> workers_;
+
+    std::mutex              mutex_;
+    std::condition_variable startCv_;     // workers: a new batch is ready
+    std::condition_variable doneCv_;      // caller: every worker finished
+    uint64_t generation_ = 0;             // bumped once per batch
+    bool     stopping_ = false;
+    size_t   count_ = 0;                  // items in the current batch
+    const std::function<void(size_t)>* job_ = nullptr;
+    int      remaining_ = 0;              // workers still busy on the batch
+};
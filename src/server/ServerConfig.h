@@ -0,0 +1,62 @@
+#pragma once
+
+#include "net/EventLoop.h"
+#include "persistence/AOFWriter.h"
+#include "store/Eviction.h"
+#include "store/Listpack.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/// Startup configuration parsed from the command line in main.cpp.
+///
+///   simple-redis [port] [--port N] [--threads N] [--io-threads N]
+///                [--io-backend epoll|io_uring] [--hz N] [--timeout SECONDS]
+///                [--appendfsync always|everysec|no]
+///                [--maxmemory BYTES] [--maxmemory-policy POLICY]
+///                [--{hash,set,zset}-max-listpack-{entries,value} N]
+///                [--set-max-intset-entries N] [--list-max-listpack-size N]
+struct ServerConfig {
+    int port = 6379;
+
+    /// Number of shard threads. Each shard owns an EventLoop, a Database
+    /// and a disjoint slice of the keyspace (by key hash). 1 = the classic
+    /// single-threaded server.
+    int threads = 1;
+
+    /// Threads (including the shard thread) that perform socket reads,
+    /// RESP parsing and socket writes. Commands still execute on the shard
+    /// thread. 1 = no offload. Only valid with threads == 1.
+    int ioThreads = 1;
+
+    /// Readiness (epoll) or completion (io_uring) socket I/O. io_uring
+    /// falls back to epoll at startup if the kernel can't provide it.
+    EventLoop::Backend ioBackend = EventLoop::Backend::EPOLL;
+
+    /// Frequency of each shard's background cron (active expiry), in calls
+    /// per second: 1 .. kMaxHz, as in Redis. Higher reclaims expired keys
+    /// sooner at the cost of more idle wakeups. CONFIG SET hz at runtime.
+    int hz = 10;
+    static constexpr int kMaxHz = 500;
+
+    /// Close clients idle for this many seconds; 0 = never. Pub/sub
+    /// subscribers are exempt. CONFIG SET timeout at runtime.
+    int timeout = 0;
+
+    /// When the AOF is fsynced: every loop iteration before its replies
+    /// go out (always), once a second (everysec, as Redis), or never.
+    AOFWriter::FsyncPolicy appendFsync = AOFWriter::FsyncPolicy::EVERYSEC;
+
+    /// Limit on stored data (Database::usedMemory()), split evenly across
+    /// shards. 0 = unlimited. Accepts k/kb/m/mb/g/gb suffixes as Redis does.
+    size_t maxMemory = 0;
+
+    /// What writes do past maxMemory: evict keys, or fail with -OOM.
+    EvictionPolicy maxMemoryPolicy = EvictionPolicy::NOEVICTION;
+
+    /// Size limits under which hashes, sets and sorted sets stay in the
+    /// compact listpack encoding (Redis defaults: 128 entries, 64 bytes),
+    /// integer sets in an intset (512 members), and the size of a list's
+    /// quicklist chunks (8 KB).
+    EncodingConfig encoding;
+};
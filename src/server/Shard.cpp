@@ -0,0 +1,1140 @@
+#include "server/Shard.h"
+#include "persistence/AOFWriter.h"
+#include "proto/RespSerializer.h"
+#include "store/HashTable.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// keyOwner() results for commands that don't map to a single shard.
+static constexpr int kKeyless   = -1;
+static constexpr int kCrossSlot = -2;
+
+static const char* kCrossSlotError =
+    "CROSSSLOT Keys in request don't hash to the same slot";
+
+static const char* kOomError =
+    "OOM command not allowed when used memory > 'maxmemory'.";
+
+// EVERYSEC fsync cadence, and how often idle clients are looked for.
+static constexpr int kFsyncPeriodMs = 1000;
+static constexpr int kClientsCronPeriodMs = 1000;
+
+/// Copy a command's arguments out of the input buffer, for anything that
+/// outlives the handler call (MULTI queue, inter-shard requests).
+static std::vector<std::string> ownedArgs(const CommandArgs& args) {
+    return std::vector<std::string>(args.begin(), args.end());
+}
+
+/// View an owned argument vector as CommandArgs, reusing `views`.
+static const CommandArgs& argsOf(const std::vector<std::string>& owned,
+                                 CommandArgs& views) {
+    views.assign(owned.begin(), owned.end());
+    return views;
+}
+
+/// Return the shard that owns every key of the command, kKeyless if the
+/// command has no keys (or fails arity — dispatch reports that), or
+/// kCrossSlot if its keys live on different shards.
+static int keyOwner(CommandId id, const CommandArgs& args, size_t numShards) {
+    const CommandSpec& spec = CommandTable::spec(id);
+    if (spec.firstKey <= 0) return kKeyless;
+
+    int argc = static_cast<int>(args.size());
+    bool arityOk = spec.arity > 0 ? argc == spec.arity
+                                  : argc >= -spec.arity;
+    if (!arityOk) return kKeyless;
+
+    int last = spec.lastKey < 0 ? argc + spec.lastKey : spec.lastKey;
+    int step = std::max(1, spec.keyStep);
+    int owner = kKeyless;
+    for (int i = spec.firstKey; i <= last && i < argc; i += step) {
+        int s = static_cast<int>(Shard::shardOf(args[i], numShards));
+        if (owner == kKeyless) {
+            owner = s;
+        } else if (s != owner) {
+            return kCrossSlot;
+        }
+    }
+    return owner;
+}
+
+/// Translate a shard-local SCAN reply into a global cursor.
+/// Global cursor = local * numShards + shard; when a shard finishes, the
+/// iteration moves on to cursor 0 of the next shard.
+static std::string rewriteScanCursor(const std::string& reply,
+                                     uint32_t shard, size_t numShards) {
+    // Expected shape: *2\r\n$L\r\n<cursor>\r\n<keys array>
+    if (reply.empty() || reply[0] != '*') return reply;  // error passthrough
+    size_t lenEnd = reply.find("\r\n", reply.find("\r\n") + 2);
+    if (lenEnd == std::string::npos) return reply;
+    size_t curStart = lenEnd + 2;
+    size_t curEnd   = reply.find("\r\n", curStart);
+    if (curEnd == std::string::npos) return reply;
+
+    uint64_t local = std::strtoull(reply.c_str() + curStart, nullptr, 10);
+    uint64_t global;
+    if (local != 0) {
+        global = local * numShards + shard;
+    } else {
+        global = (shard + 1 < numShards) ? shard + 1 : 0;
+    }
+
+    std::string cursor = std::to_string(global);
+    std::string out = "*2\r\n$" + std::to_string(cursor.size()) + "\r\n";
+    out += cursor;
+    out.append(reply, curEnd, std::string::npos);
+    return out;
+}
+
+// ── Construction ───────────────────────────────────────────────────────────
+
+Shard::Shard(uint32_t id, const ServerConfig& config, AOFWriter& aof)
+    : id_(id),
+      config_(config),
+      aof_(aof),
+      listener_("0.0.0.0", config.port, config.threads > 1),
+      eventLoop_(config.ioBackend) {
+    wakeFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        throw std::runtime_error("eventfd() failed");
+    }
+    eventLoop_.watchAccept(listener_.fd());
+    eventLoop_.addFd(wakeFd_, EPOLLIN);
+
+    // Each shard holds its share of the keyspace, and of maxmemory.
+    db_.setMaxMemory(config.maxMemory / static_cast<size_t>(config.threads),
+                     config.maxMemoryPolicy);
+    db_.setEncodingConfig(config.encoding);
+
+    metrics_.tcpPort   = static_cast<uint16_t>(config.port);
+    metrics_.ioBackend = EventLoop::backendName(eventLoop_.backend());
+
+    if (config.ioThreads > 1) {
+        ioPool_ = std::make_unique<IOThreadPool>(config.ioThreads);
+        metrics_.ioThreads = ioPool_->size();
+    }
+
+    // Attach the handlers that need this shard's state.
+    ServerCommands::bindAll(commandTable_, metrics_);
+    bindShardCommands();
+
+    // Housekeeping, each on its own timer: active expiry at `hz`, the
+    // idle-client check once a second and, on shard 0 (which owns the
+    // shared AOF file), the EVERYSEC fsync. The rewrite child is polled
+    // only while one runs — see watchRewrite().
+    clientTimeoutSec_ = config.timeout;
+    setHz(config.hz);
+    eventLoop_.addPeriodicTimer(kClientsCronPeriodMs,
+                                [this]() { closeIdleClients(); });
+    if (id_ == 0) {
+        eventLoop_.addPeriodicTimer(kFsyncPeriodMs, [this]() { aof_.tick(); });
+    }
+}
+
+Shard::~Shard() {
+    for (auto& [fd, conn] : connections_) {
+        eventLoop_.removeFd(fd);
+    }
+    connections_.clear();
+    if (wakeFd_ >= 0) {
+        ::close(wakeFd_);
+    }
+}
+
+void Shard::setPeers(std::vector<Shard*> peers) {
+    peers_ = std::move(peers);
+    wakePending_.assign(peers_.size(), 0);
+}
+
+uint32_t Shard::shardOf(std::string_view key, size_t numShards) {
+    if (numShards <= 1) return 0;
+    // FNV-1a's high bits barely move for short keys, so run the hash
+    // through a 64-bit finalizer (MurmurHash3 fmix64) and take the high
+    // half — independent of the low bits HashTable uses for slot indexes.
+    uint64_t h = HashTable::hash(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t>((h >> 32) % numShards);
+}
+
+void Shard::replay(const std::vector<Shard*>& shards, Connection& dummy,
+                   const CommandArgs& args) {
+    CommandId id = CommandTable::resolve(args[0]);
+    Route r = route(id, args, shards.size());
+    switch (r.kind) {
+    case Route::Kind::REMOTE: {
+        Shard& owner = *shards[r.shard];
+        owner.commandTable_.dispatch(id, owner.db_, dummy, args);
+        break;
+    }
+    case Route::Kind::BROADCAST:
+        for (Shard* s : shards) {
+            s->commandTable_.dispatch(id, s->db_, dummy, args);
+        }
+        break;
+    default:
+        shards[0]->commandTable_.dispatch(id, shards[0]->db_, dummy, args);
+        break;
+    }
+}
+
+// ── Shard-state commands (moved from main.cpp) ─────────────────────────────
+
+void Shard::bindShardCommands() {
+    // BGREWRITEAOF — needs the AOFWriter. The fork()ed child can only
+    // snapshot a consistent keyspace when no other shard thread is
+    // mutating, so it is limited to single-shard mode.
+    commandTable_.bind(CommandId::BGREWRITEAOF,
+        [](void* ctx, Database& cmdDb, Connection& conn,
+           const CommandArgs& /*args*/) {
+            Shard& self = *static_cast<Shard*>(ctx);
+            if (self.peers_.size() > 1) {
+                RespSerializer::writeError(conn.outgoing(),
+                    "ERR BGREWRITEAOF is not supported with --threads > 1");
+                return;
+            }
+            self.aof_.triggerRewrite(cmdDb);
+            self.watchRewrite();
+            RespSerializer::writeSimpleString(conn.outgoing(),
+                "Background append only file rewriting started");
+        }, this);
+
+    // EXEC — re-dispatches the queued commands through this shard's table.
+    commandTable_.bind(CommandId::EXEC,
+        [](void* ctx, Database& /*cmdDb*/, Connection& conn,
+           const CommandArgs& /*args*/) {
+            if (!conn.txn.has_value()) {
+                RespSerializer::writeError(conn.outgoing(),
+                                           "ERR EXEC without MULTI");
+                return;
+            }
+            static_cast<Shard*>(ctx)->runTransaction(
+                conn, conn.txn->queuedCommands);
+            // Clear transaction state.
+            conn.txn.reset();
+        }, this);
+
+    // SUBSCRIBE — needs the PubSubRegistry.
+    commandTable_.bind(CommandId::SUBSCRIBE,
+        [](void* ctx, Database& /*cmdDb*/, Connection& conn,
+           const CommandArgs& args) {
+            PubSubRegistry& pubsub = static_cast<Shard*>(ctx)->pubsub_;
+            // SUBSCRIBE channel [channel ...]
+            for (size_t i = 1; i < args.size(); ++i) {
+                size_t numSubs = pubsub.subscribe(std::string(args[i]), conn);
+
+                // Reply: ["subscribe", channelName, numSubscriptions]
+                RespSerializer::writeArrayHeader(conn.outgoing(), 3);
+                RespSerializer::writeBulkString(conn.outgoing(), "subscribe");
+                RespSerializer::writeBulkString(conn.outgoing(), args[i]);
+                RespSerializer::writeInteger(conn.outgoing(),
+                                             static_cast<int64_t>(numSubs));
+            }
+        }, this);
+
+    // UNSUBSCRIBE — needs the PubSubRegistry.
+    commandTable_.bind(CommandId::UNSUBSCRIBE,
+        [](void* ctx, Database& /*cmdDb*/, Connection& conn,
+           const CommandArgs& args) {
+            PubSubRegistry& pubsub = static_cast<Shard*>(ctx)->pubsub_;
+            if (args.size() <= 1) {
+                // Unsubscribe from all channels.
+                if (conn.subscribedChannels.empty()) {
+                    // No subscriptions — reply with 0 count.
+                    RespSerializer::writeArrayHeader(conn.outgoing(), 3);
+                    RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
+                    RespSerializer::writeNull(conn.outgoing());
+                    RespSerializer::writeInteger(conn.outgoing(), 0);
+                } else {
+                    auto channels = conn.subscribedChannels;  // copy — set will be modified
+                    for (const auto& ch : channels) {
+                        size_t remaining = pubsub.unsubscribe(ch, conn);
+                        RespSerializer::writeArrayHeader(conn.outgoing(), 3);
+                        RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
+                        RespSerializer::writeBulkString(conn.outgoing(), ch);
+                        RespSerializer::writeInteger(conn.outgoing(),
+                                                     static_cast<int64_t>(remaining));
+                    }
+                }
+            } else {
+                for (size_t i = 1; i < args.size(); ++i) {
+                    size_t remaining =
+                        pubsub.unsubscribe(std::string(args[i]), conn);
+                    RespSerializer::writeArrayHeader(conn.outgoing(), 3);
+                    RespSerializer::writeBulkString(conn.outgoing(), "unsubscribe");
+                    RespSerializer::writeBulkString(conn.outgoing(), args[i]);
+                    RespSerializer::writeInteger(conn.outgoing(),
+                                                 static_cast<int64_t>(remaining));
+                }
+            }
+        }, this);
+
+    // PUBLISH — needs the PubSubRegistry. Runs on every shard in sharded
+    // mode (Fanout::SUM_INTEGERS).
+    commandTable_.bind(CommandId::PUBLISH,
+        [](void* ctx, Database& /*cmdDb*/, Connection& conn,
+           const CommandArgs& args) {
+            // PUBLISH channel message
+            size_t delivered = static_cast<Shard*>(ctx)->pubsub_.publish(
+                std::string(args[1]), args[2]);
+            RespSerializer::writeInteger(conn.outgoing(),
+                                         static_cast<int64_t>(delivered));
+        }, this);
+
+    // CONFIG — the settings live on the shard (and its event loop).
+    commandTable_.bind(CommandId::CONFIG,
+        [](void* ctx, Database& /*cmdDb*/, Connection& conn,
+           const CommandArgs& args) {
+            static_cast<Shard*>(ctx)->configCommand(conn, args);
+        }, this);
+}
+
+// ── Timers and settings ────────────────────────────────────────────────────
+
+void Shard::setHz(int hz) {
+    hz_ = hz;
+    metrics_.hz = hz;
+    if (cronTimer_) eventLoop_.cancelTimer(cronTimer_);
+    cronTimer_ = eventLoop_.addPeriodicTimer(cronPeriodMs(), [this]() {
+        db_.activeExpireCycle(ExpireCycle::SLOW, cronPeriodMs());
+    });
+}
+
+void Shard::closeIdleClients() {
+    if (clientTimeoutSec_ == 0) return;
+    auto now = std::chrono::steady_clock::now();
+    auto limit = std::chrono::seconds(clientTimeoutSec_);
+    for (auto& [fd, conn] : connections_) {
+        // Subscribers wait on PUBLISH; a client still owed replies is busy.
+        if (!conn->subscribedChannels.empty() || hasPending(*conn)) continue;
+        if (now - conn->lastActivity() > limit) conn->setWantClose(true);
+    }
+}
+
+void Shard::watchRewrite() {
+    if (rewriteTimer_ || !aof_.isRewriting()) return;
+    rewriteTimer_ = eventLoop_.addPeriodicTimer(cronPeriodMs(), [this]() {
+        aof_.checkRewriteComplete();
+        if (!aof_.isRewriting()) {
+            eventLoop_.cancelTimer(rewriteTimer_);
+            rewriteTimer_ = 0;
+        }
+    });
+}
+
+void Shard::configCommand(Connection& conn, const CommandArgs& args) {
+    std::string sub(args[1]);
+    std::transform(sub.begin(), sub.end(), sub.begin(), ::toupper);
+
+    if (sub == "GET" && args.size() >= 3) {
+        // CONFIG GET pattern [pattern ...] — "*" or an exact name.
+        std::pair<const char*, int> settings[] = {
+            {"hz", hz_}, {"timeout", clientTimeoutSec_}};
+        std::vector<std::pair<const char*, int>> matched;
+        for (const auto& setting : settings) {
+            for (size_t i = 2; i < args.size(); ++i) {
+                std::string pattern(args[i]);
+                std::transform(pattern.begin(), pattern.end(),
+                               pattern.begin(), ::tolower);
+                if (pattern == "*" || pattern == setting.first) {
+                    matched.push_back(setting);
+                    break;
+                }
+            }
+        }
+        RespSerializer::writeArrayHeader(conn.outgoing(),
+                                         static_cast<int64_t>(matched.size() * 2));
+        for (const auto& [name, value] : matched) {
+            RespSerializer::writeBulkString(conn.outgoing(), name);
+            RespSerializer::writeBulkString(conn.outgoing(),
+                                            std::to_string(value));
+        }
+        return;
+    }
+
+    if (sub == "SET" && args.size() >= 4 && args.size() % 2 == 0) {
+        // CONFIG SET name value [name value ...] — all or nothing.
+        int hz = hz_;
+        int timeout = clientTimeoutSec_;
+        for (size_t i = 2; i < args.size(); i += 2) {
+            std::string name(args[i]);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            int* target = name == "hz"        ? &hz
+                        : name == "timeout"   ? &timeout
+                        : nullptr;
+            if (!target) {
+                RespSerializer::writeError(conn.outgoing(),
+                    "ERR Unknown option or number of arguments for CONFIG SET - '" +
+                    std::string(args[i]) + "'");
+                return;
+            }
+            int min = target == &hz ? 1 : 0;
+            int max = target == &hz ? ServerConfig::kMaxHz : INT_MAX;
+            int value = 0;
+            const char* end = args[i + 1].data() + args[i + 1].size();
+            auto [ptr, ec] = std::from_chars(args[i + 1].data(), end, value);
+            if (ec != std::errc() || ptr != end || value < min || value > max) {
+                RespSerializer::writeError(conn.outgoing(),
+                    "ERR CONFIG SET failed (possibly related to argument '" +
+                    name + "') - argument must be between " +
+                    std::to_string(min) + " and " + std::to_string(max) +
+                    " inclusive");
+                return;
+            }
+            *target = value;
+        }
+        if (hz != hz_) setHz(hz);
+        clientTimeoutSec_ = timeout;
+        RespSerializer::writeOk(conn.outgoing());
+        return;
+    }
+
+    if (sub == "GET" || sub == "SET") {
+        std::string lower(sub);
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR wrong number of arguments for 'config|" + lower + "' command");
+        return;
+    }
+    RespSerializer::writeError(conn.outgoing(),
+        "ERR unknown subcommand '" + std::string(args[1]) +
+        "'. Try CONFIG GET or CONFIG SET.");
+}
+
+// ── Event loop ─────────────────────────────────────────────────────────────
+
+void Shard::run(const std::atomic<bool>& running) {
+    while (running.load(std::memory_order_relaxed)) {
+        // Update connected clients count and AOF state for INFO command.
+        metrics_.connectedClients = connections_.size();
+        metrics_.aofEnabled = aof_.isEnabled();
+        metrics_.aofRewriteInProgress = aof_.isRewriting();
+        metrics_.aofPendingBioFsync = aof_.pendingFsyncs();
+        metrics_.aofDelayedFsync = aof_.delayedFsyncs();
+        metrics_.aofLastFsyncDurationUs = aof_.lastFsyncDurationUs();
+
+        // Before sleeping: a short expiry pass if the last one fell behind.
+        db_.activeExpireCycle(ExpireCycle::FAST, cronPeriodMs());
+
+        // Sleep until I/O or the nearest timer; the cron timer bounds it,
+        // so a cleared `running` is noticed within one cron period.
+        int n = eventLoop_.poll(-1);
+        if (n < 0) break;              // backend error
+
+        for (int i = 0; i < n; ++i) {
+            const IOEvent& ev = eventLoop_.event(i);
+            int fd = ev.fd;
+
+            if (ev.kind == IOEvent::Kind::ACCEPTED) {
+                addClient(ev.result);
+            } else if (ev.kind != IOEvent::Kind::READY) {
+                handleCompletion(ev);
+            } else if (fd == listener_.fd()) {
+                acceptClients();
+            } else if (fd == wakeFd_) {
+                // Reset the eventfd counter; the inbox is drained below.
+                uint64_t counter = 0;
+                ssize_t r = ::read(wakeFd_, &counter, sizeof(counter));
+                (void)r;
+            } else if (ioPool_) {
+                queueClientEvent(fd, ev.events);
+            } else {
+                handleClientEvent(fd, ev.events);
+            }
+        }
+        if (ioPool_) {
+            processReadQueue();
+        }
+
+        // ── Inter-shard requests and replies ───────────────────────────
+        drainInbox();
+
+        // ── Advance incremental rehashing ───────────────────────────────
+        db_.rehashStep();
+
+        // Wake peers once per tick, however many messages we posted.
+        wakePeers();
+
+        // ── Group commit: one AOF write() for every write command this
+        // tick — and under ALWAYS one fsync() — before any reply leaves.
+        // A batch postponed behind a background fsync is retried here.
+        if (!aof_.flushedThrough(aofOffset_) || aof_.writePostponed()) {
+            aof_.flush();
+        }
+
+        // Threaded I/O writes replies right away instead of waiting for
+        // EPOLLOUT; whatever the socket can't take is left to the sweep.
+        if (ioPool_) {
+            flushWrites();
+        }
+
+        // ── Sweep: enable EPOLLOUT for connections with pending output ──
+        // Necessary because PUBLISH and cross-shard replies fill a
+        // connection's outgoing buffer outside its own fd's handler.
+        // With completion I/O the bytes are handed to the backend instead;
+        // they all go out in the next poll's single submission.
+        bool completionIO = eventLoop_.completionIO();
+        for (auto& [sfd, sptr] : connections_) {
+            Connection& conn = *sptr;
+            if (conn.wantClose()) continue;
+            ReplyChain& out = conn.outgoing();
+            if (out.readableBytes() > 0 && completionIO) {
+                struct iovec iov[16];
+                while (out.readableBytes() > 0) {
+                    int count = out.gather(iov, 16);
+                    size_t queued = 0;
+                    for (int i = 0; i < count; ++i) {
+                        eventLoop_.send(sfd,
+                                        static_cast<uint8_t*>(iov[i].iov_base),
+                                        iov[i].iov_len);
+                        queued += iov[i].iov_len;
+                    }
+                    out.consume(queued);
+                }
+            } else if (out.readableBytes() > 0) {
+                conn.setWantWrite(true);
+                uint32_t desired = 0;
+                if (conn.wantRead())  desired |= EPOLLIN;
+                if (conn.wantWrite()) desired |= EPOLLOUT;
+                eventLoop_.modFd(sfd, desired);
+            } else if (!conn.wantRead() && !hasPending(conn) &&
+                       !eventLoop_.sendPending(sfd)) {
+                // Read side closed and the last reply went out.
+                conn.setWantClose(true);
+            }
+        }
+
+        // ── Cleanup closed connections ─────────────────────────────────
+        std::vector<int> toClose;
+        for (auto& [cfd, cptr] : connections_) {
+            if (cptr->wantClose()) {
+                toClose.push_back(cfd);
+            }
+        }
+        for (int cfd : toClose) {
+            closeConnection(cfd);
+        }
+    }
+}
+
+void Shard::acceptClients() {
+    // Drain all pending connections (level-triggered).
+    while (true) {
+        int clientFd = listener_.acceptClient();
+        if (clientFd < 0) break;  // EAGAIN — no more pending
+        addClient(clientFd);
+    }
+}
+
+void Shard::addClient(int fd) {
+    auto conn = std::make_unique<Connection>(fd);
+    conn->id = nextConnId_++;
+    eventLoop_.watchRecv(fd);
+    connections_[fd] = std::move(conn);
+}
+
+void Shard::handleCompletion(const IOEvent& ev) {
+    auto it = connections_.find(ev.fd);
+    if (it == connections_.end()) return;  // stale event
+    Connection& conn = *it->second;
+
+    if (ev.kind == IOEvent::Kind::FAILED) {
+        conn.setWantClose(true);
+        return;
+    }
+    if (ev.len == 0) {
+        // EOF. Keep the connection alive to flush any outgoing data.
+        conn.setWantRead(false);
+        return;
+    }
+    conn.reserveIncoming(ev.len);
+    conn.incoming().append(ev.data, ev.len);
+    conn.updateActivity();
+    processCommands(conn);
+}
+
+void Shard::handleClientEvent(int fd, uint32_t events) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;  // stale event
+    Connection& conn = *it->second;
+
+    // Fatal error — close immediately.
+    if (events & EPOLLERR) {
+        conn.setWantClose(true);
+        return;
+    }
+
+    // Readable (EPOLLIN or EPOLLHUP — HUP may still have data).
+    if (events & (EPOLLIN | EPOLLHUP)) {
+        if (!conn.handleRead()) {
+            // EOF or error on read side.  Stop reading but keep
+            // the connection alive to flush any outgoing data.
+            conn.setWantRead(false);
+        }
+        processCommands(conn);
+        if (conn.outgoing().readableBytes() > 0) {
+            conn.setWantWrite(true);
+        }
+    }
+
+    // Writable — unless this tick logged writes the AOF hasn't flushed:
+    // their replies wait for the group commit, and the level-triggered
+    // EPOLLOUT fires again on the next poll.
+    if ((events & EPOLLOUT) && !conn.wantClose() &&
+        aof_.flushedThrough(aofOffset_)) {
+        if (!conn.handleWrite()) {
+            conn.setWantClose(true);
+        } else if (conn.outgoing().readableBytes() == 0) {
+            conn.setWantWrite(false);
+        }
+    }
+
+    // Close if read side is done and nothing left to write (or owed).
+    if (!conn.wantRead() && conn.outgoing().readableBytes() == 0 &&
+        !hasPending(conn)) {
+        conn.setWantClose(true);
+    }
+
+    // ── Update epoll registration for this fd ──────────────────────────
+    if (!conn.wantClose()) {
+        uint32_t desired = 0;
+        if (conn.wantRead())  desired |= EPOLLIN;
+        if (conn.wantWrite()) desired |= EPOLLOUT;
+        eventLoop_.modFd(fd, desired);
+    }
+}
+
+// ── Parse / dispatch ───────────────────────────────────────────────────────
+
+void Shard::processCommands(Connection& conn) {
+    // Commands an I/O thread already parsed come first.
+    for (auto& cmd : conn.parsedCommands) {
+        processCommand(conn, cmd);
+    }
+    conn.parsedCommands.clear();
+
+    // Parse/dispatch loop: handle pipelining. Each command is executed
+    // straight out of the input buffer before the next one is parsed.
+    while (parser_.parse(conn.incoming(), conn.parseState, argv_)) {
+        if (argv_.empty()) continue;  // empty command (null array)
+        processCommand(conn, argv_);
+    }
+}
+
+void Shard::processCommand(Connection& conn, const CommandArgs& cmd) {
+    // While replies from other shards are outstanding, anything this
+    // command writes must queue behind them to preserve reply order.
+    size_t before = conn.outgoing().readableBytes();
+    bool queueBehind = hasPending(conn);
+
+    // Resolve the name once; the gates below only look at flags.
+    CommandId id = CommandTable::resolve(cmd[0]);
+    uint32_t flags = CommandTable::spec(id).flags;
+
+    // ── Subscriber mode gate (Phase 6) ─────────────────────────────
+    // In subscriber mode, only kCmdPubSub commands are allowed
+    // (SUBSCRIBE, UNSUBSCRIBE, PING).
+    if (conn.inSubscribeMode() && !(flags & kCmdPubSub)) {
+        RespSerializer::writeError(conn.outgoing(),
+            "ERR Can't execute '" + std::string(cmd[0]) +
+            "': only (P)SUBSCRIBE / (P)UNSUBSCRIBE / "
+            "PING / QUIT are allowed in this context");
+    } else if (conn.txn.has_value() && !(flags & kCmdNoMulti)) {
+        // ── Transaction queuing (Phase 6) ──────────────────────────
+        // If in MULTI mode, queue commands instead of executing
+        // (except kCmdNoMulti ones: EXEC, DISCARD, MULTI).
+        conn.txn->queuedCommands.push_back(ownedArgs(cmd));
+        RespSerializer::writeQueued(conn.outgoing());
+    } else if (peers_.size() == 1 ||
+               !routeCommand(conn, cmd, id)) {
+        execute(conn, cmd, id, true);
+    }
+
+    if (queueBehind) {
+        size_t written = conn.outgoing().readableBytes() - before;
+        if (written > 0) {
+            deliver(conn, conn.outgoing().takeTail(written));
+        }
+    }
+}
+
+bool Shard::makeRoomForWrite(uint32_t flags) {
+    evicted_.clear();
+    bool fits = db_.evictIfNeeded(evicted_);
+    if (aof_.isEnabled()) {
+        // Replaying the AOF must not resurrect evicted keys.
+        for (const auto& key : evicted_) {
+            aofOffset_ = aof_.log({"DEL", key});
+        }
+    }
+    return fits || !(flags & kCmdDenyOom);
+}
+
+void Shard::execute(Connection& conn, const CommandArgs& args,
+                    CommandId id, bool logAof) {
+    uint32_t flags = CommandTable::spec(id).flags;
+    if ((flags & kCmdWrite) && !makeRoomForWrite(flags)) {
+        RespSerializer::writeError(conn.outgoing(), kOomError);
+        return;
+    }
+
+    // ── Timed dispatch (Phase 7) ───────────────────────────────────────
+    auto dispatchStart = std::chrono::steady_clock::now();
+    commandTable_.dispatch(id, db_, conn, args);
+    auto dispatchEnd = std::chrono::steady_clock::now();
+
+    int64_t durationUs =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            dispatchEnd - dispatchStart).count();
+    metrics_.totalCommandsProcessed++;
+    metrics_.recordLatency(durationUs);
+    metrics_.maybeRecordSlowLog(durationUs, args);
+
+    // INV-1: Log to AOF only AFTER successful dispatch, and only for
+    // kCmdWrite commands (EXEC is not one — it logs its own queued
+    // write commands). Fan-out legs on peer shards are not logged; the
+    // originating shard logs the command once.
+    if (logAof && (flags & kCmdWrite) && aof_.isEnabled()) {
+        aofOffset_ = aof_.log(args);
+    }
+}
+
+std::string Shard::executeCaptured(Connection& conn, const CommandArgs& args,
+                                   CommandId id, bool logAof) {
+    ReplyChain& out = conn.outgoing();
+    size_t before = out.readableBytes();
+    execute(conn, args, id, logAof);
+    return out.takeTail(out.readableBytes() - before);
+}
+
+void Shard::runTransaction(Connection& conn,
+                           const std::vector<std::vector<std::string>>& queued) {
+    // Write the array header for the results.
+    RespSerializer::writeArrayHeader(conn.outgoing(),
+                                     static_cast<int64_t>(queued.size()));
+
+    // Execute each queued command. The block was admitted as a whole, so
+    // writes evict as needed but are not refused midway.
+    CommandArgs views;
+    for (const auto& qcmd : queued) {
+        const CommandArgs& args = argsOf(qcmd, views);
+        CommandId id = CommandTable::resolve(args[0]);
+        if (CommandTable::spec(id).flags & kCmdWrite) makeRoomForWrite(0);
+        commandTable_.dispatch(id, db_, conn, args);
+
+        // Log write commands to AOF.
+        if ((CommandTable::spec(id).flags & kCmdWrite) && aof_.isEnabled()) {
+            aofOffset_ = aof_.log(args);
+        }
+    }
+}
+
+// ── Threaded I/O ───────────────────────────────────────────────────────────
+
+bool Shard::offload(size_t count, const std::function<void(size_t)>& job) {
+    if (count < kMinOffloadPerThread * static_cast<size_t>(ioPool_->size())) {
+        for (size_t i = 0; i < count; ++i) job(i);
+        return false;
+    }
+    ioPool_->run(count, job);
+    return true;
+}
+
+void Shard::queueClientEvent(int fd, uint32_t events) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;  // stale event
+    Connection& conn = *it->second;
+
+    // Fatal error — close immediately.
+    if (events & EPOLLERR) {
+        conn.setWantClose(true);
+        return;
+    }
+    // EPOLLOUT needs no bookkeeping: flushWrites() visits every client
+    // with pending output.
+    if (events & (EPOLLIN | EPOLLHUP)) {
+        readQueue_.push_back(&conn);
+    }
+}
+
+void Shard::processReadQueue() {
+    if (readQueue_.empty()) return;
+
+    // Phase 1 (pool): read() + parse. Each item touches only its own
+    // connection, and RespParser holds no state.
+    bool offloaded = offload(readQueue_.size(), [this](size_t i) {
+        Connection& conn = *readQueue_[i];
+        if (!conn.handleRead()) {
+            // EOF or error on read side.  Stop reading but keep
+            // the connection alive to flush any outgoing data.
+            conn.setWantRead(false);
+        }
+        RespParser parser;
+        CommandArgs args;
+        while (parser.parse(conn.incoming(), conn.parseState, args)) {
+            if (!args.empty()) conn.parsedCommands.push_back(std::move(args));
+        }
+    });
+    if (offloaded) metrics_.ioThreadedReadsProcessed += readQueue_.size();
+
+    // Phase 2 (this thread): execute, in arrival order.
+    for (Connection* conn : readQueue_) {
+        processCommands(*conn);
+    }
+    readQueue_.clear();
+}
+
+void Shard::flushWrites() {
+    for (auto& [fd, conn] : connections_) {
+        if (!conn->wantClose() && conn->outgoing().readableBytes() > 0) {
+            writeQueue_.push_back(conn.get());
+        }
+    }
+    if (writeQueue_.empty()) return;
+
+    bool offloaded = offload(writeQueue_.size(), [this](size_t i) {
+        Connection& conn = *writeQueue_[i];
+        if (!conn.handleWrite()) {
+            conn.setWantClose(true);
+        }
+    });
+    if (offloaded) metrics_.ioThreadedWritesProcessed += writeQueue_.size();
+
+    // Fully flushed clients no longer need EPOLLOUT; the sweep re-arms it
+    // for the ones the kernel couldn't take in full.
+    for (Connection* conn : writeQueue_) {
+        if (conn->wantClose() || conn->outgoing().readableBytes() > 0) continue;
+        if (conn->wantWrite()) {
+            conn->setWantWrite(false);
+            eventLoop_.modFd(conn->fd(), conn->wantRead() ? uint32_t{EPOLLIN} : 0u);
+        }
+    }
+    writeQueue_.clear();
+}
+
+// ── Sharded routing ────────────────────────────────────────────────────────
+
+Shard::Route Shard::route(CommandId id, const CommandArgs& args,
+                          size_t numShards) {
+    Route r;
+    int owner = keyOwner(id, args, numShards);
+    if (owner == kCrossSlot) {
+        r.kind = Route::Kind::CROSSSLOT;
+        return r;
+    }
+    if (owner >= 0) {
+        r.kind  = Route::Kind::REMOTE;
+        r.shard = static_cast<uint32_t>(owner);
+        return r;
+    }
+
+    // Unknown commands are LOCAL: the local dispatch reports them.
+    Fanout fanout = CommandTable::spec(id).fanout;
+    if (id == CommandId::CONFIG && args.size() > 1) {
+        // CONFIG SET changes every shard's copy of the setting.
+        std::string sub(args[1]);
+        std::transform(sub.begin(), sub.end(), sub.begin(), ::toupper);
+        if (sub == "SET") fanout = Fanout::ALL_OK;
+    }
+    switch (fanout) {
+    case Fanout::LOCAL:
+        break;
+    case Fanout::SUM_INTEGERS:
+    case Fanout::CONCAT_ARRAYS:
+    case Fanout::ALL_OK:
+    case Fanout::MERGE_INFO:
+        r.kind  = Route::Kind::BROADCAST;
+        r.merge = fanout;
+        break;
+    case Fanout::SCAN_CURSOR: {
+        // Cursor = local * numShards + shard. Invalid cursors stay local
+        // so the handler reports the error.
+        if (args.size() < 2 || args[1].empty()) break;
+        uint64_t cursor = 0;
+        const char* end = args[1].data() + args[1].size();
+        auto [ptr, ec] = std::from_chars(args[1].data(), end, cursor);
+        if (ec != std::errc() || ptr != end) break;
+        r.kind  = Route::Kind::REMOTE;
+        r.shard = static_cast<uint32_t>(cursor % numShards);
+        r.merge = Fanout::SCAN_CURSOR;
+        r.scanCursor = std::to_string(cursor / numShards);
+        break;
+    }
+    }
+    return r;
+}
+
+bool Shard::routeCommand(Connection& conn, const CommandArgs& args,
+                         CommandId id) {
+    size_t numShards = peers_.size();
+
+    // EXEC: the whole queued block must live on one shard; run it there.
+    if (id == CommandId::EXEC && conn.txn.has_value()) {
+        auto& queued = conn.txn->queuedCommands;
+        int target = kKeyless;
+        CommandArgs views;
+        for (const auto& qcmd : queued) {
+            int owner = keyOwner(CommandTable::resolve(qcmd[0]),
+                                 argsOf(qcmd, views), numShards);
+            if (owner == kKeyless) continue;
+            if (owner == kCrossSlot || (target >= 0 && owner != target)) {
+                conn.txn.reset();
+                RespSerializer::writeError(conn.outgoing(), kCrossSlotError);
+                return true;
+            }
+            target = owner;
+        }
+        if (target < 0 || static_cast<uint32_t>(target) == id_) {
+            return false;  // EXEC handler runs it here
+        }
+        uint64_t seq = openSlot(conn, 1, Fanout::LOCAL);
+        sendRequest(static_cast<uint32_t>(target), conn, seq,
+                    std::move(queued), true, false);
+        conn.txn.reset();
+        return true;
+    }
+
+    Route r = route(id, args, numShards);
+    switch (r.kind) {
+    case Route::Kind::LOCAL:
+        return false;
+
+    case Route::Kind::CROSSSLOT:
+        RespSerializer::writeError(conn.outgoing(), kCrossSlotError);
+        return true;
+
+    case Route::Kind::REMOTE: {
+        if (r.shard == id_ && r.merge == Fanout::LOCAL) return false;
+        // SCAN runs with the shard-local cursor; `r` owns its bytes.
+        CommandArgs scanArgs;
+        const CommandArgs* routed = &args;
+        if (r.merge == Fanout::SCAN_CURSOR) {
+            scanArgs = args;
+            scanArgs[1] = r.scanCursor;
+            routed = &scanArgs;
+        }
+        uint64_t seq = openSlot(conn, 1, r.merge, r.shard);
+        if (r.shard == id_) {
+            // Local SCAN still needs its cursor translated.
+            completeSlot(conn, seq,
+                         executeCaptured(conn, *routed, id, true));
+        } else {
+            sendRequest(r.shard, conn, seq, {ownedArgs(*routed)}, false, false);
+        }
+        return true;
+    }
+
+    case Route::Kind::BROADCAST: {
+        uint64_t seq = openSlot(conn, static_cast<int>(numShards), r.merge);
+        for (uint32_t s = 0; s < numShards; ++s) {
+            if (s != id_) sendRequest(s, conn, seq, {ownedArgs(args)}, false, true);
+        }
+        completeSlot(conn, seq, executeCaptured(conn, args, id, true));
+        return true;
+    }
+    }
+    return false;
+}
+
+// ── Reply slots ────────────────────────────────────────────────────────────
+
+bool Shard::hasPending(const Connection& conn) const {
+    return pending_.count(conn.fd()) > 0;
+}
+
+void Shard::deliver(Connection& conn, std::string payload) {
+    if (!hasPending(conn)) {
+        conn.outgoing().appendOwned(std::move(payload));
+        return;
+    }
+    PendingReply slot;
+    slot.seq  = nextSeq_++;
+    slot.body = std::move(payload);
+    pending_[conn.fd()].push_back(std::move(slot));
+}
+
+uint64_t Shard::openSlot(Connection& conn, int outstanding, Fanout merge,
+                         uint32_t scanShard) {
+    PendingReply slot;
+    slot.seq         = nextSeq_++;
+    slot.outstanding = outstanding;
+    slot.merge       = merge;
+    slot.scanShard   = scanShard;
+    pending_[conn.fd()].push_back(std::move(slot));
+    return nextSeq_ - 1;
+}
+
+void Shard::completeSlot(Connection& conn, uint64_t seq,
+                         const std::string& reply) {
+    auto it = pending_.find(conn.fd());
+    if (it == pending_.end()) return;
+    auto& slots = it->second;
+
+    auto sit = std::find_if(slots.begin(), slots.end(),
+                            [seq](const PendingReply& p) { return p.seq == seq; });
+    if (sit == slots.end()) return;
+    PendingReply& slot = *sit;
+
+    bool isError = !reply.empty() && reply[0] == '-';
+    switch (slot.merge) {
+    case Fanout::LOCAL:
+        slot.body += reply;
+        break;
+    case Fanout::SUM_INTEGERS:
+        if (isError) {
+            if (slot.error.empty()) slot.error = reply;
+        } else if (!reply.empty() && reply[0] == ':') {
+            slot.sum += std::strtoll(reply.c_str() + 1, nullptr, 10);
+        }
+        break;
+    case Fanout::CONCAT_ARRAYS:
+        if (isError) {
+            if (slot.error.empty()) slot.error = reply;
+        } else if (!reply.empty() && reply[0] == '*') {
+            size_t headerEnd = reply.find("\r\n");
+            slot.count += std::strtoll(reply.c_str() + 1, nullptr, 10);
+            slot.body.append(reply, headerEnd + 2, std::string::npos);
+        }
+        break;
+    case Fanout::ALL_OK:
+        if (isError && slot.error.empty()) slot.error = reply;
+        break;
+    case Fanout::MERGE_INFO:
+        if (isError) {
+            if (slot.error.empty()) slot.error = reply;
+        } else if (!reply.empty() && reply[0] == '$') {
+            size_t headerEnd = reply.find("\r\n");
+            size_t len = std::strtoull(reply.c_str() + 1, nullptr, 10);
+            slot.infos.push_back(reply.substr(headerEnd + 2, len));
+        }
+        break;
+    case Fanout::SCAN_CURSOR:
+        slot.body = rewriteScanCursor(reply, slot.scanShard, peers_.size());
+        break;
+    }
+    --slot.outstanding;
+
+    // Flush every completed slot at the front, in order.
+    ReplyChain& out = conn.outgoing();
+    while (!slots.empty() && slots.front().outstanding <= 0) {
+        PendingReply& done = slots.front();
+        std::string payload;
+        if (!done.error.empty()) {
+            payload = std::move(done.error);
+        } else if (done.merge == Fanout::SUM_INTEGERS) {
+            payload = ":" + std::to_string(done.sum) + "\r\n";
+        } else if (done.merge == Fanout::CONCAT_ARRAYS) {
+            payload = "*" + std::to_string(done.count) + "\r\n" + done.body;
+        } else if (done.merge == Fanout::ALL_OK) {
+            payload = "+OK\r\n";
+        } else if (done.merge == Fanout::MERGE_INFO) {
+            std::string info = ServerCommands::mergeInfo(done.infos);
+            payload = "$" + std::to_string(info.size()) + "\r\n" + info + "\r\n";
+        } else {
+            payload = std::move(done.body);
+        }
+        out.appendOwned(std::move(payload));
+        slots.pop_front();
+    }
+    if (slots.empty()) {
+        pending_.erase(it);
+    }
+}
+
+// ── Inter-shard messaging ──────────────────────────────────────────────────
+
+void Shard::post(ShardMessage msg) {
+    inbox_.push(std::move(msg));
+}
+
+void Shard::wake() {
+    uint64_t one = 1;
+    ssize_t r = ::write(wakeFd_, &one, sizeof(one));
+    (void)r;  // EAGAIN means the counter is already non-zero — still awake
+}
+
+void Shard::wakePeers() {
+    for (size_t s = 0; s < wakePending_.size(); ++s) {
+        if (wakePending_[s]) {
+            peers_[s]->wake();
+            wakePending_[s] = 0;
+        }
+    }
+}
+
+void Shard::sendRequest(uint32_t target, Connection& conn, uint64_t seq,
+                        std::vector<std::vector<std::string>> cmds,
+                        bool exec, bool broadcast) {
+    ShardMessage msg;
+    msg.kind      = ShardMessage::Kind::REQUEST;
+    msg.origin    = id_;
+    msg.fd        = conn.fd();
+    msg.connId    = conn.id;
+    msg.seq       = seq;
+    msg.exec      = exec;
+    msg.broadcast = broadcast;
+    msg.cmds      = std::move(cmds);
+    peers_[target]->post(std::move(msg));
+    wakePending_[target] = 1;
+}
+
+void Shard::drainInbox() {
+    ShardMessage msg;
+    while (inbox_.pop(msg)) {
+        if (msg.kind == ShardMessage::Kind::REQUEST) {
+            // Execute against this shard's keyspace, capturing the reply.
+            if (msg.exec) {
+                runTransaction(scratch_, msg.cmds);
+            } else {
+                execute(scratch_, argsOf(msg.cmds[0], argv_),
+                        CommandTable::resolve(msg.cmds[0][0]), !msg.broadcast);
+            }
+
+            ShardMessage reply;
+            reply.kind   = ShardMessage::Kind::REPLY;
+            reply.origin = msg.origin;
+            reply.fd     = msg.fd;
+            reply.connId = msg.connId;
+            reply.seq    = msg.seq;
+            reply.reply  = scratch_.outgoing().takeAll();
+            reply.aofOffset = aofOffset_;
+
+            uint32_t origin = msg.origin;
+            peers_[origin]->post(std::move(reply));
+            wakePending_[origin] = 1;
+        } else {
+            // A reply for one of our clients. Drop it if the client is gone
+            // (or its fd was already reused by a newer connection).
+            auto it = connections_.find(msg.fd);
+            if (it == connections_.end() || it->second->id != msg.connId) {
+                continue;
+            }
+            // The reply may depend on writes the owner logged: this shard's
+            // group commit must cover them before the reply goes out.
+            aofOffset_ = std::max(aofOffset_, msg.aofOffset);
+            completeSlot(*it->second, msg.seq, msg.reply);
+        }
+    }
+}
+
+void Shard::closeConnection(int fd) {
+    auto it = connections_.find(fd);
+    if (it == connections_.end()) return;
+    // Phase 6: Remove from pub/sub before destroying Connection.
+    pubsub_.removeConnection(*it->second);
+    pending_.erase(fd);
+    eventLoop_.removeFd(fd);
+    connections_.erase(it);  // unique_ptr dtor closes the fd.
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "cmd/CommandArgs.h"
+#include "cmd/CommandTable.h"
+#include "cmd/PubSubRegistry.h"
+#include "cmd/ServerCommands.h"
+#include "net/Connection.h"
+#include "net/EventLoop.h"
+#include "net/Listener.h"
+#include "proto/RespParser.h"
+#include "server/IOThreadPool.h"
+#include "server/ServerConfig.h"
+#include "server/ShardQueue.h"
+#include "store/Database.h"
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AOFWriter;
+
+/// A message exchanged between shards through their ShardQueue inboxes.
+struct ShardMessage {
+    enum class Kind : uint8_t { REQUEST, REPLY };
+
+    Kind     kind = Kind::REQUEST;
+    uint32_t origin = 0;      // shard that owns the client connection
+    int      fd = -1;         // client connection on the origin shard
+    uint64_t connId = 0;      // guards against fd reuse after a close
+    uint64_t seq = 0;         // reply slot on the origin connection
+    bool     exec = false;    // REQUEST: run `cmds` as a MULTI/EXEC batch
+    bool     broadcast = false;  // REQUEST: one leg of a fan-out (not logged)
+    uint64_t aofOffset = 0;   // REPLY: AOF offset the owner had logged up to
+
+    std::vector<std::vector<std::string>> cmds;  // REQUEST payload (owned copy)
+    std::string reply;                           // REPLY payload (raw RESP)
+};
+
+/// One event loop + one Database + one slice of the keyspace.
+///
+/// With --threads 1 a single Shard is exactly the classic single-threaded
+/// server. With N > 1 every shard runs on its own thread, owns the keys
+/// whose hash maps to it, and accepts clients on its own SO_REUSEPORT
+/// listener. A command whose keys live elsewhere is forwarded to the owner
+/// through a lock-free inbox; the owner executes it and sends the raw RESP
+/// reply back. Per-connection reply slots keep pipelined replies in order.
+///
+/// Keyless commands follow their CommandSpec::fanout: run locally, run on
+/// every shard and merge (DBSIZE, KEYS, FLUSHDB, PUBLISH), or route by the
+/// shard encoded in the cursor (SCAN). Multi-key commands and MULTI/EXEC
+/// blocks whose keys span shards are rejected with CROSSSLOT.
+///
+/// With --io-threads N, socket reads + RESP parsing and socket writes for
+/// all ready clients are handed to an IOThreadPool once per poll iteration;
+/// commands still execute on the shard thread, in order.
+///
+/// Write commands are logged into the shared AOF buffer and flushed once
+/// per poll iteration, before that iteration's replies go out (group
+/// commit): a reply never reaches a client before its write is in the
+/// AOF — or, with --appendfsync always, on disk. The one exception is
+/// everysec's Redis-style postponement behind a slow background fsync.
+///
+/// With --io-backend io_uring the event loop does the socket I/O itself:
+/// clients arrive as ACCEPTED events, input as RECEIVED events, and the
+/// sweep hands each client's output to the backend instead of arming
+/// EPOLLOUT.
+class Shard {
+public:
+    Shard(uint32_t id, const ServerConfig& config, AOFWriter& aof);
+    ~Shard();
+
+    Shard(const Shard&) = delete;
+    Shard& operator=(const Shard&) = delete;
+
+    /// Wire up the full shard list (index == shard id, includes this one).
+    /// Must be called on every shard before run().
+    void setPeers(std::vector<Shard*> peers);
+
+    /// Run the event loop until `running` becomes false.
+    void run(const std::atomic<bool>& running);
+
+    /// Enqueue a message for this shard. Safe from any thread.
+    void post(ShardMessage msg);
+
+    /// Wake this shard's event loop (eventfd). Safe from any thread.
+    void wake();
+
+    uint32_t id() const { return id_; }
+    Database& db() { return db_; }
+    CommandTable& commandTable() { return commandTable_; }
+
+    /// Index of the shard that owns `key`.
+    static uint32_t shardOf(std::string_view key, size_t numShards);
+
+    /// Replay one AOF command into the shard(s) that own it.
+    /// Startup only — must run before any shard thread starts.
+    static void replay(const std::vector<Shard*>& shards, Connection& dummy,
+                       const CommandArgs& args);
+
+private:
+    /// Where a command executes in sharded mode.
+    struct Route {
+        enum class Kind : uint8_t { LOCAL, REMOTE, BROADCAST, CROSSSLOT };
+        Kind     kind = Kind::LOCAL;
+        uint32_t shard = 0;           // REMOTE / SCAN target
+        Fanout   merge = Fanout::LOCAL;
+        std::string scanCursor;       // SCAN: shard-local cursor to run with
+    };
+
+    /// A reply owed to a client, in command order. Filled locally or by
+    /// REPLY messages; flushed to the outgoing buffer once it (and every
+    /// slot before it) is complete.
+    struct PendingReply {
+        uint64_t    seq = 0;
+        int         outstanding = 0;   // shard replies still expected
+        Fanout      merge = Fanout::LOCAL;
+        uint32_t    scanShard = 0;     // SCAN_CURSOR: shard that was scanned
+        int64_t     sum = 0;           // SUM_INTEGERS accumulator
+        int64_t     count = 0;         // CONCAT_ARRAYS element count
+        std::string body;              // raw RESP / concatenated elements
+        std::vector<std::string> infos;  // MERGE_INFO: each shard's INFO text
+        std::string error;             // first error seen in a fan-out
+    };
+
+    uint32_t          id_;
+    const ServerConfig& config_;
+    AOFWriter&        aof_;
+
+    Listener          listener_;
+    EventLoop         eventLoop_;
+    Database          db_;
+    CommandTable      commandTable_;
+    RespParser        parser_;
+    CommandArgs       argv_;       // views into the input being processed
+    std::vector<std::string> evicted_;  // keys evicted before the current write
+    uint64_t          aofOffset_ = 0;   // AOF offset replies must wait for
+    ServerMetrics     metrics_;
+    PubSubRegistry    pubsub_;
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections_;
+    uint64_t nextConnId_ = 1;
+
+    // ── Inter-shard state ──────────────────────────────────────────────
+    std::vector<Shard*>       peers_;        // index == shard id
+    ShardQueue<ShardMessage>  inbox_;
+    int                       wakeFd_ = -1;  // eventfd, readable when posted to
+    std::vector<uint8_t>      wakePending_;  // peers to wake at end of tick
+    std::unordered_map<int, std::deque<PendingReply>> pending_;  // fd → slots
+    uint64_t                  nextSeq_ = 1;
+    Connection                scratch_{-1};  // reply sink for remote requests
+
+    // ── Timers and runtime settings (CONFIG SET) ──────────────────────
+    int                clientTimeoutSec_ = 0;  // 0 = idle clients stay
+    int                hz_ = 10;               // cron calls per second
+    EventLoop::TimerId cronTimer_ = 0;
+    EventLoop::TimerId rewriteTimer_ = 0;      // armed while a rewrite runs
+
+    // ── Threaded I/O (--io-threads) ───────────────────────────────────
+    std::unique_ptr<IOThreadPool> ioPool_;   // null when ioThreads == 1
+    std::vector<Connection*>      readQueue_;   // readable this iteration
+    std::vector<Connection*>      writeQueue_;  // have output to flush
+
+    /// Batches smaller than this many items per I/O thread run inline;
+    /// the handoff costs more than it saves.
+    static constexpr size_t kMinOffloadPerThread = 2;
+
+    /// Bind BGREWRITEAOF, EXEC, SUBSCRIBE, UNSUBSCRIBE, PUBLISH, CONFIG —
+    /// the commands that need shard-owned state (AOF writer, pub/sub
+    /// registry, settings).
+    void bindShardCommands();
+
+    /// (Re)arm the cron timer — active expiry — at `hz` calls a second.
+    void setHz(int hz);
+    int cronPeriodMs() const { return 1000 / hz_; }
+
+    /// Clients cron: mark clients idle past the timeout setting for close.
+    void closeIdleClients();
+
+    /// Poll for the end of a background rewrite, once per cron period,
+    /// until it finishes. No-op if none runs or it is already watched.
+    void watchRewrite();
+
+    /// CONFIG GET pattern [...] | CONFIG SET name value [...] for `hz`
+    /// and `timeout`. SET reaches every shard (see route()).
+    void configCommand(Connection& conn, const CommandArgs& args);
+
+    void acceptClients();
+    void addClient(int fd);
+    void handleClientEvent(int fd, uint32_t events);
+
+    /// Completion I/O: data (or EOF / an error) already read for a client.
+    void handleCompletion(const IOEvent& ev);
+
+    /// Parse and execute every complete command in the connection's input.
+    void processCommands(Connection& conn);
+
+    /// Gate, route and execute one parsed command.
+    void processCommand(Connection& conn, const CommandArgs& cmd);
+
+    /// Threaded I/O: remember a client event for the batched read phase.
+    void queueClientEvent(int fd, uint32_t events);
+
+    /// Threaded I/O: read + parse every queued client on the pool, then
+    /// execute the parsed commands on this thread.
+    void processReadQueue();
+
+    /// Threaded I/O: write every client with pending output on the pool.
+    void flushWrites();
+
+    /// Run job(i) for i in [0, count) on the I/O pool, or inline when the
+    /// batch is too small. Returns true if the batch was offloaded.
+    bool offload(size_t count, const std::function<void(size_t)>& job);
+
+    /// Sharded mode: route one command. Returns false if it should simply
+    /// execute locally and write straight to the connection.
+    bool routeCommand(Connection& conn, const CommandArgs& args,
+                      CommandId id);
+
+    /// Decide where a command runs. A SCAN's translated cursor comes back
+    /// in Route::scanCursor; the caller substitutes it for args[1].
+    static Route route(CommandId id, const CommandArgs& args,
+                       size_t numShards);
+
+    /// Timed dispatch + AOF logging for a command executing on this shard.
+    void execute(Connection& conn, const CommandArgs& args,
+                 CommandId id, bool logAof);
+
+    /// Before a write: evict keys if this shard is over its maxmemory
+    /// share, logging each eviction to the AOF as a DEL. Returns false if
+    /// a kCmdDenyOom command must be refused because memory is still over.
+    bool makeRoomForWrite(uint32_t flags);
+
+    /// Execute locally and return the reply bytes instead of queueing them.
+    std::string executeCaptured(Connection& conn, const CommandArgs& args,
+                                CommandId id, bool logAof);
+
+    /// Run queued MULTI commands and write the EXEC array reply.
+    void runTransaction(Connection& conn,
+                        const std::vector<std::vector<std::string>>& queued);
+
+    /// Deliver a reply that needs no merging, honoring slot order.
+    void deliver(Connection& conn, std::string payload);
+
+    /// Reserve a reply slot. Returns its sequence number.
+    uint64_t openSlot(Connection& conn, int outstanding, Fanout merge,
+                      uint32_t scanShard = 0);
+
+    /// Merge one reply into a slot and flush every completed slot in order.
+    void completeSlot(Connection& conn, uint64_t seq, const std::string& reply);
+
+    /// Send a REQUEST to another shard.
+    void sendRequest(uint32_t target, Connection& conn, uint64_t seq,
+                     std::vector<std::vector<std::string>> cmds,
+                     bool exec, bool broadcast);
+
+    /// Process every queued inter-shard message.
+    void drainInbox();
+
+    /// Wake every peer we posted to during this tick.
+    void wakePeers();
+
+    /// True if the connection still owes replies from other shards.
+    bool hasPending(const Connection& conn) const;
+
+    void closeConnection(int fd);
+};
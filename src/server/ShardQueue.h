@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/// Unbounded lock-free multi-producer / single-consumer queue.
+///
+/// Intrusive Vyukov design: producers publish a node with one atomic
+/// exchange on head_ and then link it behind its predecessor; the single
+/// consumer follows `next` pointers from tail_. There are no locks and no
+/// CAS retry loops — push() is wait-free, pop() is wait-free except for the
+/// brief window where a producer has swapped head_ but not yet linked
+/// `next` (pop() then reports empty and the item is seen on the next call).
+///
+/// Used for inter-shard messages: every shard may push into any other
+/// shard's inbox, and only the owning shard's thread pops.
+///
+/// Must NOT know about: shards, connections, commands.
+template <typename T>
+class ShardQueue {
+public:
+    ShardQueue() : head_(new Node), tail_(head_.load(std::memory_order_relaxed)) {}
+
+    ~ShardQueue() {
+        T discard;
+        while (pop(discard)) {}
+        delete tail_;
+    }
+
+    ShardQueue(const ShardQueue&) = delete;
+    ShardQueue& operator=(const ShardQueue&) = delete;
+
+    /// Enqueue an item. Safe to call from any thread.
+    void push(T value) {
+        Node* node = new Node;
+        node->value = std::move(value);
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    /// Dequeue the oldest item into `out`. Consumer thread only.
+    /// Returns false if the queue is (momentarily) empty.
+    bool pop(T& out) {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        out = std::move(next->value);
+        delete tail_;
+        tail_ = next;   // `next` becomes the new stub node
+        return true;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    std::atomic<Node*> head_;  // most recently pushed node (producers)
+    Node* tail_;               // stub node; tail_->next is the oldest item
+};
@@ -2,6 +2,10 @@
 
 #include <chrono>
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 /// Return current time in milliseconds since epoch.
 static int64_t nowMs() {
     using namespace std::chrono;
@@ -10,18 +14,20 @@ static int64_t nowMs() {
         .count();
 }
 
-bool Database::checkAndExpire(const std::string& key, HTEntry* entry) {
-    if (entry->expireAt < 0) return false;  // no expiry set
-    if (nowMs() < entry->expireAt) return false;  // not yet expired
+bool Database::checkAndExpire(std::string_view key, HTEntry* entry) {
+    int64_t expireAt = entry->expireAt();
+    if (expireAt < 0) return false;  // no expiry set
+    if (nowMs() < expireAt) return false;  // not yet expired
     // Subtract memory before deletion.
-    usedMemory_ -= entry->value.memoryUsage();
-    // INV-7: Remove from heap when lazy-expiring a key.
-    ttlHeap_.remove(key);
+    usedMemory_ -= entry->memoryUsage();
+    // INV-7: Remove from the wheel when lazy-expiring a key.
+    expiry_.remove(entry);
     table_.del(key);
+    expireStats_.expiredKeys++;
     return true;
 }
 
-std::optional<std::string> Database::get(const std::string& key) {
+std::optional<std::string> Database::get(std::string_view key) {
     table_.rehashStep();
 
     HTEntry* entry = table_.find(key);
@@ -30,42 +36,42 @@ std::optional<std::string> Database::get(const std::string& key) {
     // Lazy expiry: check if the key has expired.
     if (checkAndExpire(key, entry)) return std::nullopt;
 
+    touch(entry, false);
+
     // Phase 5: only STRING type is returned via get().
     if (entry->value.type != DataType::STRING) return std::nullopt;
 
     return entry->value.asString();
 }
 
-void Database::set(const std::string& key, const std::string& value) {
-    // INV-6: SET clears any existing TTL on the key.
-    ttlHeap_.remove(key);
-
+void Database::set(std::string_view key, std::string_view value) {
     // Subtract old memory if key already exists.
     HTEntry* old = table_.find(key);
-    if (old) usedMemory_ -= old->value.memoryUsage();
-
-    // If the key already exists in the hash table, we need to reset expireAt.
-    // After table_.set(), find the entry and ensure expireAt = -1.
-    table_.set(key, RedisObject::createString(value));
+    if (old) {
+        usedMemory_ -= old->memoryUsage();
+        // INV-6: SET clears any existing TTL on the key.
+        if (old->expireAt() >= 0) expiry_.remove(old);
+    }
 
+    // A short value is copied straight into the entry (no RAW string).
+    HTEntry* entry = table_.set(key, RedisObject::createStringView(value));
     // Ensure expireAt is cleared (table_.set overwrite preserves expireAt).
-    HTEntry* entry = table_.find(key);
-    if (entry) {
-        entry->expireAt = -1;
-        usedMemory_ += entry->value.memoryUsage();
-    }
+    entry = table_.setExpire(entry, -1);
+    usedMemory_ += entry->memoryUsage();
+    touch(entry, old == nullptr);
 }
 
-bool Database::del(const std::string& key) {
+bool Database::del(std::string_view key) {
     // Subtract memory before deletion.
     HTEntry* entry = table_.find(key);
-    if (entry) usedMemory_ -= entry->value.memoryUsage();
-    // INV-5: Remove from heap when a key is DEL'd.
-    ttlHeap_.remove(key);
+    if (!entry) return false;
+    usedMemory_ -= entry->memoryUsage();
+    // INV-5: Remove from the wheel when a key is DEL'd.
+    if (entry->expireAt() >= 0) expiry_.remove(entry);
     return table_.del(key);
 }
 
-bool Database::exists(const std::string& key) {
+bool Database::exists(std::string_view key) {
     table_.rehashStep();
 
     HTEntry* entry = table_.find(key);
@@ -83,7 +89,8 @@ std::vector<std::string> Database::keys() {
 }
 
 std::pair<size_t, std::vector<std::string>>
-Database::scan(size_t cursor, size_t count, const std::string& pattern) {
+Database::scan(size_t cursor, size_t count, const std::string& pattern,
+               std::optional<DataType> type) {
     table_.rehashStep();
 
     auto [nextCursor, rawKeys] = table_.scan(cursor, count);
@@ -96,6 +103,7 @@ Database::scan(size_t cursor, size_t count, const std::string& pattern) {
         HTEntry* entry = table_.find(key);
         if (!entry) continue;
         if (checkAndExpire(key, entry)) continue;
+        if (type && entry->value.type != *type) continue;
 
         // Pattern match: "*" matches everything.
         if (pattern == "*") {
@@ -117,55 +125,117 @@ void Database::rehashStep() {
     table_.rehashStep();
 }
 
-bool Database::setExpire(const std::string& key, int64_t expireAtMs) {
+bool Database::setExpire(std::string_view key, int64_t expireAtMs) {
     HTEntry* entry = table_.find(key);
     if (!entry) return false;
 
     // Lazy check: if the key is already expired, don't set a new TTL.
     if (checkAndExpire(key, entry)) return false;
 
-    entry->expireAt = expireAtMs;
-    ttlHeap_.push(key, expireAtMs);
+    // The first TTL on a key grows its entry.
+    usedMemory_ -= entry->memoryUsage();
+    entry = table_.setExpire(entry, expireAtMs);
+    usedMemory_ += entry->memoryUsage();
+    expiry_.update(entry);
     return true;
 }
 
-void Database::removeExpire(const std::string& key) {
+void Database::removeExpire(std::string_view key) {
     HTEntry* entry = table_.find(key);
     if (!entry) return;
 
-    entry->expireAt = -1;
-    ttlHeap_.remove(key);
+    if (entry->expireAt() < 0) return;
+    expiry_.remove(entry);
+    table_.setExpire(entry, -1);
 }
 
-int64_t Database::ttl(const std::string& key) {
+int64_t Database::ttl(std::string_view key) {
     HTEntry* entry = table_.find(key);
     if (!entry) return -2;  // key doesn't exist
 
     // Lazy expiry check.
-    if (entry->expireAt >= 0 && nowMs() >= entry->expireAt) {
+    int64_t expireAt = entry->expireAt();
+    if (expireAt >= 0 && nowMs() >= expireAt) {
         // Key is expired — clean up and report as non-existent.
-        ttlHeap_.remove(key);
+        usedMemory_ -= entry->memoryUsage();
+        expiry_.remove(entry);
         table_.del(key);
+        expireStats_.expiredKeys++;
         return -2;
     }
 
-    if (entry->expireAt < 0) return -1;  // no TTL set
-    return entry->expireAt - nowMs();     // remaining time in ms
+    if (expireAt < 0) return -1;  // no TTL set
+    return expireAt - nowMs();     // remaining time in ms
 }
 
-void Database::activeExpireCycle(int maxWork) {
+void Database::activeExpireCycle(ExpireCycle type, int timerPeriodMs) {
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    microseconds budget(kExpireFastUs);
+    if (type == ExpireCycle::FAST) {
+        // Only worth it while the last cycle fell behind, and never back
+        // to back: the fast cycle runs on every event loop iteration.
+        if (!expireTimedOut_ &&
+            expireStats_.stalePerc <= kExpireAcceptableStale) {
+            return;
+        }
+        if (start < lastFastCycle_ + 2 * budget) return;
+        lastFastCycle_ = start;
+    } else {
+        budget = microseconds(int64_t{timerPeriodMs} * 1000 *
+                              kExpireSlowPercent / 100);
+    }
+
+    // The wheel hands out exactly the due keys, so a full batch means
+    // more are due: keep going until a short batch or the budget ends.
     int64_t now = nowMs();
-    auto expired = ttlHeap_.popExpired(now, maxWork);
-    for (const auto& key : expired) {
-        // Subtract memory before deletion.
-        HTEntry* entry = table_.find(key);
-        if (entry) usedMemory_ -= entry->value.memoryUsage();
-        // The heap entry is already removed by popExpired.
-        table_.del(key);
+    bool timedOut = false;
+    for (;;) {
+        expired_.clear();
+        size_t n = expiry_.popExpired(now, kExpireBatch, expired_);
+        for (HTEntry* entry : expired_) {
+            // Already unlinked from the wheel by popExpired.
+            usedMemory_ -= entry->memoryUsage();
+            table_.del(entry->key());
+        }
+        expireStats_.expiredKeys += n;
+        if (n < kExpireBatch) break;
+        if (steady_clock::now() - start >= budget) {
+            timedOut = true;
+            break;
+        }
     }
+    expireTimedOut_ = timedOut;
+
+    // Like Redis, a slow-moving average: one cycle barely moves it.
+    double stale = timedOut ? sampleStalePercent(now) : 0.0;
+    expireStats_.stalePerc = stale * 0.05 + expireStats_.stalePerc * 0.95;
+    expireStats_.cycleTimeUs += static_cast<uint64_t>(
+        duration_cast<microseconds>(steady_clock::now() - start).count());
 }
 
-HTEntry* Database::findEntry(const std::string& key) {
+double Database::sampleStalePercent(int64_t now) {
+    size_t withTtl = 0;
+    size_t stale = 0;
+    auto count = [&](const HTEntry* entry) {
+        if (entry->expireAt() < 0) return;
+        ++withTtl;
+        if (entry->expireAt() <= now) ++stale;
+    };
+    sample_.clear();
+    table_.sampleEntries(rng_(), kExpireStaleSamples, sample_);
+    for (HTEntry* entry : sample_) count(entry);
+    if (withTtl == 0) {
+        // Keys with a TTL are too rare to turn up; ask the wheel.
+        for (size_t i = 0; i < kExpireStaleSamples; ++i) {
+            if (HTEntry* entry = expiry_.sample(rng_())) count(entry);
+        }
+    }
+    return withTtl == 0 ? 0.0 : 100.0 * static_cast<double>(stale) /
+                                    static_cast<double>(withTtl);
+}
+
+HTEntry* Database::findEntry(std::string_view key) {
     table_.rehashStep();
 
     HTEntry* entry = table_.find(key);
@@ -174,27 +244,114 @@ HTEntry* Database::findEntry(const std::string& key) {
     // Lazy expiry check.
     if (checkAndExpire(key, entry)) return nullptr;
 
+    touch(entry, false);
     return entry;
 }
 
-void Database::setObject(const std::string& key, RedisObject obj) {
+void Database::setObject(std::string_view key, RedisObject obj) {
     // Subtract old memory if key already exists.
     HTEntry* old = table_.find(key);
-    if (old) usedMemory_ -= old->value.memoryUsage();
-
-    table_.set(key, std::move(obj));
+    if (old) usedMemory_ -= old->memoryUsage();
 
     // Add new memory.
-    HTEntry* entry = table_.find(key);
-    if (entry) usedMemory_ += entry->value.memoryUsage();
+    HTEntry* entry = table_.set(key, std::move(obj));
+    usedMemory_ += entry->memoryUsage();
+    touch(entry, old == nullptr);
 }
 
 void Database::flushdb() {
+    expiry_.clear();
     table_.flushAll();
-    ttlHeap_ = TTLHeap{};  // reset heap
     usedMemory_ = 0;
+    evictionPool_.clear();
+#if defined(__GLIBC__)
+    // The entries were small allocations; hand the pages they freed back
+    // to the OS instead of keeping them in malloc's free lists.
+    malloc_trim(0);
+#endif
 }
 
 size_t Database::expiryCount() const {
-    return table_.expiryCount();
+    return expiry_.size();
+}
+
+// ── Eviction (maxmemory) ───────────────────────────────────────────────────
+
+void Database::setMaxMemory(size_t bytes, EvictionPolicy policy) {
+    maxMemory_ = bytes;
+    policy_ = policy;
+    evictionPool_.clear();
+}
+
+void Database::touch(HTEntry* entry, bool created) {
+    if (!Eviction::tracksAccess(policy_)) return;
+    int64_t now = nowMs();
+    if (created) {
+        entry->setLru(Eviction::initialAccess(policy_, now));
+        return;
+    }
+    double random = 0.0;
+    if (policy_ == EvictionPolicy::ALLKEYS_LFU) {
+        random = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+    }
+    entry->setLru(Eviction::touch(entry->lru(), policy_, now, random));
+}
+
+void Database::refillEvictionPool(int64_t now) {
+    bool volatileOnly = Eviction::volatileOnly(policy_);
+    sample_.clear();
+    table_.sampleEntries(rng_(), volatileOnly ? kEvictionSamples * 4
+                                              : kEvictionSamples, sample_);
+    size_t offered = 0;
+    for (HTEntry* entry : sample_) {
+        if (volatileOnly && entry->expireAt() < 0) continue;
+        evictionPool_.offer(entry->key(),
+                            Eviction::evictionScore(*entry, policy_, now));
+        ++offered;
+    }
+    if (offered > 0 || !volatileOnly) return;
+    // Keys with a TTL are too rare to turn up in the keyspace; they are
+    // all in the wheel, so sample it instead (biased towards the keys at
+    // the head of each slot).
+    for (size_t i = 0; i < kEvictionSamples; ++i) {
+        HTEntry* entry = expiry_.sample(rng_());
+        if (!entry) break;
+        evictionPool_.offer(entry->key(),
+                            Eviction::evictionScore(*entry, policy_, now));
+    }
+}
+
+bool Database::pickEvictionVictim(std::string& victim) {
+    bool volatileOnly = Eviction::volatileOnly(policy_);
+    if (volatileOnly ? expiry_.empty() : table_.size() == 0) return false;
+
+    int64_t now = nowMs();
+    // Pooled candidates can be stale; retry a few refills before giving up.
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        refillEvictionPool(now);
+        while (evictionPool_.popBest(victim)) {
+            HTEntry* entry = table_.find(victim);
+            if (entry && (!volatileOnly || entry->expireAt() >= 0)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Database::evictIfNeeded(std::vector<std::string>& evicted) {
+    if (maxMemory_ == 0 || usedMemory_ <= maxMemory_) return true;
+    if (policy_ == EvictionPolicy::NOEVICTION) return false;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string victim;
+    while (usedMemory_ > maxMemory_ && pickEvictionVictim(victim)) {
+        del(victim);
+        evicted.push_back(victim);
+        evictionStats_.evictedKeys++;
+    }
+    evictionStats_.evictionTimeUs += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    return usedMemory_ <= maxMemory_;
 }
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "store/Eviction.h"
+#include "store/ExpiryWheel.h"
 #include "store/HashTable.h"
-#include "store/TTLHeap.h"
 
+#include <chrono>
 #include <cstdint>
 #include <optional>
+#include <random>
 #include <string>
+#include <string_view>
 #include <vector>
 
+/// Which active expiry pass to run (after Redis's activeExpireCycle()).
+enum class ExpireCycle : uint8_t {
+    SLOW,  // from the timer: up to 25% of the timer period
+    FAST,  // before the event loop sleeps: up to 1 ms, only while the
+           // last cycle fell behind
+};
+
 /// Thin wrapper over HashTable that command handlers call.
 /// Provides named operations (get, set, del, exists, keys).
 /// Runs one rehash step per call to amortize rehashing cost.
@@ -17,26 +28,27 @@ class Database {
 public:
     /// Get the value for a key (STRING type only). Returns nullopt if
     /// not found, expired, or wrong type (non-STRING).
-    std::optional<std::string> get(const std::string& key);
+    std::optional<std::string> get(std::string_view key);
 
     /// Set a key to a string value (clears any existing TTL).
-    void set(const std::string& key, const std::string& value);
+    void set(std::string_view key, std::string_view value);
 
     /// Delete a key. Returns true if the key existed.
-    bool del(const std::string& key);
+    bool del(std::string_view key);
 
     /// Check if a key exists (and is not expired).
-    bool exists(const std::string& key);
+    bool exists(std::string_view key);
 
     /// Return all keys.
     std::vector<std::string> keys();
 
-    /// Scan keys starting at `cursor`, returning up to `count` keys.
-    /// If `pattern` is not "*", only keys matching the glob are returned.
+    /// Scan keys starting at `cursor`, examining about `count` keys.
+    /// If `pattern` is not "*", only keys matching the glob are returned;
+    /// if `type` is set, only keys holding that type.
     /// Returns (nextCursor, matchingKeys). nextCursor=0 means iteration done.
-    std::pair<size_t, std::vector<std::string>> scan(size_t cursor,
-                                                      size_t count,
-                                                      const std::string& pattern);
+    std::pair<size_t, std::vector<std::string>> scan(
+        size_t cursor, size_t count, const std::string& pattern,
+        std::optional<DataType> type = std::nullopt);
 
     /// Return the total number of keys.
     size_t dbsize() const;
@@ -46,46 +58,132 @@ public:
 
     /// Set expiration on an existing key. expireAtMs = ms since epoch.
     /// Returns true if the key exists (and TTL was set), false otherwise.
-    bool setExpire(const std::string& key, int64_t expireAtMs);
+    bool setExpire(std::string_view key, int64_t expireAtMs);
 
     /// Remove expiration from a key, making it permanent.
-    void removeExpire(const std::string& key);
+    void removeExpire(std::string_view key);
 
     /// Return remaining TTL in milliseconds. -1 = no TTL, -2 = key doesn't exist.
-    int64_t ttl(const std::string& key);
+    int64_t ttl(std::string_view key);
 
-    /// Proactively expire up to maxWork keys from the TTL heap.
-    /// Called by the timer callback every 100ms.
-    void activeExpireCycle(int maxWork);
+    /// Reclaim due keys from the expiry wheel, a batch at a time, until
+    /// none are left or the cycle's time budget runs out. A SLOW cycle
+    /// (the timer's, every `timerPeriodMs`) may take 25% of the period.
+    /// A FAST cycle (before the event loop sleeps) takes at most 1 ms, and
+    /// only runs when the last cycle ran out of time or the stale estimate
+    /// is above 10%, at most once every 2 ms.
+    void activeExpireCycle(ExpireCycle type, int timerPeriodMs);
 
     /// Look up a key and return its HTEntry* (with lazy expiry check).
     /// Returns nullptr if the key doesn't exist or is expired.
     /// Used by Phase 5 command handlers to access non-string types directly.
-    HTEntry* findEntry(const std::string& key);
+    HTEntry* findEntry(std::string_view key);
 
     /// Insert or overwrite a key with an arbitrary RedisObject.
     /// Does NOT clear TTL — caller manages TTL if needed.
-    void setObject(const std::string& key, RedisObject obj);
+    void setObject(std::string_view key, RedisObject obj);
+
+    /// Reconcile usedMemory() after a handler changed the value of `entry`
+    /// in place through Quicklist / HashType / SetType / ZSetType, which
+    /// keep the value's own memoryUsage() current. `before` is value.memoryUsage()
+    /// from before the change.
+    void valueChanged(HTEntry* entry, size_t before) {
+        usedMemory_ += entry->value.memoryUsage() - before;
+    }
+
+    /// Listpack / intset / quicklist limits for new and growing
+    /// collections.
+    void setEncodingConfig(const EncodingConfig& config) { encoding_ = config; }
+    const EncodingConfig& encodingConfig() const { return encoding_; }
 
     /// Return a mutable reference to the underlying hash table.
     /// Used by future phases (TTL, etc.) that need direct entry access.
     HashTable& table() { return table_; }
 
-    /// Delete all keys. Clears hash table, TTL heap, and memory counter.
+    /// Delete all keys. Clears hash table (releasing its slot arrays),
+    /// expiry wheel, and memory counter, and returns freed heap pages to
+    /// the OS.
     void flushdb();
 
     /// Return estimated memory usage of all stored objects (bytes).
     size_t usedMemory() const { return usedMemory_; }
 
+    /// Limit usedMemory() to `bytes` (0 = unlimited) and pick what
+    /// evictIfNeeded() does past the limit.
+    void setMaxMemory(size_t bytes, EvictionPolicy policy);
+    size_t maxMemory() const { return maxMemory_; }
+    EvictionPolicy evictionPolicy() const { return policy_; }
+
+    /// Evict keys per the policy until usedMemory() fits maxmemory,
+    /// appending each evicted key to `evicted` (the caller logs them).
+    /// Called before write commands. Returns false if memory is still
+    /// over the limit — noeviction, or nothing left to evict.
+    bool evictIfNeeded(std::vector<std::string>& evicted);
+
+    /// Counters for INFO stats.
+    struct EvictionStats {
+        uint64_t evictedKeys = 0;
+        uint64_t evictionTimeUs = 0;  // spent in evictIfNeeded() evicting
+    };
+    const EvictionStats& evictionStats() const { return evictionStats_; }
+
+    /// Expiry counters for INFO stats.
+    struct ExpireStats {
+        uint64_t expiredKeys = 0;  // reclaimed, by active or lazy expiry
+        double stalePerc = 0.0;    // est. % of keys with a TTL that are
+                                   // past it but not yet reclaimed
+        uint64_t cycleTimeUs = 0;  // spent in activeExpireCycle()
+    };
+    const ExpireStats& expireStats() const { return expireStats_; }
+
     /// Return the number of keys that have a TTL set.
     size_t expiryCount() const;
 
 private:
     HashTable table_;
-    TTLHeap ttlHeap_;
-    size_t usedMemory_ = 0;  // running estimate — updated on set/del/flush
+    ExpiryWheel expiry_;                // keys with a TTL, by expireAt
+    std::vector<HTEntry*> expired_;     // reused popExpired() buffer
+    size_t usedMemory_ = 0;  // running estimate — updated on every mutation
+    EncodingConfig encoding_;
+
+    // ── Eviction (maxmemory) ──
+    size_t maxMemory_ = 0;                        // 0 = unlimited
+    EvictionPolicy policy_ = EvictionPolicy::NOEVICTION;
+    EvictionPool evictionPool_;
+    EvictionStats evictionStats_;
+    std::mt19937_64 rng_{std::random_device{}()};
+    std::vector<HTEntry*> sample_;                // reused sampling buffer
+
+    // Keys sampled per pool refill (Redis's maxmemory-samples default).
+    static constexpr size_t kEvictionSamples = 5;
+
+    // ── Active expiry ──
+    ExpireStats expireStats_;
+    bool expireTimedOut_ = false;  // last cycle left due keys behind
+    std::chrono::steady_clock::time_point lastFastCycle_;
+
+    static constexpr size_t kExpireBatch = 64;          // keys per time check
+    static constexpr int kExpireSlowPercent = 25;       // of the timer period
+    static constexpr int64_t kExpireFastUs = 1000;
+    static constexpr double kExpireAcceptableStale = 10.0;  // percent
+    static constexpr size_t kExpireStaleSamples = 20;
+
+    /// Estimate the percentage of keys with a TTL that are past it at
+    /// `now`, from a sample of them.
+    double sampleStalePercent(int64_t now);
+
+    /// Record an access to `entry` for the LRU/LFU policies. `created`
+    /// starts a new key's access data instead of updating it.
+    void touch(HTEntry* entry, bool created);
+
+    /// Sample keys eligible under the policy into evictionPool_.
+    void refillEvictionPool(int64_t now);
+
+    /// Pop the best candidate that still exists and is eligible.
+    /// Returns false if none could be found.
+    bool pickEvictionVictim(std::string& victim);
 
     /// Check if an entry is expired and delete it if so (lazy expiry).
     /// Returns true if the entry was expired and removed.
-    bool checkAndExpire(const std::string& key, HTEntry* entry);
+    bool checkAndExpire(std::string_view key, HTEntry* entry);
 };
@@ -0,0 +1,129 @@
+#include "store/Eviction.h"
+
+#include "store/HashTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+
+// ── Policy names ───────────────────────────────────────────────────────────
+
+static constexpr struct {
+    const char* name;
+    EvictionPolicy policy;
+} kPolicies[] = {
+    {"noeviction",   EvictionPolicy::NOEVICTION},
+    {"allkeys-lru",  EvictionPolicy::ALLKEYS_LRU},
+    {"allkeys-lfu",  EvictionPolicy::ALLKEYS_LFU},
+    {"volatile-lru", EvictionPolicy::VOLATILE_LRU},
+    {"volatile-ttl", EvictionPolicy::VOLATILE_TTL},
+};
+
+bool parseEvictionPolicy(std::string_view name, EvictionPolicy& out) {
+    std::string lower(name);
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    for (const auto& p : kPolicies) {
+        if (lower == p.name) {
+            out = p.policy;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* evictionPolicyName(EvictionPolicy policy) {
+    for (const auto& p : kPolicies) {
+        if (p.policy == policy) return p.name;
+    }
+    return "noeviction";
+}
+
+// ── Clocks ─────────────────────────────────────────────────────────────────
+
+/// LRU clock: seconds, wrapped to 24 bits.
+static uint32_t lruClock(int64_t nowMs) {
+    return static_cast<uint32_t>(nowMs / 1000) & Eviction::kLruMax;
+}
+
+/// LFU decrement time: minutes, wrapped to 16 bits.
+static uint32_t lfuMinutes(int64_t nowMs) {
+    return static_cast<uint32_t>(nowMs / 60000) & 0xFFFF;
+}
+
+/// Milliseconds since the LRU clock read `clock`, allowing one wrap.
+static uint64_t lruIdleMs(uint32_t clock, int64_t nowMs) {
+    uint32_t now = lruClock(nowMs);
+    uint64_t seconds = now >= clock ? now - clock
+                                    : now + (Eviction::kLruMax - clock);
+    return seconds * 1000;
+}
+
+// ── Access data ────────────────────────────────────────────────────────────
+
+uint32_t Eviction::initialAccess(EvictionPolicy policy, int64_t nowMs) {
+    if (policy == EvictionPolicy::ALLKEYS_LFU) {
+        return (lfuMinutes(nowMs) << 8) | kLfuInitVal;
+    }
+    return lruClock(nowMs);
+}
+
+uint32_t Eviction::lfuCounter(uint32_t data, int64_t nowMs) {
+    uint32_t ldt = data >> 8;
+    uint32_t counter = data & 0xFF;
+    uint32_t now = lfuMinutes(nowMs);
+    uint32_t elapsed = now >= ldt ? now - ldt : 0xFFFF - ldt + now;
+    uint32_t periods = elapsed / kLfuDecayMinutes;
+    return periods > counter ? 0 : counter - periods;
+}
+
+uint32_t Eviction::touch(uint32_t data, EvictionPolicy policy, int64_t nowMs,
+                         double random) {
+    if (policy != EvictionPolicy::ALLKEYS_LFU) return lruClock(nowMs);
+
+    // Decay first, then a logarithmic increment: the more hits a key has,
+    // the less likely one more hit bumps the counter.
+    uint32_t counter = lfuCounter(data, nowMs);
+    if (counter < 255) {
+        double base = counter > kLfuInitVal ? counter - kLfuInitVal : 0;
+        if (random < 1.0 / (base * kLfuLogFactor + 1)) ++counter;
+    }
+    return (lfuMinutes(nowMs) << 8) | counter;
+}
+
+uint64_t Eviction::evictionScore(const HTEntry& entry, EvictionPolicy policy,
+                                 int64_t nowMs) {
+    switch (policy) {
+    case EvictionPolicy::ALLKEYS_LFU:
+        return 255 - lfuCounter(entry.lru(), nowMs);
+    case EvictionPolicy::VOLATILE_TTL:
+        // Sooner expiry = higher score.
+        return std::numeric_limits<uint64_t>::max() -
+               static_cast<uint64_t>(entry.expireAt());
+    default:
+        return lruIdleMs(entry.lru(), nowMs);
+    }
+}
+
+// ── Pool ───────────────────────────────────────────────────────────────────
+
+void EvictionPool::offer(std::string_view key, uint64_t score) {
+    auto same = std::find_if(candidates_.begin(), candidates_.end(),
+                             [&](const Candidate& c) { return c.key == key; });
+    if (same != candidates_.end()) candidates_.erase(same);
+
+    if (candidates_.size() == kSize) {
+        if (score <= candidates_.front().score) return;  // worse than all
+        candidates_.erase(candidates_.begin());
+    }
+    auto pos = std::upper_bound(
+        candidates_.begin(), candidates_.end(), score,
+        [](uint64_t s, const Candidate& c) { return s < c.score; });
+    candidates_.insert(pos, Candidate{score, std::string(key)});
+}
+
+bool EvictionPool::popBest(std::string& key) {
+    if (candidates_.empty()) return false;
+    key = std::move(candidates_.back().key);
+    candidates_.pop_back();
+    return true;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class HTEntry;
+
+/// maxmemory-policy: what a write does once used memory is over maxmemory.
+enum class EvictionPolicy : uint8_t {
+    NOEVICTION,    // refuse writes that may grow memory
+    ALLKEYS_LRU,   // evict the least recently used key
+    ALLKEYS_LFU,   // evict the least frequently used key
+    VOLATILE_LRU,  // least recently used among keys with a TTL
+    VOLATILE_TTL   // among keys with a TTL, the one expiring soonest
+};
+
+/// Parse a Redis policy name ("allkeys-lru", ...; case-insensitive).
+/// Returns false for unknown names.
+bool parseEvictionPolicy(std::string_view name, EvictionPolicy& out);
+
+/// The Redis name of `policy`, as shown by INFO.
+const char* evictionPolicyName(EvictionPolicy policy);
+
+/// Per-key access data for eviction, kept in the 24 spare bits of each
+/// HTEntry header (HTEntry::lru()), as Redis keeps it in robj->lru:
+///
+///   LRU policies: a clock in seconds, modulo 2^24 (~194 days).
+///   LFU policy:   16 bits of decrement time in minutes, modulo 2^16,
+///                 then an 8-bit logarithmic access counter.
+///
+/// Must NOT know about: commands, networking.
+namespace Eviction {
+
+/// Largest value of the 24-bit field.
+constexpr uint32_t kLruMax = (1u << 24) - 1;
+/// Counter a new key starts with under LFU, so it is not evicted at once.
+constexpr uint32_t kLfuInitVal = 5;
+/// Higher factors make the counter saturate more slowly (Redis default).
+constexpr uint32_t kLfuLogFactor = 10;
+/// Each full period of this many minutes without access takes one off
+/// the LFU counter.
+constexpr uint32_t kLfuDecayMinutes = 1;
+
+/// True if `policy` keeps per-key access data up to date.
+inline bool tracksAccess(EvictionPolicy policy) {
+    return policy == EvictionPolicy::ALLKEYS_LRU ||
+           policy == EvictionPolicy::ALLKEYS_LFU ||
+           policy == EvictionPolicy::VOLATILE_LRU;
+}
+
+/// True if `policy` only evicts keys that have a TTL.
+inline bool volatileOnly(EvictionPolicy policy) {
+    return policy == EvictionPolicy::VOLATILE_LRU ||
+           policy == EvictionPolicy::VOLATILE_TTL;
+}
+
+/// Access data for a key created now.
+uint32_t initialAccess(EvictionPolicy policy, int64_t nowMs);
+
+/// Access data after one more access at `nowMs`. `random` in [0, 1)
+/// drives the LFU counter's probabilistic increment.
+uint32_t touch(uint32_t data, EvictionPolicy policy, int64_t nowMs,
+               double random);
+
+/// The LFU counter of `data` after decay up to `nowMs`.
+uint32_t lfuCounter(uint32_t data, int64_t nowMs);
+
+/// How good an eviction candidate `entry` is — larger evicts first:
+/// idle milliseconds (LRU), 255 minus the decayed counter (LFU), or
+/// how soon the key expires (volatile-ttl).
+uint64_t evictionScore(const HTEntry& entry, EvictionPolicy policy,
+                       int64_t nowMs);
+
+}  // namespace Eviction
+
+/// The best eviction candidates seen so far, as in Redis's eviction pool.
+///
+/// Each round samples a few keys and offers them; the pool keeps the
+/// kSize highest scores across rounds, so an eviction picks from far
+/// more keys than one sample holds. Entries are key names and may be
+/// stale (the key deleted or accessed since) — the caller re-checks.
+class EvictionPool {
+public:
+    static constexpr size_t kSize = 16;
+
+    /// Add `key` if its score beats the worst candidate (or there is room).
+    /// A key already in the pool keeps one slot, with the new score.
+    void offer(std::string_view key, uint64_t score);
+
+    /// Remove the highest-scoring candidate into `key`. Returns false if
+    /// the pool is empty.
+    bool popBest(std::string& key);
+
+    /// Drop every candidate (e.g. after FLUSHDB).
+    void clear() { candidates_.clear(); }
+
+    size_t size() const { return candidates_.size(); }
+
+private:
+    struct Candidate {
+        uint64_t score;
+        std::string key;
+    };
+    std::vector<Candidate> candidates_;  // ascending by score
+};
@@ -0,0 +1,149 @@
+#include "store/ExpiryWheel.h"
+
+#include <algorithm>
+
+// ── Links ──────────────────────────────────────────────────────────────────
+
+void ExpiryWheel::link(HTEntry*& head, HTEntry* entry) {
+    HTEntry::ExpiryLinks& links = entry->expiryLinks();
+    links.next = head;
+    links.pprev = &head;
+    if (head) head->expiryLinks().pprev = &links.next;
+    head = entry;
+}
+
+void ExpiryWheel::unlink(HTEntry* entry) {
+    HTEntry::ExpiryLinks& links = entry->expiryLinks();
+    *links.pprev = links.next;
+    if (links.next) links.next->expiryLinks().pprev = links.pprev;
+    links = HTEntry::ExpiryLinks();
+}
+
+// ── Placement ──────────────────────────────────────────────────────────────
+
+void ExpiryWheel::place(HTEntry* entry) {
+    // A key already due goes in the current millisecond's slot.
+    int64_t at = std::max(entry->expireAt(), current_);
+    // The level is that of the highest digit where `at` and current_ differ.
+    auto diff = static_cast<uint64_t>(at ^ current_);
+    int level = diff == 0 ? 0 : (63 - __builtin_clzll(diff)) / kSlotBits;
+    if (level >= kLevels) {
+        link(overflow_, entry);
+        return;
+    }
+    int slot = digit(at, level);
+    link(slots_[level][slot], entry);
+    occupied_[level] |= uint64_t{1} << slot;
+}
+
+void ExpiryWheel::cascade(HTEntry*& head) {
+    HTEntry* entry = head;
+    head = nullptr;
+    while (entry) {
+        HTEntry* next = entry->expiryLinks().next;
+        place(entry);
+        entry = next;
+    }
+}
+
+void ExpiryWheel::insert(HTEntry* entry) {
+    place(entry);
+    ++size_;
+}
+
+void ExpiryWheel::remove(HTEntry* entry) {
+    if (!entry->expiryLinks().pprev) return;  // not indexed
+    unlink(entry);
+    --size_;
+}
+
+// ── Expiry ─────────────────────────────────────────────────────────────────
+
+size_t ExpiryWheel::popExpired(int64_t nowMs, size_t maxWork,
+                               std::vector<HTEntry*>& out) {
+    size_t popped = 0;
+    while (size_ > 0) {
+        // The next slot to reach is on the lowest level with a non-empty
+        // slot ahead of current_: each level's slots all come after the
+        // lower levels' slots. Level 0's current slot holds keys due now.
+        int level = -1;
+        int slot = 0;
+        for (int l = 0; l < kLevels && level < 0; ++l) {
+            int cur = digit(current_, l);
+            uint64_t ahead = l == 0 ? ~uint64_t{0} << cur
+                           : cur == kSlots - 1 ? 0
+                           : ~uint64_t{0} << (cur + 1);
+            for (uint64_t bits = occupied_[l] & ahead; bits; bits &= bits - 1) {
+                int s = __builtin_ctzll(bits);
+                if (slots_[l][s]) {
+                    level = l;
+                    slot = s;
+                    break;
+                }
+                occupied_[l] &= ~(uint64_t{1} << s);  // emptied by remove()
+            }
+        }
+
+        // When current_ reaches that slot (or, with only overflow keys
+        // left, the next 2^48 ms boundary).
+        int64_t due;
+        if (level >= 0) {
+            int shift = level * kSlotBits;
+            due = (current_ >> (shift + kSlotBits) << (shift + kSlotBits)) |
+                  (int64_t{slot} << shift);
+        } else {
+            if (!overflow_) break;
+            int shift = kLevels * kSlotBits;
+            due = ((current_ >> shift) + 1) << shift;
+        }
+        if (due > nowMs) break;
+        current_ = due;
+
+        if (level < 0) {
+            cascade(overflow_);
+        } else if (level > 0) {
+            cascade(slots_[level][slot]);
+        } else {
+            // A whole millisecond's worth of keys, all due.
+            HTEntry*& head = slots_[0][slot];
+            while (head) {
+                if (popped == maxWork) return popped;  // resume here next call
+                HTEntry* entry = head;
+                unlink(entry);
+                --size_;
+                out.push_back(entry);
+                ++popped;
+            }
+        }
+    }
+    // Nothing else is due by nowMs, and no slot starts at or before it,
+    // so the wheel can jump ahead without cascading.
+    current_ = std::max(current_, nowMs);
+    return popped;
+}
+
+// ── Whole-wheel operations ─────────────────────────────────────────────────
+
+void ExpiryWheel::clear() {
+    std::fill(&slots_[0][0], &slots_[0][0] + kLevels * kSlots, nullptr);
+    std::fill(occupied_, occupied_ + kLevels, 0);
+    overflow_ = nullptr;
+    size_ = 0;
+}
+
+HTEntry* ExpiryWheel::sample(uint64_t random) const {
+    if (size_ == 0) return nullptr;
+    constexpr int kAllSlots = kLevels * kSlots;
+    int start = static_cast<int>(random % kAllSlots);
+    for (int i = 0; i < kAllSlots; ++i) {
+        int idx = (start + i) % kAllSlots;
+        HTEntry* entry = slots_[idx / kSlots][idx % kSlots];
+        if (!entry) continue;
+        for (uint64_t steps = (random >> 32) % 8;
+             steps > 0 && entry->expiryLinks().next; --steps) {
+            entry = entry->expiryLinks().next;
+        }
+        return entry;
+    }
+    return overflow_;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "store/HashTable.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Index of the keys with a TTL, for active expiry: a hierarchical timing
+/// wheel over absolute expiry times in milliseconds.
+///
+/// Level L has 64 slots of 64^L ms each — 1 ms, 64 ms, ~4 s, ~4 min,
+/// ~4.7 h, ~12 days, ~2.2 years, ~142 years — and holds the keys whose
+/// expireAt first differs from the wheel's current time in its L-th
+/// 6-bit digit. When the current time reaches a slot of level L >= 1,
+/// the slot's keys cascade to lower levels; a level-0 slot is a bucket
+/// of keys expiring in the same millisecond and is popped whole. Keys
+/// more than 2^48 ms (~8,900 years) out wait in an overflow list.
+///
+/// Keys are not copied: each slot is an intrusive list threaded through
+/// the HTEntry expiry slots (HTEntry::ExpiryLinks), so insert and remove
+/// are O(1) with no allocation. A 64-bit occupancy mask per level finds
+/// the next non-empty slot in one instruction, so popExpired() skips idle
+/// stretches instead of stepping through them one millisecond at a time.
+///
+/// The slot heads are pointed at by the entries, so a wheel never moves.
+///
+/// Must NOT know about: networking, RESP, commands, the clock.
+class ExpiryWheel {
+public:
+    ExpiryWheel() = default;
+    ExpiryWheel(const ExpiryWheel&) = delete;
+    ExpiryWheel& operator=(const ExpiryWheel&) = delete;
+
+    /// Index `entry` by its expireAt() (>= 0). It must not be indexed yet.
+    void insert(HTEntry* entry);
+
+    /// Drop `entry` from the index. No-op if it is not indexed.
+    void remove(HTEntry* entry);
+
+    /// Re-index `entry` after its expireAt() changed.
+    void update(HTEntry* entry) {
+        remove(entry);
+        insert(entry);
+    }
+
+    /// Unlink up to `maxWork` entries with expireAt <= nowMs and append
+    /// them to `out`, earliest millisecond first (keys that were already
+    /// due when inserted come first, in any order). Returns how many.
+    size_t popExpired(int64_t nowMs, size_t maxWork,
+                      std::vector<HTEntry*>& out);
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    /// Forget every entry (their links are left as they are — for
+    /// FLUSHDB, which frees them next).
+    void clear();
+
+    /// An indexed entry chosen using `random`, or nullptr if empty — the
+    /// sampling step of volatile eviction. Not uniform: a random slot,
+    /// then a few steps along it.
+    HTEntry* sample(uint64_t random) const;
+
+private:
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    static constexpr int kLevels = 8;
+
+    HTEntry* slots_[kLevels][kSlots] = {};
+    // Bit s set if slots_[L][s] may be non-empty. Set on link, cleared
+    // when a search finds the slot empty.
+    uint64_t occupied_[kLevels] = {};
+    HTEntry* overflow_ = nullptr;
+    int64_t current_ = 0;  // every indexed key is due at or after this
+    size_t size_ = 0;
+
+    /// Link `entry` into the slot for its expireAt, relative to current_.
+    void place(HTEntry* entry);
+
+    /// Re-place every entry of the list at `head`, which is emptied.
+    void cascade(HTEntry*& head);
+
+    static void link(HTEntry*& head, HTEntry* entry);
+    static void unlink(HTEntry* entry);
+
+    static int digit(int64_t time, int level) {
+        return static_cast<int>((time >> (level * kSlotBits)) & (kSlots - 1));
+    }
+};
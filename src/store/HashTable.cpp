@@ -2,13 +2,19 @@
 
 #include <cassert>
 #include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 // ── FNV-1a 64-bit hash ────────────────────────────────────────────────────
 // FNV offset basis and prime for 64-bit FNV-1a.
 static constexpr uint64_t kFNVOffsetBasis = 14695981039346656037ULL;
 static constexpr uint64_t kFNVPrime       = 1099511628211ULL;
 
-uint64_t HashTable::hash(const std::string& key) {
+uint64_t HashTable::hash(std::string_view key) {
     uint64_t h = kFNVOffsetBasis;
     for (unsigned char c : key) {
         h ^= c;
@@ -17,36 +23,154 @@ uint64_t HashTable::hash(const std::string& key) {
     return h;
 }
 
+// ── Control bytes ─────────────────────────────────────────────────────────
+// A full slot holds its key's 7-bit tag (high bit clear); the two special
+// values both have the high bit set, so "not full" is one sign test.
+
+static constexpr uint8_t kEmpty   = 0x80;
+static constexpr uint8_t kDeleted = 0xFE;
+
+/// Low 7 bits of the hash — stored in the control byte.
+static inline uint8_t tagOf(uint64_t h) { return static_cast<uint8_t>(h & 0x7F); }
+
+/// Remaining bits — pick the first group to probe.
+static inline size_t groupOf(uint64_t h) { return static_cast<size_t>(h >> 7); }
+
+/// Bitmasks over the 16 control bytes of one group: bit i is set if slot i
+/// of the group matches.
+struct Group {
+#if defined(__SSE2__)
+    __m128i ctrl;
+
+    explicit Group(const uint8_t* p)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+
+    uint32_t match(uint8_t tag) const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(
+            _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(tag)))));
+    }
+    uint32_t matchEmpty() const { return match(kEmpty); }
+    /// EMPTY or DELETED: the only control bytes with the high bit set.
+    uint32_t matchFree() const {
+        return static_cast<uint32_t>(_mm_movemask_epi8(ctrl));
+    }
+#else
+    const uint8_t* ctrl;
+
+    explicit Group(const uint8_t* p) : ctrl(p) {}
+
+    uint32_t match(uint8_t tag) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < HashTable::kGroupWidth; ++i) {
+            if (ctrl[i] == tag) mask |= 1u << i;
+        }
+        return mask;
+    }
+    uint32_t matchEmpty() const { return match(kEmpty); }
+    uint32_t matchFree() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < HashTable::kGroupWidth; ++i) {
+            if (ctrl[i] & 0x80) mask |= 1u << i;
+        }
+        return mask;
+    }
+#endif
+    uint32_t matchFull() const { return ~matchFree() & 0xFFFFu; }
+};
+
+// ── Entries ────────────────────────────────────────────────────────────────
+
+bool HTEntry::embeds(const RedisObject& value) {
+    return value.type == DataType::STRING &&
+           (value.encoding == Encoding::RAW ||
+            value.encoding == Encoding::EMBSTR) &&
+           value.stringBytes().size() <= RedisObject::kEmbstrMaxLen;
+}
+
+HTEntry* HTEntry::create(std::string_view key, uint64_t hashCode,
+                         RedisObject&& value, bool withExpire,
+                         int64_t expireAt) {
+    size_t expireBytes = withExpire ? kExpireSlotBytes : 0;
+    bool embed = embeds(value);
+    size_t embLen = embed ? value.stringBytes().size() : 0;
+    void* mem = ::operator new(sizeof(HTEntry) + expireBytes + key.size() +
+                               embLen);
+    auto* entry = new (mem) HTEntry();
+    entry->hashCode = hashCode;
+    entry->keyLen_  = static_cast<uint32_t>(key.size());
+    entry->flags_   = withExpire ? kHasExpire : 0;
+    entry->lru_     = 0;
+
+    char* p = entry->tail();
+    if (withExpire) {
+        std::memcpy(p, &expireAt, sizeof(expireAt));
+        new (p + sizeof(expireAt)) ExpiryLinks();
+    }
+    p += expireBytes;
+    std::memcpy(p, key.data(), key.size());
+    p += key.size();
+
+    if (embed) {
+        // Copy the bytes in; `value` (a RAW string, or a view) is dropped.
+        if (embLen > 0) std::memcpy(p, value.stringBytes().data(), embLen);
+        entry->value = RedisObject::createEmbedded({p, embLen});
+        value = RedisObject();
+    } else {
+        entry->value = std::move(value);
+    }
+    return entry;
+}
+
+void HTEntry::takeExpiryLinks(HTEntry* from, HTEntry* to) {
+    ExpiryLinks& links = to->expiryLinks();
+    links = from->expiryLinks();
+    if (!links.pprev) return;
+    *links.pprev = to;
+    if (links.next) links.next->expiryLinks().pprev = &links.next;
+}
+
+void HTEntry::destroy(HTEntry* entry) {
+    entry->~HTEntry();
+    ::operator delete(entry);
+}
+
+size_t HTEntry::memoryUsage() const {
+    // The header's RedisObject and the embedded bytes are counted by
+    // value.memoryUsage().
+    return sizeof(HTEntry) - sizeof(RedisObject) +
+           (hasExpireSlot() ? kExpireSlotBytes : 0) + keyLen_ +
+           value.memoryUsage();
+}
+
 // ── Table helpers ──────────────────────────────────────────────────────────
 
 HashTable::Table HashTable::allocTable(size_t capacity) {
-    // INV: capacity must be a power of 2.
-    assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    // INV: capacity must be a power of 2 and at least one group.
+    assert(capacity >= kGroupWidth && (capacity & (capacity - 1)) == 0);
     Table t;
-    t.slots    = new HTEntry*[capacity]();  // zero-initialized (all nullptr)
-    t.capacity = capacity;
-    t.mask     = capacity - 1;
-    t.size     = 0;
+    // Control bytes first; capacity is a multiple of 16, so the pointer
+    // array that follows is aligned.
+    auto* mem = static_cast<uint8_t*>(
+        ::operator new(capacity * (1 + sizeof(HTEntry*))));
+    t.ctrl      = mem;
+    t.slots     = reinterpret_cast<HTEntry**>(mem + capacity);
+    t.capacity  = capacity;
+    t.groupMask = capacity / kGroupWidth - 1;
+    std::memset(t.ctrl, kEmpty, capacity);
     return t;
 }
 
+void HashTable::releaseSlots(Table& table) {
+    ::operator delete(table.ctrl);
+    table = Table{};
+}
+
 void HashTable::freeTable(Table& table) {
-    if (table.slots) {
-        // Free all entries in all chains.
-        for (size_t i = 0; i < table.capacity; ++i) {
-            HTEntry* entry = table.slots[i];
-            while (entry) {
-                HTEntry* next = entry->next;
-                delete entry;
-                entry = next;
-            }
-        }
-        delete[] table.slots;
-        table.slots    = nullptr;
-        table.capacity = 0;
-        table.mask     = 0;
-        table.size     = 0;
+    if (!table.ctrl) return;
+    for (size_t i = 0; i < table.capacity; ++i) {
+        if (!(table.ctrl[i] & 0x80)) HTEntry::destroy(table.slots[i]);
     }
+    releaseSlots(table);
 }
 
 // ── Constructor / Destructor ──────────────────────────────────────────────
@@ -61,39 +185,82 @@ HashTable::~HashTable() {
     freeTable(rehash_);
 }
 
-// ── Lookup ────────────────────────────────────────────────────────────────
+// ── Probing ───────────────────────────────────────────────────────────────
+
+size_t HashTable::findSlot(const Table& table, std::string_view key,
+                           uint64_t hashCode) {
+    if (table.ctrl == nullptr) return kNotFound;
+    uint8_t tag = tagOf(hashCode);
+    size_t g = groupOf(hashCode) & table.groupMask;
+    for (size_t step = 1;; ++step) {
+        size_t base = g * kGroupWidth;
+        Group group(table.ctrl + base);
+        for (uint32_t m = group.match(tag); m != 0; m &= m - 1) {
+            size_t idx = base + __builtin_ctz(m);
+            const HTEntry* entry = table.slots[idx];
+            if (entry->hashCode == hashCode && entry->key() == key) {
+                return idx;
+            }
+        }
+        // A group with an EMPTY slot never overflowed into the next one.
+        if (group.matchEmpty() != 0) return kNotFound;
+        // Triangular steps visit every group of a power-of-two table.
+        g = (g + step) & table.groupMask;
+    }
+}
 
-HTEntry* HashTable::findInTable(Table& table, const std::string& key,
-                                uint64_t hashCode) {
-    if (table.slots == nullptr) return nullptr;
-    size_t idx = hashCode & table.mask;
-    HTEntry* entry = table.slots[idx];
-    while (entry) {
-        if (entry->hashCode == hashCode && entry->key == key) {
-            return entry;
+void HashTable::insertEntry(Table& table, HTEntry* entry) {
+    assert(table.size + table.tombstones < growthLimit(table.capacity));
+    size_t g = groupOf(entry->hashCode) & table.groupMask;
+    for (size_t step = 1;; ++step) {
+        size_t base = g * kGroupWidth;
+        uint32_t free = Group(table.ctrl + base).matchFree();
+        if (free != 0) {
+            size_t idx = base + __builtin_ctz(free);
+            if (table.ctrl[idx] == kDeleted) table.tombstones--;
+            table.ctrl[idx]  = tagOf(entry->hashCode);
+            table.slots[idx] = entry;
+            table.size++;
+            return;
         }
-        entry = entry->next;
+        g = (g + step) & table.groupMask;
     }
-    return nullptr;
 }
 
-HTEntry* HashTable::find(const std::string& key) {
+void HashTable::eraseSlot(Table& table, size_t idx) {
+    // If the group still has an EMPTY slot it has never been full, so no
+    // probe sequence continues past it and the slot can become EMPTY again.
+    // Otherwise leave a tombstone to keep later groups reachable.
+    size_t base = idx & ~(kGroupWidth - 1);
+    if (Group(table.ctrl + base).matchEmpty() != 0) {
+        table.ctrl[idx] = kEmpty;
+    } else {
+        table.ctrl[idx] = kDeleted;
+        table.tombstones++;
+    }
+    table.size--;
+}
+
+// ── Lookup ────────────────────────────────────────────────────────────────
+
+HTEntry* HashTable::find(std::string_view key) {
     uint64_t h = hash(key);
 
     // Check primary_ first (newer/larger table).
-    HTEntry* entry = findInTable(primary_, key, h);
-    if (entry) return entry;
+    size_t idx = findSlot(primary_, key, h);
+    if (idx != kNotFound) return primary_.slots[idx];
 
     // During rehashing, also check the old table.
     if (isRehashing_) {
-        entry = findInTable(rehash_, key, h);
+        idx = findSlot(rehash_, key, h);
+        if (idx != kNotFound) return rehash_.slots[idx];
     }
-    return entry;
+    return nullptr;
 }
 
 // ── Insert / Overwrite ────────────────────────────────────────────────────
 
-void HashTable::set(const std::string& key, RedisObject value) {
+HTEntry* HashTable::set(std::string_view key, RedisObject value) {
     // Do incremental rehashing work if in progress.
     if (isRehashing_) {
         rehashStep(kRehashBatchSize);
@@ -101,72 +268,89 @@ void HashTable::set(const std::string& key, RedisObject value) {
 
     uint64_t h = hash(key);
 
-    // If rehashing, check and remove from the old table first.
-    if (isRehashing_) {
-        delFromTable(rehash_, key, h);
+    // Overwrite if the key exists in either table. Preserve the existing
+    // expireAt — the SET command will handle resetting it if needed.
+    Table* table = &primary_;
+    size_t idx = findSlot(primary_, key, h);
+    if (idx == kNotFound && isRehashing_) {
+        table = &rehash_;
+        idx = findSlot(rehash_, key, h);
+    }
+    if (idx != kNotFound) {
+        HTEntry* old = table->slots[idx];
+        bool embed = HTEntry::embeds(value);
+        if (!embed && !HTEntry::embeds(old->value)) {
+            old->value = std::move(value);  // same allocation size
+            return old;
+        }
+        if (embed && old->value.encoding == Encoding::EMBSTR &&
+            value.stringBytes().size() == old->value.stringBytes().size()) {
+            // Same length: overwrite the embedded bytes in place.
+            std::memcpy(const_cast<char*>(old->value.stringBytes().data()),
+                        value.stringBytes().data(),
+                        value.stringBytes().size());
+            return old;
+        }
+        HTEntry* entry = HTEntry::create(old->key(), h, std::move(value),
+                                         old->hasExpireSlot(), old->expireAt());
+        entry->lru_ = old->lru_;
+        if (old->hasExpireSlot()) HTEntry::takeExpiryLinks(old, entry);
+        table->slots[idx] = entry;
+        HTEntry::destroy(old);
+        return entry;
     }
 
     // Lazy allocation of primary_ on first insert.
-    if (primary_.slots == nullptr) {
+    if (primary_.ctrl == nullptr) {
         primary_ = allocTable(kInitialCapacity);
     }
 
-    // Check if key already exists in primary_ — overwrite if so.
-    HTEntry* existing = findInTable(primary_, key, h);
-    if (existing) {
-        existing->value = std::move(value);
-        // Preserve existing expireAt — the SET command will handle
-        // resetting it if needed.
-        return;
-    }
-
-    // Insert new entry at the head of the chain.
-    auto* entry     = new HTEntry();
-    entry->key      = key;
-    entry->value    = std::move(value);
-    entry->hashCode = h;
-    entry->expireAt = -1;
-
-    size_t idx = h & primary_.mask;
-    entry->next          = primary_.slots[idx];
-    primary_.slots[idx]  = entry;
-    primary_.size++;
-
-    // Check load factor — trigger rehash if needed.
-    double loadFactor = static_cast<double>(primary_.size) /
-                        static_cast<double>(primary_.capacity);
-    if (!isRehashing_ && loadFactor > kMaxLoadFactor) {
+    // Rebuild before the table gets too full to probe quickly. Counting
+    // rehash_'s remaining entries guarantees room for them once drained.
+    size_t pending = isRehashing_ ? rehash_.size : 0;
+    if (primary_.size + primary_.tombstones + pending + 1 >
+        growthLimit(primary_.capacity)) {
+        while (isRehashing_) migrateOneSlot();
         triggerRehash();
     }
+
+    HTEntry* entry = HTEntry::create(key, h, std::move(value), false, -1);
+    insertEntry(primary_, entry);
+    return entry;
 }
 
-// ── Delete ────────────────────────────────────────────────────────────────
+// ── Expiry ────────────────────────────────────────────────────────────────
 
-bool HashTable::delFromTable(Table& table, const std::string& key,
-                             uint64_t hashCode) {
-    if (table.slots == nullptr) return false;
-    size_t idx = hashCode & table.mask;
-    HTEntry* prev  = nullptr;
-    HTEntry* entry = table.slots[idx];
-    while (entry) {
-        if (entry->hashCode == hashCode && entry->key == key) {
-            // Unlink from chain.
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                table.slots[idx] = entry->next;
-            }
-            delete entry;
-            table.size--;
-            return true;
-        }
-        prev  = entry;
-        entry = entry->next;
+HTEntry*& HashTable::slotOf(const HTEntry* entry) {
+    std::string_view key = entry->key();
+    size_t idx = findSlot(primary_, key, entry->hashCode);
+    if (idx != kNotFound) return primary_.slots[idx];
+    idx = findSlot(rehash_, key, entry->hashCode);
+    assert(idx != kNotFound && rehash_.slots[idx] == entry);
+    return rehash_.slots[idx];
+}
+
+HTEntry* HashTable::setExpire(HTEntry* entry, int64_t expireAtMs) {
+    if (entry->hasExpireSlot()) {
+        std::memcpy(entry->tail(), &expireAtMs, sizeof(expireAtMs));
+        return entry;
     }
-    return false;
+    if (expireAtMs < 0) return entry;  // nothing to clear
+
+    // First TTL on this key: rebuild the entry with an expiry slot.
+    HTEntry*& slot = slotOf(entry);
+    HTEntry* grown = HTEntry::create(entry->key(), entry->hashCode,
+                                     std::move(entry->value), true,
+                                     expireAtMs);
+    grown->lru_ = entry->lru_;
+    slot = grown;
+    HTEntry::destroy(entry);
+    return grown;
 }
 
-bool HashTable::del(const std::string& key) {
+// ── Delete ────────────────────────────────────────────────────────────────
+
+bool HashTable::del(std::string_view key) {
     // Do incremental rehashing work if in progress.
     if (isRehashing_) {
         rehashStep(kRehashBatchSize);
@@ -174,14 +358,19 @@ bool HashTable::del(const std::string& key) {
 
     uint64_t h = hash(key);
 
-    // Try primary_ first.
-    if (delFromTable(primary_, key, h)) return true;
-
-    // During rehashing, also try the old table.
-    if (isRehashing_) {
-        return delFromTable(rehash_, key, h);
+    // Try primary_ first; during rehashing, also try the old table.
+    Table* table = &primary_;
+    size_t idx = findSlot(primary_, key, h);
+    if (idx == kNotFound && isRehashing_) {
+        table = &rehash_;
+        idx = findSlot(rehash_, key, h);
     }
-    return false;
+    if (idx == kNotFound) return false;
+
+    HTEntry::destroy(table->slots[idx]);
+    eraseSlot(*table, idx);
+    maybeShrink();
+    return true;
 }
 
 // ── Size ──────────────────────────────────────────────────────────────────
@@ -190,6 +379,10 @@ size_t HashTable::size() const {
     return primary_.size + rehash_.size;
 }
 
+size_t HashTable::slotMemory() const {
+    return (primary_.capacity + rehash_.capacity) * (1 + sizeof(HTEntry*));
+}
+
 // ── Keys ──────────────────────────────────────────────────────────────────
 
 std::vector<std::string> HashTable::keys() const {
@@ -197,12 +390,11 @@ std::vector<std::string> HashTable::keys() const {
     result.reserve(size());
 
     auto collect = [&](const Table& table) {
-        if (!table.slots) return;
-        for (size_t i = 0; i < table.capacity; ++i) {
-            HTEntry* entry = table.slots[i];
-            while (entry) {
-                result.push_back(entry->key);
-                entry = entry->next;
+        if (!table.ctrl) return;
+        for (size_t base = 0; base < table.capacity; base += kGroupWidth) {
+            for (uint32_t m = Group(table.ctrl + base).matchFull(); m != 0;
+                 m &= m - 1) {
+                result.emplace_back(table.slots[base + __builtin_ctz(m)]->key());
             }
         }
     };
@@ -213,110 +405,181 @@ std::vector<std::string> HashTable::keys() const {
 }
 
 // ── Scan ──────────────────────────────────────────────────────────────────
+// The cursor walks home groups (the group a key's probe starts from) in
+// reverse-binary order, as Redis's dictScan walks buckets. Growing a table
+// appends a high bit to every home group, so group g of a 2^n-group table
+// becomes groups g and g + 2^n; incrementing the reversed cursor visits
+// those together, which keeps an iteration complete across resizes.
+
+/// Reverse the bits of `v`.
+static size_t reverseBits(size_t v) {
+    static_assert(sizeof(size_t) == 8, "reverseBits assumes 64-bit size_t");
+    v = ((v >> 1) & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+    v = ((v >> 2) & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+    v = ((v >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    return __builtin_bswap64(v);
+}
+
+/// Advance `v` to the next cursor over the groups covered by `mask`.
+static size_t nextCursor(size_t v, size_t mask) {
+    v |= ~mask;  // carry through the bits above the mask
+    v = reverseBits(v);
+    ++v;
+    return reverseBits(v);
+}
+
+void HashTable::collectHomeGroup(const Table& table, size_t home,
+                                 std::vector<std::string>& out) {
+    // Entries whose probe starts at `home` sit on its probe sequence, no
+    // later than the first group with an EMPTY slot (see findSlot()).
+    size_t g = home;
+    for (size_t step = 1;; ++step) {
+        size_t base = g * kGroupWidth;
+        Group group(table.ctrl + base);
+        for (uint32_t m = group.matchFull(); m != 0; m &= m - 1) {
+            const HTEntry* entry = table.slots[base + __builtin_ctz(m)];
+            if ((groupOf(entry->hashCode) & table.groupMask) == home) {
+                out.emplace_back(entry->key());
+            }
+        }
+        if (group.matchEmpty() != 0 || step > table.groupMask) return;
+        g = (g + step) & table.groupMask;
+    }
+}
+
+size_t HashTable::scanStep(size_t cursor,
+                           std::vector<std::string>& out) const {
+    if (!isRehashing_) {
+        collectHomeGroup(primary_, cursor & primary_.groupMask, out);
+        return nextCursor(cursor, primary_.groupMask);
+    }
+
+    // Visit the smaller table's group, then every group of the larger
+    // table that it expands into.
+    const Table* small = &primary_;
+    const Table* large = &rehash_;
+    if (small->capacity > large->capacity) std::swap(small, large);
+    size_t m0 = small->groupMask;
+    size_t m1 = large->groupMask;
+
+    collectHomeGroup(*small, cursor & m0, out);
+    do {
+        collectHomeGroup(*large, cursor & m1, out);
+        cursor = nextCursor(cursor, m1);
+    } while (cursor & (m0 ^ m1));
+    return cursor;
+}
 
 std::pair<size_t, std::vector<std::string>>
 HashTable::scan(size_t cursor, size_t count) const {
     std::vector<std::string> result;
 
     // If primary_ is empty, return cursor 0 (iteration complete, no keys).
-    if (primary_.slots == nullptr || primary_.capacity == 0) {
+    if (primary_.ctrl == nullptr || primary_.capacity == 0) {
         return {0, result};
     }
 
-    // Walk slots starting from `cursor`. Each slot may have a chain of entries.
-    size_t visited = 0;
-    size_t slot = cursor;
-
-    while (visited < count && slot < primary_.capacity) {
-        HTEntry* entry = primary_.slots[slot];
-        while (entry) {
-            result.push_back(entry->key);
-            ++visited;
-            entry = entry->next;
-        }
-        ++slot;
-    }
+    // Stop after `count` keys, or after a bounded number of home groups so
+    // that a sparse table cannot turn one call into a full sweep.
+    size_t maxVisits = count * kScanVisitsPerCount;
+    do {
+        cursor = scanStep(cursor, result);
+    } while (cursor != 0 && result.size() < count && --maxVisits > 0);
+    return {cursor, result};
+}
 
-    // Also collect from rehash_ table (keys not yet migrated).
-    if (isRehashing_ && rehash_.slots != nullptr) {
-        // On the first call (cursor == 0), also scan rehash_ from slot 0.
-        // We do a full scan of rehash_ to ensure no keys are missed.
-        // This is acceptable because rehash_ is being drained.
-        if (cursor == 0) {
-            for (size_t i = 0; i < rehash_.capacity; ++i) {
-                HTEntry* entry = rehash_.slots[i];
-                while (entry) {
-                    result.push_back(entry->key);
-                    entry = entry->next;
-                }
+// ── Sampling ──────────────────────────────────────────────────────────────
+
+void HashTable::sampleEntries(uint64_t random, size_t count,
+                              std::vector<HTEntry*>& out) const {
+    if (size() == 0) return;
+    // Like Redis's dictGetSomeKeys: consecutive groups from a random
+    // start, in both tables while rehashing.
+    size_t target = out.size() + count;
+    size_t g = static_cast<size_t>(random);
+    for (size_t visits = 0;
+         visits < count * kScanVisitsPerCount && out.size() < target;
+         ++visits, ++g) {
+        for (const Table* table : {&primary_, &rehash_}) {
+            if (!table->ctrl) continue;
+            size_t base = (g & table->groupMask) * kGroupWidth;
+            for (uint32_t m = Group(table->ctrl + base).matchFull();
+                 m != 0 && out.size() < target; m &= m - 1) {
+                out.push_back(table->slots[base + __builtin_ctz(m)]);
             }
         }
     }
-
-    // If we've reached the end of primary_, next cursor is 0 (done).
-    size_t nextCursor = (slot >= primary_.capacity) ? 0 : slot;
-    return {nextCursor, result};
 }
 
 // ── Incremental Rehashing ─────────────────────────────────────────────────
 
 void HashTable::triggerRehash() {
+    // Double when live keys fill more than half the growth limit; below
+    // that, tombstones caused the rebuild and the same size suffices.
+    size_t capacity = primary_.capacity;
+    if (primary_.size + 1 > growthLimit(capacity) / 2) capacity *= 2;
+    startRehash(capacity);
+}
+
+void HashTable::maybeShrink() {
+    if (isRehashing_ || primary_.capacity <= kInitialCapacity ||
+        primary_.size >= primary_.capacity / kShrinkDivisor) {
+        return;
+    }
+    // Smallest table the keys fill at most half of the growth limit, so
+    // the shrunken table is well clear of both thresholds.
+    size_t capacity = kInitialCapacity;
+    while (primary_.size > growthLimit(capacity) / 2) capacity *= 2;
+    startRehash(capacity);
+}
+
+void HashTable::startRehash(size_t capacity) {
     assert(!isRehashing_);
     // INV: primary_ capacity must be > 0 to trigger rehash.
-    assert(primary_.slots != nullptr && primary_.capacity > 0);
+    assert(primary_.ctrl != nullptr && primary_.capacity > 0);
 
     // Move current primary_ into rehash_ (it becomes the old table).
     rehash_    = primary_;
-    // Allocate a new primary_ at 2× capacity.
-    primary_   = allocTable(rehash_.capacity * 2);
+    primary_   = allocTable(capacity);
     isRehashing_ = true;
     rehashIdx_   = 0;
 }
 
 void HashTable::migrateOneSlot() {
-    // Skip empty slots.
-    while (rehashIdx_ < rehash_.capacity &&
-           rehash_.slots[rehashIdx_] == nullptr) {
-        rehashIdx_++;
-    }
-    if (rehashIdx_ >= rehash_.capacity) {
-        // All slots migrated — rehashing complete.
-        freeTable(rehash_);
-        isRehashing_ = false;
-        rehashIdx_   = 0;
-        return;
+    // Skip free slots a group at a time.
+    while (rehashIdx_ < rehash_.capacity) {
+        size_t base = rehashIdx_ & ~(kGroupWidth - 1);
+        uint32_t full = Group(rehash_.ctrl + base).matchFull();
+        full &= ~0u << (rehashIdx_ - base);  // slots already migrated
+        if (full != 0) {
+            rehashIdx_ = base + __builtin_ctz(full);
+            break;
+        }
+        rehashIdx_ = base + kGroupWidth;
     }
 
-    // Migrate all entries in this slot to primary_.
-    HTEntry* entry = rehash_.slots[rehashIdx_];
-    while (entry) {
-        HTEntry* next = entry->next;
-
-        // Re-insert into primary_ using the cached hashCode.
-        size_t idx      = entry->hashCode & primary_.mask;
-        entry->next     = primary_.slots[idx];
-        primary_.slots[idx] = entry;
-        primary_.size++;
-        rehash_.size--;
-
-        entry = next;
+    if (rehashIdx_ < rehash_.capacity) {
+        // Re-insert into primary_ using the cached hashCode. The old slot
+        // gets EMPTY/DELETED so lookups in rehash_ no longer see the key.
+        insertEntry(primary_, rehash_.slots[rehashIdx_]);
+        eraseSlot(rehash_, rehashIdx_);
+        rehashIdx_++;
     }
-    rehash_.slots[rehashIdx_] = nullptr;
-    rehashIdx_++;
 
     // Check if rehashing is complete.
     if (rehash_.size == 0) {
-        delete[] rehash_.slots;
-        rehash_.slots    = nullptr;
-        rehash_.capacity = 0;
-        rehash_.mask     = 0;
-        isRehashing_     = false;
-        rehashIdx_       = 0;
+        releaseSlots(rehash_);
+        isRehashing_ = false;
+        rehashIdx_   = 0;
     }
 }
 
 void HashTable::rehashStep(int nSteps) {
-    if (!isRehashing_) return;
+    // Deletes during a rehash cannot start a shrink; catch up here.
+    if (!isRehashing_) {
+        maybeShrink();
+        return;
+    }
     for (int i = 0; i < nSteps && isRehashing_; ++i) {
         migrateOneSlot();
     }
@@ -336,12 +599,10 @@ void HashTable::flushAll() {
 size_t HashTable::expiryCount() const {
     size_t count = 0;
     auto countInTable = [&](const Table& table) {
-        if (!table.slots) return;
+        if (!table.ctrl) return;
         for (size_t i = 0; i < table.capacity; ++i) {
-            HTEntry* entry = table.slots[i];
-            while (entry) {
-                if (entry->expireAt >= 0) ++count;
-                entry = entry->next;
+            if (!(table.ctrl[i] & 0x80) && table.slots[i]->expireAt() >= 0) {
+                ++count;
             }
         }
     };
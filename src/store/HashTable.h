@@ -4,23 +4,119 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 
-/// An entry in the hash table's separate-chaining linked list.
-struct HTEntry {
-    std::string key;
-    RedisObject value;
+/// One key in the hash table, in a single allocation:
+///
+///   [ HTEntry header | expiry slot (optional) | key bytes | EMBSTR bytes ]
+///
+/// The 32-byte header holds the cached hash, the 16-byte RedisObject, the
+/// key length and 24 bits of eviction access data. The expiry slot, only
+/// present once the key has had a TTL, holds expireAt and the entry's
+/// links in the expiry index (ExpiryWheel).
+/// A short string value (up to RedisObject::kEmbstrMaxLen bytes) is
+/// copied after the key and `value` points at it (EMBSTR); integers live
+/// in `value` itself, and long strings and containers stay behind its
+/// pointer.
+///
+/// Created and freed only by HashTable. Rehashing never moves an entry;
+/// only HashTable::set() (when an overwrite changes the embedded length)
+/// and HashTable::setExpire() (on a key's first TTL) reallocate one, and
+/// both return the new pointer. set() carries the expiry links over, so
+/// the expiry index never holds a stale pointer.
+class HTEntry {
+public:
     uint64_t hashCode;          // cached hash — avoids rehashing during migration
-    int64_t expireAt = -1;      // -1 = no expiry; milliseconds since epoch (Phase 3)
-    HTEntry* next = nullptr;    // next entry in the chain
+    RedisObject value;
+
+    /// Intrusive list links for the expiry index. HashTable keeps them
+    /// valid when it moves an entry but otherwise never follows them.
+    struct ExpiryLinks {
+        HTEntry* next = nullptr;
+        HTEntry** pprev = nullptr;  // the pointer to this entry; nullptr = unlinked
+    };
+
+    std::string_view key() const {
+        return {tail() + (hasExpireSlot() ? kExpireSlotBytes : 0), keyLen_};
+    }
+
+    /// -1 = no expiry; milliseconds since epoch (Phase 3).
+    int64_t expireAt() const {
+        if (!hasExpireSlot()) return -1;
+        int64_t ms;
+        std::memcpy(&ms, tail(), sizeof(ms));
+        return ms;
+    }
+
+    /// The expiry links. Only for an entry with a TTL (expireAt() >= 0).
+    ExpiryLinks& expiryLinks() {
+        return *reinterpret_cast<ExpiryLinks*>(tail() + sizeof(int64_t));
+    }
+
+    /// Bytes this key accounts for: the entry allocation plus everything
+    /// the value owns on the heap.
+    size_t memoryUsage() const;
+
+    /// 24 bits of access data for eviction: an LRU clock or LFU time and
+    /// counter (see Eviction.h). Kept across overwrites and TTL changes.
+    uint32_t lru() const { return lru_; }
+    void setLru(uint32_t data) { lru_ = data & 0xFFFFFF; }
+
+private:
+    friend class HashTable;
+
+    static constexpr uint8_t kHasExpire = 1;  // flags_: expiry slot present
+    static constexpr size_t kExpireSlotBytes = sizeof(int64_t) + sizeof(ExpiryLinks);
+
+    uint32_t keyLen_ = 0;
+    uint32_t flags_ : 8;   // set by create()
+    uint32_t lru_   : 24;  // fills the header's padding
+
+    HTEntry() = default;
+    ~HTEntry() = default;
+
+    bool hasExpireSlot() const { return flags_ & kHasExpire; }
+    char* tail() { return reinterpret_cast<char*>(this + 1); }
+    const char* tail() const { return reinterpret_cast<const char*>(this + 1); }
+
+    /// Build an entry for `key`, taking `value`. A RAW or EMBSTR string of
+    /// at most kEmbstrMaxLen bytes is copied into the allocation. With
+    /// `withExpire` the entry gets an expiry slot holding `expireAt`, unlinked.
+    static HTEntry* create(std::string_view key, uint64_t hashCode,
+                           RedisObject&& value, bool withExpire,
+                           int64_t expireAt);
+
+    /// Destroy the value and free the allocation.
+    static void destroy(HTEntry* entry);
+
+    /// True if create() would copy `value`'s bytes into the entry.
+    static bool embeds(const RedisObject& value);
+
+    /// Move `from`'s place in the expiry index to its replacement `to`.
+    static void takeExpiryLinks(HTEntry* from, HTEntry* to);
 };
 
-/// Primary key-value store. Separate chaining with FNV-1a hash.
-/// Power-of-two sizing. Incremental rehashing via a dual-table approach.
+static_assert(sizeof(HTEntry) == 32, "HTEntry header should stay 32 bytes");
+
+/// Primary key-value store. Open addressing in the style of a Swiss table,
+/// FNV-1a hash, power-of-two sizing, incremental rehashing via a
+/// dual-table approach.
+///
+/// Slots are grouped 16 at a time. Each slot has a control byte: EMPTY,
+/// DELETED (tombstone) or, for a full slot, the low 7 bits of its key's
+/// hash. A lookup hashes once, picks a starting group from the upper hash
+/// bits and compares the 7-bit tag against all 16 control bytes of a group
+/// with one SSE2 compare. Only tag matches dereference the entry, so a miss
+/// almost never touches an entry and a hit usually touches exactly one.
+/// Probing moves group by group (triangular steps) and stops at the first
+/// group that still has an EMPTY slot. Tables are kept at most 7/8 full,
+/// and shrink (through the same rehashing) once less than 1/8 full.
 ///
-/// During rehashing, two tables exist: primary_ (new, larger) and rehash_
-/// (old, being drained). Reads check primary_ first, then rehash_. Writes
+/// During rehashing, two tables exist: primary_ (new) and rehash_ (old,
+/// being drained). Reads check primary_ first, then rehash_. New keys
 /// always go to primary_. Each mutating operation migrates up to
 /// kRehashBatchSize entries from rehash_ to primary_.
 ///
@@ -35,13 +131,21 @@ public:
 
     /// Find an entry by key. Returns nullptr if not found.
     /// Checks primary_ first, then rehash_ (during rehashing).
-    HTEntry* find(const std::string& key);
+    HTEntry* find(std::string_view key);
 
-    /// Insert or overwrite a key-value pair. Always writes to primary_.
-    void set(const std::string& key, RedisObject value);
+    /// Insert or overwrite a key-value pair and return its entry. An
+    /// overwrite keeps the key's expireAt and stays in its table; new keys
+    /// always go to primary_. The returned pointer replaces any previous
+    /// HTEntry* for this key.
+    HTEntry* set(std::string_view key, RedisObject value);
+
+    /// Set (expireAtMs >= 0) or clear (-1) `entry`'s expiry and return the
+    /// entry. The first TTL on a key grows its allocation, so the returned
+    /// pointer replaces `entry`.
+    HTEntry* setExpire(HTEntry* entry, int64_t expireAtMs);
 
     /// Delete a key. Returns true if the key existed.
-    bool del(const std::string& key);
+    bool del(std::string_view key);
 
     /// Return the total number of entries across both tables.
     size_t size() const;
@@ -51,64 +155,123 @@ public:
 
     /// Scan keys starting at `cursor`. Returns (nextCursor, keys).
     /// cursor=0 starts a new iteration. nextCursor=0 means iteration complete.
-    /// Scans primary_ table only (simplified — no reverse-bit iteration).
+    /// Every key present for the whole iteration is returned at least once,
+    /// even if the table resizes or rehashes between calls; keys may repeat.
+    /// Returns once it has `count` keys or has visited
+    /// count * kScanVisitsPerCount home groups, whichever comes first.
     std::pair<size_t, std::vector<std::string>> scan(size_t cursor,
                                                       size_t count) const;
 
-    /// Perform up to nSteps incremental rehashing migrations.
+    /// Append up to `count` entries from a random stretch of the table to
+    /// `out` — the sampling step of eviction. `random` picks the first
+    /// group; at most count * kScanVisitsPerCount groups are walked.
+    void sampleEntries(uint64_t random, size_t count,
+                       std::vector<HTEntry*>& out) const;
+
+    /// Perform up to nSteps incremental rehashing migrations, or start a
+    /// shrink if the table is due one.
     /// Called once per event loop tick to spread rehash cost.
     void rehashStep(int nSteps = 128);
 
     /// Delete all entries from both tables. Resets to empty state.
-    /// Used by FLUSHDB. Does NOT deallocate the primary_ slot array
-    /// — only entry nodes are freed and sizes reset.
+    /// Used by FLUSHDB.
     void flushAll();
 
     /// Count entries that have a TTL set (expireAt >= 0).
     /// Used by INFO keyspace section.
     size_t expiryCount() const;
 
+    /// Bytes of slot arrays (control bytes + entry pointers) across both
+    /// tables — the per-key index overhead, excluding the entries.
+    size_t slotMemory() const;
+
+    /// FNV-1a 64-bit hash function. Public so the sharded server can derive
+    /// a key's owning shard from the same hash.
+    static uint64_t hash(std::string_view key);
+
+    /// Slots per group — one SSE2 register of control bytes.
+    static constexpr size_t kGroupWidth = 16;
+
 private:
-    /// Internal table structure — an array of linked-list heads.
+    /// Internal table structure — control bytes and entry pointers, in one
+    /// allocation (ctrl first, then slots).
     struct Table {
-        HTEntry** slots = nullptr;  // array of linked-list heads
-        size_t capacity = 0;        // always a power of 2
-        size_t mask = 0;            // capacity - 1
-        size_t size = 0;            // number of entries in this table
+        uint8_t* ctrl = nullptr;    // one control byte per slot
+        HTEntry** slots = nullptr;  // entry pointer per slot, valid if full
+        size_t capacity = 0;        // power of 2, >= kGroupWidth
+        size_t groupMask = 0;       // capacity / kGroupWidth - 1
+        size_t size = 0;            // number of full slots
+        size_t tombstones = 0;      // number of DELETED slots
     };
 
-    Table primary_;          // the current (or new, larger) table
+    Table primary_;          // the current (or new) table
     Table rehash_;           // the old table being drained during rehashing
     bool isRehashing_ = false;
     size_t rehashIdx_ = 0;   // next slot in rehash_ to migrate
 
-    // Initial capacity — small, grows quickly via rehashing.
-    static constexpr size_t kInitialCapacity = 4;
-    // Trigger rehash when load factor exceeds this.
-    static constexpr double kMaxLoadFactor = 2.0;
+    // Initial capacity — one group, grows quickly via rehashing.
+    static constexpr size_t kInitialCapacity = kGroupWidth;
+    // Shrink once fewer than 1/kShrinkDivisor of the slots are full. The
+    // new table is sized to be under half its growth limit, leaving a wide
+    // gap before the next grow or shrink.
+    static constexpr size_t kShrinkDivisor = 8;
     // Number of entries to migrate per rehashStep() call.
     static constexpr int kRehashBatchSize = 128;
+    // Home groups scan() may visit per requested key — bounds the work a
+    // call does on a sparse table.
+    static constexpr size_t kScanVisitsPerCount = 10;
+    // Returned by findSlot() when the key is absent.
+    static constexpr size_t kNotFound = ~size_t{0};
 
-    /// FNV-1a 64-bit hash function.
-    static uint64_t hash(const std::string& key);
-
-    /// Allocate a new Table with the given capacity (must be power of 2).
+    /// Allocate a new, all-EMPTY Table (capacity must be a power of 2,
+    /// >= kGroupWidth).
     static Table allocTable(size_t capacity);
 
-    /// Free a Table's slot array.
+    /// Delete every entry in `table`, then its slot arrays.
     static void freeTable(Table& table);
 
-    /// Begin rehashing: move primary_ → rehash_, allocate new primary_.
+    /// Release `table`'s slot arrays without touching the entries.
+    static void releaseSlots(Table& table);
+
+    /// Full slots plus tombstones allowed before the table must be rebuilt.
+    static size_t growthLimit(size_t capacity) {
+        return capacity - capacity / 8;
+    }
+
+    /// Begin a growth rehash: twice as large, or the same size if
+    /// tombstones caused the rebuild.
     void triggerRehash();
 
-    /// Migrate one slot from rehash_ to primary_.
+    /// Begin a shrink rehash if primary_ has fallen below
+    /// 1/kShrinkDivisor full (and is not rehashing already).
+    void maybeShrink();
+
+    /// Move primary_ → rehash_ and allocate a new primary_ of `capacity`.
+    void startRehash(size_t capacity);
+
+    /// Migrate the next full slot of rehash_ to primary_.
     void migrateOneSlot();
 
-    /// Find an entry in a specific table.
-    static HTEntry* findInTable(Table& table, const std::string& key,
-                                uint64_t hashCode);
+    /// Index of `key`'s slot in `table`, or kNotFound.
+    static size_t findSlot(const Table& table, std::string_view key,
+                           uint64_t hashCode);
+
+    /// Put an entry known to be absent into the first free slot of its
+    /// probe sequence. The table must be below its growth limit.
+    static void insertEntry(Table& table, HTEntry* entry);
+
+    /// Append the keys of `table` whose probe sequence starts at group
+    /// `home`.
+    static void collectHomeGroup(const Table& table, size_t home,
+                                 std::vector<std::string>& out);
+
+    /// Collect the keys for one cursor position (in both tables while
+    /// rehashing) and return the next cursor.
+    size_t scanStep(size_t cursor, std::vector<std::string>& out) const;
+
+    /// Empty slot `idx` (the caller owns or has moved its entry).
+    static void eraseSlot(Table& table, size_t idx);
 
-    /// Delete an entry from a specific table. Returns true if found.
-    static bool delFromTable(Table& table, const std::string& key,
-                             uint64_t hashCode);
+    /// The slot holding `entry`, in primary_ or rehash_.
+    HTEntry*& slotOf(const HTEntry* entry);
 };
@@ -0,0 +1,89 @@
+#include "store/HashType.h"
+
+#include <string>
+
+/// Move a listpack hash's fields into a HASHTABLE.
+static void convertToHashTable(RedisObject& hash) {
+    RedisObject table = RedisObject::createHash(Encoding::HASHTABLE);
+    HashData& map = table.asHash();
+    map.reserve(HashType::size(hash) + 1);
+    HashType::forEach(hash, [&](std::string_view field, std::string_view value) {
+        map.emplace(field, value);
+    });
+    table.addUsage(static_cast<int64_t>(table.computeMemoryUsage()) -
+                   static_cast<int64_t>(table.memoryUsage()));
+    hash = std::move(table);
+}
+
+size_t HashType::size(const RedisObject& hash) {
+    if (hash.encoding == Encoding::LISTPACK) return hash.asListpack().size() / 2;
+    return hash.asHash().size();
+}
+
+std::optional<std::string_view> HashType::get(const RedisObject& hash,
+                                              std::string_view field) {
+    if (hash.encoding == Encoding::LISTPACK) {
+        const Listpack& lp = hash.asListpack();
+        size_t pos = lp.find(field, 2);
+        if (pos == lp.end()) return std::nullopt;
+        return lp.get(lp.next(pos));
+    }
+    const HashData& map = hash.asHash();
+    auto it = map.find(std::string(field));
+    if (it == map.end()) return std::nullopt;
+    return std::string_view(it->second);
+}
+
+bool HashType::set(RedisObject& hash, std::string_view field,
+                   std::string_view value, const ListpackLimits& limits) {
+    if (hash.encoding == Encoding::LISTPACK) {
+        Listpack& lp = hash.asListpack();
+        size_t pos = lp.find(field, 2);
+        if (pos != lp.end() && limits.allowsValue(value)) {
+            lp.replace(lp.next(pos), value);
+            return false;
+        }
+        bool added = pos == lp.end();
+        if (added && size(hash) < limits.maxEntries &&
+            limits.allowsValue(field) && limits.allowsValue(value)) {
+            lp.append(field);
+            lp.append(value);
+            return true;
+        }
+        // Too many fields, or a field or value too long for a listpack.
+        convertToHashTable(hash);
+    }
+
+    HashData& map = hash.asHash();
+    size_t buckets = map.bucket_count();
+    int64_t delta = 0;
+    auto [it, inserted] = map.emplace(field, value);
+    if (inserted) {
+        delta += RedisObject::hashFieldUsage(it->first, it->second);
+    } else {
+        delta -= RedisObject::stringUsage(it->second);
+        it->second.assign(value);
+        delta += RedisObject::stringUsage(it->second);
+    }
+    delta += RedisObject::bucketUsage(map.bucket_count()) -
+             RedisObject::bucketUsage(buckets);
+    hash.addUsage(delta);
+    return inserted;
+}
+
+bool HashType::del(RedisObject& hash, std::string_view field) {
+    if (hash.encoding == Encoding::LISTPACK) {
+        Listpack& lp = hash.asListpack();
+        size_t pos = lp.find(field, 2);
+        if (pos == lp.end()) return false;
+        lp.erase(pos, 2);
+        return true;
+    }
+    HashData& map = hash.asHash();
+    auto it = map.find(std::string(field));
+    if (it == map.end()) return false;
+    hash.addUsage(-static_cast<int64_t>(
+        RedisObject::hashFieldUsage(it->first, it->second)));
+    map.erase(it);
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "store/Listpack.h"
+#include "store/RedisObject.h"
+
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+/// Operations on a HASH object, whichever its encoding:
+///
+///   LISTPACK   field, value, field, value, ... in insertion order
+///   HASHTABLE  HashData (unordered_map<string,string>)
+///
+/// A hash starts as a listpack and converts to a hashtable once it
+/// outgrows `limits`. Mutators keep the object's memoryUsage() current;
+/// the caller reconciles Database::usedMemory() (Database::valueChanged).
+///
+/// Must NOT know about: commands, RESP, the keyspace.
+namespace HashType {
+
+/// Number of fields.
+size_t size(const RedisObject& hash);
+
+/// The value of `field`, pointing into the hash (valid until it changes).
+std::optional<std::string_view> get(const RedisObject& hash,
+                                    std::string_view field);
+
+/// Set `field` to `value`. Returns true if the field is new.
+bool set(RedisObject& hash, std::string_view field, std::string_view value,
+         const ListpackLimits& limits);
+
+/// Remove `field`. Returns true if it existed.
+bool del(RedisObject& hash, std::string_view field);
+
+/// Call fn(field, value) for every field.
+template <typename Fn>
+void forEach(const RedisObject& hash, Fn&& fn) {
+    if (hash.encoding == Encoding::LISTPACK) {
+        const Listpack& lp = hash.asListpack();
+        for (size_t pos = lp.begin(); pos != lp.end();) {
+            size_t valuePos = lp.next(pos);
+            fn(lp.get(pos), lp.get(valuePos));
+            pos = lp.next(valuePos);
+        }
+        return;
+    }
+    for (const auto& [field, value] : hash.asHash()) fn(field, value);
+}
+
+}  // namespace HashType
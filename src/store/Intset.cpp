@@ -0,0 +1,267 @@
+#include "store/Intset.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// ── Values ─────────────────────────────────────────────────────────────────
+
+/// Smallest width (2, 4 or 8 bytes) that holds `value`.
+static size_t widthFor(int64_t value) {
+    if (value >= std::numeric_limits<int16_t>::min() &&
+        value <= std::numeric_limits<int16_t>::max()) {
+        return sizeof(int16_t);
+    }
+    if (value >= std::numeric_limits<int32_t>::min() &&
+        value <= std::numeric_limits<int32_t>::max()) {
+        return sizeof(int32_t);
+    }
+    return sizeof(int64_t);
+}
+
+static int64_t load(const uint8_t* values, size_t width, size_t i) {
+    const uint8_t* p = values + i * width;
+    if (width == sizeof(int16_t)) {
+        int16_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    if (width == sizeof(int32_t)) {
+        int32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    int64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void store(uint8_t* values, size_t width, size_t i, int64_t value) {
+    uint8_t* p = values + i * width;
+    if (width == sizeof(int16_t)) {
+        auto v = static_cast<int16_t>(value);
+        std::memcpy(p, &v, sizeof(v));
+    } else if (width == sizeof(int32_t)) {
+        auto v = static_cast<int32_t>(value);
+        std::memcpy(p, &v, sizeof(v));
+    } else {
+        std::memcpy(p, &value, sizeof(value));
+    }
+}
+
+static uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void store32(uint8_t* p, uint32_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// ── Equality scan ──────────────────────────────────────────────────────────
+// contains() binary-searches until at most kScanBytes of values remain,
+// then compares all of them at once: past that point the branch
+// mispredictions of further halving cost more than the comparisons.
+
+static constexpr size_t kScanBytes = 64;
+
+/// Is `value` (which fits in `width`) among the `count` values at `p`?
+static bool scanEqual(const uint8_t* p, size_t count, size_t width,
+                      int64_t value) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    const size_t lanes = 16 / width;
+    __m128i needle;
+    if (width == sizeof(int16_t)) {
+        needle = _mm_set1_epi16(static_cast<int16_t>(value));
+    } else if (width == sizeof(int32_t)) {
+        needle = _mm_set1_epi32(static_cast<int32_t>(value));
+    } else {
+        needle = _mm_set1_epi64x(value);
+    }
+    for (; i + lanes <= count; i += lanes) {
+        __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(p + i * width));
+        __m128i eq;
+        if (width == sizeof(int16_t)) {
+            eq = _mm_cmpeq_epi16(v, needle);
+        } else {
+            eq = _mm_cmpeq_epi32(v, needle);
+            if (width == sizeof(int64_t)) {
+                // SSE2 has no 64-bit compare: both 32-bit halves must match.
+                eq = _mm_and_si128(
+                    eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+            }
+        }
+        if (_mm_movemask_epi8(eq) != 0) return true;
+    }
+#endif
+    for (; i < count; ++i) {
+        if (load(p, width, i) == value) return true;
+    }
+    return false;
+}
+
+// ── Lifetime ───────────────────────────────────────────────────────────────
+
+Intset::Intset()
+    : buf_(static_cast<uint8_t*>(std::malloc(kHeaderSize))) {
+    if (!buf_) throw std::bad_alloc();
+    setWidth(sizeof(int16_t));
+    setSize(0);
+}
+
+Intset::~Intset() {
+    std::free(buf_);
+}
+
+Intset::Intset(Intset&& other) noexcept : buf_(other.buf_) {
+    other.buf_ = nullptr;
+}
+
+Intset& Intset::operator=(Intset&& other) noexcept {
+    if (this != &other) {
+        std::free(buf_);
+        buf_ = other.buf_;
+        other.buf_ = nullptr;
+    }
+    return *this;
+}
+
+// ── Header ─────────────────────────────────────────────────────────────────
+// A moved-from intset has no buffer and reads as empty.
+
+size_t Intset::width() const {
+    return buf_ ? load32(buf_) : sizeof(int16_t);
+}
+
+size_t Intset::size() const {
+    return buf_ ? load32(buf_ + sizeof(uint32_t)) : 0;
+}
+
+size_t Intset::bytes() const {
+    return buf_ ? kHeaderSize + size() * width() : 0;
+}
+
+void Intset::setWidth(size_t width) {
+    store32(buf_, static_cast<uint32_t>(width));
+}
+
+void Intset::setSize(size_t n) {
+    store32(buf_ + sizeof(uint32_t), static_cast<uint32_t>(n));
+}
+
+// ── Reads ──────────────────────────────────────────────────────────────────
+
+int64_t Intset::get(size_t i) const {
+    return load(values(), width(), i);
+}
+
+size_t Intset::lowerBound(int64_t value, size_t from) const {
+    size_t lo = from;
+    size_t hi = size();
+    size_t w = width();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (load(values(), w, mid) < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+bool Intset::contains(int64_t value) const {
+    size_t w = width();
+    if (widthFor(value) > w) return false;  // out of range for every value
+
+    size_t lo = 0;
+    size_t hi = size();
+    const size_t window = kScanBytes / w;
+    while (hi - lo > window) {
+        size_t mid = lo + (hi - lo) / 2;
+        int64_t v = load(values(), w, mid);
+        if (v == value) return true;
+        if (v < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return scanEqual(values() + lo * w, hi - lo, w, value);
+}
+
+// ── Writes ─────────────────────────────────────────────────────────────────
+
+void Intset::set(size_t i, int64_t value) {
+    store(buf_ + kHeaderSize, width(), i, value);
+}
+
+void Intset::resize(size_t count, size_t width) {
+    auto* grown = static_cast<uint8_t*>(
+        std::realloc(buf_, kHeaderSize + count * width));
+    if (!grown) throw std::bad_alloc();
+    buf_ = grown;
+}
+
+void Intset::upgrade(size_t newWidth) {
+    size_t n = size();
+    size_t oldWidth = width();
+    resize(n, newWidth);
+    // Back to front, so no value is overwritten before it is moved.
+    uint8_t* v = buf_ + kHeaderSize;
+    for (size_t i = n; i-- > 0;) {
+        store(v, newWidth, i, load(v, oldWidth, i));
+    }
+    setWidth(newWidth);
+}
+
+bool Intset::add(int64_t value) {
+    if (widthFor(value) > width()) upgrade(widthFor(value));
+
+    size_t n = size();
+    size_t pos = lowerBound(value);
+    if (pos < n && get(pos) == value) return false;
+
+    size_t w = width();
+    resize(n + 1, w);
+    uint8_t* v = buf_ + kHeaderSize;
+    std::memmove(v + (pos + 1) * w, v + pos * w, (n - pos) * w);
+    set(pos, value);
+    setSize(n + 1);
+    return true;
+}
+
+bool Intset::remove(int64_t value) {
+    if (widthFor(value) > width()) return false;
+
+    size_t n = size();
+    size_t pos = lowerBound(value);
+    if (pos == n || get(pos) != value) return false;
+
+    size_t w = width();
+    uint8_t* v = buf_ + kHeaderSize;
+    std::memmove(v + pos * w, v + (pos + 1) * w, (n - pos - 1) * w);
+    resize(n - 1, w);
+    setSize(n - 1);
+    return true;
+}
+
+bool Intset::parse(std::string_view s, int64_t& out) {
+    if (s.empty()) return false;
+    // Canonical form only: "007" or "-0" would come back as "7" or "0".
+    size_t digits = s[0] == '-' ? 1 : 0;
+    if (s.size() == digits) return false;
+    if (s[digits] == '0' && (digits == 1 || s.size() > 1)) return false;
+
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && end == s.data() + s.size();
+}
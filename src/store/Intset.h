@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// A sorted array of distinct integers packed into one allocation, after
+/// Redis's intset. Sets whose members are all integers keep them here,
+/// at 2, 4 or 8 bytes a member instead of a string node in a hash table:
+///
+///   [uint32 width][uint32 count][value][value]...   (ascending)
+///
+/// Every value has the same width: the smallest of int16/int32/int64
+/// that holds them all. Adding a value that does not fit upgrades the
+/// whole array to the wider type; removing never downgrades it.
+/// Lookups binary-search down to a few cache lines and compare those
+/// with SSE2 where available. Like Listpack, every add/remove resizes
+/// the buffer to fit exactly and moves the tail — O(bytes), which the
+/// set-max-intset-entries limit keeps small.
+///
+/// Must NOT know about: strings, or that the values are set members.
+class Intset {
+public:
+    Intset();
+    ~Intset();
+
+    // Move-only: the buffer is owned.
+    Intset(Intset&& other) noexcept;
+    Intset& operator=(Intset&& other) noexcept;
+    Intset(const Intset&) = delete;
+    Intset& operator=(const Intset&) = delete;
+
+    /// Number of values.
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    /// Bytes allocated for the buffer (header included).
+    size_t bytes() const;
+
+    /// Bytes per value: 2, 4 or 8.
+    size_t width() const;
+
+    /// The value at index `i` (0 = smallest).
+    int64_t get(size_t i) const;
+
+    bool contains(int64_t value) const;
+
+    /// Index of the first value >= `value`, searching from index `from`
+    /// on; size() if there is none.
+    size_t lowerBound(int64_t value, size_t from = 0) const;
+
+    /// Insert `value` in order. Returns false if it was already there.
+    bool add(int64_t value);
+
+    /// Returns false if `value` was not there.
+    bool remove(int64_t value);
+
+    /// Parse `s` as an integer this encoding can store: decimal, in
+    /// int64_t range and in canonical form (no sign on 0, no leading
+    /// zeros), so that writing the value back gives exactly `s`.
+    static bool parse(std::string_view s, int64_t& out);
+
+private:
+    static constexpr size_t kHeaderSize = 2 * sizeof(uint32_t);
+
+    uint8_t* buf_;
+
+    const uint8_t* values() const { return buf_ + kHeaderSize; }
+    void set(size_t i, int64_t value);
+    void setWidth(size_t width);
+    void setSize(size_t n);
+
+    /// Resize the buffer to hold `count` values of `width` bytes.
+    void resize(size_t count, size_t width);
+
+    /// Rewrite every value at `width` bytes (> width()).
+    void upgrade(size_t width);
+};
@@ -0,0 +1,199 @@
+#include "store/Listpack.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// ── Varint lengths ─────────────────────────────────────────────────────────
+
+/// Bytes the varint encoding of `n` takes.
+static size_t varintSize(size_t n) {
+    size_t size = 1;
+    while (n >= 0x80) {
+        n >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+static void writeVarint(uint8_t* p, size_t n) {
+    while (n >= 0x80) {
+        *p++ = static_cast<uint8_t>(n | 0x80);
+        n >>= 7;
+    }
+    *p = static_cast<uint8_t>(n);
+}
+
+/// Decode the varint at `p` into `n`; returns the bytes it took.
+static size_t readVarint(const uint8_t* p, size_t& n) {
+    n = 0;
+    size_t i = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = p[i++];
+        n |= static_cast<size_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return i;
+    }
+}
+
+/// Write the backlen of an entry whose header and bytes take `n`: the
+/// varint of `n`, low 7 bits last, with the continuation bit on every
+/// byte but the first — read from the end, it is an ordinary varint.
+static void writeBacklen(uint8_t* p, size_t n) {
+    for (size_t i = varintSize(n); i-- > 0;) {
+        p[i] = static_cast<uint8_t>((n & 0x7F) | (i > 0 ? 0x80 : 0));
+        n >>= 7;
+    }
+}
+
+/// Decode the backlen that ends just before `end` into `n`; returns the
+/// bytes it took.
+static size_t readBacklen(const uint8_t* end, size_t& n) {
+    n = 0;
+    size_t i = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t b = *(end - 1 - i++);
+        n |= static_cast<size_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return i;
+    }
+}
+
+/// Total size of an entry holding `len` bytes.
+static size_t entrySize(size_t len) {
+    size_t body = varintSize(len) + len;
+    return body + varintSize(body);
+}
+
+/// Write an entry holding `value` at `p`.
+static void writeEntry(uint8_t* p, std::string_view value) {
+    size_t header = varintSize(value.size());
+    writeVarint(p, value.size());
+    if (!value.empty()) std::memcpy(p + header, value.data(), value.size());
+    writeBacklen(p + header + value.size(), header + value.size());
+}
+
+static uint32_t load32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static void store32(uint8_t* p, uint32_t v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// ── Lifetime ───────────────────────────────────────────────────────────────
+
+Listpack::Listpack()
+    : buf_(static_cast<uint8_t*>(std::malloc(kHeaderSize))) {
+    if (!buf_) throw std::bad_alloc();
+    setBytes(kHeaderSize);
+    setSize(0);
+}
+
+Listpack::~Listpack() {
+    std::free(buf_);
+}
+
+Listpack::Listpack(Listpack&& other) noexcept : buf_(other.buf_) {
+    other.buf_ = nullptr;
+}
+
+Listpack& Listpack::operator=(Listpack&& other) noexcept {
+    if (this != &other) {
+        std::free(buf_);
+        buf_ = other.buf_;
+        other.buf_ = nullptr;
+    }
+    return *this;
+}
+
+// ── Header ─────────────────────────────────────────────────────────────────
+// A moved-from listpack has no buffer and reads as empty.
+
+size_t Listpack::bytes() const {
+    return buf_ ? load32(buf_) : 0;
+}
+
+size_t Listpack::size() const {
+    return buf_ ? load32(buf_ + sizeof(uint32_t)) : 0;
+}
+
+void Listpack::setBytes(size_t n) {
+    store32(buf_, static_cast<uint32_t>(n));
+}
+
+void Listpack::setSize(size_t n) {
+    store32(buf_ + sizeof(uint32_t), static_cast<uint32_t>(n));
+}
+
+// ── Reads ──────────────────────────────────────────────────────────────────
+
+size_t Listpack::next(size_t pos) const {
+    size_t len;
+    size_t header = readVarint(buf_ + pos, len);
+    return pos + header + len + varintSize(header + len);
+}
+
+size_t Listpack::prev(size_t pos) const {
+    size_t body;
+    size_t backlen = readBacklen(buf_ + pos, body);
+    return pos - backlen - body;
+}
+
+size_t Listpack::entryBytes(size_t len) {
+    return entrySize(len);
+}
+
+std::string_view Listpack::get(size_t pos) const {
+    size_t len;
+    size_t header = readVarint(buf_ + pos, len);
+    return {reinterpret_cast<const char*>(buf_ + pos + header), len};
+}
+
+size_t Listpack::find(std::string_view value, size_t step) const {
+    size_t stop = end();
+    size_t pos = begin();
+    while (pos < stop) {
+        if (get(pos) == value) return pos;
+        for (size_t i = 0; i < step && pos < stop; ++i) pos = next(pos);
+    }
+    return stop;
+}
+
+// ── Writes ─────────────────────────────────────────────────────────────────
+
+void Listpack::resize(size_t newBytes, size_t from, size_t to) {
+    size_t oldBytes = bytes();
+    if (newBytes < oldBytes) {
+        // Shrinking: move the tail down before giving the space back.
+        std::memmove(buf_ + to, buf_ + from, oldBytes - from);
+    }
+    auto* grown = static_cast<uint8_t*>(std::realloc(buf_, newBytes));
+    if (!grown) throw std::bad_alloc();
+    buf_ = grown;
+    if (newBytes > oldBytes) {
+        std::memmove(buf_ + to, buf_ + from, oldBytes - from);
+    }
+    setBytes(newBytes);
+}
+
+void Listpack::insert(size_t pos, std::string_view value) {
+    size_t added = entrySize(value.size());
+    resize(bytes() + added, pos, pos + added);
+    writeEntry(buf_ + pos, value);
+    setSize(size() + 1);
+}
+
+void Listpack::replace(size_t pos, std::string_view value) {
+    size_t oldEnd = next(pos);
+    size_t newEnd = pos + entrySize(value.size());
+    if (newEnd != oldEnd) resize(bytes() - oldEnd + newEnd, oldEnd, newEnd);
+    writeEntry(buf_ + pos, value);
+}
+
+void Listpack::erase(size_t pos, size_t count) {
+    size_t stop = pos;
+    for (size_t i = 0; i < count; ++i) stop = next(stop);
+    resize(bytes() - (stop - pos), stop, pos);
+    setSize(size() - count);
+}
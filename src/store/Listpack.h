@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/// A sequence of strings packed into one allocation, after Redis's
+/// listpack. Small hashes, sets and sorted sets keep all their elements
+/// here instead of one heap node (plus bucket) per element, and each
+/// quicklist node of a list is one:
+///
+///   [uint32 total bytes][uint32 entry count][entry][entry]...
+///   entry = length as a varint (7 bits per byte) + the bytes
+///           + backlen: the size of the two, as a varint stored back to
+///             front so that it can be read from the entry's end
+///
+/// Entries are addressed by byte offset: begin() is the first entry,
+/// next(pos) the one after it, prev(pos) the one before it and end()
+/// one past the last. Offsets stay
+/// valid across reallocation, but any insert/replace/erase shifts the
+/// entries behind it. Every mutation resizes the buffer to fit exactly
+/// and moves the tail, so it is O(bytes) — fine for the few hundred
+/// bytes a listpack is allowed to grow to. Values passed to the
+/// mutators must not point into the listpack itself.
+///
+/// Must NOT know about: what the entries mean (fields, scores, ...).
+class Listpack {
+public:
+    Listpack();
+    ~Listpack();
+
+    // Move-only: the buffer is owned.
+    Listpack(Listpack&& other) noexcept;
+    Listpack& operator=(Listpack&& other) noexcept;
+    Listpack(const Listpack&) = delete;
+    Listpack& operator=(const Listpack&) = delete;
+
+    /// Number of entries.
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    /// Bytes allocated for the buffer (header included).
+    size_t bytes() const;
+
+    size_t begin() const { return kHeaderSize; }
+    size_t end() const { return bytes(); }
+    size_t next(size_t pos) const;
+    /// The entry before `pos` (> begin()); prev(end()) is the last one.
+    size_t prev(size_t pos) const;
+
+    /// The bytes of the entry at `pos` — valid until the next mutation.
+    std::string_view get(size_t pos) const;
+
+    /// Offset of the first entry equal to `value`, looking only at every
+    /// `step`-th entry from begin() (step 2 searches the keys of
+    /// key/value pairs). end() if there is none.
+    size_t find(std::string_view value, size_t step = 1) const;
+
+    /// Insert `value` before the entry at `pos` (end() appends).
+    void insert(size_t pos, std::string_view value);
+    void append(std::string_view value) { insert(end(), value); }
+
+    /// Overwrite the entry at `pos`.
+    void replace(size_t pos, std::string_view value);
+
+    /// Remove `count` consecutive entries starting at `pos`.
+    void erase(size_t pos, size_t count = 1);
+
+    /// Bytes an entry holding `len` bytes takes, header and backlen
+    /// included.
+    static size_t entryBytes(size_t len);
+
+private:
+    static constexpr size_t kHeaderSize = 2 * sizeof(uint32_t);
+
+    uint8_t* buf_;
+
+    void setBytes(size_t n);
+    void setSize(size_t n);
+
+    /// Resize the buffer to `newBytes`, moving everything from `from` on
+    /// so that it starts at `to`.
+    void resize(size_t newBytes, size_t from, size_t to);
+};
+
+/// When a collection may stay in a listpack — Redis's
+/// *-max-listpack-entries and *-max-listpack-value. Past either limit it
+/// converts to its general encoding, for good.
+struct ListpackLimits {
+    size_t maxEntries = 128;  // elements (pairs, for hashes and zsets)
+    size_t maxValue = 64;     // bytes in one field, value or member
+
+    bool allowsValue(std::string_view value) const {
+        return value.size() <= maxValue;
+    }
+};
+
+/// A set's limits: the listpack ones, plus how many members a set of
+/// integers may hold as an INTSET — Redis's set-max-intset-entries.
+struct SetLimits : ListpackLimits {
+    size_t maxIntsetEntries = 512;
+};
+
+/// When small collections use the compact LISTPACK / INTSET encodings,
+/// and how big a list's quicklist chunks grow.
+struct EncodingConfig {
+    ListpackLimits hash;  // hash-max-listpack-entries / -value
+    SetLimits set;        // set-max-listpack-*, set-max-intset-entries
+    ListpackLimits zset;  // zset-max-listpack-entries / -value
+    int listFill = -2;    // list-max-listpack-size (see Quicklist)
+};
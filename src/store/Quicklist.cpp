@@ -0,0 +1,118 @@
+#include "store/Quicklist.h"
+
+#include <utility>
+
+// Byte limits for fill -1 … -5, as in Redis.
+static constexpr size_t kFillBytes[] = {4096, 8192, 16384, 32768, 65536};
+
+// A count-limited chunk (fill > 0) still stops growing at this size.
+static constexpr size_t kSafetyBytes = 8192;
+
+// ── Lifetime ───────────────────────────────────────────────────────────────
+
+Quicklist::~Quicklist() {
+    clear();
+}
+
+void Quicklist::clear() {
+    while (head_) {
+        Node* next = head_->next;
+        delete head_;
+        head_ = next;
+    }
+    tail_ = nullptr;
+    count_ = nodes_ = bytes_ = 0;
+}
+
+Quicklist::Quicklist(Quicklist&& other) noexcept
+    : head_(std::exchange(other.head_, nullptr)),
+      tail_(std::exchange(other.tail_, nullptr)),
+      count_(std::exchange(other.count_, 0)),
+      nodes_(std::exchange(other.nodes_, 0)),
+      bytes_(std::exchange(other.bytes_, 0)) {}
+
+Quicklist& Quicklist::operator=(Quicklist&& other) noexcept {
+    if (this != &other) {
+        clear();
+        head_  = std::exchange(other.head_, nullptr);
+        tail_  = std::exchange(other.tail_, nullptr);
+        count_ = std::exchange(other.count_, 0);
+        nodes_ = std::exchange(other.nodes_, 0);
+        bytes_ = std::exchange(other.bytes_, 0);
+    }
+    return *this;
+}
+
+// ── Nodes ──────────────────────────────────────────────────────────────────
+
+bool Quicklist::hasRoom(const Node* node, size_t len, int fill) {
+    if (!node) return false;
+    const Listpack& lp = node->entries;
+    if (lp.empty()) return true;
+    size_t after = lp.bytes() + Listpack::entryBytes(len);
+    if (fill > 0) {
+        return lp.size() < static_cast<size_t>(fill) && after <= kSafetyBytes;
+    }
+    int level = fill < -5 ? 5 : (fill == 0 ? 1 : -fill);
+    return after <= kFillBytes[level - 1];
+}
+
+Quicklist::Node* Quicklist::insertNode(Node* prev) {
+    Node* node = new Node();
+    node->prev = prev;
+    node->next = prev ? prev->next : head_;
+    if (node->next) {
+        node->next->prev = node;
+    } else {
+        tail_ = node;
+    }
+    if (prev) {
+        prev->next = node;
+    } else {
+        head_ = node;
+    }
+    ++nodes_;
+    bytes_ += sizeof(Node) + node->entries.bytes();
+    return node;
+}
+
+void Quicklist::unlinkNode(Node* node) {
+    (node->prev ? node->prev->next : head_) = node->next;
+    (node->next ? node->next->prev : tail_) = node->prev;
+    --nodes_;
+    bytes_ -= sizeof(Node) + node->entries.bytes();
+    delete node;
+}
+
+// ── Push / pop ─────────────────────────────────────────────────────────────
+
+void Quicklist::pushFront(std::string_view value, int fill) {
+    Node* node = hasRoom(head_, value.size(), fill) ? head_ : insertNode(nullptr);
+    mutate(node, [&](Listpack& lp) { lp.insert(lp.begin(), value); });
+    ++count_;
+}
+
+void Quicklist::pushBack(std::string_view value, int fill) {
+    Node* node = hasRoom(tail_, value.size(), fill) ? tail_ : insertNode(tail_);
+    mutate(node, [&](Listpack& lp) { lp.append(value); });
+    ++count_;
+}
+
+std::string Quicklist::popFront() {
+    Node* node = head_;
+    std::string value(node->entries.get(node->entries.begin()));
+    mutate(node, [](Listpack& lp) { lp.erase(lp.begin()); });
+    if (node->entries.empty()) unlinkNode(node);
+    --count_;
+    return value;
+}
+
+std::string Quicklist::popBack() {
+    Node* node = tail_;
+    size_t last = node->entries.prev(node->entries.end());
+    std::string value(node->entries.get(last));
+    mutate(node, [&](Listpack& lp) { lp.erase(last); });
+    if (node->entries.empty()) unlinkNode(node);
+    --count_;
+    return value;
+}
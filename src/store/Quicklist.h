@@ -0,0 +1,120 @@
+#pragma once
+
+#include "store/Listpack.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// A list stored as a doubly linked list of Listpack chunks, after
+/// Redis's quicklist. Each element costs its bytes plus two or three of
+/// framing, instead of a std::string object and a heap buffer, and a
+/// range walks whole chunks of contiguous memory:
+///
+///   head ⇄ [listpack: e0 e1 … e99] ⇄ [listpack: e100 …] ⇄ … ⇄ tail
+///
+/// Pushes go into the head or tail chunk while it has room under `fill`,
+/// else into a new chunk; pops take from the head or tail chunk and free
+/// it once empty. Both are O(1) in the list's length — the cost is
+/// bounded by one chunk, which `fill` keeps to a few KB.
+///
+/// `fill` is Redis's list-max-listpack-size: N > 0 allows N entries a
+/// chunk (and at most 8 KB), -1 … -5 allow 4, 8, 16, 32 or 64 KB.
+/// A value too big for any chunk gets one to itself.
+///
+/// Must NOT know about: commands, RESP, the keyspace.
+class Quicklist {
+public:
+    struct Node {
+        Node* prev = nullptr;
+        Node* next = nullptr;
+        Listpack entries;
+    };
+
+    Quicklist() = default;
+    ~Quicklist();
+
+    // Move-only: the nodes are owned.
+    Quicklist(Quicklist&& other) noexcept;
+    Quicklist& operator=(Quicklist&& other) noexcept;
+    Quicklist(const Quicklist&) = delete;
+    Quicklist& operator=(const Quicklist&) = delete;
+
+    /// Number of elements.
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    /// Number of chunks.
+    size_t nodeCount() const { return nodes_; }
+
+    /// Bytes the nodes and their listpacks take (the Quicklist itself
+    /// excluded). Kept as a running total, so O(1).
+    size_t bytes() const { return bytes_; }
+
+    void pushFront(std::string_view value, int fill);
+    void pushBack(std::string_view value, int fill);
+
+    /// Remove and return the first / last element. The list must not be
+    /// empty.
+    std::string popFront();
+    std::string popBack();
+
+    /// The first chunk, or nullptr; follow Node::next for the rest.
+    const Node* head() const { return head_; }
+
+    /// Call fn(element) for the `count` elements from index `start` on
+    /// (both already in range). The chunk holding `start` is found from
+    /// whichever end is nearer, skipping whole chunks by entry count.
+    template <typename Fn>
+    void forRange(size_t start, size_t count, Fn&& fn) const {
+        const Node* node = head_;
+        if (start < count_ / 2) {
+            while (start >= node->entries.size()) {
+                start -= node->entries.size();
+                node = node->next;
+            }
+        } else {
+            node = tail_;
+            size_t first = count_ - node->entries.size();
+            while (start < first) {
+                node = node->prev;
+                first -= node->entries.size();
+            }
+            start -= first;
+        }
+        for (; node && count > 0; node = node->next) {
+            const Listpack& lp = node->entries;
+            size_t pos = lp.begin();
+            for (; start > 0; --start) pos = lp.next(pos);
+            for (; pos != lp.end() && count > 0; pos = lp.next(pos)) {
+                fn(lp.get(pos));
+                --count;
+            }
+        }
+    }
+
+private:
+    Node* head_ = nullptr;
+    Node* tail_ = nullptr;
+    size_t count_ = 0;
+    size_t nodes_ = 0;
+    size_t bytes_ = 0;
+
+    /// Free every node.
+    void clear();
+
+    /// May `node` take one more entry of `len` bytes under `fill`?
+    static bool hasRoom(const Node* node, size_t len, int fill);
+
+    /// Link a new, empty node after `prev` (nullptr = at the head).
+    Node* insertNode(Node* prev);
+    void unlinkNode(Node* node);
+
+    /// Apply `fn` to `node`'s listpack, keeping bytes_ current.
+    template <typename Fn>
+    void mutate(Node* node, Fn&& fn) {
+        bytes_ -= node->entries.bytes();
+        fn(node->entries);
+        bytes_ += node->entries.bytes();
+    }
+};
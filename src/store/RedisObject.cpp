@@ -1,139 +1,298 @@
 #include "store/RedisObject.h"
 
-#include <cerrno>
-#include <cstdlib>
-#include <climits>
+#include <charconv>
 
-RedisObject RedisObject::createString(const std::string& val) {
+// Longest string libstdc++/libc++ keep inside the std::string object.
+static const size_t kSsoCapacity = std::string().capacity();
+
+/// Heap bytes behind a std::string (0 while the string fits inline).
+static size_t heapBytes(const std::string& s) {
+    return s.capacity() > kSsoCapacity ? s.capacity() + 1 : 0;
+}
+
+// ── Lifetime ───────────────────────────────────────────────────────────────
+
+RedisObject::~RedisObject() {
+    release();
+}
+
+RedisObject::RedisObject(RedisObject&& other) noexcept
+    : type(other.type), encoding(other.encoding), embLen_(other.embLen_) {
+    ptr_ = other.ptr_;  // copies whichever payload word is active
+    other.type     = DataType::STRING;
+    other.encoding = Encoding::RAW;
+    other.embLen_  = 0;
+    other.ptr_     = nullptr;
+}
+
+RedisObject& RedisObject::operator=(RedisObject&& other) noexcept {
+    if (this != &other) {
+        release();
+        type     = other.type;
+        encoding = other.encoding;
+        embLen_  = other.embLen_;
+        ptr_     = other.ptr_;
+        other.type     = DataType::STRING;
+        other.encoding = Encoding::RAW;
+        other.embLen_  = 0;
+        other.ptr_     = nullptr;
+    }
+    return *this;
+}
+
+void RedisObject::release() {
+    if (encoding == Encoding::LISTPACK) {
+        delete box<Listpack>();
+        ptr_ = nullptr;
+        return;
+    }
+    if (encoding == Encoding::INTSET) {
+        delete box<Intset>();
+        ptr_ = nullptr;
+        return;
+    }
+    switch (type) {
+    case DataType::STRING:
+        if (encoding == Encoding::RAW) delete raw_;
+        break;
+    case DataType::LIST: delete box<ListData>(); break;
+    case DataType::HASH: delete box<HashData>(); break;
+    case DataType::SET:  delete box<SetData>();  break;
+    case DataType::ZSET: delete box<ZSetData>(); break;
+    }
+    ptr_ = nullptr;
+}
+
+// ── Factories ──────────────────────────────────────────────────────────────
+
+bool RedisObject::parseInteger(std::string_view s, int64_t& out) {
+    if (s.empty()) return false;
+    auto [end, ec] = std::from_chars(s.data(), s.data() + s.size(), out);
+    return ec == std::errc() && end == s.data() + s.size();
+}
+
+RedisObject RedisObject::createString(std::string_view val) {
     RedisObject obj;
     obj.type = DataType::STRING;
 
     // Try to store as INTEGER encoding for memory savings.
-    if (!val.empty()) {
-        const char* start = val.c_str();
-        char* end = nullptr;
-        errno = 0;
-        long long parsed = std::strtoll(start, &end, 10);
-        if (end == start + val.size() && errno == 0 &&
-            parsed >= LLONG_MIN && parsed <= LLONG_MAX) {
-            obj.encoding = Encoding::INTEGER;
-            obj.data = static_cast<int64_t>(parsed);
-            return obj;
-        }
+    int64_t parsed = 0;
+    if (parseInteger(val, parsed)) {
+        obj.encoding = Encoding::INTEGER;
+        obj.integer_ = parsed;
+        return obj;
     }
 
     obj.encoding = Encoding::RAW;
-    obj.data = val;
+    obj.raw_ = new std::string(val);
     return obj;
 }
 
-RedisObject RedisObject::createList() {
-    RedisObject obj;
-    obj.type = DataType::LIST;
-    obj.encoding = Encoding::LINKEDLIST;
-    obj.data = std::deque<std::string>{};
-    return obj;
+RedisObject RedisObject::createStringView(std::string_view val) {
+    int64_t parsed = 0;
+    if (val.size() > kEmbstrMaxLen || parseInteger(val, parsed)) {
+        return createString(val);
+    }
+    return createEmbedded(val);
 }
 
-RedisObject RedisObject::createHash() {
+RedisObject RedisObject::createEmbedded(std::string_view bytes) {
     RedisObject obj;
-    obj.type = DataType::HASH;
-    obj.encoding = Encoding::HASHTABLE;
-    obj.data = std::unordered_map<std::string, std::string>{};
+    obj.type     = DataType::STRING;
+    obj.encoding = Encoding::EMBSTR;
+    obj.embLen_  = static_cast<uint32_t>(bytes.size());
+    obj.embstr_  = bytes.data();
     return obj;
 }
 
-RedisObject RedisObject::createSet() {
+template <typename T>
+RedisObject RedisObject::createContainer(DataType type, Encoding encoding) {
     RedisObject obj;
-    obj.type = DataType::SET;
-    obj.encoding = Encoding::HASHTABLE;
-    obj.data = std::unordered_set<std::string>{};
+    obj.type = type;
+    obj.encoding = encoding;
+    obj.ptr_ = new Box<T>();
+    // An empty container: its own size plus, for the hash-based ones,
+    // an initial bucket array.
+    obj.containerUsage() = obj.computeMemoryUsage() - sizeof(RedisObject);
     return obj;
 }
 
-RedisObject RedisObject::createZSet() {
-    RedisObject obj;
-    obj.type = DataType::ZSET;
-    obj.encoding = Encoding::SKIPLIST;
-    obj.data = ZSetData{};
-    return obj;
+RedisObject RedisObject::createList() {
+    return createContainer<ListData>(DataType::LIST, Encoding::QUICKLIST);
+}
+
+RedisObject RedisObject::createHash(Encoding encoding) {
+    if (encoding == Encoding::LISTPACK) {
+        return createContainer<Listpack>(DataType::HASH, encoding);
+    }
+    return createContainer<HashData>(DataType::HASH, Encoding::HASHTABLE);
+}
+
+RedisObject RedisObject::createSet(Encoding encoding) {
+    if (encoding == Encoding::LISTPACK) {
+        return createContainer<Listpack>(DataType::SET, encoding);
+    }
+    if (encoding == Encoding::INTSET) {
+        return createContainer<Intset>(DataType::SET, encoding);
+    }
+    return createContainer<SetData>(DataType::SET, Encoding::HASHTABLE);
+}
+
+RedisObject RedisObject::createZSet(Encoding encoding) {
+    if (encoding == Encoding::LISTPACK) {
+        return createContainer<Listpack>(DataType::ZSET, encoding);
+    }
+    return createContainer<ZSetData>(DataType::ZSET, Encoding::SKIPLIST);
 }
 
+const char* encodingName(Encoding encoding) {
+    switch (encoding) {
+    case Encoding::RAW:        return "raw";
+    case Encoding::INTEGER:    return "int";
+    case Encoding::EMBSTR:     return "embstr";
+    case Encoding::QUICKLIST:  return "quicklist";
+    case Encoding::HASHTABLE:  return "hashtable";
+    case Encoding::SKIPLIST:   return "skiplist";
+    case Encoding::LISTPACK:   return "listpack";
+    case Encoding::INTSET:     return "intset";
+    }
+    return "unknown";
+}
+
+// ── Accessors ──────────────────────────────────────────────────────────────
+
 std::string RedisObject::asString() const {
-    if (encoding == Encoding::INTEGER) {
-        auto* p = std::get_if<int64_t>(&data);
-        return p ? std::to_string(*p) : "";
+    if (type != DataType::STRING) return "";
+    if (encoding == Encoding::INTEGER) return std::to_string(integer_);
+    return std::string(stringBytes());
+}
+
+std::string_view RedisObject::stringBytes() const {
+    if (encoding == Encoding::EMBSTR) return {embstr_, embLen_};
+    if (encoding == Encoding::RAW && raw_) return *raw_;
+    return {};
+}
+
+// ── Memory accounting ──────────────────────────────────────────────────────
+
+// Overhead per bucket in std hash containers (estimated at pointer size).
+static constexpr size_t kBucketOverhead = sizeof(void*);
+// Per-node overhead in std hash containers: next pointer + cached hash.
+static constexpr size_t kNodeOverhead = sizeof(void*) + sizeof(size_t);
+// Skiplist node: member string object, score, the forward vector and a
+// backward pointer (32), and the forward pointers themselves — average
+// level ~1.33 with p=0.25; estimate 2 per node.
+static constexpr size_t kSkiplistNodeOverhead =
+    sizeof(std::string) + 32 + sizeof(double) + 2 * sizeof(void*);
+
+size_t RedisObject::stringUsage(const std::string& s) {
+    return sizeof(std::string) + heapBytes(s);
+}
+
+size_t RedisObject::hashFieldUsage(const std::string& field,
+                                   const std::string& value) {
+    return kNodeOverhead + stringUsage(field) + stringUsage(value);
+}
+
+size_t RedisObject::setMemberUsage(const std::string& member) {
+    return kNodeOverhead + stringUsage(member);
+}
+
+size_t RedisObject::zsetMemberUsage(const std::string& member) {
+    // One skiplist node, plus the member's dict node (member → score).
+    return kSkiplistNodeOverhead + kNodeOverhead + stringUsage(member) +
+           sizeof(double);
+}
+
+size_t RedisObject::bucketUsage(size_t bucketCount) {
+    return bucketCount * kBucketOverhead;
+}
+
+size_t& RedisObject::containerUsage() {
+    if (encoding == Encoding::LISTPACK) return box<Listpack>()->usage;
+    if (encoding == Encoding::INTSET) return box<Intset>()->usage;
+    switch (type) {
+    case DataType::LIST: return box<ListData>()->usage;
+    case DataType::HASH: return box<HashData>()->usage;
+    case DataType::SET:  return box<SetData>()->usage;
+    default:             return box<ZSetData>()->usage;
     }
-    auto* p = std::get_if<std::string>(&data);
-    return p ? *p : "";
 }
 
 size_t RedisObject::memoryUsage() const {
-    // Base cost: the RedisObject struct itself (type, encoding, variant).
+    // Base cost: the RedisObject struct itself (tags + payload word).
     size_t total = sizeof(RedisObject);
+    if (encoding == Encoding::LISTPACK) {
+        return total + sizeof(Box<Listpack>) + asListpack().bytes();
+    }
+    if (encoding == Encoding::INTSET) {
+        return total + sizeof(Box<Intset>) + asIntset().bytes();
+    }
+    if (type == DataType::LIST) {
+        return total + sizeof(Box<ListData>) + asList().bytes();
+    }
+    if (type != DataType::STRING) return total + containerUsage();
 
-    // Overhead per bucket in std hash containers (estimated at pointer size).
-    static constexpr size_t kBucketOverhead = sizeof(void*);
+    if (encoding == Encoding::EMBSTR) {
+        total += embLen_;
+    } else if (encoding == Encoding::RAW && raw_) {
+        total += sizeof(std::string) + heapBytes(*raw_);
+    }
+    // INTEGER is stored in the payload word — no dynamic alloc.
+    return total;
+}
 
-    switch (type) {
-    case DataType::STRING: {
-        if (encoding == Encoding::INTEGER) {
-            // int64_t is stored inline in the variant — no dynamic alloc.
-        } else {
-            auto* p = std::get_if<std::string>(&data);
-            if (p) total += p->capacity();
-        }
-        break;
+/// Sum `cost(element)` over `container`, or over its first `samples`
+/// elements scaled up to its size.
+template <typename C, typename Cost>
+static size_t sumElements(const C& container, size_t samples, Cost cost) {
+    size_t sum = 0;
+    size_t seen = 0;
+    for (const auto& element : container) {
+        if (samples > 0 && seen == samples) break;
+        sum += cost(element);
+        ++seen;
     }
-    case DataType::LIST: {
-        auto* p = std::get_if<std::deque<std::string>>(&data);
-        if (p) {
-            for (const auto& s : *p) {
-                total += sizeof(std::string) + s.capacity();
-            }
-        }
-        break;
+    if (seen == 0 || seen == container.size()) return sum;
+    return static_cast<size_t>(static_cast<double>(sum) / seen *
+                               container.size());
+}
+
+size_t RedisObject::computeMemoryUsage(size_t samples) const {
+    // Nothing to walk: these structures keep their own size.
+    if (type == DataType::STRING || type == DataType::LIST ||
+        encoding == Encoding::LISTPACK || encoding == Encoding::INTSET) {
+        return memoryUsage();
     }
+
+    size_t total = sizeof(RedisObject);
+    switch (type) {
     case DataType::HASH: {
-        auto* p = std::get_if<std::unordered_map<std::string, std::string>>(&data);
-        if (p) {
-            // Bucket array overhead.
-            total += p->bucket_count() * kBucketOverhead;
-            for (const auto& [k, v] : *p) {
-                total += sizeof(std::string) * 2 + k.capacity() + v.capacity();
-            }
-        }
+        const HashData& hash = asHash();
+        total += sizeof(HashData) + bucketUsage(hash.bucket_count()) +
+                 sumElements(hash, samples, [](const auto& kv) {
+                     return hashFieldUsage(kv.first, kv.second);
+                 });
         break;
     }
     case DataType::SET: {
-        auto* p = std::get_if<std::unordered_set<std::string>>(&data);
-        if (p) {
-            total += p->bucket_count() * kBucketOverhead;
-            for (const auto& m : *p) {
-                total += sizeof(std::string) + m.capacity();
-            }
-        }
+        const SetData& set = asSet();
+        total += sizeof(SetData) + bucketUsage(set.bucket_count()) +
+                 sumElements(set, samples, [](const std::string& m) {
+                     return setMemberUsage(m);
+                 });
         break;
     }
     case DataType::ZSET: {
-        auto* p = std::get_if<ZSetData>(&data);
-        if (p) {
-            // Skiplist nodes: each node has member string + score + forward ptrs.
-            size_t slSize = p->skiplist.size();
-            // Average level ~1.33 with p=0.25; estimate 2 pointers per node.
-            static constexpr size_t kAvgPointersPerNode = 2;
-            total += slSize * (sizeof(std::string) + 32 +
-                               sizeof(double) +
-                               kAvgPointersPerNode * sizeof(void*));
-            // Dict (member → score): bucket overhead + entries.
-            total += p->dict.bucket_count() * kBucketOverhead;
-            for (const auto& [m, s] : p->dict) {
-                total += sizeof(std::string) + m.capacity() + sizeof(double);
-            }
-        }
+        const ZSetData& zset = asZSet();
+        total += sizeof(ZSetData) + bucketUsage(zset.dict.bucket_count()) +
+                 sumElements(zset.dict, samples, [](const auto& ms) {
+                     return zsetMemberUsage(ms.first);
+                 });
         break;
     }
+    default:
+        break;
     }
-
     return total;
 }
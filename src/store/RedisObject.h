@@ -1,12 +1,14 @@
 #pragma once
 
 #include <cstdint>
-#include <deque>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
-#include <variant>
 
+#include "store/Intset.h"
+#include "store/Listpack.h"
+#include "store/Quicklist.h"
 #include "store/Skiplist.h"
 
 /// Data type tag — matches the five Redis object types.
@@ -20,13 +22,19 @@ enum class DataType : uint8_t {
 
 /// Encoding tag — describes the internal representation.
 enum class Encoding : uint8_t {
-    RAW,          // std::string, any binary data
+    RAW,          // heap std::string, any binary data
     INTEGER,      // int64_t, for values that are valid integers
-    LINKEDLIST,   // std::deque<std::string> (lists)
+    EMBSTR,       // short string whose bytes live in the owning HTEntry
+    QUICKLIST,    // Quicklist: linked listpack chunks (lists)
     HASHTABLE,    // unordered_map / unordered_set (hashes, sets)
-    SKIPLIST      // Skiplist + unordered_map (sorted sets)
+    SKIPLIST,     // Skiplist + unordered_map (sorted sets)
+    LISTPACK,     // Listpack: small hashes, sets and sorted sets
+    INTSET        // Intset: sets whose members are all integers
 };
 
+/// The name OBJECT ENCODING reports for `encoding`, as Redis names it.
+const char* encodingName(Encoding encoding);
+
 /// Sorted set internal data: a skiplist for ordering plus a hash map
 /// for O(1) ZSCORE lookups.
 struct ZSetData {
@@ -42,50 +50,155 @@ struct ZSetData {
     ZSetData& operator=(const ZSetData&) = delete;
 };
 
-/// The data payload. One of these alternatives is active at any time.
-using RedisData = std::variant<
-    std::string,                                  // STRING / RAW
-    int64_t,                                      // STRING / INTEGER
-    std::deque<std::string>,                      // LIST
-    std::unordered_map<std::string, std::string>,  // HASH
-    std::unordered_set<std::string>,              // SET
-    ZSetData                                      // ZSET
->;
+using ListData = Quicklist;
+using HashData = std::unordered_map<std::string, std::string>;
+using SetData  = std::unordered_set<std::string>;
 
 /// The value stored for every key in the database.
 /// Supports STRING (Phase 2), LIST, HASH, SET, ZSET (Phase 5).
+///
+/// 16 bytes: the type and encoding tags plus one word of payload — the
+/// integer itself, or a pointer to the string or container, which the
+/// object owns. An EMBSTR value only points at bytes it does not own:
+/// inside the database those are the tail of the HTEntry allocation.
 struct RedisObject {
     DataType type = DataType::STRING;
     Encoding encoding = Encoding::RAW;
-    RedisData data;   // active alternative determined by type + encoding
 
-    // Move-only because ZSetData (hence Skiplist) is non-copyable.
+    /// Longest string stored as EMBSTR inside its HTEntry; longer ones
+    /// get their own allocation (RAW).
+    static constexpr size_t kEmbstrMaxLen = 64;
+
+    // Move-only: the object owns its payload.
     RedisObject() = default;
-    RedisObject(RedisObject&&) = default;
-    RedisObject& operator=(RedisObject&&) = default;
+    ~RedisObject();
+    RedisObject(RedisObject&& other) noexcept;
+    RedisObject& operator=(RedisObject&& other) noexcept;
     RedisObject(const RedisObject&) = delete;
     RedisObject& operator=(const RedisObject&) = delete;
 
     /// Create a STRING RedisObject. Uses INTEGER encoding if the value
-    /// is a valid int64_t, otherwise RAW.
-    static RedisObject createString(const std::string& val);
+    /// is a valid int64_t, otherwise RAW (an owned copy).
+    static RedisObject createString(std::string_view val);
+
+    /// Like createString(), but a short non-integer value is referenced
+    /// rather than copied (EMBSTR over `val`). Only for handing straight
+    /// to HashTable::set(), which copies the bytes into the entry.
+    static RedisObject createStringView(std::string_view val);
+
+    /// An EMBSTR over `bytes`, which must outlive the object.
+    static RedisObject createEmbedded(std::string_view bytes);
 
-    /// Create an empty LIST RedisObject (std::deque).
+    /// Create an empty LIST RedisObject (a Quicklist).
     static RedisObject createList();
 
-    /// Create an empty HASH RedisObject (unordered_map<string,string>).
-    static RedisObject createHash();
+    /// Create an empty HASH RedisObject: a listpack of field/value pairs,
+    /// or with HASHTABLE an unordered_map<string,string>.
+    static RedisObject createHash(Encoding encoding = Encoding::LISTPACK);
 
-    /// Create an empty SET RedisObject (unordered_set<string>).
-    static RedisObject createSet();
+    /// Create an empty SET RedisObject: a listpack of members, with
+    /// INTSET a sorted integer array, or with HASHTABLE an
+    /// unordered_set<string>.
+    static RedisObject createSet(Encoding encoding = Encoding::LISTPACK);
 
-    /// Create an empty ZSET RedisObject (Skiplist + dict).
-    static RedisObject createZSet();
+    /// Create an empty ZSET RedisObject: a listpack of member/score pairs
+    /// in score order, or with SKIPLIST a Skiplist + dict.
+    static RedisObject createZSet(Encoding encoding = Encoding::LISTPACK);
+
+    /// Parse `s` as a decimal int64_t — the test for INTEGER encoding.
+    static bool parseInteger(std::string_view s, int64_t& out);
 
     /// Return the string representation (STRING type only).
     std::string asString() const;
 
-    /// Estimate total memory consumed by this object (struct + dynamic data).
+    /// The bytes of a RAW or EMBSTR string.
+    std::string_view stringBytes() const;
+
+    /// The value of an INTEGER string.
+    int64_t asInteger() const { return integer_; }
+
+    /// The container of a LIST / HASH / SET / ZSET object.
+    ListData& asList() { return box<ListData>()->data; }
+    HashData& asHash() { return box<HashData>()->data; }
+    SetData&  asSet()  { return box<SetData>()->data; }
+    ZSetData& asZSet() { return box<ZSetData>()->data; }
+    const ListData& asList() const { return box<ListData>()->data; }
+    const HashData& asHash() const { return box<HashData>()->data; }
+    const SetData&  asSet()  const { return box<SetData>()->data; }
+    const ZSetData& asZSet() const { return box<ZSetData>()->data; }
+
+    /// The elements of a LISTPACK-encoded HASH / SET / ZSET. The per-type
+    /// operations in HashType / SetType / ZSetType hide the difference.
+    Listpack& asListpack() { return box<Listpack>()->data; }
+    const Listpack& asListpack() const { return box<Listpack>()->data; }
+
+    /// The members of an INTSET-encoded SET.
+    Intset& asIntset() { return box<Intset>()->data; }
+    const Intset& asIntset() const { return box<Intset>()->data; }
+
+    /// Bytes this value accounts for: the object itself, everything it
+    /// owns on the heap and, for EMBSTR, its embedded bytes.
     /// Used by Database to maintain a running usedMemory_ counter for INFO.
+    /// O(1): a container's bytes are a running total kept up to date with
+    /// addUsage() by whoever mutates it.
     size_t memoryUsage() const;
+
+    /// Recompute memoryUsage() by walking the container. With `samples`
+    /// > 0, only that many elements are measured and the average is
+    /// scaled to the container's size (MEMORY USAGE ... SAMPLES n).
+    size_t computeMemoryUsage(size_t samples = 0) const;
+
+    /// Add `delta` bytes to a container's running total (not needed for
+    /// a LIST, LISTPACK or INTSET, whose structure keeps its own size).
+    /// Callers pass the difference of the element costs below, plus
+    /// bucketUsage() before and after if a hash container rehashed.
+    void addUsage(int64_t delta) { containerUsage() += delta; }
+
+    // ── Element costs (match computeMemoryUsage()) ──
+    /// A std::string object plus its heap buffer, if any.
+    static size_t stringUsage(const std::string& s);
+    static size_t hashFieldUsage(const std::string& field,
+                                 const std::string& value);
+    static size_t setMemberUsage(const std::string& member);
+    static size_t zsetMemberUsage(const std::string& member);
+    /// Bucket array of a std hash container with `bucketCount` buckets.
+    static size_t bucketUsage(size_t bucketCount);
+
+private:
+    /// A container together with its running byte count. The count
+    /// covers the container and everything it owns, but not the
+    /// RedisObject itself.
+    template <typename T>
+    struct Box {
+        T data;
+        size_t usage = 0;
+    };
+
+    template <typename T> Box<T>* box() { return static_cast<Box<T>*>(ptr_); }
+    template <typename T> const Box<T>* box() const {
+        return static_cast<const Box<T>*>(ptr_);
+    }
+
+    /// The running total of a container object.
+    size_t& containerUsage();
+    size_t containerUsage() const {
+        return const_cast<RedisObject*>(this)->containerUsage();
+    }
+
+    /// Box a new, empty container and start its running total.
+    template <typename T>
+    static RedisObject createContainer(DataType type, Encoding encoding);
+
+    uint32_t embLen_ = 0;         // EMBSTR: number of bytes
+    union {
+        int64_t      integer_;    // INTEGER
+        const char*  embstr_;     // EMBSTR — not owned
+        std::string* raw_;        // RAW — owned, nullptr = ""
+        void*        ptr_ = nullptr;  // containers — owned
+    };
+
+    /// Free the owned payload (if any).
+    void release();
 };
+
+static_assert(sizeof(RedisObject) == 16, "RedisObject should stay two words");
@@ -0,0 +1,161 @@
+#include "store/SetType.h"
+
+#include <algorithm>
+#include <string>
+
+/// Longest member an intset can hold, as text: "-9223372036854775808".
+static constexpr size_t kMaxIntegerLength = 20;
+
+/// Move `set`'s members into a new set of `encoding` (LISTPACK or
+/// HASHTABLE).
+static void convert(RedisObject& set, Encoding encoding) {
+    RedisObject target = RedisObject::createSet(encoding);
+    if (encoding == Encoding::LISTPACK) {
+        Listpack& lp = target.asListpack();
+        SetType::forEach(set, [&](std::string_view member) {
+            lp.append(member);
+        });
+    } else {
+        SetData& members = target.asSet();
+        members.reserve(SetType::size(set) + 1);
+        SetType::forEach(set, [&](std::string_view member) {
+            members.emplace(member);
+        });
+        target.addUsage(static_cast<int64_t>(target.computeMemoryUsage()) -
+                        static_cast<int64_t>(target.memoryUsage()));
+    }
+    set = std::move(target);
+}
+
+/// Convert an intset that cannot take `member`: to a listpack if the
+/// result fits one, else to a hashtable.
+static void convertIntset(RedisObject& set, std::string_view member,
+                          const SetLimits& limits) {
+    bool fits = SetType::size(set) < limits.maxEntries &&
+                limits.maxValue >= kMaxIntegerLength &&
+                limits.allowsValue(member);
+    convert(set, fits ? Encoding::LISTPACK : Encoding::HASHTABLE);
+}
+
+RedisObject SetType::create(std::string_view first, const SetLimits& limits) {
+    int64_t value;
+    if (limits.maxIntsetEntries > 0 && Intset::parse(first, value)) {
+        return RedisObject::createSet(Encoding::INTSET);
+    }
+    return RedisObject::createSet(Encoding::LISTPACK);
+}
+
+size_t SetType::size(const RedisObject& set) {
+    if (set.encoding == Encoding::INTSET) return set.asIntset().size();
+    if (set.encoding == Encoding::LISTPACK) return set.asListpack().size();
+    return set.asSet().size();
+}
+
+bool SetType::contains(const RedisObject& set, std::string_view member) {
+    if (set.encoding == Encoding::INTSET) {
+        int64_t value;
+        return Intset::parse(member, value) && set.asIntset().contains(value);
+    }
+    if (set.encoding == Encoding::LISTPACK) {
+        const Listpack& lp = set.asListpack();
+        return lp.find(member) != lp.end();
+    }
+    return set.asSet().count(std::string(member)) > 0;
+}
+
+bool SetType::add(RedisObject& set, std::string_view member,
+                  const SetLimits& limits) {
+    if (set.encoding == Encoding::INTSET) {
+        Intset& is = set.asIntset();
+        int64_t value;
+        if (Intset::parse(member, value)) {
+            if (is.contains(value)) return false;
+            if (is.size() < limits.maxIntsetEntries) return is.add(value);
+        }
+        convertIntset(set, member, limits);
+    }
+
+    if (set.encoding == Encoding::LISTPACK) {
+        Listpack& lp = set.asListpack();
+        if (lp.find(member) != lp.end()) return false;
+        if (lp.size() < limits.maxEntries && limits.allowsValue(member)) {
+            lp.append(member);
+            return true;
+        }
+        convert(set, Encoding::HASHTABLE);
+    }
+
+    SetData& members = set.asSet();
+    size_t buckets = members.bucket_count();
+    auto [it, inserted] = members.emplace(member);
+    if (!inserted) return false;
+    set.addUsage(static_cast<int64_t>(
+        RedisObject::setMemberUsage(*it) +
+        RedisObject::bucketUsage(members.bucket_count()) -
+        RedisObject::bucketUsage(buckets)));
+    return true;
+}
+
+bool SetType::remove(RedisObject& set, std::string_view member) {
+    if (set.encoding == Encoding::INTSET) {
+        int64_t value;
+        return Intset::parse(member, value) && set.asIntset().remove(value);
+    }
+    if (set.encoding == Encoding::LISTPACK) {
+        Listpack& lp = set.asListpack();
+        size_t pos = lp.find(member);
+        if (pos == lp.end()) return false;
+        lp.erase(pos);
+        return true;
+    }
+    SetData& members = set.asSet();
+    auto it = members.find(std::string(member));
+    if (it == members.end()) return false;
+    set.addUsage(-static_cast<int64_t>(RedisObject::setMemberUsage(*it)));
+    members.erase(it);
+    return true;
+}
+
+std::vector<std::string> SetType::intersect(
+    std::vector<const RedisObject*> sets) {
+    std::vector<std::string> result;
+    if (sets.empty()) return result;
+    // Drive from the smallest set: the result is no larger.
+    std::sort(sets.begin(), sets.end(),
+              [](const RedisObject* a, const RedisObject* b) {
+                  return size(*a) < size(*b);
+              });
+    const RedisObject& smallest = *sets.front();
+
+    bool allIntsets = std::all_of(sets.begin(), sets.end(),
+                                  [](const RedisObject* s) {
+                                      return s->encoding == Encoding::INTSET;
+                                  });
+    if (allIntsets) {
+        // Merge: every array is sorted, so each set's cursor only moves
+        // forward, and running off the end of one ends the intersection.
+        const Intset& base = smallest.asIntset();
+        std::vector<size_t> cursor(sets.size(), 0);
+        for (size_t i = 0; i < base.size(); ++i) {
+            int64_t value = base.get(i);
+            bool inAll = true;
+            for (size_t k = 1; k < sets.size() && inAll; ++k) {
+                const Intset& other = sets[k]->asIntset();
+                size_t& c = cursor[k];
+                while (c < other.size() && other.get(c) < value) ++c;
+                if (c == other.size()) return result;
+                inAll = other.get(c) == value;
+            }
+            if (inAll) result.push_back(std::to_string(value));
+        }
+        return result;
+    }
+
+    forEach(smallest, [&](std::string_view member) {
+        for (size_t k = 1; k < sets.size(); ++k) {
+            if (!contains(*sets[k], member)) return;
+        }
+        result.emplace_back(member);
+    });
+    return result;
+}
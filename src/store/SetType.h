@@ -0,0 +1,71 @@
+#pragma once
+
+#include "store/Intset.h"
+#include "store/Listpack.h"
+#include "store/RedisObject.h"
+
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Operations on a SET object, whichever its encoding:
+///
+///   INTSET     every member is an integer: a sorted int16/32/64 array
+///   LISTPACK   members in insertion order
+///   HASHTABLE  SetData (unordered_set<string>)
+///
+/// A set starts as an intset if its first member is an integer, else as
+/// a listpack. An intset that receives a non-integer member or outgrows
+/// `limits.maxIntsetEntries` converts to a listpack if it fits one, else
+/// to a hashtable; a listpack converts to a hashtable once it outgrows
+/// `limits`. Conversions never go back. Mutators keep the object's
+/// memoryUsage() current; the caller reconciles Database::usedMemory()
+/// (Database::valueChanged).
+///
+/// Must NOT know about: commands, RESP, the keyspace.
+namespace SetType {
+
+/// An empty set in the encoding `first`, its first member, calls for.
+RedisObject create(std::string_view first, const SetLimits& limits);
+
+/// Number of members.
+size_t size(const RedisObject& set);
+
+bool contains(const RedisObject& set, std::string_view member);
+
+/// Add `member`. Returns true if it was not already there.
+bool add(RedisObject& set, std::string_view member, const SetLimits& limits);
+
+/// Remove `member`. Returns true if it was there.
+bool remove(RedisObject& set, std::string_view member);
+
+/// Members present in every one of `sets`. Intsets are intersected by
+/// merging their sorted arrays; otherwise each member of the smallest
+/// set is looked up in the others.
+std::vector<std::string> intersect(std::vector<const RedisObject*> sets);
+
+/// Call fn(member) for every member — an intset's in ascending order.
+template <typename Fn>
+void forEach(const RedisObject& set, Fn&& fn) {
+    if (set.encoding == Encoding::INTSET) {
+        const Intset& is = set.asIntset();
+        char buf[24];
+        for (size_t i = 0; i < is.size(); ++i) {
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), is.get(i));
+            fn(std::string_view(buf, static_cast<size_t>(end - buf)));
+        }
+        return;
+    }
+    if (set.encoding == Encoding::LISTPACK) {
+        const Listpack& lp = set.asListpack();
+        for (size_t pos = lp.begin(); pos != lp.end(); pos = lp.next(pos)) {
+            fn(lp.get(pos));
+        }
+        return;
+    }
+    for (const auto& member : set.asSet()) fn(std::string_view(member));
+}
+
+}  // namespace SetType
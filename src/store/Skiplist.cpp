@@ -14,10 +14,12 @@ Skiplist::~Skiplist() { deleteAllNodes(); }
 
 Skiplist::Skiplist(Skiplist&& other) noexcept
     : header_(other.header_),
+      tail_(other.tail_),
       level_(other.level_),
       size_(other.size_),
       rng_(std::move(other.rng_)) {
     other.header_ = nullptr;
+    other.tail_ = nullptr;
     other.level_ = 1;
     other.size_ = 0;
 }
@@ -26,10 +28,12 @@ Skiplist& Skiplist::operator=(Skiplist&& other) noexcept {
     if (this != &other) {
         deleteAllNodes();
         header_ = other.header_;
+        tail_ = other.tail_;
         level_ = other.level_;
         size_ = other.size_;
         rng_ = std::move(other.rng_);
         other.header_ = nullptr;
+        other.tail_ = nullptr;
         other.level_ = 1;
         other.size_ = 0;
     }
@@ -41,39 +45,55 @@ Skiplist& Skiplist::operator=(Skiplist&& other) noexcept {
 // ---------------------------------------------------------------------------
 
 Skiplist::Node* Skiplist::insert(const std::string& member, double score) {
-    // update[i] = last node at level i whose successor is >= new node.
+    // update[i] = last node at level i whose successor is >= new node;
+    // rank[i] = that node's rank (header = 0, first node = 1).
     Node* update[kMaxLevel];
+    size_t rank[kMaxLevel];
     Node* x = header_;
 
     for (int i = level_ - 1; i >= 0; --i) {
-        while (x->forward[i] &&
-               lessThan(x->forward[i]->score, x->forward[i]->member,
-                        score, member)) {
-            x = x->forward[i];
+        rank[i] = (i == level_ - 1) ? 0 : rank[i + 1];
+        while (x->levels[i].forward &&
+               lessThan(x->levels[i].forward->score,
+                        x->levels[i].forward->member, score, member)) {
+            rank[i] += x->levels[i].span;
+            x = x->levels[i].forward;
         }
         update[i] = x;
     }
 
     int newLevel = randomLevel();
     if (newLevel > level_) {
+        // New levels start at the header and span the whole list.
         for (int i = level_; i < newLevel; ++i) {
+            rank[i] = 0;
             update[i] = header_;
+            header_->levels[i].span = size_;
         }
         level_ = newLevel;
     }
 
     Node* node = new Node(member, score, newLevel);
 
-    // Splice into each level.
+    // Splice into each level, splitting the span it lands in.
     for (int i = 0; i < newLevel; ++i) {
-        node->forward[i] = update[i]->forward[i];
-        update[i]->forward[i] = node;
+        Node::Level& prev = update[i]->levels[i];
+        node->levels[i].forward = prev.forward;
+        prev.forward = node;
+        node->levels[i].span = prev.span - (rank[0] - rank[i]);
+        prev.span = (rank[0] - rank[i]) + 1;
+    }
+    // Levels above the node now jump over one more element.
+    for (int i = newLevel; i < level_; ++i) {
+        ++update[i]->levels[i].span;
     }
 
     // Set backward pointer (level 0 doubly linked).
     node->backward = (update[0] == header_) ? nullptr : update[0];
-    if (node->forward[0]) {
-        node->forward[0]->backward = node;
+    if (node->levels[0].forward) {
+        node->levels[0].forward->backward = node;
+    } else {
+        tail_ = node;
     }
 
     ++size_;
@@ -85,59 +105,103 @@ bool Skiplist::remove(const std::string& member, double score) {
     Node* x = header_;
 
     for (int i = level_ - 1; i >= 0; --i) {
-        while (x->forward[i] &&
-               lessThan(x->forward[i]->score, x->forward[i]->member,
-                        score, member)) {
-            x = x->forward[i];
+        while (x->levels[i].forward &&
+               lessThan(x->levels[i].forward->score,
+                        x->levels[i].forward->member, score, member)) {
+            x = x->levels[i].forward;
         }
         update[i] = x;
     }
 
-    x = x->forward[0];
+    x = x->levels[0].forward;
     if (!x || x->score != score || x->member != member) {
         return false;  // not found
     }
+    unlink(x, update);
+    delete x;
+    return true;
+}
 
-    // Unlink from each level.
+void Skiplist::unlink(Node* x, Node* const* update) {
+    // Unlink from each level; spans that jumped over x get one shorter.
     for (int i = 0; i < level_; ++i) {
-        if (update[i]->forward[i] != x) break;
-        update[i]->forward[i] = x->forward[i];
+        Node::Level& prev = update[i]->levels[i];
+        if (prev.forward == x) {
+            prev.span += x->levels[i].span - 1;
+            prev.forward = x->levels[i].forward;
+        } else {
+            --prev.span;
+        }
     }
 
     // Fix backward pointer.
-    if (x->forward[0]) {
-        x->forward[0]->backward = x->backward;
+    if (x->levels[0].forward) {
+        x->levels[0].forward->backward = x->backward;
+    } else {
+        tail_ = x->backward;
     }
-
-    delete x;
     --size_;
 
     // Shrink level if top levels are now empty.
-    while (level_ > 1 && !header_->forward[level_ - 1]) {
+    while (level_ > 1 && !header_->levels[level_ - 1].forward) {
         --level_;
     }
-    return true;
 }
 
 Skiplist::Node* Skiplist::find(const std::string& member, double score) {
     Node* x = header_;
     for (int i = level_ - 1; i >= 0; --i) {
-        while (x->forward[i] &&
-               lessThan(x->forward[i]->score, x->forward[i]->member,
-                        score, member)) {
-            x = x->forward[i];
+        while (x->levels[i].forward &&
+               lessThan(x->levels[i].forward->score,
+                        x->levels[i].forward->member, score, member)) {
+            x = x->levels[i].forward;
         }
     }
 
-    x = x->forward[0];
+    x = x->levels[0].forward;
     if (x && x->score == score && x->member == member) {
         return x;
     }
     return nullptr;
 }
 
-std::vector<std::pair<std::string, double>>
-Skiplist::rangeByRank(int start, int stop) {
+std::optional<size_t> Skiplist::rank(const std::string& member,
+                                     double score) const {
+    // Advance while the next node is <= (score, member), summing spans.
+    size_t traversed = 0;
+    const Node* x = header_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->levels[i].forward &&
+               !lessThan(score, member, x->levels[i].forward->score,
+                         x->levels[i].forward->member)) {
+            traversed += x->levels[i].span;
+            x = x->levels[i].forward;
+        }
+        if (x != header_ && x->score == score && x->member == member) {
+            return traversed - 1;
+        }
+    }
+    return std::nullopt;
+}
+
+const Skiplist::Node* Skiplist::byRank(size_t rank) const {
+    if (rank >= size_) return nullptr;
+    // Positions are 1-based here: the header is position 0.
+    size_t target = rank + 1;
+    size_t traversed = 0;
+    const Node* x = header_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->levels[i].forward &&
+               traversed + x->levels[i].span <= target) {
+            traversed += x->levels[i].span;
+            x = x->levels[i].forward;
+        }
+        if (traversed == target) return x;
+    }
+    return nullptr;
+}
+
+bool Skiplist::clampRange(int& start, int& stop) const {
     int n = static_cast<int>(size_);
     // Convert negative indices.
     if (start < 0) start += n;
@@ -145,23 +209,163 @@ Skiplist::rangeByRank(int start, int stop) {
     // Clamp.
     if (start < 0) start = 0;
     if (stop >= n) stop = n - 1;
+    return start <= stop && start < n;
+}
 
+std::vector<std::pair<std::string, double>>
+Skiplist::rangeByRank(int start, int stop) const {
     std::vector<std::pair<std::string, double>> result;
-    if (start > stop || start >= n) return result;
+    if (!clampRange(start, stop)) return result;
 
-    // Walk level 0 to reach the start rank.
-    Node* x = header_->forward[0];
-    for (int i = 0; i < start && x; ++i) {
-        x = x->forward[0];
+    result.reserve(static_cast<size_t>(stop - start + 1));
+    const Node* x = byRank(static_cast<size_t>(start));
+    for (int i = start; i <= stop && x; ++i) {
+        result.emplace_back(x->member, x->score);
+        x = x->levels[0].forward;
     }
+    return result;
+}
+
+std::vector<std::pair<std::string, double>>
+Skiplist::revRangeByRank(int start, int stop) const {
+    std::vector<std::pair<std::string, double>> result;
+    if (!clampRange(start, stop)) return result;
 
+    result.reserve(static_cast<size_t>(stop - start + 1));
+    const Node* x = byRank(size_ - 1 - static_cast<size_t>(start));
     for (int i = start; i <= stop && x; ++i) {
         result.emplace_back(x->member, x->score);
-        x = x->forward[0];
+        x = x->backward;
     }
     return result;
 }
 
+// ── Score and lex ranges ───────────────────────────────────────────────────
+
+/// One end of a lex range. `open` is the symbol that leaves this end
+/// unbounded ("-" for the minimum, "+" for the maximum); the other one
+/// makes the whole range empty.
+static bool parseLexBound(std::string_view s, char open, std::string& value,
+                          bool& exclusive, bool& isOpen, bool& empty) {
+    if (s.size() == 1 && (s[0] == '-' || s[0] == '+')) {
+        isOpen = s[0] == open;
+        if (!isOpen) empty = true;
+        return true;
+    }
+    if (s.empty() || (s[0] != '[' && s[0] != '(')) return false;
+    exclusive = s[0] == '(';
+    value.assign(s.substr(1));
+    return true;
+}
+
+bool LexRange::parse(std::string_view min, std::string_view max,
+                     LexRange& out) {
+    out = LexRange{};
+    return parseLexBound(min, '-', out.min, out.minExclusive, out.minOpen,
+                         out.empty) &&
+           parseLexBound(max, '+', out.max, out.maxExclusive, out.maxOpen,
+                         out.empty);
+}
+
+// One implementation for both kinds of range: rangeKey() picks the field
+// a range bounds.
+
+static double rangeKey(const ScoreRange&, const Skiplist::Node* x) {
+    return x->score;
+}
+
+static const std::string& rangeKey(const LexRange&, const Skiplist::Node* x) {
+    return x->member;
+}
+
+template <typename Range>
+const Skiplist::Node* Skiplist::firstInRange(const Range& range) const {
+    // Advance while the next node is below the range's minimum.
+    const Node* x = header_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->levels[i].forward &&
+               !range.aboveMin(rangeKey(range, x->levels[i].forward))) {
+            x = x->levels[i].forward;
+        }
+    }
+    x = x->levels[0].forward;
+    return x && range.belowMax(rangeKey(range, x)) ? x : nullptr;
+}
+
+template <typename Range>
+const Skiplist::Node* Skiplist::lastInRange(const Range& range) const {
+    // Advance while the next node is still within the range's maximum.
+    const Node* x = header_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->levels[i].forward &&
+               range.belowMax(rangeKey(range, x->levels[i].forward))) {
+            x = x->levels[i].forward;
+        }
+    }
+    return x != header_ && range.aboveMin(rangeKey(range, x)) ? x : nullptr;
+}
+
+template <typename Range>
+std::vector<std::pair<std::string, double>>
+Skiplist::rangeIn(const Range& range, size_t offset, size_t count) const {
+    std::vector<std::pair<std::string, double>> result;
+    const Node* x = firstInRange(range);
+    if (x && offset > 0) {
+        // Skip the offset by rank rather than one node at a time.
+        x = byRank(*rank(x->member, x->score) + offset);
+    }
+    for (; x && count > 0 && range.belowMax(rangeKey(range, x));
+         x = x->levels[0].forward, --count) {
+        result.emplace_back(x->member, x->score);
+    }
+    return result;
+}
+
+std::vector<std::pair<std::string, double>>
+Skiplist::rangeByScore(const ScoreRange& range, size_t offset,
+                       size_t count) const {
+    return rangeIn(range, offset, count);
+}
+
+std::vector<std::pair<std::string, double>>
+Skiplist::rangeByLex(const LexRange& range, size_t offset,
+                     size_t count) const {
+    if (range.empty) return {};
+    return rangeIn(range, offset, count);
+}
+
+size_t Skiplist::countInRange(const ScoreRange& range) const {
+    const Node* first = firstInRange(range);
+    if (!first) return 0;
+    const Node* last = lastInRange(range);
+    return *rank(last->member, last->score) -
+           *rank(first->member, first->score) + 1;
+}
+
+void Skiplist::removeRangeByScore(const ScoreRange& range,
+                                  std::vector<std::string>& removed) {
+    Node* update[kMaxLevel];
+    Node* x = header_;
+    for (int i = level_ - 1; i >= 0; --i) {
+        while (x->levels[i].forward &&
+               !range.aboveMin(x->levels[i].forward->score)) {
+            x = x->levels[i].forward;
+        }
+        update[i] = x;
+    }
+
+    // The nodes in range are consecutive, and every one of them has the
+    // same predecessors at each level: update[] stays valid throughout.
+    x = x->levels[0].forward;
+    while (x && range.belowMax(x->score)) {
+        Node* next = x->levels[0].forward;
+        unlink(x, update);
+        removed.push_back(std::move(x->member));
+        delete x;
+        x = next;
+    }
+}
+
 size_t Skiplist::size() const { return size_; }
 
 // ---------------------------------------------------------------------------
@@ -179,9 +383,9 @@ int Skiplist::randomLevel() {
 
 void Skiplist::deleteAllNodes() {
     if (!header_) return;
-    Node* x = header_->forward[0];
+    Node* x = header_->levels[0].forward;
     while (x) {
-        Node* next = x->forward[0];
+        Node* next = x->levels[0].forward;
         delete x;
         x = next;
     }
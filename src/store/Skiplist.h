@@ -1,14 +1,64 @@
 #pragma once
 
 #include <cstddef>
+#include <limits>
+#include <optional>
 #include <random>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+/// A score interval, as ZRANGEBYSCORE takes it: either end may be
+/// exclusive, and an infinite end leaves that side open.
+struct ScoreRange {
+    double min = -std::numeric_limits<double>::infinity();
+    double max = std::numeric_limits<double>::infinity();
+    bool minExclusive = false;
+    bool maxExclusive = false;
+
+    bool aboveMin(double s) const { return minExclusive ? s > min : s >= min; }
+    bool belowMax(double s) const { return maxExclusive ? s < max : s <= max; }
+    bool contains(double s) const { return aboveMin(s) && belowMax(s); }
+};
+
+/// A member interval, as ZRANGEBYLEX takes it: members compare bytewise,
+/// and `-` / `+` (minOpen / maxOpen) leave that side unbounded. A `+`
+/// minimum or a `-` maximum matches nothing (`empty`).
+struct LexRange {
+    std::string min;
+    std::string max;
+    bool minExclusive = false;
+    bool maxExclusive = false;
+    bool minOpen = false;
+    bool maxOpen = false;
+    bool empty = false;
+
+    /// Parse ZRANGEBYLEX's `min max`: each "[member", "(member", "-" or
+    /// "+". Returns false if either is none of those.
+    static bool parse(std::string_view min, std::string_view max,
+                      LexRange& out);
+
+    bool aboveMin(std::string_view m) const {
+        return !empty && (minOpen || (minExclusive ? m > min : m >= min));
+    }
+    bool belowMax(std::string_view m) const {
+        return !empty && (maxOpen || (maxExclusive ? m < max : m <= max));
+    }
+    bool contains(std::string_view m) const {
+        return aboveMin(m) && belowMax(m);
+    }
+};
+
 /// An ordered probabilistic data structure for sorted sets.
-/// Provides O(log n) expected insert, delete, and range-by-rank queries.
-/// Ordered by (score ASC, member ASC lexicographic) — matches Redis behavior.
+/// Provides O(log n) expected insert, delete, rank lookup and seek to a
+/// rank. Ordered by (score ASC, member ASC lexicographic) — matches Redis
+/// behavior.
+///
+/// Every forward pointer carries a span: how many level-0 steps it
+/// jumps. Summing spans along a search path gives a node's rank, and
+/// following them down from the top level finds the node at a rank,
+/// both without touching the nodes in between.
 ///
 /// Used as the ordered index in ZSet alongside an unordered_map for O(1) ZSCORE.
 ///
@@ -16,22 +66,27 @@
 class Skiplist {
 public:
     /// A node in the skiplist. Each node holds a member-score pair and
-    /// forward pointers (one per level) plus a backward pointer for
-    /// reverse iteration at level 0.
+    /// a forward pointer with its span per level, plus a backward pointer
+    /// for reverse iteration at level 0.
     struct Node {
+        struct Level {
+            Node* forward = nullptr;
+            size_t span = 0;          // level-0 steps to `forward`
+        };
+
         std::string member;
         double score;
-        std::vector<Node*> forward;   // one pointer per level
+        std::vector<Level> levels;    // one per level
         Node* backward = nullptr;     // previous node at level 0
 
         Node(const std::string& m, double s, int level)
-            : member(m), score(s), forward(level, nullptr) {}
+            : member(m), score(s), levels(level) {}
     };
 
     Skiplist();
     ~Skiplist();
 
-    // Move-only (non-copyable). Required for std::variant in RedisObject.
+    // Move-only (non-copyable). ZSetData moves it with the rest of a sorted set.
     Skiplist(Skiplist&& other) noexcept;
     Skiplist& operator=(Skiplist&& other) noexcept;
     Skiplist(const Skiplist&) = delete;
@@ -47,16 +102,50 @@ public:
     /// Find the node with exact (member, score). Returns nullptr if not found.
     Node* find(const std::string& member, double score);
 
+    /// 0-based rank of the node with exact (member, score), in O(log n).
+    std::optional<size_t> rank(const std::string& member, double score) const;
+
+    /// The node at 0-based `rank`, or nullptr if out of range. O(log n).
+    const Node* byRank(size_t rank) const;
+
+    /// The last node (highest score), or nullptr if empty.
+    const Node* last() const { return tail_; }
+
     /// Return elements between rank start and stop (inclusive, 0-based).
     /// Negative indices count from the end (-1 = last).
-    /// Walks level 0 — O(n) rank lookup (simplified, no span tracking).
-    std::vector<std::pair<std::string, double>> rangeByRank(int start, int stop);
+    /// O(log n) to reach `start`, then one step per element returned.
+    std::vector<std::pair<std::string, double>> rangeByRank(int start, int stop) const;
+
+    /// Like rangeByRank(), with ranks counted from the highest score down
+    /// (ZREVRANGE): walks the backward pointers.
+    std::vector<std::pair<std::string, double>> revRangeByRank(int start, int stop) const;
+
+    /// Elements with a score in `range`, lowest first: skips `offset` of
+    /// them, then returns at most `count`. O(log n + returned) — the
+    /// offset is skipped by rank, not walked.
+    std::vector<std::pair<std::string, double>> rangeByScore(
+        const ScoreRange& range, size_t offset, size_t count) const;
+
+    /// As rangeByScore(), for members in `range`. Meaningful only when
+    /// every element has the same score (ZRANGEBYLEX), as in Redis.
+    std::vector<std::pair<std::string, double>> rangeByLex(
+        const LexRange& range, size_t offset, size_t count) const;
+
+    /// Number of elements with a score in `range`, from the ranks of the
+    /// first and last of them. O(log n).
+    size_t countInRange(const ScoreRange& range) const;
+
+    /// Remove every element with a score in `range`, moving its member
+    /// into `removed`. O(log n + removed).
+    void removeRangeByScore(const ScoreRange& range,
+                            std::vector<std::string>& removed);
 
     /// Return the number of elements.
     size_t size() const;
 
 private:
     Node* header_;          // sentinel node — never holds real data
+    Node* tail_ = nullptr;  // last node, for reverse ranges
     int level_ = 1;         // current max level in use (1-based)
     size_t size_ = 0;       // number of real elements
     std::mt19937 rng_;      // per-instance PRNG — no static mutable state
@@ -73,6 +162,24 @@ private:
     /// Delete all nodes (including header). Called by destructor and move-assign.
     void deleteAllNodes();
 
+    /// Resolve negative ranks and clamp to [0, size). Returns false if
+    /// the range is empty.
+    bool clampRange(int& start, int& stop) const;
+
+    /// Unlink `x`, whose predecessor at each level is update[level], and
+    /// fix the spans, tail and level. The caller deletes it.
+    void unlink(Node* x, Node* const* update);
+
+    /// First / last node inside a ScoreRange or LexRange, or nullptr.
+    template <typename Range>
+    const Node* firstInRange(const Range& range) const;
+    template <typename Range>
+    const Node* lastInRange(const Range& range) const;
+
+    template <typename Range>
+    std::vector<std::pair<std::string, double>> rangeIn(
+        const Range& range, size_t offset, size_t count) const;
+
     /// Compare two (score, member) pairs. Returns true if (s1,m1) < (s2,m2).
     static bool lessThan(double s1, const std::string& m1,
                          double s2, const std::string& m2);
@@ -0,0 +1,301 @@
+#include "store/ZSetType.h"
+
+#include <algorithm>
+#include <cstring>
+
+// ── Listpack helpers ───────────────────────────────────────────────────────
+
+/// Scores are stored as the raw bytes of the double: exact, and fixed size.
+struct ScoreBytes {
+    char bytes[sizeof(double)];
+
+    explicit ScoreBytes(double score) {
+        std::memcpy(bytes, &score, sizeof(score));
+    }
+    std::string_view view() const { return {bytes, sizeof(bytes)}; }
+};
+
+static double decodeScore(std::string_view bytes) {
+    double score;
+    std::memcpy(&score, bytes.data(), sizeof(score));
+    return score;
+}
+
+/// Call fn(pos, member, score) for each pair in order, stopping early if
+/// fn returns true.
+template <typename Fn>
+static void forEachPair(const Listpack& lp, Fn&& fn) {
+    for (size_t pos = lp.begin(); pos != lp.end();) {
+        size_t scorePos = lp.next(pos);
+        if (fn(pos, lp.get(pos), decodeScore(lp.get(scorePos)))) return;
+        pos = lp.next(scorePos);
+    }
+}
+
+/// Resolve negative ranks and clamp to [0, size), as Skiplist does.
+/// Returns false if the range is empty.
+static bool clampRange(const RedisObject& zset, int& start, int& stop) {
+    int n = static_cast<int>(ZSetType::size(zset));
+    if (start < 0) start += n;
+    if (stop < 0) stop += n;
+    if (start < 0) start = 0;
+    if (stop >= n) stop = n - 1;
+    return start <= stop && start < n;
+}
+
+/// Insert (member, score) in (score, member) order.
+static void listpackInsert(Listpack& lp, std::string_view member,
+                           double score) {
+    size_t at = lp.end();
+    forEachPair(lp, [&](size_t pos, std::string_view m, double s) {
+        if (s > score || (s == score && m > member)) {
+            at = pos;
+            return true;
+        }
+        return false;
+    });
+    lp.insert(at, member);
+    lp.insert(lp.next(at), ScoreBytes(score).view());
+}
+
+/// Move a listpack sorted set's members into a SKIPLIST.
+static void convertToSkiplist(RedisObject& zset) {
+    RedisObject sorted = RedisObject::createZSet(Encoding::SKIPLIST);
+    ZSetData& data = sorted.asZSet();
+    data.dict.reserve(ZSetType::size(zset) + 1);
+    forEachPair(zset.asListpack(),
+                [&](size_t, std::string_view member, double score) {
+        std::string m(member);
+        data.skiplist.insert(m, score);
+        data.dict.emplace(std::move(m), score);
+        return false;
+    });
+    sorted.addUsage(static_cast<int64_t>(sorted.computeMemoryUsage()) -
+                    static_cast<int64_t>(sorted.memoryUsage()));
+    zset = std::move(sorted);
+}
+
+// ── Operations ─────────────────────────────────────────────────────────────
+
+size_t ZSetType::size(const RedisObject& zset) {
+    if (zset.encoding == Encoding::LISTPACK) return zset.asListpack().size() / 2;
+    return zset.asZSet().dict.size();
+}
+
+std::optional<double> ZSetType::score(const RedisObject& zset,
+                                      std::string_view member) {
+    if (zset.encoding == Encoding::LISTPACK) {
+        const Listpack& lp = zset.asListpack();
+        size_t pos = lp.find(member, 2);
+        if (pos == lp.end()) return std::nullopt;
+        return decodeScore(lp.get(lp.next(pos)));
+    }
+    const ZSetData& data = zset.asZSet();
+    auto it = data.dict.find(std::string(member));
+    if (it == data.dict.end()) return std::nullopt;
+    return it->second;
+}
+
+bool ZSetType::add(RedisObject& zset, std::string_view member, double score,
+                   const ListpackLimits& limits) {
+    if (zset.encoding == Encoding::LISTPACK) {
+        Listpack& lp = zset.asListpack();
+        size_t pos = lp.find(member, 2);
+        if (pos != lp.end()) {
+            // Same member, new score: take it out and put it back in order.
+            if (decodeScore(lp.get(lp.next(pos))) != score) {
+                lp.erase(pos, 2);
+                listpackInsert(lp, member, score);
+            }
+            return false;
+        }
+        if (size(zset) < limits.maxEntries && limits.allowsValue(member)) {
+            listpackInsert(lp, member, score);
+            return true;
+        }
+        convertToSkiplist(zset);
+    }
+
+    ZSetData& data = zset.asZSet();
+    std::string m(member);
+    auto it = data.dict.find(m);
+    if (it != data.dict.end()) {
+        // Member exists — update score if different.
+        if (it->second != score) {
+            data.skiplist.remove(m, it->second);
+            data.skiplist.insert(m, score);
+            it->second = score;
+        }
+        return false;
+    }
+    size_t buckets = data.dict.bucket_count();
+    data.skiplist.insert(m, score);
+    data.dict.emplace(m, score);
+    zset.addUsage(static_cast<int64_t>(
+        RedisObject::zsetMemberUsage(m) +
+        RedisObject::bucketUsage(data.dict.bucket_count()) -
+        RedisObject::bucketUsage(buckets)));
+    return true;
+}
+
+bool ZSetType::remove(RedisObject& zset, std::string_view member) {
+    if (zset.encoding == Encoding::LISTPACK) {
+        Listpack& lp = zset.asListpack();
+        size_t pos = lp.find(member, 2);
+        if (pos == lp.end()) return false;
+        lp.erase(pos, 2);
+        return true;
+    }
+    ZSetData& data = zset.asZSet();
+    auto it = data.dict.find(std::string(member));
+    if (it == data.dict.end()) return false;
+    zset.addUsage(-static_cast<int64_t>(RedisObject::zsetMemberUsage(it->first)));
+    data.skiplist.remove(it->first, it->second);
+    data.dict.erase(it);
+    return true;
+}
+
+std::optional<size_t> ZSetType::rank(const RedisObject& zset,
+                                     std::string_view member) {
+    std::optional<size_t> found;
+    size_t rank = 0;
+    if (zset.encoding == Encoding::LISTPACK) {
+        forEachPair(zset.asListpack(),
+                    [&](size_t, std::string_view m, double) {
+            if (m == member) {
+                found = rank;
+                return true;
+            }
+            ++rank;
+            return false;
+        });
+        return found;
+    }
+
+    const ZSetData& data = zset.asZSet();
+    auto it = data.dict.find(std::string(member));
+    if (it == data.dict.end()) return std::nullopt;
+    return data.skiplist.rank(it->first, it->second);
+}
+
+std::vector<std::pair<std::string, double>> ZSetType::rangeByRank(
+    const RedisObject& zset, int start, int stop) {
+    if (zset.encoding != Encoding::LISTPACK) {
+        return zset.asZSet().skiplist.rangeByRank(start, stop);
+    }
+
+    std::vector<std::pair<std::string, double>> result;
+    if (!clampRange(zset, start, stop)) return result;
+    result.reserve(static_cast<size_t>(stop - start + 1));
+    int rank = 0;
+    forEachPair(zset.asListpack(),
+                [&](size_t, std::string_view member, double score) {
+        if (rank >= start) result.emplace_back(std::string(member), score);
+        return ++rank > stop;
+    });
+    return result;
+}
+
+std::vector<std::pair<std::string, double>> ZSetType::revRangeByRank(
+    const RedisObject& zset, int start, int stop) {
+    if (zset.encoding != Encoding::LISTPACK) {
+        return zset.asZSet().skiplist.revRangeByRank(start, stop);
+    }
+
+    // A listpack has no backward order worth walking: take the same
+    // members in forward rank order and reverse them.
+    if (!clampRange(zset, start, stop)) return {};
+    int last = static_cast<int>(size(zset)) - 1;
+    auto result = rangeByRank(zset, last - stop, last - start);
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+// ── Score and lex ranges ───────────────────────────────────────────────────
+// A listpack is small and already in order: scan it.
+
+static double rangeKey(const ScoreRange&, std::string_view, double score) {
+    return score;
+}
+
+static std::string_view rangeKey(const LexRange&, std::string_view member,
+                                 double) {
+    return member;
+}
+
+template <typename Range>
+static std::vector<std::pair<std::string, double>> listpackRange(
+    const Listpack& lp, const Range& range, size_t offset, size_t count) {
+    std::vector<std::pair<std::string, double>> result;
+    forEachPair(lp, [&](size_t, std::string_view member, double score) {
+        auto key = rangeKey(range, member, score);
+        if (!range.aboveMin(key)) return false;
+        if (!range.belowMax(key) || count == 0) return true;
+        if (offset > 0) {
+            --offset;
+        } else {
+            result.emplace_back(std::string(member), score);
+            --count;
+        }
+        return false;
+    });
+    return result;
+}
+
+std::vector<std::pair<std::string, double>> ZSetType::rangeByScore(
+    const RedisObject& zset, const ScoreRange& range, size_t offset,
+    size_t count) {
+    if (zset.encoding != Encoding::LISTPACK) {
+        return zset.asZSet().skiplist.rangeByScore(range, offset, count);
+    }
+    return listpackRange(zset.asListpack(), range, offset, count);
+}
+
+std::vector<std::pair<std::string, double>> ZSetType::rangeByLex(
+    const RedisObject& zset, const LexRange& range, size_t offset,
+    size_t count) {
+    if (range.empty) return {};
+    if (zset.encoding != Encoding::LISTPACK) {
+        return zset.asZSet().skiplist.rangeByLex(range, offset, count);
+    }
+    return listpackRange(zset.asListpack(), range, offset, count);
+}
+
+size_t ZSetType::count(const RedisObject& zset, const ScoreRange& range) {
+    if (zset.encoding != Encoding::LISTPACK) {
+        return zset.asZSet().skiplist.countInRange(range);
+    }
+    size_t n = 0;
+    forEachPair(zset.asListpack(), [&](size_t, std::string_view, double s) {
+        if (range.contains(s)) ++n;
+        return !range.belowMax(s);
+    });
+    return n;
+}
+
+size_t ZSetType::removeRangeByScore(RedisObject& zset,
+                                    const ScoreRange& range) {
+    if (zset.encoding == Encoding::LISTPACK) {
+        // The pairs in range are consecutive: erase them in one go.
+        Listpack& lp = zset.asListpack();
+        size_t first = lp.end();
+        size_t n = 0;
+        forEachPair(lp, [&](size_t pos, std::string_view, double score) {
+            if (!range.aboveMin(score)) return false;
+            if (!range.belowMax(score)) return true;
+            if (n++ == 0) first = pos;
+            return false;
+        });
+        if (n > 0) lp.erase(first, n * 2);
+        return n;
+    }
+
+    ZSetData& data = zset.asZSet();
+    std::vector<std::string> removed;
+    data.skiplist.removeRangeByScore(range, removed);
+    for (const std::string& member : removed) {
+        zset.addUsage(-static_cast<int64_t>(RedisObject::zsetMemberUsage(member)));
+        data.dict.erase(member);
+    }
+    return removed.size();
+}
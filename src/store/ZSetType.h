@@ -0,0 +1,70 @@
+#pragma once
+
+#include "store/Listpack.h"
+#include "store/RedisObject.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// Operations on a ZSET object, whichever its encoding:
+///
+///   LISTPACK   member, score, member, score, ... ordered by
+///              (score, member); each score is the 8 bytes of a double
+///   SKIPLIST   ZSetData (Skiplist + member → score dict)
+///
+/// A sorted set starts as a listpack and converts to a skiplist once it
+/// outgrows `limits`. Mutators keep the object's memoryUsage() current;
+/// the caller reconciles Database::usedMemory() (Database::valueChanged).
+///
+/// Must NOT know about: commands, RESP, the keyspace.
+namespace ZSetType {
+
+/// Number of members.
+size_t size(const RedisObject& zset);
+
+/// The score of `member`, if present.
+std::optional<double> score(const RedisObject& zset, std::string_view member);
+
+/// Add `member` with `score`, or move it to `score` if present.
+/// Returns true if the member is new.
+bool add(RedisObject& zset, std::string_view member, double score,
+         const ListpackLimits& limits);
+
+/// Remove `member`. Returns true if it was there.
+bool remove(RedisObject& zset, std::string_view member);
+
+/// 0-based position of `member` in (score, member) order.
+std::optional<size_t> rank(const RedisObject& zset, std::string_view member);
+
+/// Members between ranks start and stop (inclusive), with their scores.
+/// Negative ranks count from the end (-1 = last).
+std::vector<std::pair<std::string, double>> rangeByRank(
+    const RedisObject& zset, int start, int stop);
+
+/// As rangeByRank(), with ranks counted from the highest score down.
+std::vector<std::pair<std::string, double>> revRangeByRank(
+    const RedisObject& zset, int start, int stop);
+
+/// Members with a score in `range`, lowest first, with their scores:
+/// skips `offset` of them, then returns at most `count`.
+std::vector<std::pair<std::string, double>> rangeByScore(
+    const RedisObject& zset, const ScoreRange& range, size_t offset,
+    size_t count);
+
+/// As rangeByScore(), for members in `range` (ZRANGEBYLEX — meaningful
+/// when every member has the same score).
+std::vector<std::pair<std::string, double>> rangeByLex(
+    const RedisObject& zset, const LexRange& range, size_t offset,
+    size_t count);
+
+/// Number of members with a score in `range`.
+size_t count(const RedisObject& zset, const ScoreRange& range);
+
+/// Remove every member with a score in `range`. Returns how many.
+size_t removeRangeByScore(RedisObject& zset, const ScoreRange& range);
+
+}  // namespace ZSetType
@@ -0,0 +1,149 @@
+/// Microbenchmark for AOF group commit.
+///
+/// Logs N SET commands (default 200K; pass a count to override, e.g.
+/// `bench_aof 50000`) to a scratch file under /tmp and reports SETs per
+/// second for each fsync policy:
+///   - "per-cmd":  the previous AOFWriter::log() — format, write() and,
+///                 under always, fsync() once per command
+///   - "group/B":  log() into the buffer, then one flush() — one write()
+///                 and at most one fsync() — per batch of B commands, B
+///                 standing in for the write commands one event loop
+///                 iteration runs (1 = a lone client, 256 = deep pipelines
+///                 or many clients)
+/// everysec fsyncs once per elapsed second in both cases, as the fsync
+/// timer does. always runs N/100 commands: every batch waits for the disk.
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "persistence/AOFWriter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+using Policy = AOFWriter::FsyncPolicy;
+
+// ── Previous implementation (baseline) ─────────────────────────────────────
+
+/// The old log(): one formatted string, one write() (and fsync) a command.
+static void perCommandLog(int fd, Policy policy,
+                          const std::vector<std::string_view>& args) {
+    std::string resp;
+    resp.reserve(64);
+    resp += '*';
+    resp += std::to_string(args.size());
+    resp += "\r\n";
+    for (const auto& arg : args) {
+        resp += '$';
+        resp += std::to_string(arg.size());
+        resp += "\r\n";
+        resp += arg;
+        resp += "\r\n";
+    }
+    const char* p = resp.data();
+    size_t left = resp.size();
+    while (left > 0) {
+        ssize_t n = ::write(fd, p, left);
+        if (n <= 0) return;
+        p += n;
+        left -= static_cast<size_t>(n);
+    }
+    if (policy == Policy::ALWAYS) ::fsync(fd);
+}
+
+// ── Workload ───────────────────────────────────────────────────────────────
+
+static std::string scratchFile() {
+    return "/tmp/bench_aof." + std::to_string(::getpid()) + ".aof";
+}
+
+/// Commands are SET key:<i> <16-byte value>.
+struct Command {
+    std::string key;
+    std::vector<std::string_view> args;
+};
+
+static std::vector<Command> makeCommands(size_t n) {
+    static const std::string kValue(16, 'v');
+    std::vector<Command> cmds(n);
+    for (size_t i = 0; i < n; ++i) {
+        cmds[i].key = "key:" + std::to_string(i);
+    }
+    for (auto& c : cmds) c.args = {"SET", c.key, kValue};
+    return cmds;
+}
+
+static double runPerCommand(const std::vector<Command>& cmds, Policy policy) {
+    std::string path = scratchFile();
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (fd < 0) return 0;
+    auto start = std::chrono::steady_clock::now();
+    auto lastSync = start;
+    for (const auto& c : cmds) {
+        perCommandLog(fd, policy, c.args);
+        if (policy == Policy::EVERYSEC && secondsSince(lastSync) >= 1.0) {
+            ::fsync(fd);
+            lastSync = std::chrono::steady_clock::now();
+        }
+    }
+    double secs = secondsSince(start);
+    ::close(fd);
+    ::unlink(path.c_str());
+    return static_cast<double>(cmds.size()) / secs;
+}
+
+static double runGroup(const std::vector<Command>& cmds, Policy policy,
+                       size_t batch) {
+    std::string path = scratchFile();
+    ::unlink(path.c_str());
+    double secs;
+    {
+        AOFWriter aof(path, policy);
+        if (!aof.isEnabled()) return 0;
+        auto start = std::chrono::steady_clock::now();
+        auto lastSync = start;
+        for (size_t i = 0; i < cmds.size(); ++i) {
+            aof.log(cmds[i].args);
+            if ((i + 1) % batch == 0 || i + 1 == cmds.size()) aof.flush();
+            if (policy == Policy::EVERYSEC && secondsSince(lastSync) >= 1.0) {
+                aof.tick();
+                lastSync = std::chrono::steady_clock::now();
+            }
+        }
+        secs = secondsSince(start);
+    }
+    ::unlink(path.c_str());
+    return static_cast<double>(cmds.size()) / secs;
+}
+
+static void run(const char* name, Policy policy, size_t n) {
+    std::vector<Command> cmds = makeCommands(n);
+    std::printf("%-11s %9zu %12.0f", name, n, runPerCommand(cmds, policy));
+    for (size_t batch : {1, 16, 64, 256}) {
+        std::printf(" %12.0f", runGroup(cmds, policy, batch));
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char** argv) {
+    size_t n = 200000;
+    if (argc > 1) n = std::strtoull(argv[1], nullptr, 10);
+
+    std::printf("=== AOF group commit benchmark (SETs per second) ===\n");
+    std::printf("%-11s %9s %12s %12s %12s %12s %12s\n", "appendfsync", "cmds",
+                "per-cmd", "group/1", "group/16", "group/64", "group/256");
+    run("no", Policy::NO, n);
+    run("everysec", Policy::EVERYSEC, n);
+    run("always", Policy::ALWAYS, n / 100 > 0 ? n / 100 : 1);
+    return 0;
+}
@@ -0,0 +1,252 @@
+/// Microbenchmark for the index of keys with a TTL.
+///
+/// Gives N keys (default 1M; pass counts to override, e.g.
+/// `bench_expiry 100000`) random deadlines over the next hour, then times,
+/// per key:
+///   - insert:  indexing each key's deadline
+///   - update:  moving random keys to new deadlines (EXPIRE on a key that
+///              already has one)
+///   - remove:  dropping half the keys (DEL / PERSIST)
+///   - pop:     active expiry of the rest, 100 ms of clock at a time
+/// for two indexes:
+///   - "heap":  the previous TTLHeap — a binary min-heap of (key, deadline)
+///              plus an unordered_map from key to heap position, O(log n)
+///   - "wheel": ExpiryWheel — a hierarchical timing wheel threaded through
+///              the HTEntry expiry slots, O(1)
+/// Also prints the index's bytes per key: the heap's entries, map nodes and
+/// buckets (key copies past the SSO buffer excluded), against the 16 bytes
+/// of links each entry carries for the wheel.
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "store/ExpiryWheel.h"
+#include "store/HashTable.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// ── Previous implementation (baseline) ─────────────────────────────────────
+
+class TTLHeap {
+public:
+    void push(const std::string& key, int64_t expireAtMs) {
+        if (keyToIndex_.count(key)) {
+            update(key, expireAtMs);
+            return;
+        }
+        heap_.push_back({key, expireAtMs});
+        keyToIndex_[key] = heap_.size() - 1;
+        siftUp(heap_.size() - 1);
+    }
+
+    void remove(const std::string& key) {
+        auto it = keyToIndex_.find(key);
+        if (it == keyToIndex_.end()) return;
+        size_t idx = it->second;
+        if (idx != heap_.size() - 1) swapEntries(idx, heap_.size() - 1);
+        keyToIndex_.erase(heap_.back().key);
+        heap_.pop_back();
+        if (idx < heap_.size()) {
+            siftDown(idx);
+            siftUp(idx);
+        }
+    }
+
+    void update(const std::string& key, int64_t expireAtMs) {
+        size_t idx = keyToIndex_.at(key);
+        heap_[idx].expireAtMs = expireAtMs;
+        siftUp(idx);
+        siftDown(idx);
+    }
+
+    std::vector<std::string> popExpired(int64_t nowMs, int maxWork) {
+        std::vector<std::string> expired;
+        while (!heap_.empty() && static_cast<int>(expired.size()) < maxWork &&
+               heap_[0].expireAtMs <= nowMs) {
+            std::string key = heap_[0].key;
+            remove(key);
+            expired.push_back(std::move(key));
+        }
+        return expired;
+    }
+
+    size_t indexBytes() const {
+        // libstdc++ node: next pointer, the pair, the cached hash.
+        size_t node = sizeof(void*) + sizeof(std::pair<const std::string, size_t>) +
+                      sizeof(size_t);
+        return heap_.capacity() * sizeof(HeapEntry) +
+               keyToIndex_.size() * node +
+               keyToIndex_.bucket_count() * sizeof(void*);
+    }
+
+private:
+    struct HeapEntry {
+        std::string key;
+        int64_t expireAtMs;
+    };
+
+    std::vector<HeapEntry> heap_;
+    std::unordered_map<std::string, size_t> keyToIndex_;
+
+    void siftUp(size_t idx) {
+        while (idx > 0) {
+            size_t parent = (idx - 1) / 2;
+            if (heap_[idx].expireAtMs >= heap_[parent].expireAtMs) break;
+            swapEntries(idx, parent);
+            idx = parent;
+        }
+    }
+
+    void siftDown(size_t idx) {
+        while (true) {
+            size_t left = 2 * idx + 1, right = left + 1, smallest = idx;
+            if (left < heap_.size() &&
+                heap_[left].expireAtMs < heap_[smallest].expireAtMs) {
+                smallest = left;
+            }
+            if (right < heap_.size() &&
+                heap_[right].expireAtMs < heap_[smallest].expireAtMs) {
+                smallest = right;
+            }
+            if (smallest == idx) break;
+            swapEntries(idx, smallest);
+            idx = smallest;
+        }
+    }
+
+    void swapEntries(size_t a, size_t b) {
+        std::swap(heap_[a], heap_[b]);
+        keyToIndex_[heap_[a].key] = a;
+        keyToIndex_[heap_[b].key] = b;
+    }
+};
+
+// ── Workload ───────────────────────────────────────────────────────────────
+
+struct Timings {
+    double insertNs, updateNs, removeNs, popNs, bytesPerKey;
+};
+
+static const int64_t kStart = 1790000000000;
+static const int64_t kHourMs = 3600 * 1000;
+static const int64_t kTickMs = 100;
+
+static Timings runHeap(const std::vector<std::string>& keys,
+                       const std::vector<int64_t>& deadlines,
+                       const std::vector<size_t>& picks) {
+    size_t n = keys.size();
+    Timings t{};
+    TTLHeap heap;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) heap.push(keys[i], deadlines[i]);
+    t.insertNs = secondsSince(start) * 1e9 / static_cast<double>(n);
+    t.bytesPerKey = static_cast<double>(heap.indexBytes()) / static_cast<double>(n);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < picks.size(); ++i) {
+        heap.update(keys[picks[i]], deadlines[picks[(i + 1) % picks.size()]]);
+    }
+    t.updateNs = secondsSince(start) * 1e9 / static_cast<double>(picks.size());
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i += 2) heap.remove(keys[i]);
+    t.removeNs = secondsSince(start) * 1e9 / static_cast<double>(n / 2);
+
+    size_t popped = 0;
+    start = std::chrono::steady_clock::now();
+    for (int64_t now = kStart; now <= kStart + kHourMs; now += kTickMs) {
+        popped += heap.popExpired(now, INT_MAX).size();
+    }
+    t.popNs = secondsSince(start) * 1e9 / static_cast<double>(popped);
+    if (popped != n - (n + 1) / 2) std::printf("heap pop mismatch!\n");
+    return t;
+}
+
+static Timings runWheel(const std::vector<std::string>& keys,
+                        const std::vector<int64_t>& deadlines,
+                        const std::vector<size_t>& picks) {
+    size_t n = keys.size();
+    Timings t{};
+    HashTable table;
+    std::vector<HTEntry*> entries(n);
+    for (size_t i = 0; i < n; ++i) {
+        HTEntry* entry = table.set(keys[i], RedisObject::createString("v"));
+        entries[i] = table.setExpire(entry, deadlines[i]);
+    }
+
+    ExpiryWheel wheel;
+    auto start = std::chrono::steady_clock::now();
+    for (HTEntry* entry : entries) wheel.insert(entry);
+    t.insertNs = secondsSince(start) * 1e9 / static_cast<double>(n);
+    t.bytesPerKey = (static_cast<double>(sizeof(ExpiryWheel)) +
+                     static_cast<double>(n * sizeof(HTEntry::ExpiryLinks))) /
+                    static_cast<double>(n);
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < picks.size(); ++i) {
+        HTEntry* entry = table.setExpire(
+            entries[picks[i]], deadlines[picks[(i + 1) % picks.size()]]);
+        wheel.update(entry);
+    }
+    t.updateNs = secondsSince(start) * 1e9 / static_cast<double>(picks.size());
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i += 2) wheel.remove(entries[i]);
+    t.removeNs = secondsSince(start) * 1e9 / static_cast<double>(n / 2);
+
+    std::vector<HTEntry*> out;
+    size_t popped = 0;
+    start = std::chrono::steady_clock::now();
+    for (int64_t now = kStart; now <= kStart + kHourMs; now += kTickMs) {
+        out.clear();
+        popped += wheel.popExpired(now, SIZE_MAX, out);
+    }
+    t.popNs = secondsSince(start) * 1e9 / static_cast<double>(popped);
+    if (popped != n - (n + 1) / 2) std::printf("wheel pop mismatch!\n");
+    return t;
+}
+
+static void print(const char* name, size_t n, const Timings& t) {
+    std::printf("%-6s %10zu %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, n,
+                t.insertNs, t.updateNs, t.removeNs, t.popNs, t.bytesPerKey);
+}
+
+static void run(size_t n) {
+    std::mt19937_64 rng(42);
+    std::vector<std::string> keys(n);
+    std::vector<int64_t> deadlines(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = "key:" + std::to_string(i);
+        deadlines[i] = kStart + 1 + static_cast<int64_t>(rng() % kHourMs);
+    }
+    std::vector<size_t> picks(n);
+    for (auto& p : picks) p = rng() % n;
+
+    print("heap", n, runHeap(keys, deadlines, picks));
+    print("wheel", n, runWheel(keys, deadlines, picks));
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) sizes = {1000000};
+
+    std::printf("=== TTL index benchmark (ns per key) ===\n");
+    std::printf("%-6s %10s %10s %10s %10s %10s %10s\n", "index", "keys",
+                "insert", "update", "remove", "pop", "bytes/key");
+    for (size_t n : sizes) run(n);
+    return 0;
+}
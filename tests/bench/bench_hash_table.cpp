@@ -0,0 +1,168 @@
+/// Microbenchmark for HashTable lookups.
+///
+/// Loads N keys (default 400K, about 2 GB with today's entries; pass a
+/// count to override, e.g. 50000000 on a machine with the memory for it),
+/// then times GET-style lookups of random existing keys and of absent keys
+/// for two layouts:
+///   - "chained": the previous table — one bucket pointer per slot, a
+///                `next` pointer per entry, load factor up to 2, and a
+///                full hash + string compare per node walked
+///   - "swiss":   HashTable — 16-slot groups of control bytes with 7-bit
+///                tags matched by one SSE2 compare, load factor <= 7/8
+/// Also prints the index overhead per key: everything the table allocates
+/// besides the key/value payload.
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "store/HashTable.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// ── Previous implementation (baseline) ─────────────────────────────────────
+// Lookup and insert paths only; it grows by rehashing all at once, which
+// does not change the steady-state lookups measured here.
+
+struct ChainedEntry {
+    std::string key;
+    RedisObject value;
+    uint64_t hashCode;
+    int64_t expireAt = -1;
+    ChainedEntry* next = nullptr;
+};
+
+class ChainedTable {
+public:
+    ~ChainedTable() {
+        for (size_t i = 0; i < capacity_; ++i) {
+            for (ChainedEntry* e = slots_[i]; e != nullptr;) {
+                ChainedEntry* next = e->next;
+                delete e;
+                e = next;
+            }
+        }
+        delete[] slots_;
+    }
+
+    ChainedEntry* find(std::string_view key) const {
+        uint64_t h = HashTable::hash(key);
+        for (ChainedEntry* e = slots_[h & (capacity_ - 1)]; e; e = e->next) {
+            if (e->hashCode == h && e->key == key) return e;
+        }
+        return nullptr;
+    }
+
+    void set(std::string_view key, RedisObject value) {
+        auto* e = new ChainedEntry();
+        e->key = key;
+        e->value = std::move(value);
+        e->hashCode = HashTable::hash(key);
+        link(e);
+        if (++size_ > capacity_ * 2) grow();
+    }
+
+    size_t indexBytes() const {
+        return capacity_ * sizeof(ChainedEntry*) + size_ * sizeof(ChainedEntry*);
+    }
+
+private:
+    void link(ChainedEntry* e) {
+        size_t idx = e->hashCode & (capacity_ - 1);
+        e->next = slots_[idx];
+        slots_[idx] = e;
+    }
+
+    void grow() {
+        ChainedEntry** old = slots_;
+        size_t oldCapacity = capacity_;
+        capacity_ *= 2;
+        slots_ = new ChainedEntry*[capacity_]();
+        for (size_t i = 0; i < oldCapacity; ++i) {
+            for (ChainedEntry* e = old[i]; e != nullptr;) {
+                ChainedEntry* next = e->next;
+                link(e);
+                e = next;
+            }
+        }
+        delete[] old;
+    }
+
+    size_t capacity_ = 4;
+    size_t size_ = 0;
+    ChainedEntry** slots_ = new ChainedEntry*[4]();
+};
+
+// ── Workload ───────────────────────────────────────────────────────────────
+
+static std::string keyName(size_t i) { return "key:" + std::to_string(i); }
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/// Time `probes.size()` lookups, in ns per lookup. `found` keeps the
+/// loop from being optimized away and is checked by the caller.
+template <typename Table>
+static double timeLookups(Table& table, const std::vector<std::string>& probes,
+                          size_t& found) {
+    found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& key : probes) {
+        if (table.find(key) != nullptr) ++found;
+    }
+    return secondsSince(start) * 1e9 / static_cast<double>(probes.size());
+}
+
+template <typename Table>
+static void run(const char* name, size_t n,
+                const std::vector<std::string>& hits,
+                const std::vector<std::string>& misses,
+                size_t (*indexBytes)(const Table&)) {
+    Table table;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        table.set(keyName(i), RedisObject::createString("v"));
+    }
+    double loadNs = secondsSince(start) * 1e9 / static_cast<double>(n);
+
+    size_t found = 0;
+    double hitNs = timeLookups(table, hits, found);
+    if (found != hits.size()) std::printf("%s: missing keys!\n", name);
+    double missNs = timeLookups(table, misses, found);
+    if (found != 0) std::printf("%s: phantom keys!\n", name);
+
+    std::printf("%-8s %10.1f %10.1f %10.1f %12.1f\n", name, loadNs, hitNs,
+                missNs,
+                static_cast<double>(indexBytes(table)) / static_cast<double>(n));
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400000;
+    const size_t probes = std::min<size_t>(n, 2000000);
+
+    std::printf("=== HashTable lookup benchmark ===\n");
+    std::printf("%zu keys, %zu random lookups per column\n", n, probes);
+
+    std::mt19937_64 rng(42);
+    std::vector<std::string> hits, misses;
+    hits.reserve(probes);
+    misses.reserve(probes);
+    for (size_t i = 0; i < probes; ++i) {
+        hits.push_back(keyName(rng() % n));
+        misses.push_back("miss:" + std::to_string(rng()));
+    }
+
+    std::printf("%-8s %10s %10s %10s %12s\n", "table", "insert ns",
+                "hit ns", "miss ns", "index B/key");
+    run<ChainedTable>("chained", n, hits, misses,
+                      [](const ChainedTable& t) { return t.indexBytes(); });
+    run<HashTable>("swiss", n, hits, misses,
+                   [](const HashTable& t) { return t.slotMemory(); });
+    return 0;
+}
@@ -0,0 +1,122 @@
+/// Microbenchmark for RespParser over a pipelined command stream.
+///
+/// Parses the same stream once per CRLF scanning kernel the CPU supports
+/// and prints bytes/sec and commands/sec for each, so the scalar row is
+/// the "before" and the vector rows the "after".
+///
+/// Usage:
+///   bench_resp_parser              synthetic GET-heavy pipelines, as RESP
+///                                  arrays and as inline commands
+///   bench_resp_parser <capture>    raw client->server bytes, e.g. a TCP
+///                                  stream saved with tcpflow
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "net/Buffer.h"
+#include "proto/CrlfScanner.h"
+#include "proto/RespParser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Roughly what `redis-benchmark -P 16 -t get,set` sends: 90% GET,
+/// 10% SET with a 64-byte value, keys like "key:000001234". `inlineCmds`
+/// writes them as inline commands (one line each) instead of RESP arrays.
+static std::string syntheticStream(size_t commands, bool inlineCmds) {
+    std::string out;
+    char key[32];
+    const std::string value(64, 'v');
+    for (size_t i = 0; i < commands; ++i) {
+        int n = std::snprintf(key, sizeof(key), "key:%09zu", (i * 7919) % 1000000);
+        std::string k(key, static_cast<size_t>(n));
+        if (inlineCmds) {
+            out += (i % 10 == 9) ? "SET " + k + " " + value + "\r\n"
+                                 : "GET " + k + "\r\n";
+        } else if (i % 10 == 9) {
+            out += "*3\r\n$3\r\nSET\r\n$" + std::to_string(k.size()) + "\r\n" +
+                   k + "\r\n$" + std::to_string(value.size()) + "\r\n" +
+                   value + "\r\n";
+        } else {
+            out += "*2\r\n$3\r\nGET\r\n$" + std::to_string(k.size()) + "\r\n" +
+                   k + "\r\n";
+        }
+    }
+    return out;
+}
+
+/// Parse every command in `stream` `passes` times. Returns the time spent
+/// parsing (not refilling the buffer) and the number of commands seen.
+static double parseAll(const std::string& stream, int passes,
+                       size_t& commands) {
+    RespParser parser;
+    ParseState state;
+    std::vector<std::string_view> args;
+    Buffer buf;
+    double seconds = 0;
+    commands = 0;
+    for (int p = 0; p < passes; ++p) {
+        buf.append(stream.data(), stream.size());
+        auto start = std::chrono::steady_clock::now();
+        while (parser.parse(buf, state, args)) {
+            ++commands;
+        }
+        seconds += std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+        buf.consume(buf.readableBytes());  // drop a trailing partial frame
+        state.reset();
+    }
+    return seconds;
+}
+
+/// Benchmark `stream` with every supported kernel and print one row each.
+static void benchStream(const char* title, const std::string& stream) {
+    std::printf("\n%s: %zu bytes per pass\n", title, stream.size());
+    std::printf("%-8s %12s %14s %9s\n", "kernel", "MB/s", "commands/s",
+                "speedup");
+
+    const CrlfScanner::Kernel kernels[] = {
+        CrlfScanner::Kernel::SCALAR,
+        CrlfScanner::Kernel::SSE2,
+        CrlfScanner::Kernel::AVX2,
+    };
+    const CrlfScanner::Kernel startup = CrlfScanner::kernel();
+    const int passes = 50;
+    double scalarRate = 0;
+
+    for (CrlfScanner::Kernel k : kernels) {
+        if (!CrlfScanner::useKernel(k)) continue;
+        size_t commands = 0;
+        parseAll(stream, 2, commands);  // warm up caches and the allocator
+        double seconds = parseAll(stream, passes, commands);
+
+        double bytesPerSec = static_cast<double>(stream.size()) * passes / seconds;
+        if (k == CrlfScanner::Kernel::SCALAR) scalarRate = bytesPerSec;
+        std::printf("%-8s %12.1f %14.0f %8.2fx\n", CrlfScanner::kernelName(k),
+                    bytesPerSec / 1e6, static_cast<double>(commands) / seconds,
+                    bytesPerSec / scalarRate);
+    }
+    CrlfScanner::useKernel(startup);
+}
+
+int main(int argc, char** argv) {
+    std::printf("=== RespParser benchmark ===\n");
+    if (argc > 1) {
+        std::ifstream in(argv[1], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "cannot open %s\n", argv[1]);
+            return 1;
+        }
+        std::string stream((std::istreambuf_iterator<char>(in)),
+                           std::istreambuf_iterator<char>());
+        benchStream(argv[1], stream);
+        return 0;
+    }
+    benchStream("RESP arrays", syntheticStream(200000, false));
+    benchStream("Inline commands", syntheticStream(200000, true));
+    return 0;
+}
@@ -0,0 +1,123 @@
+/// Microbenchmark for RespSerializer.
+///
+/// Serializes a reply mix typical of a cache workload and prints
+/// replies/sec and MB/s for two implementations writing into the same
+/// ReplyChain:
+///   - "to_string": the previous serializer, which built every number
+///     line with std::to_string and wrote each piece with its own append
+///   - "shared":    RespSerializer — pre-encoded fragments, std::to_chars
+///                  and one reservation per short bulk string
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "net/ReplyChain.h"
+#include "proto/RespSerializer.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// ── Previous implementation (baseline) ─────────────────────────────────────
+
+struct ToStringSerializer {
+    static void writeOk(ReplyChain& buf) {
+        buf.append("+", 1);
+        buf.append("OK", 2);
+        buf.append("\r\n", 2);
+    }
+    static void writeInteger(ReplyChain& buf, int64_t val) {
+        std::string s = ":" + std::to_string(val) + "\r\n";
+        buf.append(s.data(), s.size());
+    }
+    static void writeBulkString(ReplyChain& buf, std::string_view s) {
+        std::string header = "$" + std::to_string(s.size()) + "\r\n";
+        buf.append(header.data(), header.size());
+        buf.append(s.data(), s.size());
+        buf.append("\r\n", 2);
+    }
+    static void writeNull(ReplyChain& buf) {
+        buf.append("$-1\r\n", 5);
+    }
+    static void writeArrayHeader(ReplyChain& buf, int64_t count) {
+        std::string s = "*" + std::to_string(count) + "\r\n";
+        buf.append(s.data(), s.size());
+    }
+};
+
+struct SharedSerializer {
+    static void writeOk(ReplyChain& buf) { RespSerializer::writeOk(buf); }
+    static void writeInteger(ReplyChain& buf, int64_t val) {
+        RespSerializer::writeInteger(buf, val);
+    }
+    static void writeBulkString(ReplyChain& buf, std::string_view s) {
+        RespSerializer::writeBulkString(buf, s);
+    }
+    static void writeNull(ReplyChain& buf) { RespSerializer::writeNull(buf); }
+    static void writeArrayHeader(ReplyChain& buf, int64_t count) {
+        RespSerializer::writeArrayHeader(buf, count);
+    }
+};
+
+// ── Workload ───────────────────────────────────────────────────────────────
+
+/// Per 100 replies: 60 GET hits (64-byte value), 10 GET misses, 10 SET
+/// (+OK), 10 INCR/LPUSH/EXISTS-style integers (mostly small), and 10
+/// 10-element LRANGE/HGETALL-style arrays of 16-byte values. Replies are
+/// drained every 16 KB, like a socket write would.
+template <typename S>
+static double run(size_t replies, size_t& bytes) {
+    ReplyChain chain;
+    const std::string value(64, 'v');
+    const std::string field(16, 'f');
+    bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < replies; ++i) {
+        size_t kind = i % 100;
+        if (kind < 60) {
+            S::writeBulkString(chain, value);
+        } else if (kind < 70) {
+            S::writeNull(chain);
+        } else if (kind < 80) {
+            S::writeOk(chain);
+        } else if (kind < 90) {
+            // Counters: mostly small, every tenth past the shared range.
+            S::writeInteger(chain, (kind == 89) ? 1000000 + i : i % 5000);
+        } else {
+            S::writeArrayHeader(chain, 10);
+            for (int e = 0; e < 10; ++e) S::writeBulkString(chain, field);
+        }
+        if (chain.readableBytes() >= ReplyChain::kBlockSize) {
+            bytes += chain.readableBytes();
+            chain.consume(chain.readableBytes());
+        }
+    }
+    bytes += chain.readableBytes();
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename S>
+static void report(const char* name, size_t replies, double baseline,
+                   double& rate) {
+    size_t bytes = 0;
+    run<S>(replies / 10, bytes);  // warm up
+    double seconds = run<S>(replies, bytes);
+    rate = static_cast<double>(replies) / seconds;
+    std::printf("%-10s %14.0f %10.1f %8.2fx\n", name, rate,
+                static_cast<double>(bytes) / seconds / 1e6,
+                baseline > 0 ? rate / baseline : 1.0);
+}
+
+int main() {
+    std::printf("=== RespSerializer benchmark ===\n");
+    const size_t replies = 20000000;
+    std::printf("%zu replies\n", replies);
+    std::printf("%-10s %14s %10s %9s\n", "serializer", "replies/s", "MB/s",
+                "speedup");
+    double baseline = 0, shared = 0;
+    report<ToStringSerializer>("to_string", replies, 0, baseline);
+    report<SharedSerializer>("shared", replies, baseline, shared);
+    return 0;
+}
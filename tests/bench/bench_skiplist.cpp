@@ -0,0 +1,125 @@
+/// Microbenchmark for Skiplist rank queries.
+///
+/// Builds skiplists of N members with random scores (default 1M and 10M,
+/// about 1.5 GB at 10M; pass counts to override, e.g. `bench_skiplist
+/// 100000`), then times:
+///   - insert:  building the list, per member
+///   - rank:    ZRANK of a random member — summing spans down the levels
+///   - range:   ZRANGE of 10 members from 80% of the way in — seek to the
+///              start rank by span, then walk
+/// against the previous way of answering both: counting level-0 steps
+/// from the head ("walk"). The walk is O(n) a query, so it gets far fewer
+/// queries.
+///
+/// Not part of `make test` — run with `make bench`.
+
+#include "store/Skiplist.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// ── Previous implementation (baseline) ─────────────────────────────────────
+
+/// Rank by walking level 0 from the head until the member turns up.
+static size_t walkRank(const Skiplist& sl, const std::string& member,
+                       double score) {
+    size_t rank = 0;
+    for (const Skiplist::Node* x = sl.byRank(0); x;
+         x = x->levels[0].forward, ++rank) {
+        if (x->score == score && x->member == member) return rank;
+    }
+    return rank;
+}
+
+/// The `count` members from `start` on, reached by walking level 0.
+static size_t walkRange(const Skiplist& sl, size_t start, size_t count) {
+    const Skiplist::Node* x = sl.byRank(0);
+    for (size_t i = 0; i < start && x; ++i) x = x->levels[0].forward;
+    size_t got = 0;
+    for (; x && got < count; x = x->levels[0].forward) ++got;
+    return got;
+}
+
+// ── Workload ───────────────────────────────────────────────────────────────
+
+static void run(size_t n) {
+    std::mt19937_64 rng(42);
+    std::vector<std::pair<std::string, double>> members;
+    members.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        members.emplace_back("member:" + std::to_string(i),
+                             static_cast<double>(rng() % (n * 4)));
+    }
+
+    Skiplist sl;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& [member, score] : members) sl.insert(member, score);
+    double insertNs = secondsSince(start) * 1e9 / static_cast<double>(n);
+
+    const size_t spanQueries = 1000000;
+    const size_t walkQueries = 5;
+    std::vector<size_t> picks(spanQueries);
+    for (auto& p : picks) p = rng() % n;
+
+    // `check` keeps the loops from being optimized away.
+    size_t check = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t p : picks) {
+        check += *sl.rank(members[p].first, members[p].second);
+    }
+    double rankNs = secondsSince(start) * 1e9 / spanQueries;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < walkQueries; ++i) {
+        size_t p = picks[i];
+        check -= walkRank(sl, members[p].first, members[p].second);
+    }
+    double walkRankNs = secondsSince(start) * 1e9 / walkQueries;
+    for (size_t i = walkQueries; i < spanQueries; ++i) {
+        check -= *sl.rank(members[picks[i]].first, members[picks[i]].second);
+    }
+    if (check != 0) std::printf("rank mismatch!\n");
+
+    int from = static_cast<int>(n / 10 * 8);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < spanQueries; ++i) {
+        check += sl.rangeByRank(from, from + 9).size();
+    }
+    double rangeNs = secondsSince(start) * 1e9 / spanQueries;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < walkQueries; ++i) {
+        check += walkRange(sl, static_cast<size_t>(from), 10);
+    }
+    double walkRangeNs = secondsSince(start) * 1e9 / walkQueries;
+    if (check != (spanQueries + walkQueries) * 10) {
+        std::printf("range mismatch!\n");
+    }
+
+    std::printf("%10zu %10.1f %10.1f %12.1f %10.1f %12.1f\n", n, insertNs,
+                rankNs, walkRankNs / 1000, rangeNs, walkRangeNs / 1000);
+}
+
+int main(int argc, char** argv) {
+    std::vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+    }
+    if (sizes.empty()) sizes = {1000000, 10000000};
+
+    std::printf("=== Skiplist rank benchmark ===\n");
+    std::printf("%10s %10s %10s %12s %10s %12s\n", "members", "insert ns",
+                "rank ns", "walk rank us", "range ns", "walk rng us");
+    for (size_t n : sizes) run(n);
+    return 0;
+}
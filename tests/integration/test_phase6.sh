@@ -242,6 +242,37 @@ cursor=$(echo "$result" | head -1)
 # Just verify it doesn't error.
 assert_contains "SCAN COUNT returns numeric cursor" "" "$result"
 
+# ── Test 11: SCAN with TYPE ───────────────────────────────────────────────
+echo ""
+echo "--- Test 11: SCAN TYPE filter ---"
+
+redis_cmd RPUSH "scanlist:1" a > /dev/null
+redis_cmd SADD "scanset:1" m > /dev/null
+
+cursor=0
+type_keys=""
+iterations=0
+while true; do
+    result=$(redis_cmd SCAN "$cursor" COUNT 100 TYPE list)
+    cursor=$(echo "$result" | head -1)
+    type_keys="$type_keys $(echo "$result" | tail -n +2)"
+    ((iterations++)) || true
+    if [[ "$cursor" == "0" || "$iterations" -ge 100 ]]; then
+        break
+    fi
+done
+assert_contains "SCAN TYPE list finds the list" "scanlist:1" "$type_keys"
+if [[ "$type_keys" != *"scanset:1"* && "$type_keys" != *"scankey:"* ]]; then
+    echo "  PASS: SCAN TYPE list skips other types"
+    ((PASS++)) || true
+else
+    echo "  FAIL: SCAN TYPE list returned keys of other types"
+    ((FAIL++)) || true
+fi
+
+result=$(redis_cmd SCAN 0 TYPE nosuchtype)
+assert_contains "SCAN TYPE rejects unknown types" "unknown type name" "$result"
+
 # ============================================================================
 echo ""
 echo "============================================"
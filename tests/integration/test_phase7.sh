@@ -224,6 +224,31 @@ info_mem_flush=$(redis_cmd INFO memory)
 mem_flush=$(echo "$info_mem_flush" | grep -oP 'used_memory:\K\d+')
 assert_eq "Memory is 0 after FLUSHDB" "0" "$mem_flush"
 
+# ── Test 11: Collections are accounted, MEMORY USAGE ─────────────────────
+echo ""
+echo "--- Test 11: Collection memory / MEMORY USAGE ---"
+
+redis_cmd HSET memhash f0 v0 > /dev/null
+info_h1=$(redis_cmd INFO memory)
+memh1=$(echo "$info_h1" | grep -oP 'used_memory:\K\d+')
+for i in $(seq 1 50); do
+    redis_cmd HSET memhash "field$i" "$(printf 'y%.0s' $(seq 1 40))" > /dev/null
+done
+info_h2=$(redis_cmd INFO memory)
+memh2=$(echo "$info_h2" | grep -oP 'used_memory:\K\d+')
+assert_gt "Memory grows with HSET into an existing hash" "$memh2" "$memh1"
+
+usage_all=$(redis_cmd MEMORY USAGE memhash SAMPLES 0)
+usage_default=$(redis_cmd MEMORY USAGE memhash)
+assert_gt "MEMORY USAGE counts the fields" "$usage_all" "2000"
+assert_gt "MEMORY USAGE with default samples" "$usage_default" "2000"
+assert_eq "MEMORY USAGE of a missing key" "" "$(redis_cmd MEMORY USAGE nosuchkey)"
+
+redis_cmd DEL memhash > /dev/null
+info_h3=$(redis_cmd INFO memory)
+memh3=$(echo "$info_h3" | grep -oP 'used_memory:\K\d+')
+assert_eq "Memory is 0 after deleting the hash" "0" "$memh3"
+
 # ============================================================================
 echo ""
 echo "=== Phase 7 Results: $PASS passed, $FAIL failed ==="
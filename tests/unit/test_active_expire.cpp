@@ -0,0 +1,130 @@
+/// Unit tests for the adaptive active expiry cycle — time budgets, the
+/// fast cycle's trigger and the INFO counters.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "store/Database.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+static int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(
+               system_clock::now().time_since_epoch())
+        .count();
+}
+
+/// Add `n` keys named prefix0..prefixN-1 expiring at `expireAt`.
+static void fillExpiring(Database& db, const std::string& prefix, int n,
+                         int64_t expireAt) {
+    for (int i = 0; i < n; ++i) {
+        std::string key = prefix + std::to_string(i);
+        db.set(key, "value");
+        db.setExpire(key, expireAt);
+    }
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+static bool test_slow_cycle_reclaims_everything_due() {
+    // Far more than the old fixed 200 keys a tick.
+    Database db;
+    fillExpiring(db, "due", 20000, nowMs() - 1);
+    fillExpiring(db, "later", 100, nowMs() + 3600 * 1000);
+    db.set("plain", "value");
+
+    db.activeExpireCycle(ExpireCycle::SLOW, 100);  // 25 ms budget
+    EXPECT(db.dbsize() == 101);
+    EXPECT(db.expiryCount() == 100);
+    EXPECT(db.expireStats().expiredKeys == 20000);
+    EXPECT(db.expireStats().stalePerc == 0.0);
+    return true;
+}
+
+static bool test_budget_bounds_a_cycle() {
+    // A 1 ms period leaves a 250 us budget: not enough for 300K keys.
+    Database db;
+    fillExpiring(db, "due", 300000, nowMs() - 1);
+    db.activeExpireCycle(ExpireCycle::SLOW, 1);
+    uint64_t first = db.expireStats().expiredKeys;
+    EXPECT(first > 0);
+    EXPECT(first < 300000);
+    EXPECT(db.dbsize() == 300000 - first);
+    EXPECT(db.expireStats().stalePerc > 0.0);  // everything left is stale
+
+    // It fell behind, so fast cycles (at most one per 2 ms) keep going.
+    for (int i = 0; i < 5000 && db.dbsize() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        db.activeExpireCycle(ExpireCycle::FAST, 1);
+    }
+    EXPECT(db.dbsize() == 0);
+    EXPECT(db.expireStats().expiredKeys == 300000);
+    EXPECT(db.usedMemory() == 0);
+    return true;
+}
+
+static bool test_fast_cycle_idle_unless_behind() {
+    Database db;
+    fillExpiring(db, "due", 1000, nowMs() - 1);
+
+    // No slow cycle has fallen behind yet: the fast cycle stays out.
+    db.activeExpireCycle(ExpireCycle::FAST, 100);
+    EXPECT(db.expireStats().expiredKeys == 0);
+    EXPECT(db.dbsize() == 1000);
+
+    db.activeExpireCycle(ExpireCycle::SLOW, 100);
+    EXPECT(db.dbsize() == 0);
+    return true;
+}
+
+static bool test_lazy_expiry_counts() {
+    Database db;
+    fillExpiring(db, "k", 3, nowMs() - 1);
+    EXPECT(!db.exists("k0"));
+    EXPECT(db.ttl("k1") == -2);
+    EXPECT(db.expireStats().expiredKeys == 2);
+    db.activeExpireCycle(ExpireCycle::SLOW, 100);
+    EXPECT(db.expireStats().expiredKeys == 3);
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== Active expiry unit tests ===\n");
+
+    RUN(test_slow_cycle_reclaims_everything_due);
+    RUN(test_budget_bounds_a_cycle);
+    RUN(test_fast_cycle_idle_unless_behind);
+    RUN(test_lazy_expiry_counts);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
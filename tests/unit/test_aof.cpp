@@ -15,6 +15,7 @@
 #include <cstring>
 #include <fcntl.h>
 #include <string>
+#include <string_view>
 #include <unistd.h>
 #include <vector>
 
@@ -46,7 +47,7 @@ static bool roundTrip(const std::vector<std::string>& args,
     {
         AOFWriter writer(tmpPath, AOFWriter::FsyncPolicy::ALWAYS);
         assert(writer.isEnabled());
-        writer.log(args);
+        writer.log(std::vector<std::string_view>(args.begin(), args.end()));
     }  // destructor closes + fsyncs
 
     // Read the file into a Buffer.
@@ -277,6 +278,50 @@ static void test_exact_resp_format() {
     pass(name);
 }
 
+// ── Test: group commit ──────────────────────────────────────────────────
+// Verifies that log() only buffers, returns growing offsets, and that one
+// flush() writes the whole batch and advances flushedThrough().
+static void test_group_commit_flush() {
+    const char* name = "group_commit_flush";
+
+    char tmpPath[] = "/tmp/test_aof_gc_XXXXXX";
+    int tmpFd = ::mkstemp(tmpPath);
+    if (tmpFd < 0) { fail(name, "mkstemp failed"); return; }
+    ::close(tmpFd);
+
+    const std::string one = "*3\r\n$3\r\nSET\r\n$1\r\na\r\n$1\r\n1\r\n";
+    const std::string two = "*2\r\n$3\r\nDEL\r\n$1\r\na\r\n";
+    auto fileSize = [&]() {
+        int fd = ::open(tmpPath, O_RDONLY);
+        off_t size = fd < 0 ? -1 : ::lseek(fd, 0, SEEK_END);
+        if (fd >= 0) ::close(fd);
+        return size;
+    };
+
+    bool ok = true;
+    const char* reason = "";
+    {
+        AOFWriter writer(tmpPath, AOFWriter::FsyncPolicy::ALWAYS);
+        writer.flush();  // nothing buffered: a no-op
+        uint64_t first = writer.log({"SET", "a", "1"});
+        uint64_t second = writer.log({"DEL", "a"});
+        if (first != one.size() || second != one.size() + two.size()) {
+            ok = false; reason = "wrong offsets";
+        } else if (fileSize() != 0 || writer.flushedThrough(first)) {
+            ok = false; reason = "written before flush()";
+        } else {
+            writer.flush();
+            if (fileSize() != static_cast<off_t>(second) ||
+                !writer.flushedThrough(second)) {
+                ok = false; reason = "flush() did not write the batch";
+            }
+        }
+    }
+    ::unlink(tmpPath);
+    if (!ok) { fail(name, reason); return; }
+    pass(name);
+}
+
 int main() {
     std::printf("=== AOF Unit Tests ===\n");
 
@@ -289,6 +334,7 @@ int main() {
     test_expire_roundtrip();
     test_large_value();
     test_exact_resp_format();
+    test_group_commit_flush();
 
     std::printf("\n%d passed, %d failed\n", g_passed, g_failed);
     return g_failed > 0 ? 1 : 0;
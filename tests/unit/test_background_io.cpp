@@ -0,0 +1,136 @@
+/// Unit tests for BackgroundIO — the AOF's background fsync / close thread:
+/// jobs run, pending counts drain, and nothing queued is dropped at
+/// shutdown.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "persistence/BackgroundIO.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// An unlinked scratch file opened for writing, or -1.
+static int scratchFd() {
+    char path[] = "/tmp/test_bio_XXXXXX";
+    int fd = ::mkstemp(path);
+    if (fd >= 0) ::unlink(path);
+    return fd;
+}
+
+static bool isOpen(int fd) {
+    return ::fcntl(fd, F_GETFD) != -1 || errno != EBADF;
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+static bool test_idle() {
+    BackgroundIO bio;
+    bio.waitIdle();  // nothing queued: returns at once
+    EXPECT(bio.pending(BackgroundIO::JobType::FSYNC) == 0);
+    EXPECT(bio.pending(BackgroundIO::JobType::CLOSE) == 0);
+    EXPECT(bio.lastFsyncDurationUs() == 0);
+    return true;
+}
+
+static bool test_fsync_job() {
+    int fd = scratchFd();
+    EXPECT(fd >= 0);
+    EXPECT(::write(fd, "data", 4) == 4);
+
+    BackgroundIO bio;
+    bio.submit(BackgroundIO::JobType::FSYNC, fd);
+    EXPECT(bio.pending(BackgroundIO::JobType::CLOSE) == 0);
+    bio.waitIdle();
+    EXPECT(bio.pending(BackgroundIO::JobType::FSYNC) == 0);
+    EXPECT(isOpen(fd));  // an fsync leaves the fd to its owner
+    ::close(fd);
+    return true;
+}
+
+static bool test_close_job() {
+    int fd = scratchFd();
+    EXPECT(fd >= 0);
+
+    BackgroundIO bio;
+    bio.submit(BackgroundIO::JobType::FSYNC, fd);
+    bio.submit(BackgroundIO::JobType::CLOSE, fd);  // after the fsync
+    bio.waitIdle();
+    EXPECT(bio.pending(BackgroundIO::JobType::FSYNC) == 0);
+    EXPECT(bio.pending(BackgroundIO::JobType::CLOSE) == 0);
+    EXPECT(!isOpen(fd));
+    return true;
+}
+
+static bool test_shutdown_runs_queued_jobs() {
+    std::vector<int> fds;
+    for (int i = 0; i < 64; ++i) {
+        int fd = scratchFd();
+        EXPECT(fd >= 0);
+        fds.push_back(fd);
+    }
+    {
+        BackgroundIO bio;
+        for (int fd : fds) {
+            bio.submit(BackgroundIO::JobType::FSYNC, fd);
+            bio.submit(BackgroundIO::JobType::CLOSE, fd);
+        }
+    }  // no waitIdle(): the destructor drains the queue
+    for (int fd : fds) EXPECT(!isOpen(fd));
+    return true;
+}
+
+static bool test_wait_idle_between_batches() {
+    BackgroundIO bio;
+    for (int round = 0; round < 100; ++round) {
+        int fd = scratchFd();
+        EXPECT(fd >= 0);
+        bio.submit(BackgroundIO::JobType::CLOSE, fd);
+        bio.waitIdle();
+        EXPECT(!isOpen(fd));
+        EXPECT(bio.pending(BackgroundIO::JobType::CLOSE) == 0);
+    }
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== BackgroundIO unit tests ===\n");
+
+    RUN(test_idle);
+    RUN(test_fsync_job);
+    RUN(test_close_job);
+    RUN(test_shutdown_runs_queued_jobs);
+    RUN(test_wait_idle_between_batches);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
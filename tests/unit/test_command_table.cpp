@@ -0,0 +1,250 @@
+/// Unit tests for CommandTable — name resolution, flags and dispatch.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "cmd/CommandTable.h"
+#include "cmd/ServerCommands.h"
+#include "net/Connection.h"
+#include "store/Database.h"
+
+#include <cctype>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// Run `args` through `table` and return the reply bytes.
+static std::string run(const CommandTable& table, const CommandArgs& args) {
+    Database db;
+    Connection conn(-1);
+    table.dispatch(db, conn, args);
+    return conn.outgoing().takeAll();
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+/// Every command resolves to its own ID in any letter case.
+static bool test_resolve_every_command() {
+    for (size_t i = 0; i < kCommandCount; ++i) {
+        CommandId id = static_cast<CommandId>(i);
+        std::string name(CommandTable::spec(id).name);
+        EXPECT(!name.empty());
+        EXPECT(CommandTable::resolve(name) == id);
+
+        std::string lower = name, mixed = name;
+        for (size_t j = 0; j < name.size(); ++j) {
+            lower[j] = static_cast<char>(std::tolower(name[j]));
+            if (j % 2) mixed[j] = lower[j];
+        }
+        EXPECT(CommandTable::resolve(lower) == id);
+        EXPECT(CommandTable::resolve(mixed) == id);
+    }
+    return true;
+}
+
+/// Near misses, non-letters and junk never resolve.
+static bool test_resolve_unknown() {
+    const char* names[] = {
+        "", "G", "GE", "GETT", "SETX", "XGET", "GET ", "G3T", "G\x05T",
+        "get\r", "ZREVRANGEBYSCORE", "BGREWRITEAOFF", "\xc7\xc5\xd4",
+    };
+    for (const char* n : names) {
+        EXPECT(CommandTable::resolve(n) == CommandId::UNKNOWN);
+    }
+    EXPECT(CommandTable::resolve(std::string(100000, 'A')) ==
+           CommandId::UNKNOWN);
+    return true;
+}
+
+/// Flags that gating and AOF logging rely on.
+static bool test_flags() {
+    auto flags = [](CommandId id) { return CommandTable::spec(id).flags; };
+    EXPECT(flags(CommandId::SET) & kCmdWrite);
+    EXPECT(flags(CommandId::FLUSHDB) & kCmdWrite);
+    EXPECT(!(flags(CommandId::GET) & kCmdWrite));
+    EXPECT(flags(CommandId::GET) & kCmdReadonly);
+    EXPECT(!(flags(CommandId::EXEC) & kCmdWrite));
+    EXPECT(!(flags(CommandId::PUBLISH) & kCmdWrite));
+
+    EXPECT(flags(CommandId::SUBSCRIBE) & kCmdPubSub);
+    EXPECT(flags(CommandId::UNSUBSCRIBE) & kCmdPubSub);
+    EXPECT(flags(CommandId::PING) & kCmdPubSub);
+    EXPECT(!(flags(CommandId::GET) & kCmdPubSub));
+
+    EXPECT(flags(CommandId::MULTI) & kCmdNoMulti);
+    EXPECT(flags(CommandId::EXEC) & kCmdNoMulti);
+    EXPECT(flags(CommandId::DISCARD) & kCmdNoMulti);
+    EXPECT(!(flags(CommandId::SET) & kCmdNoMulti));
+
+    EXPECT(flags(CommandId::SET) & kCmdDenyOom);
+    EXPECT(flags(CommandId::ZADD) & kCmdDenyOom);
+    EXPECT(!(flags(CommandId::DEL) & kCmdDenyOom));
+    EXPECT(!(flags(CommandId::GET) & kCmdDenyOom));
+
+    const CommandSpec& unknown = CommandTable::spec(CommandId::UNKNOWN);
+    EXPECT(unknown.flags == 0 && unknown.firstKey == 0);
+    EXPECT(unknown.fanout == Fanout::LOCAL);
+    EXPECT(CommandTable::spec(CommandId::INFO).fanout == Fanout::MERGE_INFO);
+    return true;
+}
+
+/// Dispatch: handlers run, arity and unknown names are reported.
+static bool test_dispatch() {
+    CommandTable table;
+    EXPECT(run(table, {"ping"}) == "+PONG\r\n");
+    EXPECT(run(table, {"Get", "missing"}) == "$-1\r\n");
+    EXPECT(run(table, {"nosuch", "x"}) ==
+           "-ERR unknown command 'nosuch'\r\n");
+    EXPECT(run(table, {"get"}) ==
+           "-ERR wrong number of arguments for 'GET' command\r\n");
+    EXPECT(run(table, {"hset", "h", "f"}) ==
+           "-ERR wrong number of arguments for 'HSET' command\r\n");
+    return true;
+}
+
+/// Commands without a static handler fail cleanly until bound.
+static bool test_bind() {
+    CommandTable table;
+    EXPECT(run(table, {"INFO"}) == "-ERR command 'INFO' is not available\r\n");
+
+    int calls = 0;
+    table.bind(CommandId::INFO,
+        [](void* ctx, Database&, Connection& conn, const CommandArgs&) {
+            ++*static_cast<int*>(ctx);
+            conn.outgoing().append("+bound\r\n", 8);
+        },
+        &calls);
+    EXPECT(run(table, {"info"}) == "+bound\r\n");
+    EXPECT(calls == 1);
+
+    CommandTable other;  // bindings are per table
+    EXPECT(run(other, {"INFO"}) == "-ERR command 'INFO' is not available\r\n");
+    return true;
+}
+
+/// Collection commands keep usedMemory() equal to a full recount, and
+/// MEMORY USAGE reports it.
+static bool test_memory_accounting() {
+    CommandTable table;
+    Database db;
+    Connection conn(-1);
+    auto exec = [&](const CommandArgs& args) {
+        table.dispatch(db, conn, args);
+        return conn.outgoing().takeAll();
+    };
+    // The running total matches a walk of every key.
+    auto recount = [&]() {
+        size_t total = 0;
+        for (const auto& key : db.keys()) {
+            const HTEntry* e = db.table().find(key);
+            total += e->memoryUsage() - e->value.memoryUsage() +
+                     e->value.computeMemoryUsage(0);
+        }
+        return total;
+    };
+
+    std::string longValue(100, 'v');  // past the SSO buffer
+    for (int i = 0; i < 200; ++i) {
+        std::string n = std::to_string(i);
+        exec({"RPUSH", "list", longValue + n});
+        exec({"LPUSH", "list", n});
+        exec({"HSET", "hash", "f" + n, longValue});
+        exec({"SADD", "set", longValue + n});
+        exec({"ZADD", "zset", n, "m" + n});
+    }
+    EXPECT(db.usedMemory() == recount());
+
+    for (int i = 0; i < 200; i += 2) {
+        std::string n = std::to_string(i);
+        exec({"LPOP", "list"});
+        exec({"HSET", "hash", "f" + n, "short"});  // overwrite shrinks
+        exec({"HDEL", "hash", "f" + std::to_string(i + 1), "nosuch"});
+        exec({"SREM", "set", longValue + n});
+        exec({"ZADD", "zset", "-1", "m" + n});     // score update only
+        exec({"ZREM", "zset", "m" + std::to_string(i + 1)});
+    }
+    EXPECT(db.usedMemory() == recount());
+
+    std::string reply = exec({"memory", "usage", "hash", "SAMPLES", "0"});
+    const HTEntry* hash = db.table().find("hash");
+    EXPECT(reply == ":" + std::to_string(hash->memoryUsage()) + "\r\n");
+    EXPECT(exec({"MEMORY", "USAGE", "nosuch"}) == "$-1\r\n");
+    EXPECT(exec({"MEMORY", "USAGE", "hash", "SAMPLES", "-1"}) ==
+           "-ERR syntax error\r\n");
+    EXPECT(exec({"MEMORY", "DOCTOR", "x"}).compare(0, 27,
+                                                   "-ERR unknown subcommand 'DO") == 0);
+
+    // Emptying containers deletes them, and the counter returns to 0.
+    for (const char* key : {"list", "hash", "set", "zset"}) {
+        exec({"DEL", key});
+    }
+    EXPECT(db.usedMemory() == 0);
+    return true;
+}
+
+/// Sharded INFO: counters and the keyspace are summed, settings are not.
+static bool test_merge_info() {
+    std::vector<std::string> infos = {
+        "# Server\r\ntcp_port:6379\r\nhz:10\r\n\r\n"
+        "# Memory\r\nused_memory:100\r\nmaxmemory_policy:noeviction\r\n\r\n"
+        "# Stats\r\ntotal_commands_processed:93\r\n"
+        "expired_stale_perc:10.00\r\nio_threads:1\r\n\r\n"
+        "# Keyspace\r\n\r\n",
+        "# Server\r\ntcp_port:6379\r\nhz:10\r\n\r\n"
+        "# Memory\r\nused_memory:250\r\nmaxmemory_policy:noeviction\r\n\r\n"
+        "# Stats\r\ntotal_commands_processed:7\r\n"
+        "expired_stale_perc:20.00\r\nio_threads:1\r\n\r\n"
+        "# Keyspace\r\ndb0:keys=150,expires=2,avg_ttl=0\r\n\r\n",
+        "# Keyspace\r\ndb0:keys=150,expires=0,avg_ttl=0\r\n\r\n",
+    };
+    EXPECT(ServerCommands::mergeInfo(infos) ==
+           "# Server\r\ntcp_port:6379\r\nhz:10\r\n\r\n"
+           "# Memory\r\nused_memory:350\r\nmaxmemory_policy:noeviction\r\n\r\n"
+           "# Stats\r\ntotal_commands_processed:100\r\n"
+           "expired_stale_perc:15.00\r\nio_threads:1\r\n\r\n"
+           "# Keyspace\r\ndb0:keys=300,expires=2,avg_ttl=0\r\n\r\n");
+
+    // One shard: unchanged.
+    EXPECT(ServerCommands::mergeInfo({infos[1]}) == infos[1]);
+    return true;
+}
+
+// ── Main ───────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== CommandTable unit tests ===\n");
+
+    RUN(test_resolve_every_command);
+    RUN(test_resolve_unknown);
+    RUN(test_flags);
+    RUN(test_dispatch);
+    RUN(test_bind);
+    RUN(test_memory_accounting);
+    RUN(test_merge_info);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
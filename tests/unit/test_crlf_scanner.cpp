@@ -0,0 +1,145 @@
+/// Unit tests for CrlfScanner — every kernel must agree with the scalar one.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "proto/CrlfScanner.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+static const CrlfScanner::Kernel kKernels[] = {
+    CrlfScanner::Kernel::SCALAR,
+    CrlfScanner::Kernel::SSE2,
+    CrlfScanner::Kernel::AVX2,
+};
+
+/// Run find() with kernel `k`, then restore the startup kernel.
+static int64_t findWith(CrlfScanner::Kernel k, const std::string& s,
+                        size_t offset) {
+    CrlfScanner::Kernel saved = CrlfScanner::kernel();
+    CrlfScanner::useKernel(k);
+    int64_t r = CrlfScanner::find(
+        reinterpret_cast<const uint8_t*>(s.data()), s.size(), offset);
+    CrlfScanner::useKernel(saved);
+    return r;
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+/// The scalar kernel is always available, and so is the startup choice.
+static bool test_kernel_selection() {
+    EXPECT(CrlfScanner::supported(CrlfScanner::Kernel::SCALAR));
+    EXPECT(CrlfScanner::supported(CrlfScanner::kernel()));
+    std::printf("  startup kernel: %s\n",
+                CrlfScanner::kernelName(CrlfScanner::kernel()));
+    return true;
+}
+
+/// A CRLF at every position of buffers of every length up to 100 bytes —
+/// covers the vector bodies, their tails and the boundary between them.
+static bool test_every_position() {
+    for (CrlfScanner::Kernel k : kKernels) {
+        if (!CrlfScanner::supported(k)) continue;
+        for (size_t len = 0; len <= 100; ++len) {
+            std::string s(len, 'a');
+            EXPECT(findWith(k, s, 0) == -1);
+            for (size_t pos = 0; pos + 1 < len; ++pos) {
+                s.assign(len, 'a');
+                s[pos] = '\r';
+                s[pos + 1] = '\n';
+                EXPECT(findWith(k, s, 0) == static_cast<int64_t>(pos));
+                EXPECT(findWith(k, s, pos) == static_cast<int64_t>(pos));
+                EXPECT(findWith(k, s, pos + 1) == -1);
+            }
+        }
+    }
+    return true;
+}
+
+/// Lone \r, lone \n, \n\r and \r\r\n must not confuse the kernels.
+static bool test_near_misses() {
+    std::string s(64, 'x');
+    s[3] = '\r';            // lone CR
+    s[10] = '\n';           // lone LF
+    s[20] = '\n'; s[21] = '\r';   // LF CR
+    s[40] = '\r'; s[41] = '\r'; s[42] = '\n';  // CR CR LF → match at 41
+    s[63] = '\r';           // CR as the very last byte
+    for (CrlfScanner::Kernel k : kKernels) {
+        if (!CrlfScanner::supported(k)) continue;
+        EXPECT(findWith(k, s, 0) == 41);
+        EXPECT(findWith(k, s, 42) == -1);
+    }
+    return true;
+}
+
+/// Random bytes drawn mostly from {\r, \n, a}: all kernels agree.
+static bool test_random_agreement() {
+    std::mt19937 rng(12345);
+    const char alphabet[] = "\r\n\r\naaaaaaaa";
+    for (int round = 0; round < 2000; ++round) {
+        size_t len = rng() % 300;
+        std::string s(len, 'a');
+        for (auto& c : s) c = alphabet[rng() % (sizeof(alphabet) - 1)];
+        size_t offset = len ? rng() % len : 0;
+        int64_t expected = findWith(CrlfScanner::Kernel::SCALAR, s, offset);
+        for (CrlfScanner::Kernel k : kKernels) {
+            if (!CrlfScanner::supported(k)) continue;
+            EXPECT(findWith(k, s, offset) == expected);
+        }
+    }
+    return true;
+}
+
+/// useKernel() refuses nothing it reports as supported and switches find().
+static bool test_use_kernel() {
+    CrlfScanner::Kernel saved = CrlfScanner::kernel();
+    for (CrlfScanner::Kernel k : kKernels) {
+        EXPECT(CrlfScanner::useKernel(k) == CrlfScanner::supported(k));
+        if (CrlfScanner::supported(k)) EXPECT(CrlfScanner::kernel() == k);
+    }
+    CrlfScanner::useKernel(saved);
+    EXPECT(CrlfScanner::kernel() == saved);
+    return true;
+}
+
+// ── Main ───────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== CrlfScanner unit tests ===\n");
+
+    RUN(test_kernel_selection);
+    RUN(test_every_position);
+    RUN(test_near_misses);
+    RUN(test_random_agreement);
+    RUN(test_use_kernel);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
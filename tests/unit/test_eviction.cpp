@@ -0,0 +1,221 @@
+/// Unit tests for maxmemory eviction — policies, access data and the pool.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "store/Database.h"
+#include "store/Eviction.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+static int64_t nowMs() {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(
+               system_clock::now().time_since_epoch())
+        .count();
+}
+
+/// Fill `db` with `n` keys named prefix0..prefixN-1.
+static void fill(Database& db, const std::string& prefix, int n) {
+    for (int i = 0; i < n; ++i) {
+        db.set(prefix + std::to_string(i), "value-" + std::to_string(i));
+    }
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+static bool test_policy_names() {
+    EvictionPolicy p;
+    EXPECT(parseEvictionPolicy("allkeys-lru", p) &&
+           p == EvictionPolicy::ALLKEYS_LRU);
+    EXPECT(parseEvictionPolicy("ALLKEYS-LFU", p) &&
+           p == EvictionPolicy::ALLKEYS_LFU);
+    EXPECT(parseEvictionPolicy("volatile-lru", p) &&
+           p == EvictionPolicy::VOLATILE_LRU);
+    EXPECT(parseEvictionPolicy("volatile-ttl", p) &&
+           p == EvictionPolicy::VOLATILE_TTL);
+    EXPECT(parseEvictionPolicy("noeviction", p) &&
+           p == EvictionPolicy::NOEVICTION);
+    EXPECT(!parseEvictionPolicy("allkeys-random", p));
+    EXPECT(std::string(evictionPolicyName(EvictionPolicy::VOLATILE_TTL)) ==
+           "volatile-ttl");
+    return true;
+}
+
+static bool test_pool_keeps_best() {
+    EvictionPool pool;
+    for (uint64_t s = 0; s < 40; ++s) {
+        pool.offer("k" + std::to_string(s), s);
+    }
+    EXPECT(pool.size() == EvictionPool::kSize);
+    pool.offer("k39", 100);  // re-offered key keeps one slot
+    EXPECT(pool.size() == EvictionPool::kSize);
+    std::string key;
+    EXPECT(pool.popBest(key) && key == "k39");
+    EXPECT(pool.popBest(key) && key == "k38");
+    pool.offer("low", 1);  // room again, but the worst score: still added
+    size_t n = pool.size();
+    while (pool.popBest(key)) {}
+    EXPECT(n == EvictionPool::kSize - 1);
+    EXPECT(key == "low");
+    return true;
+}
+
+static bool test_lfu_counter() {
+    int64_t now = nowMs();
+    uint32_t data = Eviction::initialAccess(EvictionPolicy::ALLKEYS_LFU, now);
+    EXPECT(Eviction::lfuCounter(data, now) == Eviction::kLfuInitVal);
+
+    // random = 0 always passes the probability test.
+    data = Eviction::touch(data, EvictionPolicy::ALLKEYS_LFU, now, 0.0);
+    EXPECT(Eviction::lfuCounter(data, now) == Eviction::kLfuInitVal + 1);
+    // random close to 1 fails it once the counter is past the initial value.
+    uint32_t same = Eviction::touch(data, EvictionPolicy::ALLKEYS_LFU, now,
+                                    0.999);
+    EXPECT(Eviction::lfuCounter(same, now) == Eviction::kLfuInitVal + 1);
+
+    // Three idle minutes take three off the counter.
+    int64_t later = now + 3 * 60 * 1000;
+    EXPECT(Eviction::lfuCounter(data, later) == Eviction::kLfuInitVal - 2);
+    return true;
+}
+
+static bool test_noeviction_refuses() {
+    Database db;
+    fill(db, "k", 100);
+    db.setMaxMemory(db.usedMemory() / 2, EvictionPolicy::NOEVICTION);
+    std::vector<std::string> evicted;
+    EXPECT(!db.evictIfNeeded(evicted));
+    EXPECT(evicted.empty());
+    EXPECT(db.dbsize() == 100);
+
+    db.setMaxMemory(0, EvictionPolicy::NOEVICTION);  // unlimited
+    EXPECT(db.evictIfNeeded(evicted));
+    return true;
+}
+
+static bool test_allkeys_lru_prefers_idle() {
+    Database db;
+    db.setMaxMemory(0, EvictionPolicy::ALLKEYS_LRU);
+    fill(db, "old", 500);
+    fill(db, "new", 500);
+    // Age the "old" keys by an hour.
+    uint32_t hourAgo = static_cast<uint32_t>((nowMs() / 1000) - 3600) &
+                       Eviction::kLruMax;
+    for (int i = 0; i < 500; ++i) {
+        db.table().find("old" + std::to_string(i))->setLru(hourAgo);
+    }
+
+    db.setMaxMemory(db.usedMemory() * 7 / 10, EvictionPolicy::ALLKEYS_LRU);
+    std::vector<std::string> evicted;
+    EXPECT(db.evictIfNeeded(evicted));
+    EXPECT(db.usedMemory() <= db.maxMemory());
+    EXPECT(!evicted.empty());
+    EXPECT(db.evictionStats().evictedKeys == evicted.size());
+
+    size_t old = 0;
+    for (const auto& k : evicted) {
+        EXPECT(!db.exists(k));
+        if (k.compare(0, 3, "old") == 0) ++old;
+    }
+    // Sampling is approximate, but idle keys should dominate.
+    EXPECT(old * 10 >= evicted.size() * 9);
+    return true;
+}
+
+static bool test_volatile_policies_spare_persistent_keys() {
+    for (EvictionPolicy policy :
+         {EvictionPolicy::VOLATILE_LRU, EvictionPolicy::VOLATILE_TTL}) {
+        Database db;
+        fill(db, "keep", 300);
+        fill(db, "ttl", 300);
+        int64_t now = nowMs();
+        for (int i = 0; i < 300; ++i) {
+            // ttl0 expires soonest.
+            db.setExpire("ttl" + std::to_string(i), now + 60000 + i * 1000);
+        }
+        db.setMaxMemory(db.usedMemory() * 3 / 4, policy);
+
+        std::vector<std::string> evicted;
+        EXPECT(db.evictIfNeeded(evicted));
+        EXPECT(!evicted.empty());
+        size_t soon = 0;
+        for (const auto& k : evicted) {
+            EXPECT(k.compare(0, 3, "ttl") == 0);
+            if (std::stoi(k.substr(3)) < 150) ++soon;
+        }
+        if (policy == EvictionPolicy::VOLATILE_TTL) {
+            EXPECT(soon * 10 >= evicted.size() * 8);
+        }
+
+        // Once only persistent keys are left, eviction gives up.
+        db.setMaxMemory(1, policy);
+        EXPECT(!db.evictIfNeeded(evicted));
+        EXPECT(db.dbsize() == 300);
+        EXPECT(db.expiryCount() == 0);
+    }
+    return true;
+}
+
+static bool test_allkeys_lfu_prefers_cold() {
+    Database db;
+    db.setMaxMemory(0, EvictionPolicy::ALLKEYS_LFU);
+    fill(db, "cold", 300);
+    fill(db, "hot", 300);
+    for (int round = 0; round < 50; ++round) {
+        for (int i = 0; i < 300; ++i) db.get("hot" + std::to_string(i));
+    }
+    db.setMaxMemory(db.usedMemory() * 3 / 4, EvictionPolicy::ALLKEYS_LFU);
+    std::vector<std::string> evicted;
+    EXPECT(db.evictIfNeeded(evicted));
+    size_t cold = 0;
+    for (const auto& k : evicted) {
+        if (k.compare(0, 4, "cold") == 0) ++cold;
+    }
+    EXPECT(cold * 10 >= evicted.size() * 9);
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== Eviction unit tests ===\n");
+
+    RUN(test_policy_names);
+    RUN(test_pool_keeps_best);
+    RUN(test_lfu_counter);
+    RUN(test_noeviction_refuses);
+    RUN(test_allkeys_lru_prefers_idle);
+    RUN(test_volatile_policies_spare_persistent_keys);
+    RUN(test_allkeys_lfu_prefers_cold);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
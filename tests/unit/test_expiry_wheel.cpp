@@ -0,0 +1,375 @@
+// tests/unit/test_expiry_wheel.cpp
+// Unit tests for ExpiryWheel — deterministic timestamps, no sockets.
+
+#include "store/ExpiryWheel.h"
+#include "store/HashTable.h"
+
+#include <cassert>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+static int passed = 0;
+static int failed = 0;
+
+#define RUN_TEST(name)                                \
+    do {                                              \
+        std::printf("  %-55s", #name);                \
+        try {                                         \
+            name();                                   \
+            std::printf("[PASS]\n");                   \
+            ++passed;                                 \
+        } catch (...) {                               \
+            std::printf("[FAIL]\n");                   \
+            ++failed;                                 \
+        }                                             \
+    } while (0)
+
+/// Store `key` in `ht` with a TTL at `expireAt` and index it in `wheel`.
+static HTEntry* addKey(HashTable& ht, ExpiryWheel& wheel,
+                       const std::string& key, int64_t expireAt) {
+    HTEntry* entry = ht.set(key, RedisObject::createString("v"));
+    entry = ht.setExpire(entry, expireAt);
+    wheel.insert(entry);
+    return entry;
+}
+
+/// Give `entry` a new deadline and re-index it.
+static void moveKey(HashTable& ht, ExpiryWheel& wheel, HTEntry* entry,
+                    int64_t expireAt) {
+    entry = ht.setExpire(entry, expireAt);
+    wheel.update(entry);
+}
+
+/// Keys of the entries popExpired() returns for `nowMs`.
+static std::vector<std::string> pop(ExpiryWheel& wheel, int64_t nowMs,
+                                    size_t maxWork = 200) {
+    std::vector<HTEntry*> entries;
+    size_t n = wheel.popExpired(nowMs, maxWork, entries);
+    assert(n == entries.size());
+    std::vector<std::string> keys;
+    for (HTEntry* entry : entries) keys.emplace_back(entry->key());
+    return keys;
+}
+
+// ── Test: empty wheel returns nothing from popExpired ──
+// Verifies that popExpired on an empty wheel returns nothing and does not crash.
+static void test_empty_wheel() {
+    ExpiryWheel wheel;
+    assert(wheel.empty());
+    assert(wheel.size() == 0);
+    assert(pop(wheel, 1000).empty());
+    assert(wheel.sample(12345) == nullptr);
+}
+
+// ── Test: insert and pop a single entry ──
+// Verifies the entry stays until its deadline and pops exactly at it.
+static void test_insert_and_pop_single() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "key1", 100);
+    assert(wheel.size() == 1);
+
+    assert(pop(wheel, 99).empty());
+    auto expired = pop(wheel, 100);
+    assert(expired.size() == 1);
+    assert(expired[0] == "key1");
+    assert(wheel.empty());
+}
+
+// ── Test: entries pop earliest millisecond first ──
+// Verifies ordering across slots and levels.
+static void test_ordering() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "d", 300000);  // level 3
+    addKey(ht, wheel, "b", 5000);    // level 2
+    addKey(ht, wheel, "a", 30);      // level 0
+    addKey(ht, wheel, "c", 5001);
+
+    auto expired = pop(wheel, 1000000);
+    assert((expired == std::vector<std::string>{"a", "b", "c", "d"}));
+    assert(wheel.empty());
+}
+
+// ── Test: remove an entry ──
+// Verifies a removed entry never pops and the others still do.
+static void test_remove() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "a", 100);
+    HTEntry* b = addKey(ht, wheel, "b", 200);
+    addKey(ht, wheel, "c", 300);
+
+    wheel.remove(b);
+    assert(wheel.size() == 2);
+    wheel.remove(b);  // not indexed any more: no-op
+    assert(wheel.size() == 2);
+
+    auto expired = pop(wheel, 350);
+    assert((expired == std::vector<std::string>{"a", "c"}));
+}
+
+// ── Test: remove an entry that was never indexed ──
+// Verifies no crash or corruption for a key without a TTL slot in the wheel.
+static void test_remove_not_indexed() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "a", 100);
+    HTEntry* other = ht.setExpire(ht.set("other", RedisObject::createString("v")), 50);
+    wheel.remove(other);
+    assert(wheel.size() == 1);
+    auto expired = pop(wheel, 200);
+    assert(expired.size() == 1 && expired[0] == "a");
+}
+
+// ── Test: update to an earlier deadline ──
+// Verifies update moves the entry ahead of the others.
+static void test_update_to_earlier() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "a", 100);
+    HTEntry* b = addKey(ht, wheel, "b", 200000);
+
+    moveKey(ht, wheel, b, 50);
+    assert(wheel.size() == 2);
+
+    auto expired = pop(wheel, 75);
+    assert(expired.size() == 1 && expired[0] == "b");
+    expired = pop(wheel, 150);
+    assert(expired.size() == 1 && expired[0] == "a");
+}
+
+// ── Test: update to a later deadline ──
+// Verifies update moves the entry behind the others.
+static void test_update_to_later() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    HTEntry* a = addKey(ht, wheel, "a", 100);
+    addKey(ht, wheel, "b", 200);
+    addKey(ht, wheel, "c", 300);
+
+    moveKey(ht, wheel, a, 400);
+
+    assert((pop(wheel, 250) == std::vector<std::string>{"b"}));
+    assert((pop(wheel, 350) == std::vector<std::string>{"c"}));
+    assert((pop(wheel, 450) == std::vector<std::string>{"a"}));
+}
+
+// ── Test: popExpired respects the maxWork bound ──
+// Verifies at most maxWork entries come back, and the next call resumes
+// mid-bucket.
+static void test_popExpired_maxWork() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    for (int i = 0; i < 100; ++i) {
+        addKey(ht, wheel, "key" + std::to_string(i), 10 + i % 3);
+    }
+
+    assert(pop(wheel, 200, 5).size() == 5);
+    assert(wheel.size() == 95);
+    assert(pop(wheel, 200, 10).size() == 10);
+    assert(wheel.size() == 85);
+    assert(pop(wheel, 200, 1000).size() == 85);
+    assert(wheel.empty());
+}
+
+// ── Test: popExpired stops at entries not yet due ──
+// Verifies that entries with future deadlines stay in the wheel.
+static void test_popExpired_stops_at_future() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "expired1", 100);
+    addKey(ht, wheel, "expired2", 200);
+    addKey(ht, wheel, "future", 500);
+
+    assert(pop(wheel, 300).size() == 2);
+    assert(wheel.size() == 1);
+    assert(pop(wheel, 300).empty());
+    assert(pop(wheel, 499).empty());
+    assert(pop(wheel, 500).size() == 1);
+}
+
+// ── Test: deadlines already in the past ──
+// Verifies a key inserted after its deadline pops on the next call.
+static void test_insert_in_the_past() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "later", 10000);
+    assert(pop(wheel, 5000).empty());
+
+    addKey(ht, wheel, "late", 1000);  // due before the wheel's current time
+    auto expired = pop(wheel, 5000);
+    assert(expired.size() == 1 && expired[0] == "late");
+}
+
+// ── Test: real clock values and long idle gaps ──
+// Verifies the wheel jumps from 0 to epoch milliseconds, and across hours
+// and years, without stepping through each millisecond.
+static void test_epoch_times_and_gaps() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    const int64_t now = 1790000000000;  // 2026
+    addKey(ht, wheel, "second", now + 1000);
+    addKey(ht, wheel, "hour", now + 3600 * 1000);
+    addKey(ht, wheel, "year", now + int64_t{365} * 86400 * 1000);
+
+    assert(pop(wheel, now).empty());
+    assert((pop(wheel, now + 1000) == std::vector<std::string>{"second"}));
+    assert(pop(wheel, now + 3600 * 1000 - 1).empty());
+    assert((pop(wheel, now + 3600 * 1000) == std::vector<std::string>{"hour"}));
+    assert((pop(wheel, now + int64_t{400} * 86400 * 1000) ==
+            std::vector<std::string>{"year"}));
+}
+
+// ── Test: deadlines beyond the top level ──
+// Verifies keys more than 2^48 ms out wait in overflow and still pop in order.
+static void test_overflow() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    const int64_t far = int64_t{1} << 50;
+    addKey(ht, wheel, "far2", far + 7);
+    addKey(ht, wheel, "far1", far + 3);
+    addKey(ht, wheel, "near", 42);
+    assert(wheel.size() == 3);
+
+    assert((pop(wheel, 100) == std::vector<std::string>{"near"}));
+    assert(pop(wheel, far + 2).empty());
+    assert((pop(wheel, far + 10) == std::vector<std::string>{"far1", "far2"}));
+    assert(wheel.empty());
+}
+
+// ── Test: links survive the entry being reallocated ──
+// Verifies that overwriting a key with a TTL by a value of another length
+// (which reallocates the HTEntry) keeps it indexed at its new address.
+static void test_entry_reallocation() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    addKey(ht, wheel, "a", 100);
+    addKey(ht, wheel, "b", 100);
+    addKey(ht, wheel, "c", 100);
+
+    HTEntry* b = ht.set("b", RedisObject::createString(std::string(40, 'x')));
+    assert(b->expireAt() == 100);
+
+    wheel.remove(b);  // reaches the reallocated entry's neighbours
+    assert(wheel.size() == 2);
+    HTEntry* c = ht.set("c", RedisObject::createString("short"));
+    auto expired = pop(wheel, 100);
+    std::sort(expired.begin(), expired.end());
+    assert((expired == std::vector<std::string>{"a", "c"}));
+    assert(c->expiryLinks().pprev == nullptr);
+}
+
+// ── Test: clear and sample ──
+// Verifies clear() empties the wheel and sample() only returns indexed keys.
+static void test_clear_and_sample() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    for (int i = 0; i < 50; ++i) {
+        addKey(ht, wheel, "key" + std::to_string(i), 1000 + i * 997);
+    }
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 100; ++i) {
+        HTEntry* entry = wheel.sample(rng());
+        assert(entry != nullptr);
+        assert(entry->expiryLinks().pprev != nullptr);
+    }
+    wheel.clear();
+    assert(wheel.empty());
+    assert(wheel.sample(rng()) == nullptr);
+    assert(pop(wheel, int64_t{1} << 40).empty());
+}
+
+// ── Test: random operations against a model ──
+// Verifies inserts, updates, removes and pops at random times match an
+// ordered map of deadlines exactly.
+static void test_random_against_model() {
+    HashTable ht;
+    ExpiryWheel wheel;
+    std::map<std::string, int64_t> model;  // key → deadline
+    std::mt19937_64 rng(7);
+    int64_t now = 1790000000000;
+
+    // Deadlines from "already due" to days out, biased towards short.
+    auto deadline = [&] {
+        static const int64_t spans[] = {1, 64, 4096, 300000, 86400000};
+        return now - 10 + static_cast<int64_t>(rng() % spans[rng() % 5]);
+    };
+
+    for (int step = 0; step < 20000; ++step) {
+        std::string key = "key" + std::to_string(rng() % 2000);
+        switch (rng() % 4) {
+        case 0:
+        case 1: {
+            int64_t at = deadline();
+            HTEntry* entry = ht.find(key);
+            if (entry) {
+                moveKey(ht, wheel, entry, at);
+            } else {
+                addKey(ht, wheel, key, at);
+            }
+            model[key] = at;
+            break;
+        }
+        case 2:
+            if (HTEntry* entry = ht.find(key)) {
+                wheel.remove(entry);
+                ht.del(key);
+                model.erase(key);
+            }
+            break;
+        default: {
+            int64_t before = now;
+            now += static_cast<int64_t>(rng() % (rng() % 8 == 0 ? 1000000 : 50));
+            std::vector<HTEntry*> out;
+            wheel.popExpired(now, 1u << 30, out);
+            // Keys that were overdue when indexed come first, in any order;
+            // then earliest millisecond first.
+            int64_t last = INT64_MIN;
+            for (HTEntry* entry : out) {
+                auto it = model.find(std::string(entry->key()));
+                assert(it != model.end());
+                assert(it->second <= now);
+                if (it->second > before) {
+                    assert(it->second >= last);
+                    last = it->second;
+                } else {
+                    assert(last == INT64_MIN);
+                }
+                model.erase(it);
+                ht.del(entry->key());
+            }
+            for (const auto& [k, at] : model) assert(at > now);
+            break;
+        }
+        }
+        assert(wheel.size() == model.size());
+    }
+}
+
+int main() {
+    std::printf("=== ExpiryWheel Unit Tests ===\n");
+
+    RUN_TEST(test_empty_wheel);
+    RUN_TEST(test_insert_and_pop_single);
+    RUN_TEST(test_ordering);
+    RUN_TEST(test_remove);
+    RUN_TEST(test_remove_not_indexed);
+    RUN_TEST(test_update_to_earlier);
+    RUN_TEST(test_update_to_later);
+    RUN_TEST(test_popExpired_maxWork);
+    RUN_TEST(test_popExpired_stops_at_future);
+    RUN_TEST(test_insert_in_the_past);
+    RUN_TEST(test_epoch_times_and_gaps);
+    RUN_TEST(test_overflow);
+    RUN_TEST(test_entry_reallocation);
+    RUN_TEST(test_clear_and_sample);
+    RUN_TEST(test_random_against_model);
+
+    std::printf("\nResults: %d passed, %d failed\n", passed, failed);
+    return failed > 0 ? 1 : 0;
+}
@@ -28,7 +28,7 @@ static void test_insert_and_find() {
 
     HTEntry* entry = ht.find("hello");
     assert(entry != nullptr);
-    assert(entry->key == "hello");
+    assert(entry->key() == "hello");
     assert(entry->value.asString() == "world");
     assert(ht.size() == 1);
     check("insert_and_find", true);
@@ -103,13 +103,13 @@ static void test_keys_collection() {
 }
 
 // ── Test: Rehashing triggers and completes ────────────────────────────
-// Verifies that inserting enough keys to exceed load factor 2.0
+// Verifies that inserting enough keys to exceed the 7/8 load limit
 // triggers rehashing, and after enough rehash steps, all keys are
 // still accessible.
 static void test_rehash_triggers() {
     HashTable ht;
-    // Initial capacity is 4. Load factor threshold is 2.0.
-    // So inserting 9 keys (9 / 4 = 2.25 > 2.0) should trigger rehash.
+    // Initial capacity is one group of 16 slots, full at 14 keys.
+    // So inserting 20 keys must trigger a rehash.
     for (int i = 0; i < 20; ++i) {
         std::string key = "key" + std::to_string(i);
         ht.set(key, RedisObject::createString(std::to_string(i)));
@@ -199,26 +199,377 @@ static void test_expire_at_default() {
     ht.set("key", RedisObject::createString("val"));
     HTEntry* entry = ht.find("key");
     assert(entry != nullptr);
-    assert(entry->expireAt == -1);
+    assert(entry->expireAt() == -1);
     check("expire_at_default", true);
 }
 
+// ── Test: Entries never move ──────────────────────────────────────────
+// Verifies that an HTEntry* stays valid while the table grows and
+// rehashes around it (callers hold entries across set() calls).
+static void test_entry_pointers_stable() {
+    HashTable ht;
+    ht.set("anchor", RedisObject::createString("v"));
+    HTEntry* anchor = ht.find("anchor");
+    assert(anchor != nullptr);
+
+    for (int i = 0; i < 5000; ++i) {
+        ht.set("k" + std::to_string(i), RedisObject::createString("x"));
+        if (i % 97 == 0) assert(ht.find("anchor") == anchor);
+    }
+    for (int i = 0; i < 10000; ++i) ht.rehashStep(128);
+    assert(ht.find("anchor") == anchor);
+    assert(anchor->key() == "anchor");
+    check("entry_pointers_stable", true);
+}
+
+// ── Test: Overwrite while rehashing ───────────────────────────────────
+// Verifies that overwriting a key still in the old table updates it in
+// place: no duplicate, and expireAt is preserved as for any overwrite.
+static void test_overwrite_during_rehash() {
+    HashTable ht;
+    const int N = 896;  // 7/8 of 1024 slots — the next new key rehashes
+    for (int i = 0; i < N; ++i) {
+        HTEntry* e = ht.set("k" + std::to_string(i),
+                            RedisObject::createString("old"));
+        ht.setExpire(e, 1000 + i);
+    }
+    // Each set() migrates only 128 entries, so the first overwrites
+    // after the trigger find most keys still in the old table.
+    ht.set("trigger", RedisObject::createString("t"));
+    for (int i = 0; i < N; ++i) {
+        HTEntry* e = ht.set("k" + std::to_string(i),
+                            RedisObject::createString("new"));
+        assert(e->expireAt() == 1000 + i);
+    }
+    assert(ht.size() == static_cast<size_t>(N + 1));
+    for (int i = 0; i < 1000; ++i) ht.rehashStep(128);
+    assert(ht.size() == static_cast<size_t>(N + 1));
+    for (int i = 0; i < N; ++i) {
+        HTEntry* e = ht.find("k" + std::to_string(i));
+        assert(e != nullptr && e->value.asString() == "new");
+    }
+    check("overwrite_during_rehash", true);
+}
+
+// ── Test: Insert/delete churn ─────────────────────────────────────────
+// Verifies that tombstones left by deletes are reclaimed: a table that
+// never holds more than 1000 keys stays small however many keys pass
+// through it, and lookups stay correct throughout.
+static void test_churn_reclaims_tombstones() {
+    HashTable ht;
+    const int live = 1000;
+    for (int i = 0; i < 200000; ++i) {
+        ht.set("c" + std::to_string(i), RedisObject::createString("v"));
+        if (i >= live) {
+            assert(ht.del("c" + std::to_string(i - live)));
+        }
+        ht.rehashStep(16);
+    }
+    assert(ht.size() == static_cast<size_t>(live));
+    for (int i = 200000 - live; i < 200000; ++i) {
+        assert(ht.find("c" + std::to_string(i)) != nullptr);
+    }
+    assert(ht.find("c0") == nullptr);
+    // 1000 keys need 2048 slots; allow one in-flight rebuild on top.
+    assert(ht.slotMemory() <= 3 * 2048 * (1 + sizeof(HTEntry*)));
+    check("churn_reclaims_tombstones", true);
+}
+
+// ── Test: Full scan sees every key ────────────────────────────────────
+// Verifies that a SCAN iteration started mid-rehash returns every key
+// at least once.
+static void test_scan_complete() {
+    HashTable ht;
+    const int N = 3000;
+    for (int i = 0; i < N; ++i) {
+        ht.set("s" + std::to_string(i), RedisObject::createString("v"));
+    }
+    std::unordered_set<std::string> seen;
+    size_t cursor = 0;
+    do {
+        auto [next, batch] = ht.scan(cursor, 10);
+        seen.insert(batch.begin(), batch.end());
+        cursor = next;
+    } while (cursor != 0);
+    assert(seen.size() == static_cast<size_t>(N));
+    check("scan_complete", true);
+}
+
+// ── Test: Scan stays complete while the table grows ───────────────────
+// Verifies the reverse-binary cursor: keys present for the whole scan
+// are all returned even though inserts between calls double the table
+// twice and migration runs in between.
+static void test_scan_across_resize() {
+    HashTable ht;
+    const int N = 500;
+    for (int i = 0; i < N; ++i) {
+        ht.set("orig" + std::to_string(i), RedisObject::createString("v"));
+    }
+    std::unordered_set<std::string> seen;
+    size_t cursor = 0;
+    int extra = 0;
+    do {
+        auto [next, batch] = ht.scan(cursor, 8);
+        seen.insert(batch.begin(), batch.end());
+        cursor = next;
+        // Grow the table under the iteration; set() also migrates.
+        for (int i = 0; i < 40; ++i) {
+            ht.set("new" + std::to_string(extra++),
+                   RedisObject::createString("v"));
+        }
+    } while (cursor != 0);
+    assert(ht.size() > 4 * static_cast<size_t>(N));
+    for (int i = 0; i < N; ++i) {
+        assert(seen.count("orig" + std::to_string(i)) == 1);
+    }
+    check("scan_across_resize", true);
+}
+
+// ── Test: Scan after mass deletes ─────────────────────────────────────
+// Verifies that a table emptied down to one key no longer makes SCAN
+// walk its old size: the shrink leaves few groups, and the per-call visit
+// limit keeps each call short in the meantime.
+static void test_scan_sparse_table() {
+    HashTable ht;
+    const int N = 20000;
+    for (int i = 0; i < N; ++i) {
+        ht.set("sp" + std::to_string(i), RedisObject::createString("v"));
+    }
+    ht.rehashStep(N);  // finish any migration
+    for (int i = 1; i < N; ++i) ht.del("sp" + std::to_string(i));
+
+    size_t cursor = 0;
+    int calls = 0;
+    bool found = false;
+    do {
+        auto [next, batch] = ht.scan(cursor, 1);
+        assert(batch.size() <= 1);
+        for (const auto& k : batch) found |= (k == "sp0");
+        cursor = next;
+        ++calls;
+    } while (cursor != 0);
+    assert(found);
+    // 20000 keys needed 2048 groups; one key needs one.
+    assert(calls <= 2);
+    check("scan_sparse_table", true);
+}
+
+// ── Test: Mass deletes shrink the table ───────────────────────────────
+// Verifies that deleting 90% of the keys starts a shrink rehash, that
+// the slot arrays end up at most half their size, and that the
+// survivors stay reachable throughout.
+static void test_shrink_after_mass_delete() {
+    HashTable ht;
+    const int N = 50000;
+    for (int i = 0; i < N; ++i) {
+        ht.set("m" + std::to_string(i), RedisObject::createString("v"));
+    }
+    ht.rehashStep(N);
+    size_t grown = ht.slotMemory();
+
+    for (int i = 0; i < N; ++i) {
+        if (i % 10 != 0) {
+            assert(ht.del("m" + std::to_string(i)));
+        }
+        if (i % 1000 == 0) {
+            // Survivors stay reachable while a shrink is in progress.
+            for (int j = 0; j <= i; j += 10) {
+                assert(ht.find("m" + std::to_string(j)) != nullptr);
+            }
+        }
+    }
+    for (int i = 0; i < 100; ++i) ht.rehashStep();  // finish migrating
+    assert(ht.size() == static_cast<size_t>(N / 10));
+    assert(ht.slotMemory() * 2 <= grown);
+    for (int i = 0; i < N; i += 10) {
+        assert(ht.find("m" + std::to_string(i)) != nullptr);
+    }
+
+    // Deleting everything shrinks to a single group.
+    for (int i = 0; i < N; i += 10) ht.del("m" + std::to_string(i));
+    for (int i = 0; i < 100; ++i) ht.rehashStep();
+    assert(ht.size() == 0);
+    assert(ht.slotMemory() ==
+           HashTable::kGroupWidth * (1 + sizeof(HTEntry*)));
+    check("shrink_after_mass_delete", true);
+}
+
+// ── Test: Scan stays complete while the table shrinks ─────────────────
+// Verifies that keys present for the whole scan are returned when
+// deletes between calls shrink the table under the cursor.
+static void test_scan_across_shrink() {
+    HashTable ht;
+    const int N = 8000;
+    for (int i = 0; i < N; ++i) {
+        ht.set("x" + std::to_string(i), RedisObject::createString("v"));
+    }
+    ht.rehashStep(N);
+    size_t grown = ht.slotMemory();
+    std::unordered_set<std::string> seen;
+    size_t cursor = 0;
+    int next = 0;
+    do {
+        auto [nextCursor, batch] = ht.scan(cursor, 16);
+        seen.insert(batch.begin(), batch.end());
+        cursor = nextCursor;
+        // Delete all but every 20th key, a few at a time.
+        for (int i = 0; i < 100 && next < N; ++next) {
+            if (next % 20 != 0) {
+                ht.del("x" + std::to_string(next));
+                ++i;
+            }
+        }
+        ht.rehashStep();
+    } while (cursor != 0);
+    assert(ht.slotMemory() < grown);
+    for (int i = 0; i < N; i += 20) {
+        assert(seen.count("x" + std::to_string(i)) == 1);
+    }
+    check("scan_across_shrink", true);
+}
+
+// ── Test: Keys with colliding hash prefixes ───────────────────────────
+// Verifies lookups when many keys share a starting group: a 16-slot
+// table's group choice ignores all but the low bits, so keys with
+// equal tags end up probing past each other.
+static void test_probe_past_full_groups() {
+    HashTable ht;
+    std::vector<std::string> keys;
+    for (int i = 0; keys.size() < 300; ++i) {
+        std::string key = "p" + std::to_string(i);
+        if ((HashTable::hash(key) & 0x7F) == 0x2A) keys.push_back(key);
+    }
+    for (const auto& k : keys) ht.set(k, RedisObject::createString(k));
+    for (const auto& k : keys) {
+        HTEntry* e = ht.find(k);
+        assert(e != nullptr && e->value.asString() == k);
+    }
+    for (size_t i = 0; i < keys.size(); i += 3) assert(ht.del(keys[i]));
+    for (size_t i = 0; i < keys.size(); ++i) {
+        assert((ht.find(keys[i]) == nullptr) == (i % 3 == 0));
+    }
+    check("probe_past_full_groups", true);
+}
+
+// ── Test: Short strings live inside the entry ─────────────────────────
+// Verifies the single-allocation layout: values up to kEmbstrMaxLen
+// bytes become EMBSTR copies owned by the entry, longer ones stay RAW,
+// integers stay INTEGER.
+static void test_embedded_strings() {
+    HashTable ht;
+    std::string shortVal(RedisObject::kEmbstrMaxLen, 's');
+    std::string longVal(RedisObject::kEmbstrMaxLen + 1, 'l');
+    {
+        std::string temp = "view-" + std::to_string(7);
+        ht.set("view", RedisObject::createStringView(temp));
+        temp.assign(temp.size(), 'X');  // the entry must hold its own copy
+    }
+    ht.set("short", RedisObject::createString(shortVal));
+    ht.set("long", RedisObject::createString(longVal));
+    ht.set("int", RedisObject::createStringView("-12345"));
+    ht.set("empty", RedisObject::createString(""));
+
+    HTEntry* e = ht.find("view");
+    assert(e->value.encoding == Encoding::EMBSTR);
+    assert(e->value.asString() == "view-7");
+    e = ht.find("short");
+    assert(e->value.encoding == Encoding::EMBSTR);
+    assert(e->value.asString() == shortVal);
+    assert(e->key() == "short");
+    e = ht.find("long");
+    assert(e->value.encoding == Encoding::RAW);
+    assert(e->value.asString() == longVal);
+    e = ht.find("int");
+    assert(e->value.encoding == Encoding::INTEGER);
+    assert(e->value.asInteger() == -12345);
+    e = ht.find("empty");
+    assert(e->value.encoding == Encoding::EMBSTR);
+    assert(e->value.asString().empty());
+    check("embedded_strings", true);
+}
+
+// ── Test: Overwrites that change the entry size ───────────────────────
+// Verifies that overwriting with a value of another embedded length
+// rebuilds the entry (returning the new pointer) and keeps the key and
+// its expireAt; same-length overwrites stay in place.
+static void test_overwrite_resizes_entry() {
+    HashTable ht;
+    HTEntry* e = ht.set("key", RedisObject::createString("abc"));
+    e = ht.setExpire(e, 5000);
+
+    HTEntry* same = ht.set("key", RedisObject::createString("xyz"));
+    assert(same == e);
+    assert(same->value.asString() == "xyz");
+
+    const std::vector<std::string> values = {"a", std::string(200, 'b'),
+                                             "42", "ccc", ""};
+    for (const auto& v : values) {
+        e = ht.set("key", RedisObject::createString(v));
+        assert(ht.find("key") == e);
+        assert(e->key() == "key");
+        assert(e->value.asString() == v);
+        assert(e->expireAt() == 5000);
+    }
+    e = ht.set("key", RedisObject::createList());
+    e->value.asList().pushBack("x", -2);
+    assert(ht.find("key")->value.type == DataType::LIST);
+    assert(ht.size() == 1);
+    check("overwrite_resizes_entry", true);
+}
+
+// ── Test: The first TTL grows the entry ───────────────────────────────
+// Verifies that setExpire() adds an expiry slot on first use (moving
+// the entry), updates it in place afterwards, and that memoryUsage()
+// reports the layout: 32-byte header, expireAt and expiry-index links,
+// key and embedded bytes.
+static void test_set_expire_grows_entry() {
+    HashTable ht;
+    for (int i = 0; i < 100; ++i) {
+        ht.set("k" + std::to_string(i), RedisObject::createString("value"));
+    }
+    HTEntry* e = ht.find("k42");
+    size_t before = e->memoryUsage();
+    assert(before == sizeof(HTEntry) + 3 + 5);
+    assert(ht.setExpire(e, -1) == e);  // clearing a missing TTL: no-op
+
+    HTEntry* grown = ht.setExpire(e, 123456);
+    assert(ht.find("k42") == grown);
+    assert(grown->key() == "k42");
+    assert(grown->value.asString() == "value");
+    assert(grown->expireAt() == 123456);
+    assert(grown->memoryUsage() ==
+           before + sizeof(int64_t) + sizeof(HTEntry::ExpiryLinks));
+    assert(grown->expiryLinks().pprev == nullptr);  // not indexed yet
+
+    assert(ht.setExpire(grown, 99) == grown);
+    assert(grown->expireAt() == 99);
+    assert(ht.setExpire(grown, -1) == grown);
+    assert(grown->expireAt() == -1);
+    assert(ht.expiryCount() == 0);
+
+    // Every other key is untouched.
+    for (int i = 0; i < 100; ++i) {
+        assert(ht.find("k" + std::to_string(i))->value.asString() == "value");
+    }
+    check("set_expire_grows_entry", true);
+}
+
 // ── Test: Integer encoding for numeric strings ────────────────────────
 // Verifies RedisObject::createString uses INTEGER encoding for "12345".
 static void test_integer_encoding() {
     auto obj = RedisObject::createString("12345");
     assert(obj.encoding == Encoding::INTEGER);
-    assert(std::get<int64_t>(obj.data) == 12345);
+    assert(obj.asInteger() == 12345);
     assert(obj.asString() == "12345");
 
     auto obj2 = RedisObject::createString("-42");
     assert(obj2.encoding == Encoding::INTEGER);
-    assert(std::get<int64_t>(obj2.data) == -42);
+    assert(obj2.asInteger() == -42);
     assert(obj2.asString() == "-42");
 
     auto obj3 = RedisObject::createString("hello");
     assert(obj3.encoding == Encoding::RAW);
-    assert(std::get<std::string>(obj3.data) == "hello");
+    assert(obj3.stringBytes() == "hello");
     assert(obj3.asString() == "hello");
     check("integer_encoding", true);
 }
@@ -236,6 +587,18 @@ int main() {
     test_large_scale();
     test_empty_table();
     test_expire_at_default();
+    test_entry_pointers_stable();
+    test_overwrite_during_rehash();
+    test_churn_reclaims_tombstones();
+    test_scan_complete();
+    test_scan_across_resize();
+    test_scan_sparse_table();
+    test_shrink_after_mass_delete();
+    test_scan_across_shrink();
+    test_probe_past_full_groups();
+    test_embedded_strings();
+    test_overwrite_resizes_entry();
+    test_set_expire_grows_entry();
     test_integer_encoding();
 
     std::printf("\n%d passed, %d failed\n", passed, failed);
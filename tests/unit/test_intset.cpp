@@ -0,0 +1,238 @@
+/// Unit tests for Intset and the intset encoding of sets — including
+/// conversion to the listpack and hashtable encodings, and SINTER's merge.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "store/Intset.h"
+#include "store/SetType.h"
+
+#include <cstdio>
+#include <limits>
+#include <set>
+#include <string>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// All values of `is`, in order.
+static std::vector<int64_t> values(const Intset& is) {
+    std::vector<int64_t> out;
+    for (size_t i = 0; i < is.size(); ++i) out.push_back(is.get(i));
+    return out;
+}
+
+// ── Intset ─────────────────────────────────────────────────────────────────
+
+static bool test_sorted_add_remove() {
+    Intset is;
+    EXPECT(is.empty());
+    EXPECT(is.add(5));
+    EXPECT(is.add(-3));
+    EXPECT(is.add(12));
+    EXPECT(!is.add(5));
+    EXPECT((values(is) == std::vector<int64_t>{-3, 5, 12}));
+    EXPECT(is.width() == 2);
+    EXPECT(is.bytes() == 8 + 3 * 2);
+
+    EXPECT(is.lowerBound(6) == 2);
+    EXPECT(is.lowerBound(-100) == 0);
+    EXPECT(is.lowerBound(100) == 3);
+
+    EXPECT(is.remove(5));
+    EXPECT(!is.remove(5));
+    EXPECT(!is.remove(1LL << 40));  // wider than any value: not there
+    EXPECT((values(is) == std::vector<int64_t>{-3, 12}));
+    return true;
+}
+
+static bool test_width_upgrade() {
+    Intset is;
+    is.add(1);
+    is.add(-2);
+    is.add(70000);  // needs int32
+    EXPECT(is.width() == 4);
+    EXPECT((values(is) == std::vector<int64_t>{-2, 1, 70000}));
+
+    int64_t big = std::numeric_limits<int64_t>::min();
+    is.add(big);  // needs int64, and goes in front
+    EXPECT(is.width() == 8);
+    EXPECT((values(is) == std::vector<int64_t>{big, -2, 1, 70000}));
+    EXPECT(is.contains(big) && is.contains(-2) && is.contains(70000));
+
+    // Removing the wide values keeps the width.
+    is.remove(big);
+    is.remove(70000);
+    EXPECT(is.width() == 8);
+    EXPECT(is.contains(1) && !is.contains(70000));
+    return true;
+}
+
+static bool test_contains_every_width() {
+    // Enough values that contains() both halves and scans, at each
+    // width, with some not a multiple of the SIMD lane count.
+    for (int64_t scale : {int64_t{1}, int64_t{100000}, int64_t{1} << 40}) {
+        Intset is;
+        for (int64_t i = 0; i < 301; ++i) is.add(i * 3 * scale);
+        for (int64_t i = 0; i < 301; ++i) {
+            EXPECT(is.contains(i * 3 * scale));
+            EXPECT(!is.contains(i * 3 * scale + 1));
+        }
+        EXPECT(!is.contains(-1));
+        EXPECT(!is.contains(301 * 3 * scale));
+    }
+    // Values that agree in one 32-bit half only must not match.
+    Intset wide;
+    wide.add(int64_t{7} << 32);
+    wide.add(7);
+    EXPECT(!wide.contains((int64_t{7} << 32) + 7));
+    EXPECT(!wide.contains(int64_t{8} << 32));
+    return true;
+}
+
+static bool test_parse_canonical_only() {
+    int64_t v = 0;
+    EXPECT(Intset::parse("0", v) && v == 0);
+    EXPECT(Intset::parse("-42", v) && v == -42);
+    EXPECT(Intset::parse("9223372036854775807", v));
+    EXPECT(Intset::parse("-9223372036854775808", v));
+    EXPECT(!Intset::parse("9223372036854775808", v));  // overflow
+    EXPECT(!Intset::parse("007", v));
+    EXPECT(!Intset::parse("-0", v));
+    EXPECT(!Intset::parse("+1", v));
+    EXPECT(!Intset::parse("1.0", v));
+    EXPECT(!Intset::parse("", v));
+    EXPECT(!Intset::parse("-", v));
+    return true;
+}
+
+// ── Sets ───────────────────────────────────────────────────────────────────
+
+static bool test_set_starts_as_intset() {
+    SetLimits limits;
+    RedisObject ints = SetType::create("10", limits);
+    EXPECT(ints.encoding == Encoding::INTSET);
+    EXPECT(SetType::add(ints, "10", limits));
+    EXPECT(SetType::add(ints, "-7", limits));
+    EXPECT(!SetType::add(ints, "10", limits));
+    EXPECT(SetType::contains(ints, "-7"));
+    EXPECT(!SetType::contains(ints, "010"));  // a different member
+    EXPECT(!SetType::contains(ints, "abc"));
+    EXPECT(SetType::remove(ints, "-7"));
+    EXPECT(!SetType::remove(ints, "abc"));
+    EXPECT(SetType::size(ints) == 1);
+    EXPECT(ints.memoryUsage() == ints.computeMemoryUsage());
+
+    EXPECT(SetType::create("abc", limits).encoding == Encoding::LISTPACK);
+    EXPECT(SetType::create("010", limits).encoding == Encoding::LISTPACK);
+    limits.maxIntsetEntries = 0;
+    EXPECT(SetType::create("10", limits).encoding == Encoding::LISTPACK);
+    return true;
+}
+
+static bool test_intset_conversions() {
+    SetLimits limits;
+    limits.maxIntsetEntries = 4;
+    limits.maxEntries = 6;
+
+    // A non-integer member: to a listpack, which still fits.
+    RedisObject set = SetType::create("3", limits);
+    for (const char* m : {"3", "1", "2"}) SetType::add(set, m, limits);
+    EXPECT(SetType::add(set, "x", limits));
+    EXPECT(set.encoding == Encoding::LISTPACK);
+    std::set<std::string> members;
+    SetType::forEach(set, [&](std::string_view m) { members.emplace(m); });
+    EXPECT((members == std::set<std::string>{"1", "2", "3", "x"}));
+
+    // Past maxIntsetEntries and maxEntries: straight to a hashtable.
+    limits.maxEntries = 2;
+    RedisObject many = SetType::create("0", limits);
+    for (int i = 0; i < 4; ++i) SetType::add(many, std::to_string(i), limits);
+    EXPECT(many.encoding == Encoding::INTSET);
+    EXPECT(SetType::add(many, "4", limits));
+    EXPECT(many.encoding == Encoding::HASHTABLE);
+    EXPECT(SetType::size(many) == 5 && SetType::contains(many, "4"));
+    EXPECT(many.memoryUsage() == many.computeMemoryUsage());
+    return true;
+}
+
+static bool test_intset_is_compact() {
+    SetLimits limits;
+    RedisObject ints = SetType::create("0", limits);
+    RedisObject table = RedisObject::createSet(Encoding::HASHTABLE);
+    for (int i = 0; i < 500; ++i) {
+        std::string id = std::to_string(100000 + i * 7);
+        SetType::add(ints, id, limits);
+        SetType::add(table, id, limits);
+    }
+    EXPECT(ints.encoding == Encoding::INTSET);
+    EXPECT(ints.asIntset().width() == 4);
+    // 4 bytes a member, against a string node plus bucket.
+    EXPECT(ints.memoryUsage() < 500 * 4 + 64);
+    EXPECT(table.memoryUsage() > 500 * 40);
+    return true;
+}
+
+static bool test_intersect() {
+    SetLimits limits;
+    RedisObject a = SetType::create("0", limits);
+    RedisObject b = SetType::create("0", limits);
+    RedisObject c = SetType::create("0", limits);
+    for (int i = 0; i < 100; ++i) SetType::add(a, std::to_string(i * 2), limits);
+    for (int i = 0; i < 100; ++i) SetType::add(b, std::to_string(i * 3), limits);
+    for (int i = 0; i < 10; ++i) SetType::add(c, std::to_string(i * 6 - 6), limits);
+
+    // Merge over three intsets: multiples of 6 in [0, 48].
+    auto merged = SetType::intersect({&a, &b, &c});
+    EXPECT((merged == std::vector<std::string>{"0", "6", "12", "18", "24",
+                                               "30", "36", "42", "48"}));
+
+    // Mixed encodings take the lookup path, and agree.
+    RedisObject d = SetType::create("x", limits);
+    for (const char* m : {"x", "12", "13", "48"}) SetType::add(d, m, limits);
+    EXPECT(d.encoding == Encoding::LISTPACK);
+    auto mixed = SetType::intersect({&a, &b, &c, &d});
+    EXPECT((std::set<std::string>(mixed.begin(), mixed.end()) ==
+            std::set<std::string>{"12", "48"}));
+    EXPECT(SetType::intersect({&a}).size() == 100);
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== Intset unit tests ===\n");
+
+    RUN(test_sorted_add_remove);
+    RUN(test_width_upgrade);
+    RUN(test_contains_every_width);
+    RUN(test_parse_canonical_only);
+    RUN(test_set_starts_as_intset);
+    RUN(test_intset_conversions);
+    RUN(test_intset_is_compact);
+    RUN(test_intersect);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
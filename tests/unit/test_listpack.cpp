@@ -0,0 +1,335 @@
+/// Unit tests for Listpack and the listpack encoding of hashes, sets and
+/// sorted sets — including conversion to the general encodings.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "store/HashType.h"
+#include "store/Listpack.h"
+#include "store/SetType.h"
+#include "store/ZSetType.h"
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// All entries of `lp`, in order.
+static std::vector<std::string> entries(const Listpack& lp) {
+    std::vector<std::string> out;
+    for (size_t pos = lp.begin(); pos != lp.end(); pos = lp.next(pos)) {
+        out.emplace_back(lp.get(pos));
+    }
+    return out;
+}
+
+// ── Listpack ───────────────────────────────────────────────────────────────
+
+static bool test_insert_find_erase() {
+    Listpack lp;
+    EXPECT(lp.empty());
+    size_t emptyBytes = lp.bytes();
+
+    lp.append("b");
+    lp.append("");
+    lp.insert(lp.begin(), "a");
+    lp.append("d");
+    EXPECT(lp.size() == 4);
+    EXPECT((entries(lp) == std::vector<std::string>{"a", "b", "", "d"}));
+
+    EXPECT(lp.get(lp.find("d")) == "d");
+    EXPECT(lp.find("") == lp.next(lp.find("b")));
+    EXPECT(lp.find("zz") == lp.end());
+    // step 2 only looks at entries 0, 2, ...: "b" is entry 1.
+    EXPECT(lp.find("b", 2) == lp.end());
+    EXPECT(lp.find("", 2) != lp.end());
+
+    lp.erase(lp.find("b"), 2);
+    EXPECT((entries(lp) == std::vector<std::string>{"a", "d"}));
+    lp.erase(lp.begin(), 2);
+    EXPECT(lp.empty());
+    EXPECT(lp.bytes() == emptyBytes);
+    return true;
+}
+
+static bool test_replace_and_long_entries() {
+    Listpack lp;
+    lp.append("x");
+    lp.append("tail");
+    std::string big(300, 'q');  // length needs a two-byte varint
+    lp.replace(lp.begin(), big);
+    EXPECT(lp.get(lp.begin()) == big);
+    EXPECT(lp.get(lp.next(lp.begin())) == "tail");
+    lp.replace(lp.begin(), "y");
+    EXPECT((entries(lp) == std::vector<std::string>{"y", "tail"}));
+    // Exact sizing: header + (1 + 1 + 1) + (1 + 4 + 1).
+    EXPECT(lp.bytes() == 8 + 3 + 6);
+
+    // Walking back from the end, across a two-byte backlen.
+    lp.replace(lp.next(lp.begin()), big);
+    EXPECT(lp.get(lp.prev(lp.end())) == big);
+    EXPECT(lp.prev(lp.prev(lp.end())) == lp.begin());
+    EXPECT(lp.bytes() == 8 + 3 + Listpack::entryBytes(300));
+    EXPECT(Listpack::entryBytes(300) == 2 + 300 + 2);
+
+    Listpack moved(std::move(lp));
+    EXPECT(moved.size() == 2);
+    EXPECT(lp.size() == 0);
+    return true;
+}
+
+// ── Hashes ─────────────────────────────────────────────────────────────────
+
+static bool test_hash_listpack_and_conversion() {
+    ListpackLimits limits;
+    limits.maxEntries = 4;
+    limits.maxValue = 8;
+
+    RedisObject hash = RedisObject::createHash();
+    EXPECT(hash.encoding == Encoding::LISTPACK);
+    EXPECT(HashType::set(hash, "a", "1", limits));
+    EXPECT(HashType::set(hash, "b", "2", limits));
+    EXPECT(!HashType::set(hash, "a", "one", limits));  // overwrite
+    EXPECT(*HashType::get(hash, "a") == "one");
+    EXPECT(!HashType::get(hash, "one"));  // values are not fields
+    EXPECT(HashType::size(hash) == 2);
+    EXPECT(HashType::del(hash, "b"));
+    EXPECT(!HashType::del(hash, "b"));
+    EXPECT(hash.encoding == Encoding::LISTPACK);
+
+    // A value past maxValue converts, and keeps every field.
+    EXPECT(!HashType::set(hash, "a", "a long value", limits));
+    EXPECT(hash.encoding == Encoding::HASHTABLE);
+    EXPECT(*HashType::get(hash, "a") == "a long value");
+    EXPECT(hash.memoryUsage() == hash.computeMemoryUsage());
+
+    // Too many fields converts too.
+    RedisObject wide = RedisObject::createHash();
+    for (int i = 0; i < 4; ++i) {
+        HashType::set(wide, "f" + std::to_string(i), "v", limits);
+    }
+    EXPECT(wide.encoding == Encoding::LISTPACK);
+    HashType::set(wide, "f4", "v", limits);
+    EXPECT(wide.encoding == Encoding::HASHTABLE);
+    std::map<std::string, std::string> seen;
+    HashType::forEach(wide, [&](std::string_view f, std::string_view v) {
+        seen.emplace(f, v);
+    });
+    EXPECT(seen.size() == 5 && seen["f0"] == "v" && seen["f4"] == "v");
+    EXPECT(wide.memoryUsage() == wide.computeMemoryUsage());
+    return true;
+}
+
+static bool test_small_hash_is_compact() {
+    ListpackLimits limits;
+    RedisObject packed = RedisObject::createHash();
+    RedisObject table = RedisObject::createHash(Encoding::HASHTABLE);
+    for (const char* f : {"name", "email", "age"}) {
+        HashType::set(packed, f, "some-value", limits);
+        HashType::set(table, f, "some-value", limits);
+    }
+    EXPECT(packed.encoding == Encoding::LISTPACK);
+    EXPECT(table.encoding == Encoding::HASHTABLE);
+    EXPECT(packed.memoryUsage() * 3 < table.memoryUsage());
+    return true;
+}
+
+// ── Sets ───────────────────────────────────────────────────────────────────
+
+static bool test_set_listpack_and_conversion() {
+    SetLimits limits;
+    limits.maxEntries = 3;
+
+    RedisObject set = RedisObject::createSet();
+    EXPECT(SetType::add(set, "x", limits));
+    EXPECT(!SetType::add(set, "x", limits));
+    EXPECT(SetType::add(set, "y", limits));
+    EXPECT(SetType::contains(set, "y"));
+    EXPECT(SetType::remove(set, "x"));
+    EXPECT(!SetType::contains(set, "x"));
+    EXPECT(SetType::add(set, "x", limits));
+    EXPECT(SetType::add(set, "z", limits));
+    EXPECT(set.encoding == Encoding::LISTPACK);
+    EXPECT(SetType::add(set, "w", limits));
+    EXPECT(set.encoding == Encoding::HASHTABLE);
+
+    std::set<std::string> members;
+    SetType::forEach(set, [&](std::string_view m) { members.emplace(m); });
+    EXPECT((members == std::set<std::string>{"w", "x", "y", "z"}));
+    EXPECT(set.memoryUsage() == set.computeMemoryUsage());
+    return true;
+}
+
+// ── Sorted sets ────────────────────────────────────────────────────────────
+
+static bool test_zset_order_in_both_encodings() {
+    for (size_t maxEntries : {size_t{128}, size_t{0}}) {
+        ListpackLimits limits;
+        limits.maxEntries = maxEntries;  // 0: skiplist from the first add
+
+        RedisObject zset = RedisObject::createZSet();
+        EXPECT(ZSetType::add(zset, "c", 3, limits));
+        EXPECT(ZSetType::add(zset, "a", 1, limits));
+        EXPECT(ZSetType::add(zset, "b2", 2, limits));
+        EXPECT(ZSetType::add(zset, "b1", 2, limits));  // tie: member order
+        EXPECT(!ZSetType::add(zset, "c", 0.5, limits));  // moves to front
+        EXPECT(zset.encoding ==
+               (maxEntries ? Encoding::LISTPACK : Encoding::SKIPLIST));
+
+        auto all = ZSetType::rangeByRank(zset, 0, -1);
+        std::vector<std::string> order;
+        for (const auto& [m, s] : all) order.push_back(m);
+        EXPECT((order == std::vector<std::string>{"c", "a", "b1", "b2"}));
+        EXPECT(all[0].second == 0.5);
+
+        EXPECT(*ZSetType::score(zset, "b2") == 2);
+        EXPECT(*ZSetType::rank(zset, "b1") == 2);
+        EXPECT(!ZSetType::rank(zset, "nope"));
+        auto tail = ZSetType::rangeByRank(zset, -2, -1);
+        EXPECT(tail.size() == 2 && tail[0].first == "b1");
+        EXPECT(ZSetType::rangeByRank(zset, 3, 1).empty());
+
+        EXPECT(ZSetType::remove(zset, "a"));
+        EXPECT(!ZSetType::remove(zset, "a"));
+        EXPECT(ZSetType::size(zset) == 3);
+        EXPECT(zset.memoryUsage() == zset.computeMemoryUsage());
+    }
+    return true;
+}
+
+static bool test_zset_converts_on_long_member() {
+    ListpackLimits limits;
+    RedisObject zset = RedisObject::createZSet();
+    ZSetType::add(zset, "short", 2, limits);
+    ZSetType::add(zset, std::string(limits.maxValue + 1, 'm'), 1, limits);
+    EXPECT(zset.encoding == Encoding::SKIPLIST);
+    EXPECT(ZSetType::size(zset) == 2);
+    EXPECT(*ZSetType::rank(zset, "short") == 1);
+    EXPECT(zset.memoryUsage() == zset.computeMemoryUsage());
+    return true;
+}
+
+static bool test_zset_ranges_in_both_encodings() {
+    for (size_t maxEntries : {size_t{128}, size_t{0}}) {
+        ListpackLimits limits;
+        limits.maxEntries = maxEntries;
+        const size_t all = SIZE_MAX;
+
+        // Scores 0..9, members "m0".."m9".
+        RedisObject zset = RedisObject::createZSet();
+        for (int i = 9; i >= 0; --i) {
+            ZSetType::add(zset, "m" + std::to_string(i), i, limits);
+        }
+        ScoreRange r;
+        r.min = 2;
+        r.max = 5;
+        EXPECT(ZSetType::count(zset, r) == 4);
+        auto got = ZSetType::rangeByScore(zset, r, 0, all);
+        EXPECT(got.size() == 4 && got[0].first == "m2" && got[3].second == 5);
+        got = ZSetType::rangeByScore(zset, r, 1, 2);  // LIMIT 1 2
+        EXPECT(got.size() == 2 && got[0].first == "m3" && got[1].first == "m4");
+        EXPECT(ZSetType::rangeByScore(zset, r, 10, all).empty());
+
+        // ZRANGE / ZREVRANGE clamp out-of-int ranks to +-INT_MAX.
+        EXPECT(ZSetType::rangeByRank(zset, -INT_MAX, INT_MAX).size() == 10);
+        got = ZSetType::revRangeByRank(zset, -INT_MAX, 0);
+        EXPECT(got.size() == 1 && got[0].first == "m9");
+        EXPECT(ZSetType::rangeByRank(zset, INT_MAX, -INT_MAX).empty());
+        EXPECT(ZSetType::revRangeByRank(zset, INT_MAX, INT_MAX).empty());
+
+        r.minExclusive = r.maxExclusive = true;  // (2 (5
+        EXPECT(ZSetType::count(zset, r) == 2);
+        EXPECT(ZSetType::rangeByScore(zset, r, 0, all)[0].first == "m3");
+        EXPECT(ZSetType::count(zset, ScoreRange{}) == 10);  // -inf +inf
+        ScoreRange empty;
+        empty.min = 7;
+        empty.max = 3;
+        EXPECT(ZSetType::count(zset, empty) == 0);
+
+        // ZREMRANGEBYSCORE -inf (3: m0, m1, m2.
+        ScoreRange low;
+        low.max = 3;
+        low.maxExclusive = true;
+        EXPECT(ZSetType::removeRangeByScore(zset, low) == 3);
+        EXPECT(ZSetType::size(zset) == 7);
+        EXPECT(*ZSetType::rank(zset, "m3") == 0);
+        EXPECT(ZSetType::removeRangeByScore(zset, low) == 0);
+        EXPECT(zset.memoryUsage() == zset.computeMemoryUsage());
+
+        // Lex ranges over equal scores.
+        RedisObject lex = RedisObject::createZSet();
+        for (const char* m : {"e", "a", "d", "b", "c"}) {
+            ZSetType::add(lex, m, 0, limits);
+        }
+        LexRange lr;
+        lr.min = "b";
+        lr.max = "d";
+        lr.maxExclusive = true;  // [b (d
+        got = ZSetType::rangeByLex(lex, lr, 0, all);
+        EXPECT(got.size() == 2 && got[0].first == "b" && got[1].first == "c");
+        lr.minOpen = lr.maxOpen = true;  // - +
+        EXPECT(ZSetType::rangeByLex(lex, lr, 3, all).size() == 2);
+
+        // Parsed bounds; a "+" minimum or a "-" maximum matches nothing.
+        EXPECT(LexRange::parse("-", "+", lr));
+        EXPECT(ZSetType::rangeByLex(lex, lr, 0, all).size() == 5);
+        EXPECT(LexRange::parse("(b", "[d", lr));
+        got = ZSetType::rangeByLex(lex, lr, 0, all);
+        EXPECT(got.size() == 2 && got[0].first == "c" && got[1].first == "d");
+        EXPECT(LexRange::parse("+", "+", lr));
+        EXPECT(ZSetType::rangeByLex(lex, lr, 0, all).empty());
+        EXPECT(LexRange::parse("+", "[x", lr));
+        EXPECT(ZSetType::rangeByLex(lex, lr, 0, all).empty());
+        EXPECT(LexRange::parse("[x", "-", lr));
+        EXPECT(ZSetType::rangeByLex(lex, lr, 0, all).empty());
+        EXPECT(LexRange::parse("-", "-", lr));
+        EXPECT(ZSetType::rangeByLex(lex, lr, 0, all).empty());
+        EXPECT(!LexRange::parse("b", "+", lr));
+        EXPECT(!LexRange::parse("-", "", lr));
+    }
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== Listpack unit tests ===\n");
+
+    RUN(test_insert_find_erase);
+    RUN(test_replace_and_long_entries);
+    RUN(test_hash_listpack_and_conversion);
+    RUN(test_small_hash_is_compact);
+    RUN(test_set_listpack_and_conversion);
+    RUN(test_zset_order_in_both_encodings);
+    RUN(test_zset_converts_on_long_member);
+    RUN(test_zset_ranges_in_both_encodings);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
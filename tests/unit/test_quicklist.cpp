@@ -0,0 +1,162 @@
+/// Unit tests for Quicklist — the chunked listpack encoding of lists.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "store/Quicklist.h"
+#include "store/RedisObject.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// `count` elements of `ql` from `start`, through forRange().
+static std::vector<std::string> range(const Quicklist& ql, size_t start,
+                                      size_t count) {
+    std::vector<std::string> out;
+    ql.forRange(start, count, [&](std::string_view e) { out.emplace_back(e); });
+    return out;
+}
+
+static bool test_push_pop_both_ends() {
+    Quicklist ql;
+    EXPECT(ql.empty() && ql.bytes() == 0);
+    ql.pushBack("b", -2);
+    ql.pushBack("c", -2);
+    ql.pushFront("a", -2);
+    EXPECT(ql.size() == 3 && ql.nodeCount() == 1);
+    EXPECT((range(ql, 0, 3) == std::vector<std::string>{"a", "b", "c"}));
+
+    EXPECT(ql.popBack() == "c");
+    EXPECT(ql.popFront() == "a");
+    EXPECT(ql.popFront() == "b");
+    EXPECT(ql.empty() && ql.nodeCount() == 0 && ql.bytes() == 0);
+    return true;
+}
+
+static bool test_matches_deque_across_chunks() {
+    // 4 entries a chunk, so every operation crosses chunk boundaries.
+    Quicklist ql;
+    std::deque<std::string> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 5000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        std::string v = std::to_string(i) + std::string(seed % 20, 'x');
+        switch ((seed >> 8) % 6) {  // pushes twice as likely as pops
+        case 0: case 1: ql.pushFront(v, 4); model.push_front(v); break;
+        case 2: case 3: ql.pushBack(v, 4);  model.push_back(v);  break;
+        case 4:
+            if (!model.empty()) {
+                EXPECT(ql.popFront() == model.front());
+                model.pop_front();
+            }
+            break;
+        default:
+            if (!model.empty()) {
+                EXPECT(ql.popBack() == model.back());
+                model.pop_back();
+            }
+            break;
+        }
+        EXPECT(ql.size() == model.size());
+    }
+    EXPECT(ql.nodeCount() >= (model.size() + 3) / 4);
+    auto all = range(ql, 0, ql.size());
+    EXPECT(std::equal(all.begin(), all.end(), model.begin(), model.end()));
+
+    // A window that starts and ends mid-chunk.
+    size_t start = model.size() / 3;
+    auto mid = range(ql, start, 9);
+    EXPECT(mid.size() == 9);
+    for (size_t i = 0; i < 9; ++i) EXPECT(mid[i] == model[start + i]);
+    // Past the middle, found from the tail.
+    start = model.size() - model.size() / 3;
+    auto late = range(ql, start, 9);
+    for (size_t i = 0; i < 9; ++i) EXPECT(late[i] == model[start + i]);
+    EXPECT(range(ql, model.size() - 1, 1)[0] == model.back());
+    return true;
+}
+
+static bool test_fill_limits() {
+    // -1: 4 KB chunks, each as full as 100-byte values allow.
+    Quicklist bySize;
+    std::string v(100, 'v');
+    for (int i = 0; i < 1000; ++i) bySize.pushBack(v, -1);
+    for (const Quicklist::Node* n = bySize.head(); n; n = n->next) {
+        EXPECT(n->entries.bytes() <= 4096);
+    }
+    size_t perChunk = (4096 - Listpack().bytes()) / Listpack::entryBytes(100);
+    EXPECT(bySize.nodeCount() == (1000 + perChunk - 1) / perChunk);
+
+    // N > 0: N entries a chunk.
+    Quicklist byCount;
+    for (int i = 0; i < 10; ++i) byCount.pushFront("x", 3);
+    EXPECT(byCount.nodeCount() == 4);
+
+    // A value bigger than any chunk gets one to itself.
+    Quicklist big;
+    big.pushBack("a", -1);
+    big.pushBack(std::string(10000, 'b'), -1);
+    big.pushBack("c", -1);
+    EXPECT(big.nodeCount() == 3);
+    EXPECT(big.popBack() == "c");
+    EXPECT(big.popBack().size() == 10000);
+    return true;
+}
+
+static bool test_memory_is_compact() {
+    RedisObject list = RedisObject::createList();
+    EXPECT(list.encoding == Encoding::QUICKLIST);
+    size_t empty = list.memoryUsage();
+    for (int i = 0; i < 10000; ++i) {
+        list.asList().pushBack("job:" + std::to_string(i), -2);
+    }
+    // ~10 bytes a payload: the element costs ~2 bytes of framing, not a
+    // 32-byte std::string.
+    size_t perElement = (list.memoryUsage() - empty) / 10000;
+    EXPECT(perElement < 16);
+    EXPECT(list.memoryUsage() == list.computeMemoryUsage());
+
+    Quicklist moved(std::move(list.asList()));
+    EXPECT(moved.size() == 10000 && list.asList().empty());
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== Quicklist unit tests ===\n");
+
+    RUN(test_push_pop_both_ends);
+    RUN(test_matches_deque_across_chunks);
+    RUN(test_fill_limits);
+    RUN(test_memory_is_compact);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+/// Unit tests for ReplyChain — the outgoing side of a connection.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "net/ReplyChain.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// Concatenate what gather() exposes — i.e. what writev() would send.
+static std::string gathered(const ReplyChain& chain) {
+    struct iovec iov[256];
+    int n = chain.gather(iov, 256);
+    std::string out;
+    for (int i = 0; i < n; ++i) {
+        out.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    }
+    return out;
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+/// A fresh chain holds nothing and allocates nothing.
+static bool test_fresh_chain_is_empty() {
+    ReplyChain chain;
+    EXPECT(chain.readableBytes() == 0);
+    EXPECT(chain.segmentCount() == 0);
+    EXPECT(gathered(chain).empty());
+    return true;
+}
+
+/// Small appends are packed into one block.
+static bool test_small_appends_share_a_block() {
+    ReplyChain chain;
+    for (int i = 0; i < 100; ++i) chain.append("+OK\r\n", 5);
+    EXPECT(chain.readableBytes() == 500);
+    EXPECT(chain.segmentCount() == 1);
+    EXPECT(gathered(chain).substr(0, 10) == "+OK\r\n+OK\r\n");
+    return true;
+}
+
+/// Data that overflows a block continues in a new one — nothing is copied
+/// twice and earlier blocks are never reallocated.
+static bool test_block_overflow() {
+    ReplyChain chain;
+    std::string chunk(1000, 'a');
+    size_t total = 0;
+    while (total < 3 * ReplyChain::kBlockSize) {
+        chain.append(chunk.data(), chunk.size());
+        total += chunk.size();
+    }
+    EXPECT(chain.readableBytes() == total);
+    EXPECT(chain.segmentCount() == 4);
+    EXPECT(gathered(chain) == std::string(total, 'a'));
+    return true;
+}
+
+/// appendSpace() hands out contiguous room: in the current block while it
+/// fits, else in a fresh block — the reserved bytes are never split.
+static bool test_append_space() {
+    ReplyChain chain;
+    char* p = chain.appendSpace(5);
+    std::memcpy(p, "+OK\r\n", 5);
+    EXPECT(chain.segmentCount() == 1);
+
+    std::string fill(ReplyChain::kBlockSize - 10, 'f');
+    chain.append(fill.data(), fill.size());
+    p = chain.appendSpace(8);  // 5 bytes left in the block: not enough
+    std::memcpy(p, ":12345\r\n", 8);
+    EXPECT(chain.segmentCount() == 2);
+    EXPECT(chain.readableBytes() == 5 + fill.size() + 8);
+    EXPECT(gathered(chain) == "+OK\r\n" + fill + ":12345\r\n");
+    return true;
+}
+
+/// A large owned value becomes its own segment without being copied.
+static bool test_append_owned_moves_large_value() {
+    ReplyChain chain;
+    chain.append("$1000000\r\n", 10);
+    std::string big(1000000, 'x');
+    const char* storage = big.data();
+    chain.appendOwned(std::move(big));
+    chain.append("\r\n", 2);
+
+    EXPECT(chain.readableBytes() == 1000012);
+    EXPECT(chain.segmentCount() == 3);
+    struct iovec iov[4];
+    EXPECT(chain.gather(iov, 4) == 3);
+    EXPECT(iov[1].iov_base == storage);  // same bytes, not a copy
+    return true;
+}
+
+/// Small owned strings are packed like ordinary appends.
+static bool test_append_owned_small_is_packed() {
+    ReplyChain chain;
+    chain.append("*2\r\n", 4);
+    chain.appendOwned(std::string("$1\r\na\r\n"));
+    EXPECT(chain.segmentCount() == 1);
+    EXPECT(gathered(chain) == "*2\r\n$1\r\na\r\n");
+    return true;
+}
+
+/// consume() frees fully sent segments but keeps one block for reuse.
+static bool test_consume_releases_segments() {
+    ReplyChain chain;
+    chain.append("head", 4);
+    chain.appendOwned(std::string(100000, 'y'));
+    chain.append("tail", 4);
+
+    chain.consume(2);
+    EXPECT(gathered(chain).substr(0, 2) == "ad");
+    chain.consume(2 + 100000);
+    EXPECT(chain.readableBytes() == 4);
+    EXPECT(chain.segmentCount() == 1);
+    EXPECT(gathered(chain) == "tail");
+
+    chain.consume(4);
+    EXPECT(chain.readableBytes() == 0);
+    EXPECT(chain.segmentCount() <= 1);
+    chain.append("next", 4);
+    EXPECT(gathered(chain) == "next");
+    return true;
+}
+
+/// unwrite() drops the most recent bytes, across segment boundaries.
+static bool test_unwrite() {
+    ReplyChain chain;
+    chain.append("keep", 4);
+    chain.appendOwned(std::string(ReplyChain::kBlockSize, 'z'));
+    chain.append("drop", 4);
+
+    chain.unwrite(4 + ReplyChain::kBlockSize + 2);
+    EXPECT(chain.readableBytes() == 2);
+    EXPECT(gathered(chain) == "ke");
+    return true;
+}
+
+/// takeTail() returns exactly the last n bytes and removes them.
+static bool test_take_tail() {
+    ReplyChain chain;
+    chain.append("+OK\r\n", 5);
+    size_t before = chain.readableBytes();
+    chain.append("$3\r\n", 4);
+    chain.appendOwned(std::string(ReplyChain::kBlockSize, 'v'));
+    chain.append("\r\n", 2);
+
+    std::string reply = chain.takeTail(chain.readableBytes() - before);
+    EXPECT(reply.size() == 4 + ReplyChain::kBlockSize + 2);
+    EXPECT(reply.compare(0, 4, "$3\r\n") == 0);
+    EXPECT(reply.compare(reply.size() - 2, 2, "\r\n") == 0);
+    EXPECT(gathered(chain) == "+OK\r\n");
+    return true;
+}
+
+/// takeAll() hands a lone owned segment over without copying.
+static bool test_take_all_moves_single_segment() {
+    ReplyChain chain;
+    std::string big(ReplyChain::kBlockSize * 2, 'q');
+    const char* storage = big.data();
+    chain.appendOwned(std::move(big));
+
+    std::string out = chain.takeAll();
+    EXPECT(out.size() == ReplyChain::kBlockSize * 2);
+    EXPECT(out.data() == storage);
+    EXPECT(chain.readableBytes() == 0);
+    return true;
+}
+
+/// gather() honours the iovec limit; the rest follows on the next call.
+static bool test_gather_limit() {
+    ReplyChain chain;
+    for (int i = 0; i < 5; ++i) {
+        chain.appendOwned(std::string(ReplyChain::kBlockSize, 'a' + i));
+    }
+    struct iovec iov[2];
+    EXPECT(chain.gather(iov, 2) == 2);
+    chain.consume(iov[0].iov_len + iov[1].iov_len);
+    EXPECT(chain.gather(iov, 2) == 2);
+    EXPECT(static_cast<const char*>(iov[0].iov_base)[0] == 'c');
+    return true;
+}
+
+// ── Main ───────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== ReplyChain unit tests ===\n");
+
+    RUN(test_fresh_chain_is_empty);
+    RUN(test_small_appends_share_a_block);
+    RUN(test_block_overflow);
+    RUN(test_append_space);
+    RUN(test_append_owned_moves_large_value);
+    RUN(test_append_owned_small_is_packed);
+    RUN(test_consume_releases_segments);
+    RUN(test_unwrite);
+    RUN(test_take_tail);
+    RUN(test_take_all_moves_single_segment);
+    RUN(test_gather_limit);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
@@ -6,6 +6,7 @@
 #include <cstring>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 static int passed = 0;
@@ -253,6 +254,110 @@ static void test_parse_many_args() {
     check("parse_many_args", true);
 }
 
+// ── Test: A frame arriving byte by byte resumes where it stopped ─────────
+// Verifies that the ParseState carries the element index across calls,
+// the buffer is never consumed early, and the result is the full command.
+static void test_parse_resumes_split_frame() {
+    const std::string wire = "*3\r\n$3\r\nSET\r\n$3\r\nfoo\r\n$5\r\nb\r\nar\r\n";
+    Buffer buf;
+    ParseState state;
+    RespParser parser;
+    std::vector<std::string_view> args;
+
+    for (size_t i = 0; i + 1 < wire.size(); ++i) {
+        buf.append(&wire[i], 1);
+        assert(!parser.parse(buf, state, args));
+        assert(buf.readableBytes() == i + 1);
+        if (i + 1 == 22) {
+            // "*3\r\n$3\r\nSET\r\n$3\r\nfoo\r\n" — two elements done.
+            assert(state.arrayCount == 3);
+            assert(state.spans.size() == 2);
+        }
+    }
+    buf.append(&wire.back(), 1);
+    assert(parser.parse(buf, state, args));
+    assert(args.size() == 3);
+    assert(args[0] == "SET");
+    assert(args[1] == "foo");
+    assert(args[2] == std::string_view("b\r\nar"));
+    assert(buf.readableBytes() == 0);
+    check("parse_resumes_split_frame", true);
+}
+
+// ── Test: State is reset after a frame, pipelined frames still parse ────
+// Verifies that a completed frame leaves no stale progress behind.
+static void test_parse_state_reset_between_frames() {
+    Buffer buf;
+    ParseState state;
+    RespParser parser;
+    std::vector<std::string_view> args;
+
+    fillBuffer(buf, "*2\r\n$3\r\nGET\r\n$1\r\na\r\n*2\r\n$3\r\nGET");
+    assert(parser.parse(buf, state, args));
+    assert(args.size() == 2 && args[1] == "a");
+    assert(state.arrayCount == -1 && state.pos == 0 && state.spans.empty());
+
+    assert(!parser.parse(buf, state, args));
+    fillBuffer(buf, "\r\n$1\r\nb\r\n");
+    assert(parser.parse(buf, state, args));
+    assert(args.size() == 2 && args[1] == "b");
+    assert(buf.readableBytes() == 0);
+    check("parse_state_reset_between_frames", true);
+}
+
+// ── Test: Large bulk length records the full frame size ───────────────
+// Verifies that once a big $len header is parsed, expectedBytes tells the
+// reader how much room the whole frame needs, and small bulks do not.
+static void test_parse_large_bulk_expected_bytes() {
+    const size_t bigLen = 100000;
+    std::string head = "*3\r\n$3\r\nSET\r\n$1\r\nk\r\n$" +
+                       std::to_string(bigLen) + "\r\n";
+    Buffer buf;
+    ParseState state;
+    RespParser parser;
+    std::vector<std::string_view> args;
+
+    buf.append(head.data(), head.size());
+    buf.append(std::string(10, 'x').data(), 10);
+    assert(!parser.parse(buf, state, args));
+    assert(state.spans.size() == 2);
+    assert(state.bulkLength == static_cast<int64_t>(bigLen));
+    assert(state.expectedBytes == head.size() + bigLen + 2);
+
+    std::string rest(bigLen - 10, 'x');
+    rest += "\r\n";
+    buf.append(rest.data(), rest.size());
+    assert(parser.parse(buf, state, args));
+    assert(args.size() == 3 && args[2].size() == bigLen);
+    assert(state.expectedBytes == 0);
+
+    // A small bulk never asks for presizing.
+    fillBuffer(buf, "*1\r\n$10\r\nabc");
+    assert(!parser.parse(buf, state, args));
+    assert(state.expectedBytes == 0);
+    check("parse_large_bulk_expected_bytes", true);
+}
+
+// ── Test: Inline command split across reads ───────────────────────────
+// Verifies the CRLF search resumes, including a \r at the very end.
+static void test_parse_inline_resumes() {
+    Buffer buf;
+    ParseState state;
+    RespParser parser;
+    std::vector<std::string_view> args;
+
+    fillBuffer(buf, "SET foo");
+    assert(!parser.parse(buf, state, args));
+    fillBuffer(buf, " bar\r");
+    assert(!parser.parse(buf, state, args));
+    fillBuffer(buf, "\n");
+    assert(parser.parse(buf, state, args));
+    assert(args.size() == 3);
+    assert(args[0] == "SET" && args[1] == "foo" && args[2] == "bar");
+    assert(buf.readableBytes() == 0);
+    check("parse_inline_resumes", true);
+}
+
 int main() {
     std::printf("=== RespParser Unit Tests ===\n");
 
@@ -269,6 +374,10 @@ int main() {
     test_parse_empty_bulk_string();
     test_parse_null_array();
     test_parse_many_args();
+    test_parse_resumes_split_frame();
+    test_parse_state_reset_between_frames();
+    test_parse_large_bulk_expected_bytes();
+    test_parse_inline_resumes();
 
     std::printf("\n%d passed, %d failed\n", passed, failed);
     return failed > 0 ? 1 : 0;
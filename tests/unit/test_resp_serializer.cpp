@@ -0,0 +1,155 @@
+/// Unit tests for RespSerializer — table-served and formatted replies must
+/// be byte-identical to the plain RESP encoding.
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "proto/RespSerializer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+/// Everything in the chain, in order.
+static std::string drain(ReplyChain& chain) {
+    return chain.takeAll();
+}
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+/// Status replies, error and null.
+static bool test_fixed_replies() {
+    ReplyChain c;
+    RespSerializer::writeOk(c);
+    RespSerializer::writeQueued(c);
+    RespSerializer::writePong(c);
+    RespSerializer::writeSimpleString(c, "Background saving started");
+    RespSerializer::writeError(c, "ERR unknown command");
+    RespSerializer::writeNull(c);
+    EXPECT(drain(c) == "+OK\r\n+QUEUED\r\n+PONG\r\n"
+                       "+Background saving started\r\n"
+                       "-ERR unknown command\r\n$-1\r\n");
+    return true;
+}
+
+/// Integers on both sides of the shared range and at the int64 limits.
+static bool test_integers() {
+    const int64_t values[] = {
+        0, 1, 9, 10, 999, 9999, 10000, 123456789, -1, -10000,
+        std::numeric_limits<int64_t>::max(),
+        std::numeric_limits<int64_t>::min(),
+    };
+    for (int64_t v : values) {
+        ReplyChain c;
+        RespSerializer::writeInteger(c, v);
+        EXPECT(drain(c) == ":" + std::to_string(v) + "\r\n");
+    }
+    for (int64_t v = 0; v < RespSerializer::kSharedIntegers; ++v) {
+        ReplyChain c;
+        RespSerializer::writeInteger(c, v);
+        EXPECT(drain(c) == ":" + std::to_string(v) + "\r\n");
+    }
+    return true;
+}
+
+/// Array headers from the table, beyond it, and negative.
+static bool test_array_headers() {
+    const int64_t counts[] = {0, 1, 2, 1023, 1024, 5000000, -1};
+    for (int64_t n : counts) {
+        ReplyChain c;
+        RespSerializer::writeArrayHeader(c, n);
+        EXPECT(drain(c) == "*" + std::to_string(n) + "\r\n");
+    }
+    return true;
+}
+
+/// Bulk strings of every length around the table and single-copy limits.
+static bool test_bulk_strings() {
+    for (size_t len = 0; len <= 1100; ++len) {
+        std::string v(len, 'v');
+        ReplyChain c;
+        RespSerializer::writeBulkString(c, v);
+        EXPECT(drain(c) == "$" + std::to_string(len) + "\r\n" + v + "\r\n");
+    }
+    std::string big(100000, 'b');
+    ReplyChain c;
+    RespSerializer::writeBulkString(c, big);
+    EXPECT(drain(c) == "$100000\r\n" + big + "\r\n");
+    return true;
+}
+
+/// Owned bulk strings: small ones are copied, large ones linked.
+static bool test_bulk_strings_owned() {
+    ReplyChain c;
+    RespSerializer::writeBulkStringOwned(c, std::string("hello"));
+    EXPECT(c.segmentCount() == 1);
+    std::string big(ReplyChain::kBlockSize * 2, 'x');
+    const char* storage = big.data();
+    RespSerializer::writeBulkStringOwned(c, std::move(big));
+    EXPECT(c.segmentCount() == 3);  // block, owned value, block for CRLF
+
+    struct iovec iov[4];
+    EXPECT(c.gather(iov, 4) == 3);
+    EXPECT(iov[1].iov_base == storage);
+    EXPECT(drain(c) == "$5\r\nhello\r\n$" +
+                       std::to_string(ReplyChain::kBlockSize * 2) + "\r\n" +
+                       std::string(ReplyChain::kBlockSize * 2, 'x') + "\r\n");
+    return true;
+}
+
+/// Many small replies crossing block boundaries stay in order and intact.
+static bool test_replies_across_blocks() {
+    ReplyChain c;
+    std::string expected;
+    std::string value(300, 'z');
+    for (int i = 0; i < 2000; ++i) {
+        RespSerializer::writeArrayHeader(c, 2);
+        RespSerializer::writeInteger(c, i * 7);
+        RespSerializer::writeBulkString(c, value);
+        expected += "*2\r\n:" + std::to_string(i * 7) + "\r\n$300\r\n" +
+                    value + "\r\n";
+    }
+    EXPECT(c.readableBytes() == expected.size());
+    EXPECT(drain(c) == expected);
+    return true;
+}
+
+// ── Main ───────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== RespSerializer unit tests ===\n");
+
+    RUN(test_fixed_replies);
+    RUN(test_integers);
+    RUN(test_array_headers);
+    RUN(test_bulk_strings);
+    RUN(test_bulk_strings_owned);
+    RUN(test_replies_across_blocks);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}
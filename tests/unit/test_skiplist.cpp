@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cstdio>
+#include <iterator>
 #include <set>
 #include <string>
 #include <utility>
@@ -177,6 +178,142 @@ static void testEmptySkiplist() {
     PASS();
 }
 
+// ── Rank via spans ─────────────────────────────────────────────────────────
+static void testRankMatchesWalk() {
+    TEST("rank/byRank agree with a level-0 walk");
+    Skiplist sl;
+    std::set<std::pair<double, std::string>> model;
+    unsigned seed = 42;
+    for (int i = 0; i < 3000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        double score = static_cast<double>((seed >> 8) % 200);
+        std::string member = "m" + std::to_string((seed >> 4) % 500);
+        if (model.count({score, member})) {
+            assert(sl.remove(member, score));
+            model.erase({score, member});
+        } else {
+            sl.insert(member, score);
+            model.emplace(score, member);
+        }
+    }
+    assert(sl.size() == model.size());
+
+    // Every span sum must land on the same position as the model.
+    size_t expected = 0;
+    for (const auto& [score, member] : model) {
+        auto r = sl.rank(member, score);
+        assert(r && *r == expected);
+        const Skiplist::Node* n = sl.byRank(expected);
+        assert(n && n->member == member && n->score == score);
+        ++expected;
+    }
+    assert(!sl.rank("absent", 0.0));
+    assert(!sl.rank(model.begin()->second, model.begin()->first + 0.5));
+    assert(sl.byRank(model.size()) == nullptr);
+
+    // Ranges that start deep in the list.
+    auto mid = sl.rangeByRank(100, 109);
+    auto it = std::next(model.begin(), 100);
+    assert(mid.size() == 10);
+    for (const auto& [member, score] : mid) {
+        assert(member == it->second && score == it->first);
+        ++it;
+    }
+    PASS();
+}
+
+// ── Reverse ranges ─────────────────────────────────────────────────────────
+static void testRevRange() {
+    TEST("revRangeByRank walks from the highest score");
+    Skiplist sl;
+    for (int i = 0; i < 100; ++i) {
+        sl.insert("m" + std::to_string(i), static_cast<double>(i));
+    }
+    auto top = sl.revRangeByRank(0, 2);
+    assert(top.size() == 3);
+    assert(top[0].second == 99.0 && top[1].second == 98.0 &&
+           top[2].second == 97.0);
+    auto bottom = sl.revRangeByRank(-2, -1);
+    assert(bottom.size() == 2);
+    assert(bottom[0].second == 1.0 && bottom[1].second == 0.0);
+    assert(sl.revRangeByRank(0, -1).size() == 100);
+    assert(sl.revRangeByRank(100, 200).empty());
+    PASS();
+}
+
+// ── Tail pointer ───────────────────────────────────────────────────────────
+static void testTailTracksRemovals() {
+    TEST("last() follows inserts and removals at the end");
+    Skiplist sl;
+    assert(sl.last() == nullptr);
+    sl.insert("a", 1.0);
+    sl.insert("c", 3.0);
+    sl.insert("b", 2.0);
+    assert(sl.last()->member == "c");
+    sl.remove("c", 3.0);
+    assert(sl.last()->member == "b");
+    sl.remove("a", 1.0);
+    sl.remove("b", 2.0);
+    assert(sl.last() == nullptr);
+    assert(sl.revRangeByRank(0, -1).empty());
+
+    Skiplist moved(std::move(sl));
+    moved.insert("z", 9.0);
+    assert(moved.last()->member == "z");
+    PASS();
+}
+
+// ── Score ranges ───────────────────────────────────────────────────────────
+static void testScoreRanges() {
+    TEST("score range count/remove agree with a model");
+    Skiplist sl;
+    std::set<std::pair<double, std::string>> model;
+    unsigned seed = 7;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        double score = static_cast<double>((seed >> 8) % 100);
+        std::string member = "m" + std::to_string(i);
+        sl.insert(member, score);
+        model.emplace(score, member);
+    }
+    auto inModel = [&](const ScoreRange& r) {
+        size_t n = 0;
+        for (const auto& [s, m] : model) n += r.contains(s);
+        return n;
+    };
+
+    ScoreRange r;
+    r.min = 10;
+    r.max = 20;
+    r.minExclusive = true;
+    assert(sl.countInRange(r) == inModel(r));
+    auto page = sl.rangeByScore(r, 5, 3);
+    auto it = model.upper_bound({10.0, "\xff"});
+    std::advance(it, 5);
+    assert(page.size() == 3 && page[0].first == it->second);
+
+    // Remove a window, then check ranks and spans are still exact.
+    std::vector<std::string> removed;
+    sl.removeRangeByScore(r, removed);
+    assert(removed.size() == inModel(r));
+    for (auto m = model.begin(); m != model.end();) {
+        m = r.contains(m->first) ? model.erase(m) : std::next(m);
+    }
+    assert(sl.size() == model.size() && sl.countInRange(r) == 0);
+    size_t expected = 0;
+    for (const auto& [score, member] : model) {
+        assert(*sl.rank(member, score) == expected++);
+    }
+
+    // Everything from 90 up: the tail moves back.
+    ScoreRange top;
+    top.min = 90;
+    removed.clear();
+    sl.removeRangeByScore(top, removed);
+    assert(sl.last()->score < 90);
+    PASS();
+}
+
 int main() {
     std::printf("=== Skiplist Unit Tests ===\n");
     testInsertAndFind();
@@ -187,6 +324,10 @@ int main() {
     testMoveSemantics();
     testLargeInsert();
     testEmptySkiplist();
+    testRankMatchesWalk();
+    testRevRange();
+    testTailTracksRemovals();
+    testScoreRanges();
     std::printf("\n%d tests passed.\n", testsPassed);
     return 0;
 }
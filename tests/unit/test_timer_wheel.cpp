@@ -0,0 +1,297 @@
+/// Unit tests for TimerWheel — the event loop's one-shot and periodic
+/// timers: firing order, the nearest-deadline query, periodic re-arming
+/// and cancellation (including from inside callbacks).
+///
+/// Test framework: lightweight macros — no external dependencies.
+
+#include "net/TimerWheel.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <map>
+#include <random>
+#include <vector>
+
+// ── Minimal test harness ───────────────────────────────────────────────────
+static int g_pass = 0;
+static int g_fail = 0;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::printf("  FAILED: %s  (%s:%d)\n", #cond, __FILE__,         \
+                        __LINE__);                                           \
+            return false;                                                    \
+        }                                                                    \
+    } while (0)
+
+#define RUN(fn)                                                              \
+    do {                                                                     \
+        if (fn()) {                                                          \
+            g_pass++;                                                        \
+            std::printf("[PASS] %s\n", #fn);                                 \
+        } else {                                                             \
+            g_fail++;                                                        \
+            std::printf("[FAIL] %s\n", #fn);                                 \
+        }                                                                    \
+    } while (0)
+
+// ── Tests ──────────────────────────────────────────────────────────────────
+
+static bool test_empty() {
+    TimerWheel wheel;
+    EXPECT(wheel.empty());
+    EXPECT(wheel.nextDeadline() == -1);
+    EXPECT(wheel.runDue(1000000) == 0);
+    EXPECT(!wheel.cancel(0));
+    EXPECT(!wheel.cancel(12345));
+    return true;
+}
+
+static bool test_one_shot_fires_once_at_deadline() {
+    TimerWheel wheel;
+    int fired = 0;
+    TimerWheel::TimerId id = wheel.add(250, 0, [&]() { ++fired; });
+    EXPECT(id != 0);
+    EXPECT(wheel.size() == 1);
+    EXPECT(wheel.nextDeadline() == 250);
+
+    EXPECT(wheel.runDue(249) == 0);
+    EXPECT(fired == 0);
+    EXPECT(wheel.runDue(250) == 1);
+    EXPECT(fired == 1);
+    EXPECT(wheel.empty());
+    EXPECT(wheel.nextDeadline() == -1);
+    EXPECT(wheel.runDue(10000) == 0);
+    EXPECT(!wheel.cancel(id));  // already fired
+    return true;
+}
+
+static bool test_fires_earliest_first_across_levels() {
+    // 1 ms, 64 ms, ~4 s and ~4.5 min slots, plus the overflow list.
+    TimerWheel wheel;
+    std::vector<int64_t> order;
+    const int64_t deadlines[] = {70000000, 5, 300000, 63, 64, 4100, 1,
+                                 262144, 20000000};
+    for (int64_t d : deadlines) {
+        wheel.add(d, 0, [&order, d]() { order.push_back(d); });
+    }
+    EXPECT(wheel.nextDeadline() == 1);
+
+    // Step to each deadline: nextDeadline() is exact, nothing fires early.
+    std::vector<int64_t> expected(std::begin(deadlines), std::end(deadlines));
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT(wheel.nextDeadline() == expected[i]);
+        EXPECT(wheel.runDue(expected[i] - 1) == 0);
+        EXPECT(wheel.runDue(expected[i]) == 1);
+    }
+    EXPECT(order == expected);
+    EXPECT(wheel.empty());
+    return true;
+}
+
+static bool test_late_run_fires_all_due_in_order() {
+    TimerWheel wheel;
+    std::vector<int> order;
+    wheel.add(5000, 0, [&]() { order.push_back(3); });
+    wheel.add(10, 0, [&]() { order.push_back(1); });
+    wheel.add(700, 0, [&]() { order.push_back(2); });
+    wheel.add(9000, 0, [&]() { order.push_back(4); });
+    EXPECT(wheel.runDue(6000) == 3);
+    EXPECT((order == std::vector<int>{1, 2, 3}));
+    EXPECT(wheel.nextDeadline() == 9000);
+    return true;
+}
+
+static bool test_past_deadline_fires_next_run() {
+    TimerWheel wheel;
+    wheel.runDue(1000);
+    int fired = 0;
+    wheel.add(400, 0, [&]() { ++fired; });
+    EXPECT(wheel.nextDeadline() == 400);  // overdue: the caller won't sleep
+    EXPECT(wheel.runDue(1000) == 1);
+    EXPECT(fired == 1);
+    return true;
+}
+
+static bool test_periodic_rearms_and_skips_missed_ticks() {
+    TimerWheel wheel;
+    int fired = 0;
+    wheel.add(100, 100, [&]() { ++fired; });
+    for (int64_t now = 100; now <= 1000; now += 100) {
+        EXPECT(wheel.runDue(now) == 1);
+        EXPECT(wheel.nextDeadline() == now + 100);
+    }
+    EXPECT(fired == 10);
+
+    // Stalled for 5 periods: fires once, then back on a fresh schedule.
+    EXPECT(wheel.runDue(1550) == 1);
+    EXPECT(fired == 11);
+    EXPECT(wheel.nextDeadline() == 1650);
+
+    // A little late is not a missed tick: the schedule holds.
+    EXPECT(wheel.runDue(1660) == 1);
+    EXPECT(wheel.nextDeadline() == 1750);
+    EXPECT(wheel.size() == 1);
+    return true;
+}
+
+static bool test_cancel() {
+    TimerWheel wheel;
+    int fired = 0;
+    TimerWheel::TimerId a = wheel.add(100, 0, [&]() { fired += 1; });
+    TimerWheel::TimerId b = wheel.add(50, 0, [&]() { fired += 10; });
+    TimerWheel::TimerId c = wheel.add(5000, 50, [&]() { fired += 100; });
+    EXPECT(wheel.nextDeadline() == 50);
+    EXPECT(wheel.cancel(b));
+    EXPECT(!wheel.cancel(b));
+    EXPECT(wheel.nextDeadline() == 100);
+    EXPECT(wheel.cancel(c));
+    EXPECT(wheel.size() == 1);
+    EXPECT(wheel.runDue(10000) == 1);
+    EXPECT(fired == 1);
+    EXPECT(!wheel.cancel(a));
+
+    // A reused slot gets a new id; the stale one can't cancel it.
+    TimerWheel::TimerId d = wheel.add(20000, 0, [&]() { fired += 1000; });
+    EXPECT(d != a && d != b && d != c);
+    EXPECT(!wheel.cancel(b));
+    EXPECT(wheel.size() == 1);
+    EXPECT(wheel.runDue(20000) == 1);
+    EXPECT(fired == 1001);
+    return true;
+}
+
+static bool test_cancel_from_own_callback() {
+    TimerWheel wheel;
+    int runs = 0;
+    bool cancelled = false;
+    TimerWheel::TimerId periodic = 0;
+    TimerWheel::TimerId oneShot = 0;
+
+    // A periodic timer that stops itself on its third run.
+    periodic = wheel.add(10, 10, [&]() {
+        if (++runs == 3) cancelled = wheel.cancel(periodic);
+    });
+    // A one-shot has already fired by the time its callback runs.
+    bool oneShotCancelled = true;
+    oneShot = wheel.add(15, 0, [&]() {
+        oneShotCancelled = wheel.cancel(oneShot);
+    });
+
+    EXPECT(wheel.runDue(10) == 1);
+    EXPECT(wheel.runDue(20) == 2);
+    EXPECT(!oneShotCancelled);
+    EXPECT(wheel.runDue(30) == 1);
+    EXPECT(runs == 3);
+    EXPECT(cancelled);
+    EXPECT(wheel.empty());
+    EXPECT(wheel.runDue(200) == 0);
+    return true;
+}
+
+static bool test_cancel_later_timer_in_same_batch() {
+    TimerWheel wheel;
+    int fired = 0;
+    TimerWheel::TimerId later = 0;
+    wheel.add(10, 0, [&]() { wheel.cancel(later); });
+    later = wheel.add(20, 0, [&]() { ++fired; });
+    EXPECT(wheel.runDue(30) == 1);
+    EXPECT(fired == 0);
+    EXPECT(wheel.empty());
+    return true;
+}
+
+static bool test_add_from_callback_waits_for_next_run() {
+    TimerWheel wheel;
+    int inner = 0;
+    wheel.add(10, 0, [&]() {
+        wheel.add(0, 0, [&]() { ++inner; });  // already due
+        for (int i = 0; i < 100; ++i) wheel.add(5000 + i, 0, []() {});
+    });
+    EXPECT(wheel.runDue(10) == 1);
+    EXPECT(inner == 0);
+    EXPECT(wheel.nextDeadline() == 0);
+    EXPECT(wheel.runDue(10) == 1);
+    EXPECT(inner == 1);
+    EXPECT(wheel.size() == 100);
+    EXPECT(wheel.runDue(6000) == 100);
+    return true;
+}
+
+/// Random adds, cancels and runs against a sorted reference model.
+static bool test_matches_model() {
+    std::mt19937_64 rng(7);
+    TimerWheel wheel;
+    std::multimap<int64_t, int> model;                 // deadline -> tag
+    std::map<int, TimerWheel::TimerId> ids;            // live one-shots
+    std::vector<std::pair<int64_t, int>> fired;
+    int64_t now = 0;
+    int nextTag = 0;
+
+    for (int step = 0; step < 20000; ++step) {
+        uint64_t r = rng() % 10;
+        if (r < 5) {
+            // Mostly near deadlines, some far, a few past the wheel.
+            uint64_t span = rng() % 10 == 0 ? (uint64_t{1} << 26) : 5000;
+            int64_t deadline = now + static_cast<int64_t>(rng() % span);
+            int tag = nextTag++;
+            ids[tag] = wheel.add(deadline, 0, [&fired, deadline, tag]() {
+                fired.push_back({deadline, tag});
+            });
+            model.insert({deadline, tag});
+        } else if (r < 7 && !ids.empty()) {
+            auto it = ids.lower_bound(static_cast<int>(rng() % nextTag));
+            if (it == ids.end()) it = ids.begin();
+            EXPECT(wheel.cancel(it->second));
+            for (auto m = model.begin(); m != model.end(); ++m) {
+                if (m->second == it->first) {
+                    model.erase(m);
+                    break;
+                }
+            }
+            ids.erase(it);
+        } else {
+            now += static_cast<int64_t>(rng() % (rng() % 50 == 0 ? 100000 : 300));
+            fired.clear();
+            wheel.runDue(now);
+            std::vector<std::pair<int64_t, int>> expected;
+            while (!model.empty() && model.begin()->first <= now) {
+                expected.push_back(*model.begin());
+                ids.erase(model.begin()->second);
+                model.erase(model.begin());
+            }
+            EXPECT(fired.size() == expected.size());
+            for (size_t i = 0; i < fired.size(); ++i) {
+                EXPECT(fired[i].first == expected[i].first);  // by deadline
+            }
+        }
+        EXPECT(wheel.size() == model.size());
+        EXPECT(wheel.nextDeadline() ==
+               (model.empty() ? -1 : model.begin()->first));
+    }
+    return true;
+}
+
+// ── Main ──────────────────────────────────────────────────────────────────
+
+int main() {
+    std::printf("=== TimerWheel unit tests ===\n");
+
+    RUN(test_empty);
+    RUN(test_one_shot_fires_once_at_deadline);
+    RUN(test_fires_earliest_first_across_levels);
+    RUN(test_late_run_fires_all_due_in_order);
+    RUN(test_past_deadline_fires_next_run);
+    RUN(test_periodic_rearms_and_skips_missed_ticks);
+    RUN(test_cancel);
+    RUN(test_cancel_from_own_callback);
+    RUN(test_cancel_later_timer_in_same_batch);
+    RUN(test_add_from_callback_waits_for_next_run);
+    RUN(test_matches_model);
+
+    std::printf("\nResults: %d passed, %d failed\n", g_pass, g_fail);
+    return g_fail > 0 ? 1 : 0;
+}